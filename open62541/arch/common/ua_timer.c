@@ -8,6 +8,8 @@
 
 #include "ua_timer.h"
 
+#ifndef UA_ENABLE_TIMER_WHEEL
+
 static enum ZIP_CMP
 cmpDateTime(const UA_DateTime *a, const UA_DateTime *b) {
     if(*a == *b)
@@ -25,24 +27,6 @@ cmpId(const UA_UInt64 *a, const UA_UInt64 *b) {
 ZIP_FUNCTIONS(UA_TimerTree, UA_TimerEntry, treeEntry, UA_DateTime, nextTime, cmpDateTime)
 ZIP_FUNCTIONS(UA_TimerIdTree, UA_TimerEntry, idTreeEntry, UA_UInt64, id, cmpId)
 
-static UA_DateTime
-calculateNextTime(UA_DateTime currentTime, UA_DateTime baseTime,
-                  UA_DateTime interval) {
-    /* Take the difference between current and base time */
-    UA_DateTime diffCurrentTimeBaseTime = currentTime - baseTime;
-
-    /* Take modulo of the diff time with the interval. This is the duration we
-     * are already "into" the current interval. Subtract it from (current +
-     * interval) to get the next execution time. */
-    UA_DateTime cycleDelay = diffCurrentTimeBaseTime % interval;
-
-    /* Handle the special case where the baseTime is in the future */
-    if(UA_UNLIKELY(cycleDelay < 0))
-        cycleDelay += interval;
-
-    return currentTime + interval - cycleDelay;
-}
-
 void
 UA_Timer_init(UA_Timer *t) {
     memset(t, 0, sizeof(UA_Timer));
@@ -114,7 +98,8 @@ UA_Timer_addRepeatedCallback(UA_Timer *t, UA_ApplicationCallback callback,
         /* Use "now" as the basetime */
         nextTime = currentTime + (UA_DateTime)interval;
     } else {
-        nextTime = calculateNextTime(currentTime, *baseTime, (UA_DateTime)interval);
+        nextTime = UA_Timer_calculateNextTime(currentTime, *baseTime,
+                                              (UA_DateTime)interval);
     }
 
     UA_LOCK(&t->timerMutex);
@@ -156,7 +141,8 @@ UA_Timer_changeRepeatedCallback(UA_Timer *t, UA_UInt64 callbackId,
         /* Use "now" as the basetime */
         te->nextTime = currentTime + (UA_DateTime)interval;
     } else {
-        te->nextTime = calculateNextTime(currentTime, *baseTime, (UA_DateTime)interval);
+        te->nextTime = UA_Timer_calculateNextTime(currentTime, *baseTime,
+                                                  (UA_DateTime)interval);
     }
 
     /* Update the remaining parameters and re-insert */
@@ -228,8 +214,8 @@ processEntryCallback(void *context, UA_TimerEntry *te) {
      * changes. (Part 4, 5.12.1.2) */
     if(te->nextTime < tpc->nowMonotonic) {
         if(te->timerPolicy == UA_TIMER_HANDLE_CYCLEMISS_WITH_BASETIME)
-            te->nextTime = calculateNextTime(tpc->nowMonotonic, te->nextTime,
-                                              (UA_DateTime)te->interval);
+            te->nextTime = UA_Timer_calculateNextTime(tpc->nowMonotonic, te->nextTime,
+                                                      (UA_DateTime)te->interval);
         else
             te->nextTime = tpc->nowMonotonic + (UA_DateTime)te->interval;
     }
@@ -304,3 +290,5 @@ UA_Timer_clear(UA_Timer *t) {
     UA_LOCK_DESTROY(&t->timerMutex);
 #endif
 }
+
+#endif /* !UA_ENABLE_TIMER_WHEEL */
@@ -12,6 +12,7 @@
 #include <open62541/types.h>
 #include <open62541/plugin/eventloop.h>
 #include "ziptree.h"
+#include "open62541_queue.h"
 
 _UA_BEGIN_DECLS
 
@@ -26,6 +27,8 @@ _UA_BEGIN_DECLS
 /* Callback where the application is either a client or a server */
 typedef void (*UA_ApplicationCallback)(void *application, void *data);
 
+#ifndef UA_ENABLE_TIMER_WHEEL
+
 typedef struct UA_TimerEntry {
     ZIP_ENTRY(UA_TimerEntry) treeEntry;
     UA_TimerPolicy timerPolicy;      /* Timer policy to handle cycle misses */
@@ -61,6 +64,85 @@ typedef struct {
                                * Then we iterate over that tree. */
 } UA_Timer;
 
+#else /* UA_ENABLE_TIMER_WHEEL */
+
+/* Hierarchical timing wheel. The time is divided into ticks of
+ * UA_TIMERWHEEL_RESOLUTION. Every level has UA_TIMERWHEEL_SLOTS slots. A slot
+ * in level 0 covers one tick, a slot in level 1 covers UA_TIMERWHEEL_SLOTS
+ * ticks, and so on. Entries further in the future than the highest level are
+ * kept in an overflow list. Inserting and removing an entry is O(1). Entries
+ * move to lower levels as the time advances. The entries keep their exact
+ * nextTime. The ticks only determine the slots. */
+
+#define UA_TIMERWHEEL_RESOLUTION UA_DATETIME_MSEC
+#define UA_TIMERWHEEL_BITS 6
+#define UA_TIMERWHEEL_SLOTS (1 << UA_TIMERWHEEL_BITS)
+#define UA_TIMERWHEEL_LEVELS 6
+
+typedef struct UA_TimerEntry {
+    LIST_ENTRY(UA_TimerEntry) slotEntry; /* In a slot or the overflow list */
+    struct UA_TimerEntry *processNext;   /* Next in the list of due entries */
+    UA_Boolean processing;               /* In the list of due entries */
+    UA_TimerPolicy timerPolicy;      /* Timer policy to handle cycle misses */
+    UA_DateTime nextTime;            /* The next time when the callback is to be
+                                      * executed */
+    UA_UInt64 interval;              /* Interval in 100ns resolution. If the
+                                      * interval is zero, the callback is not
+                                      * repeated and removed after execution. */
+    UA_ApplicationCallback callback; /* This is also a sentinel value. If the
+                                      * callback is NULL, then the entry is
+                                      * marked for deletion. */
+    void *application;
+    void *data;
+
+    struct UA_TimerEntry *idNext;    /* Next in the bucket of the id index */
+    UA_UInt64 id;                    /* Id of the entry */
+} UA_TimerEntry;
+
+typedef LIST_HEAD(UA_TimerSlot, UA_TimerEntry) UA_TimerSlot;
+
+typedef struct {
+    UA_UInt64 currentTick; /* All earlier ticks have been processed */
+    UA_UInt64 occupied[UA_TIMERWHEEL_LEVELS]; /* Bitmaps of non-empty slots */
+    UA_TimerSlot slots[UA_TIMERWHEEL_LEVELS][UA_TIMERWHEEL_SLOTS];
+    UA_TimerSlot overflow;
+
+    /* Hash index of the entries by their id */
+    UA_TimerEntry **idIndex;
+    size_t idIndexSize; /* Power of two */
+    size_t entriesCount;
+
+    UA_UInt64 idCounter;   /* Generate unique identifiers. Identifiers are
+                            * always above zero. */
+#if UA_MULTITHREADING >= 100
+    UA_Lock timerMutex;
+#endif
+
+    UA_Boolean processing; /* UA_Timer_process is running */
+} UA_Timer;
+
+#endif /* UA_ENABLE_TIMER_WHEEL */
+
+/* Compute the next execution time after the current time that is a multiple of
+ * the interval away from the base time */
+static UA_INLINE UA_DateTime
+UA_Timer_calculateNextTime(UA_DateTime currentTime, UA_DateTime baseTime,
+                           UA_DateTime interval) {
+    /* Take the difference between current and base time */
+    UA_DateTime diffCurrentTimeBaseTime = currentTime - baseTime;
+
+    /* Take modulo of the diff time with the interval. This is the duration we
+     * are already "into" the current interval. Subtract it from (current +
+     * interval) to get the next execution time. */
+    UA_DateTime cycleDelay = diffCurrentTimeBaseTime % interval;
+
+    /* Handle the special case where the baseTime is in the future */
+    if(UA_UNLIKELY(cycleDelay < 0))
+        cycleDelay += interval;
+
+    return currentTime + interval - cycleDelay;
+}
+
 void
 UA_Timer_init(UA_Timer *t);
 
@@ -0,0 +1,579 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ua_timer.h"
+
+#ifdef UA_ENABLE_TIMER_WHEEL
+
+#define SLOTMASK ((UA_UInt64)UA_TIMERWHEEL_SLOTS - 1)
+#define SLOTBIT(i) ((UA_UInt64)1 << (i))
+
+static UA_UInt64
+toTick(UA_DateTime time) {
+    return (time <= 0) ? 0 : (UA_UInt64)time / UA_TIMERWHEEL_RESOLUTION;
+}
+
+/* Index of the lowest set bit. The argument must not be zero. */
+static size_t
+lowestBit(UA_UInt64 v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (size_t)__builtin_ctzll(v);
+#else
+    size_t i = 0;
+    while(!(v & 1)) {
+        v >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+/************/
+/* Id Index */
+/************/
+
+static UA_TimerEntry *
+findEntry(UA_Timer *t, UA_UInt64 id) {
+    if(t->idIndexSize == 0)
+        return NULL;
+    UA_TimerEntry *te = t->idIndex[id & (t->idIndexSize - 1)];
+    for(; te; te = te->idNext) {
+        if(te->id == id)
+            return te;
+    }
+    return NULL;
+}
+
+static void
+indexEntry(UA_Timer *t, UA_TimerEntry *te) {
+    UA_TimerEntry **bucket = &t->idIndex[te->id & (t->idIndexSize - 1)];
+    te->idNext = *bucket;
+    *bucket = te;
+    t->entriesCount++;
+}
+
+static void
+unindexEntry(UA_Timer *t, UA_TimerEntry *te) {
+    UA_TimerEntry **pos = &t->idIndex[te->id & (t->idIndexSize - 1)];
+    for(; *pos; pos = &(*pos)->idNext) {
+        if(*pos == te) {
+            *pos = te->idNext;
+            t->entriesCount--;
+            return;
+        }
+    }
+}
+
+/* Double the size of the id index if it is full */
+static UA_StatusCode
+growIdIndex(UA_Timer *t) {
+    if(t->entriesCount < t->idIndexSize)
+        return UA_STATUSCODE_GOOD;
+    size_t newSize = (t->idIndexSize > 0) ? t->idIndexSize * 2 : 64;
+    UA_TimerEntry **newIndex = (UA_TimerEntry**)
+        UA_calloc(newSize, sizeof(UA_TimerEntry*));
+    if(!newIndex)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    for(size_t i = 0; i < t->idIndexSize; i++) {
+        UA_TimerEntry *te = t->idIndex[i], *next;
+        for(; te; te = next) {
+            next = te->idNext;
+            UA_TimerEntry **bucket = &newIndex[te->id & (newSize - 1)];
+            te->idNext = *bucket;
+            *bucket = te;
+        }
+    }
+    UA_free(t->idIndex);
+    t->idIndex = newIndex;
+    t->idIndexSize = newSize;
+    return UA_STATUSCODE_GOOD;
+}
+
+/*********/
+/* Wheel */
+/*********/
+
+/* Insert into the lowest level whose current block contains the tick of the
+ * entry. Entries in the past go into the slot of the current tick. */
+static void
+insertEntry(UA_Timer *t, UA_TimerEntry *te) {
+    UA_UInt64 tick = toTick(te->nextTime);
+    if(tick < t->currentTick)
+        tick = t->currentTick;
+    for(size_t level = 0; level < UA_TIMERWHEEL_LEVELS; level++) {
+        size_t shift = UA_TIMERWHEEL_BITS * (level + 1);
+        if((tick >> shift) != (t->currentTick >> shift))
+            continue;
+        size_t slot = (size_t)((tick >> (UA_TIMERWHEEL_BITS * level)) & SLOTMASK);
+        LIST_INSERT_HEAD(&t->slots[level][slot], te, slotEntry);
+        t->occupied[level] |= SLOTBIT(slot);
+        return;
+    }
+    LIST_INSERT_HEAD(&t->overflow, te, slotEntry);
+}
+
+/* The occupancy bits are cleared lazily when an empty slot is encountered.
+ * Returns the first non-empty slot at or after the index or -1. */
+static int
+nextOccupiedSlot(UA_Timer *t, size_t level, size_t index) {
+    if(index >= UA_TIMERWHEEL_SLOTS)
+        return -1;
+    UA_UInt64 bits = t->occupied[level] & (~(UA_UInt64)0 << index);
+    while(bits) {
+        size_t i = lowestBit(bits);
+        if(!LIST_EMPTY(&t->slots[level][i]))
+            return (int)i;
+        t->occupied[level] &= ~SLOTBIT(i);
+        bits &= bits - 1;
+    }
+    return -1;
+}
+
+static UA_DateTime
+earliestInSlot(UA_TimerSlot *slot) {
+    UA_DateTime next = UA_INT64_MAX;
+    UA_TimerEntry *te;
+    LIST_FOREACH(te, slot, slotEntry) {
+        if(te->nextTime < next)
+            next = te->nextTime;
+    }
+    return next;
+}
+
+/* The entries of a level are all earlier than those of the next level. And
+ * within a level the slots are ordered. So the earliest entry is in the first
+ * non-empty slot. */
+static UA_DateTime
+earliestTime(UA_Timer *t) {
+    for(size_t level = 0; level < UA_TIMERWHEEL_LEVELS; level++) {
+        /* In the higher levels, the slot of the current tick is empty. Its
+         * entries are in the lower levels. */
+        size_t index = (size_t)((t->currentTick >> (UA_TIMERWHEEL_BITS * level)) & SLOTMASK);
+        if(level > 0)
+            index++;
+        int slot = nextOccupiedSlot(t, level, index);
+        if(slot >= 0)
+            return earliestInSlot(&t->slots[level][slot]);
+    }
+    return earliestInSlot(&t->overflow);
+}
+
+/* Merge sort of the (singly-linked) list of due entries by their nextTime */
+static UA_TimerEntry *
+sortDue(UA_TimerEntry *list) {
+    if(!list || !list->processNext)
+        return list;
+
+    /* Split in the middle */
+    UA_TimerEntry *slow = list, *fast = list->processNext;
+    while(fast && fast->processNext) {
+        slow = slow->processNext;
+        fast = fast->processNext->processNext;
+    }
+    UA_TimerEntry *second = slow->processNext;
+    slow->processNext = NULL;
+
+    /* Sort both halves and merge */
+    UA_TimerEntry *a = sortDue(list), *b = sortDue(second);
+    UA_TimerEntry *head = NULL, **tail = &head;
+    while(a && b) {
+        if(b->nextTime < a->nextTime) {
+            *tail = b;
+            b = b->processNext;
+        } else {
+            *tail = a;
+            a = a->processNext;
+        }
+        tail = &(*tail)->processNext;
+    }
+    *tail = (a) ? a : b;
+    return head;
+}
+
+typedef struct {
+    UA_TimerEntry *first;
+    UA_TimerEntry **last;
+} UA_TimerDueList;
+
+/* Move the entries of a level-0 slot with nextTime <= limit to the end of the
+ * list of due entries */
+static void
+takeDue(UA_TimerSlot *slot, UA_DateTime limit, UA_TimerDueList *due) {
+    UA_TimerEntry *list = NULL, *te, *next;
+    for(te = LIST_FIRST(slot); te; te = next) {
+        next = LIST_NEXT(te, slotEntry);
+        if(te->nextTime > limit)
+            continue;
+        LIST_REMOVE(te, slotEntry);
+        te->processing = true;
+        te->processNext = list;
+        list = te;
+    }
+
+    list = sortDue(list);
+    *due->last = list;
+    while(*due->last)
+        due->last = &(*due->last)->processNext;
+}
+
+/* Advance the current tick to the tick of nowMonotonic. The due entries are
+ * collected in the order of their nextTime. Entries from the higher levels
+ * move down when their slot is reached. Empty stretches of the wheel are
+ * skipped using the occupancy bitmaps. */
+static void
+advanceWheel(UA_Timer *t, UA_DateTime nowMonotonic, UA_TimerDueList *due) {
+    UA_UInt64 target = toTick(nowMonotonic);
+    if(target < t->currentTick)
+        target = t->currentTick;
+
+    while(true) {
+        /* Take the due entries from level 0 */
+        UA_UInt64 cur = t->currentTick;
+        UA_Boolean sameBlock =
+            (target >> UA_TIMERWHEEL_BITS) == (cur >> UA_TIMERWHEEL_BITS);
+        size_t last = (sameBlock) ? (size_t)(target & SLOTMASK) : (size_t)SLOTMASK;
+        int slot = nextOccupiedSlot(t, 0, (size_t)(cur & SLOTMASK));
+        for(; slot >= 0 && (size_t)slot <= last;
+            slot = nextOccupiedSlot(t, 0, (size_t)slot + 1)) {
+            /* Only the slot of the target tick can contain entries that are
+             * not due yet */
+            UA_DateTime limit =
+                (sameBlock && (size_t)slot == last) ? nowMonotonic : UA_INT64_MAX;
+            takeDue(&t->slots[0][slot], limit, due);
+        }
+        if(sameBlock) {
+            t->currentTick = target;
+            return;
+        }
+
+        /* Find the next non-empty slot in the higher levels */
+        size_t level = 1;
+        UA_UInt64 next = 0;
+        for(; level < UA_TIMERWHEEL_LEVELS; level++) {
+            size_t shift = UA_TIMERWHEEL_BITS * level;
+            size_t index = (size_t)((cur >> shift) & SLOTMASK) + 1;
+            slot = nextOccupiedSlot(t, level, index);
+            if(slot < 0)
+                continue;
+            next = ((cur >> (shift + UA_TIMERWHEEL_BITS)) << (shift + UA_TIMERWHEEL_BITS)) |
+                ((UA_UInt64)slot << shift);
+            break;
+        }
+
+        /* Everything is in the overflow list. Jump to the block of the earliest
+         * entry there. */
+        if(level == UA_TIMERWHEEL_LEVELS) {
+            if(LIST_EMPTY(&t->overflow)) {
+                t->currentTick = target;
+                return;
+            }
+            size_t shift = UA_TIMERWHEEL_BITS * UA_TIMERWHEEL_LEVELS;
+            next = (toTick(earliestInSlot(&t->overflow)) >> shift) << shift;
+            if(next > target) {
+                t->currentTick = target;
+                return;
+            }
+            t->currentTick = next;
+            UA_TimerSlot overflow = t->overflow;
+            if(LIST_FIRST(&overflow))
+                LIST_FIRST(&overflow)->slotEntry.le_prev = &LIST_FIRST(&overflow);
+            LIST_INIT(&t->overflow);
+            UA_TimerEntry *te;
+            while((te = LIST_FIRST(&overflow))) {
+                LIST_REMOVE(te, slotEntry);
+                insertEntry(t, te);
+            }
+            continue;
+        }
+
+        /* Nothing more is due */
+        if(next > target) {
+            t->currentTick = target;
+            return;
+        }
+
+        /* Move the entries of the slot to the lower levels */
+        t->currentTick = next;
+        UA_TimerSlot *s = &t->slots[level][slot];
+        t->occupied[level] &= ~SLOTBIT(slot);
+        UA_TimerEntry *te;
+        while((te = LIST_FIRST(s))) {
+            LIST_REMOVE(te, slotEntry);
+            insertEntry(t, te);
+        }
+    }
+}
+
+/**************/
+/* Public API */
+/**************/
+
+void
+UA_Timer_init(UA_Timer *t) {
+    memset(t, 0, sizeof(UA_Timer));
+    UA_LOCK_INIT(&t->timerMutex);
+}
+
+static UA_StatusCode
+addCallback(UA_Timer *t, UA_ApplicationCallback callback, void *application,
+            void *data, UA_DateTime nextTime, UA_UInt64 interval,
+            UA_TimerPolicy timerPolicy, UA_UInt64 *callbackId) {
+    /* A callback method needs to be present */
+    if(!callback)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    /* Make room in the id index */
+    UA_StatusCode res = growIdIndex(t);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    /* Allocate the repeated callback structure */
+    UA_TimerEntry *te = (UA_TimerEntry*)UA_malloc(sizeof(UA_TimerEntry));
+    if(!te)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    /* Set the repeated callback */
+    te->interval = (UA_UInt64)interval;
+    te->id = ++t->idCounter;
+    te->callback = callback;
+    te->application = application;
+    te->data = data;
+    te->nextTime = nextTime;
+    te->timerPolicy = timerPolicy;
+    te->processing = false;
+    te->processNext = NULL;
+
+    /* Set the output identifier */
+    if(callbackId)
+        *callbackId = te->id;
+
+    indexEntry(t, te);
+    insertEntry(t, te);
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_Timer_addTimedCallback(UA_Timer *t, UA_ApplicationCallback callback,
+                          void *application, void *data, UA_DateTime date,
+                          UA_UInt64 *callbackId) {
+    UA_LOCK(&t->timerMutex);
+    UA_StatusCode res = addCallback(t, callback, application, data, date,
+                                    0, UA_TIMER_HANDLE_CYCLEMISS_WITH_CURRENTTIME,
+                                    callbackId);
+    UA_UNLOCK(&t->timerMutex);
+    return res;
+}
+
+UA_StatusCode
+UA_Timer_addRepeatedCallback(UA_Timer *t, UA_ApplicationCallback callback,
+                             void *application, void *data, UA_Double interval_ms,
+                             UA_DateTime *baseTime, UA_TimerPolicy timerPolicy,
+                             UA_UInt64 *callbackId) {
+    /* The interval needs to be positive */
+    if(interval_ms <= 0.0)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    UA_UInt64 interval = (UA_UInt64)(interval_ms * UA_DATETIME_MSEC);
+    if(interval == 0)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    /* Compute the first time for execution */
+    UA_DateTime currentTime = UA_DateTime_nowMonotonic();
+    UA_DateTime nextTime;
+    if(baseTime == NULL) {
+        /* Use "now" as the basetime */
+        nextTime = currentTime + (UA_DateTime)interval;
+    } else {
+        nextTime = UA_Timer_calculateNextTime(currentTime, *baseTime,
+                                              (UA_DateTime)interval);
+    }
+
+    UA_LOCK(&t->timerMutex);
+    UA_StatusCode res = addCallback(t, callback, application, data, nextTime,
+                                    interval, timerPolicy, callbackId);
+    UA_UNLOCK(&t->timerMutex);
+    return res;
+}
+
+UA_StatusCode
+UA_Timer_changeRepeatedCallback(UA_Timer *t, UA_UInt64 callbackId,
+                                UA_Double interval_ms, UA_DateTime *baseTime,
+                                UA_TimerPolicy timerPolicy) {
+    /* The interval needs to be positive */
+    if(interval_ms <= 0.0)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    UA_UInt64 interval = (UA_UInt64)(interval_ms * UA_DATETIME_MSEC);
+    if(interval == 0)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    UA_LOCK(&t->timerMutex);
+
+    /* Find according to the id */
+    UA_TimerEntry *te = findEntry(t, callbackId);
+    if(!te) {
+        UA_UNLOCK(&t->timerMutex);
+        return UA_STATUSCODE_BADNOTFOUND;
+    }
+
+    /* Entries that are currently processed stay in the list of due entries.
+     * Only the interval and nextTime are adjusted. They are re-inserted after
+     * their execution. */
+    if(!te->processing)
+        LIST_REMOVE(te, slotEntry);
+
+    /* Compute the next time for execution. The logic is identical to the
+     * creation of a new repeated callback. */
+    UA_DateTime currentTime = UA_DateTime_nowMonotonic();
+    if(baseTime == NULL) {
+        /* Use "now" as the basetime */
+        te->nextTime = currentTime + (UA_DateTime)interval;
+    } else {
+        te->nextTime = UA_Timer_calculateNextTime(currentTime, *baseTime,
+                                                  (UA_DateTime)interval);
+    }
+
+    /* Update the remaining parameters and re-insert */
+    te->interval = interval;
+    te->timerPolicy = timerPolicy;
+
+    if(!te->processing)
+        insertEntry(t, te);
+
+    UA_UNLOCK(&t->timerMutex);
+    return UA_STATUSCODE_GOOD;
+}
+
+void
+UA_Timer_removeCallback(UA_Timer *t, UA_UInt64 callbackId) {
+    UA_LOCK(&t->timerMutex);
+    UA_TimerEntry *te = findEntry(t, callbackId);
+    if(UA_LIKELY(te != NULL)) {
+        if(!te->processing) {
+            /* Remove/free the entry */
+            LIST_REMOVE(te, slotEntry);
+            unindexEntry(t, te);
+            UA_free(te);
+        } else {
+            /* The entry is in the list of due entries. Only mark the entry to
+             * be deleted. Will be removed/freed when it is reached during the
+             * processing. */
+            te->callback = NULL;
+        }
+    }
+    UA_UNLOCK(&t->timerMutex);
+}
+
+static void
+processEntry(UA_Timer *t, UA_TimerEntry *te, UA_DateTime nowMonotonic) {
+    /* Execute the callback. The memory is not freed during the callback.
+     * Instead, the entries that are processed are only marked for deletion by
+     * setting elm->callback to NULL. */
+    if(te->callback) {
+        te->callback(te->application, te->data);
+    }
+    te->processing = false;
+
+    /* Remove and free the entry if marked for deletion or a one-time timed
+     * callback */
+    if(!te->callback || te->interval == 0) {
+        unindexEntry(t, te);
+        UA_free(te);
+        return;
+    }
+
+    /* Set the time for the next regular execution */
+    te->nextTime += (UA_DateTime)te->interval;
+
+    /* Handle the case where the "window" was missed. E.g. due to congestion of
+     * the application or if the clock was shifted.
+     *
+     * If the timer policy is "CurrentTime", then there is at least the
+     * interval between executions. This is used for Monitoreditems, for
+     * which the spec says: The sampling interval indicates the fastest rate
+     * at which the Server should sample its underlying source for data
+     * changes. (Part 4, 5.12.1.2) */
+    if(te->nextTime < nowMonotonic) {
+        if(te->timerPolicy == UA_TIMER_HANDLE_CYCLEMISS_WITH_BASETIME)
+            te->nextTime = UA_Timer_calculateNextTime(nowMonotonic, te->nextTime,
+                                                      (UA_DateTime)te->interval);
+        else
+            te->nextTime = nowMonotonic + (UA_DateTime)te->interval;
+    }
+
+    /* Insert back into the wheel */
+    insertEntry(t, te);
+}
+
+UA_DateTime
+UA_Timer_process(UA_Timer *t, UA_DateTime nowMonotonic) {
+    UA_LOCK(&t->timerMutex);
+
+    /* Not reentrant. Don't call _process from within _process. */
+    if(!t->processing) {
+        t->processing = true;
+
+        /* Collect the entries that need processing now. Entries added by the
+         * callbacks are inserted into the wheel and not processed before the
+         * next call. */
+        UA_TimerDueList due;
+        due.first = NULL;
+        due.last = &due.first;
+        advanceWheel(t, nowMonotonic, &due);
+
+        /* Process the entries in-order */
+        UA_TimerEntry *te = due.first, *next;
+        for(; te; te = next) {
+            next = te->processNext;
+            processEntry(t, te, nowMonotonic);
+        }
+
+        t->processing = false;
+    }
+
+    /* Compute the timestamp of the earliest next callback */
+    UA_DateTime next = earliestTime(t);
+    if(next < nowMonotonic)
+        next = nowMonotonic;
+
+    UA_UNLOCK(&t->timerMutex);
+    return next;
+}
+
+UA_DateTime
+UA_Timer_nextRepeatedTime(UA_Timer *t) {
+    UA_LOCK(&t->timerMutex);
+    UA_DateTime next = earliestTime(t);
+    UA_UNLOCK(&t->timerMutex);
+    return next;
+}
+
+void
+UA_Timer_clear(UA_Timer *t) {
+    UA_LOCK(&t->timerMutex);
+
+    for(size_t i = 0; i < t->idIndexSize; i++) {
+        UA_TimerEntry *te = t->idIndex[i], *next;
+        for(; te; te = next) {
+            next = te->idNext;
+            UA_free(te);
+        }
+    }
+    UA_free(t->idIndex);
+    t->idIndex = NULL;
+    t->idIndexSize = 0;
+    t->entriesCount = 0;
+    memset(t->slots, 0, sizeof(t->slots));
+    memset(t->occupied, 0, sizeof(t->occupied));
+    LIST_INIT(&t->overflow);
+    t->currentTick = 0;
+    t->idCounter = 0;
+
+    UA_UNLOCK(&t->timerMutex);
+
+#if UA_MULTITHREADING >= 100
+    UA_LOCK_DESTROY(&t->timerMutex);
+#endif
+}
+
+#endif /* UA_ENABLE_TIMER_WHEEL */
@@ -131,15 +131,41 @@ UA_EventLoopPOSIX_start(UA_EventLoopPOSIX *el) {
     UA_LOG_INFO(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
                 "Starting the EventLoop");
 
+    /* Select the backend for polling the fds */
+    const UA_String *backend = (const UA_String*)
+        UA_KeyValueMap_getScalar(el->eventLoop.params,
+                                 UA_QUALIFIEDNAME(0, "backend"),
+                                 &UA_TYPES[UA_TYPES_STRING]);
+    if(backend) {
+        UA_String ioUring = UA_STRING("io_uring");
+        if(UA_String_equal(backend, &ioUring)) {
+#ifdef UA_HAVE_IO_URING
+            if(UA_EventLoopPOSIX_startURing(el) != UA_STATUSCODE_GOOD)
+                UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                               "Eventloop\t| Falling back to the default backend");
+#else
+            UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                           "Eventloop\t| The io_uring backend is not available. "
+                           "Using the default backend.");
+#endif
+        }
+    }
+
 #ifdef UA_HAVE_EPOLL
-    el->epollfd = epoll_create1(0);
-    if(el->epollfd == -1) {
-        UA_LOG_SOCKET_ERRNO_WRAP(
-           UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
-                          "Eventloop\t| Could not create the epoll socket (%s)",
-                          errno_str));
-        UA_UNLOCK(&el->elMutex);
-        return UA_STATUSCODE_BADINTERNALERROR;
+    el->epollfd = UA_INVALID_FD;
+#ifdef UA_HAVE_IO_URING
+    if(!el->uring)
+#endif
+    {
+        el->epollfd = epoll_create1(0);
+        if(el->epollfd == -1) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                              "Eventloop\t| Could not create the epoll socket (%s)",
+                              errno_str));
+            UA_UNLOCK(&el->elMutex);
+            return UA_STATUSCODE_BADINTERNALERROR;
+        }
     }
 #endif
 
@@ -179,7 +205,11 @@ checkClosed(UA_EventLoopPOSIX *el) {
 
     /* Close the epoll/IOCP socket once all EventSources have shut down */
 #ifdef UA_HAVE_EPOLL
-    close(el->epollfd);
+    if(el->epollfd != UA_INVALID_FD)
+        close(el->epollfd);
+#endif
+#ifdef UA_HAVE_IO_URING
+    UA_EventLoopPOSIX_stopURing(el);
 #endif
 
     UA_LOG_INFO(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
@@ -411,6 +441,7 @@ UA_EventLoopPOSIX_free(UA_EventLoopPOSIX *el) {
 #endif
 
     /* Clean up */
+    UA_KeyValueMap_delete(el->eventLoop.params);
     UA_UNLOCK(&el->elMutex);
     UA_LOCK_DESTROY(&el->elMutex);
     UA_free(el);
@@ -447,6 +478,12 @@ UA_EventLoop_new_POSIX(const UA_Logger *logger) {
 
     /* Set the public EventLoop content */
     el->eventLoop.logger = logger;
+    el->eventLoop.params = UA_KeyValueMap_new();
+    if(!el->eventLoop.params) {
+        UA_LOCK_DESTROY(&el->elMutex);
+        UA_free(el);
+        return NULL;
+    }
 
     el->eventLoop.start = (UA_StatusCode (*)(UA_EventLoop*))UA_EventLoopPOSIX_start;
     el->eventLoop.stop = (void (*)(UA_EventLoop*))UA_EventLoopPOSIX_stop;
@@ -482,11 +519,94 @@ UA_EventLoop_new_POSIX(const UA_Logger *logger) {
 
 /* Reusable EventSource functionality */
 
+#define UA_SENDPOOL_DEFAULTSIZE 16
+
+void
+UA_EventLoopPOSIX_configureSendPool(UA_POSIXConnectionManager *pcm) {
+    UA_NetworkBufferPool *pool = &pcm->sendPool;
+    if(pool->region)
+        return; /* Already in use */
+
+    const UA_UInt32 *poolSize = (const UA_UInt32 *)
+        UA_KeyValueMap_getScalar(&pcm->cm.eventSource.params,
+                                 UA_QUALIFIEDNAME(0, "send-pool-size"),
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    const UA_UInt32 *bufSize = (const UA_UInt32 *)
+        UA_KeyValueMap_getScalar(&pcm->cm.eventSource.params,
+                                 UA_QUALIFIEDNAME(0, "send-pool-bufsize"),
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    pool->poolSize = (poolSize) ? *poolSize : UA_SENDPOOL_DEFAULTSIZE;
+    pool->bufSize = (bufSize) ? *bufSize : 0; /* Zero -> size on first use */
+    pool->stats.poolSize = pool->poolSize;
+}
+
+void
+UA_EventLoopPOSIX_clearSendPool(UA_POSIXConnectionManager *pcm) {
+    UA_NetworkBufferPool *pool = &pcm->sendPool;
+    UA_free(pool->region);
+    memset(pool, 0, sizeof(UA_NetworkBufferPool));
+}
+
+/* Carve the pooled buffers from a single allocation and link them. Without a
+ * configured buffer size, the size of the first requested buffer is used. The
+ * SecureChannels request buffers of their negotiated send buffer size. */
+static UA_Boolean
+initSendPool(UA_NetworkBufferPool *pool, size_t firstBufSize) {
+    if(pool->bufSize == 0)
+        pool->bufSize = firstBufSize;
+
+    /* Align the buffers for the free-list pointer */
+    if(pool->bufSize < sizeof(UA_Byte*))
+        pool->bufSize = sizeof(UA_Byte*);
+    pool->bufSize = (pool->bufSize + sizeof(UA_Byte*) - 1) &
+        ~(sizeof(UA_Byte*) - 1);
+    pool->stats.bufSize = pool->bufSize;
+
+    if(pool->poolSize == 0 || pool->bufSize > SIZE_MAX / pool->poolSize)
+        return false;
+    pool->region = (UA_Byte*)UA_malloc(pool->bufSize * pool->poolSize);
+    if(!pool->region)
+        return false;
+    for(size_t i = 0; i < pool->poolSize; i++) {
+        UA_Byte *b = &pool->region[i * pool->bufSize];
+        UA_Byte *next = (i + 1 < pool->poolSize) ? b + pool->bufSize : NULL;
+        memcpy(b, &next, sizeof(UA_Byte*));
+    }
+    pool->freeList = pool->region;
+    return true;
+}
+
 UA_StatusCode
 UA_EventLoopPOSIX_allocNetworkBuffer(UA_ConnectionManager *cm,
                                      uintptr_t connectionId,
                                      UA_ByteString *buf,
                                      size_t bufSize) {
+    UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
+    UA_NetworkBufferPool *pool = &pcm->sendPool;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    if(bufSize == 0 || !el)
+        goto heap;
+
+    UA_LOCK(&el->elMutex);
+    if((!pool->region && !initSendPool(pool, bufSize)) ||
+       !pool->freeList || bufSize > pool->bufSize) {
+        UA_UNLOCK(&el->elMutex);
+        goto heap;
+    }
+
+    /* Take the first unused buffer */
+    buf->data = pool->freeList;
+    buf->length = bufSize;
+    memcpy(&pool->freeList, buf->data, sizeof(UA_Byte*));
+    pool->stats.poolAllocs++;
+    pool->stats.inUse++;
+    if(pool->stats.inUse > pool->stats.maxInUse)
+        pool->stats.maxInUse = pool->stats.inUse;
+    UA_UNLOCK(&el->elMutex);
+    return UA_STATUSCODE_GOOD;
+
+ heap:
+    UA_atomic_addSize((volatile size_t*)&pool->stats.heapAllocs, 1);
     return UA_ByteString_allocBuffer(buf, bufSize);
 }
 
@@ -494,7 +614,41 @@ void
 UA_EventLoopPOSIX_freeNetworkBuffer(UA_ConnectionManager *cm,
                                     uintptr_t connectionId,
                                     UA_ByteString *buf) {
-    UA_ByteString_clear(buf);
+    UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
+    UA_NetworkBufferPool *pool = &pcm->sendPool;
+    UA_Byte *region = pool->region;
+    uintptr_t start = (uintptr_t)region;
+    uintptr_t pos = (uintptr_t)buf->data;
+    if(!region || pos < start || pos - start >= pool->bufSize * pool->poolSize) {
+        UA_ByteString_clear(buf);
+        return;
+    }
+
+    /* Return the pooled buffer. The application might have moved the start of
+     * the buffer forward. */
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    UA_LOCK(&el->elMutex);
+    size_t index = (size_t)(pos - start) / pool->bufSize;
+    UA_Byte *b = &region[index * pool->bufSize];
+    memcpy(b, &pool->freeList, sizeof(UA_Byte*));
+    pool->freeList = b;
+    pool->stats.inUse--;
+    UA_UNLOCK(&el->elMutex);
+    UA_ByteString_init(buf);
+}
+
+void
+UA_ConnectionManager_getSendPoolStatistics_POSIX(UA_ConnectionManager *cm,
+                                                 UA_NetworkBufferPoolStatistics *stats) {
+    UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    if(el) {
+        UA_LOCK(&el->elMutex);
+    }
+    *stats = pcm->sendPool.stats;
+    if(el) {
+        UA_UNLOCK(&el->elMutex);
+    }
 }
 
 UA_StatusCode
@@ -31,6 +31,18 @@
 # include <sys/epoll.h>
 #endif
 
+/* io_uring is used via the raw system calls (no liburing required). The
+ * timeout argument for waiting requires the kernel headers of Linux 5.11 or
+ * newer. */
+#if defined(UA_HAVE_EPOLL) && defined(__has_include)
+# if __has_include(<linux/io_uring.h>)
+#  include <linux/io_uring.h>
+#  ifdef IORING_ENTER_EXT_ARG
+#   define UA_HAVE_IO_URING
+#  endif
+# endif
+#endif
+
 #define UA_MAXBACKLOG 100
 #define UA_MAXHOSTNAME_LENGTH 256
 #define UA_MAXPORTSTR_LENGTH 6
@@ -64,6 +76,15 @@ typedef struct UA_RegisteredFD UA_RegisteredFD;
 
 typedef void (*UA_FDCallback)(UA_EventSource *es, UA_RegisteredFD *rfd, short event);
 
+/* Callbacks for the backends that perform the I/O on behalf of the EventSource
+ * (see UA_EventLoopPOSIX_asyncIO). The received data is only valid during the
+ * callback. Empty data signals that the peer has shut down the connection.
+ * The result of a send is the number of bytes sent or a negative errno. */
+typedef void (*UA_FDRecvCallback)(UA_EventSource *es, UA_RegisteredFD *rfd,
+                                  const UA_ByteString *data);
+typedef void (*UA_FDSendCallback)(UA_EventSource *es, UA_RegisteredFD *rfd,
+                                  int result);
+
 struct UA_RegisteredFD {
     UA_DelayedCallback dc; /* Used for async closing. Must be the first member
                             * because the rfd is freed by the delayed callback
@@ -75,12 +96,28 @@ struct UA_RegisteredFD {
 
     UA_EventSource *es; /* Backpointer to the EventSource */
     UA_FDCallback eventSourceCB;
+
+    /* Optional. Set only if UA_EventLoopPOSIX_asyncIO returns true. */
+    UA_FDRecvCallback recvCB;
+    UA_FDSendCallback sendCB;
 };
 
 enum ZIP_CMP cmpFD(const UA_FD *a, const UA_FD *b);
 typedef ZIP_HEAD(UA_FDTree, UA_RegisteredFD) UA_FDTree;
 ZIP_FUNCTIONS(UA_FDTree, UA_RegisteredFD, zipPointers, UA_FD, fd, cmpFD)
 
+/* Pool of fixed-size network buffers for sending. All pooled buffers are
+ * carved from a single allocation. So the pool recognizes its own buffers from
+ * their address and buffers from the heap can be mixed in. The first bytes of
+ * an unused buffer link to the next unused buffer. */
+typedef struct {
+    size_t bufSize;   /* Size of each pooled buffer */
+    size_t poolSize;  /* Number of pooled buffers */
+    UA_Byte *region;  /* Allocated on first use */
+    UA_Byte *freeList;
+    UA_NetworkBufferPoolStatistics stats;
+} UA_NetworkBufferPool;
+
 /* All ConnectionManager in the POSIX EventLoop can be cast to
  * UA_ConnectionManagerPOSIX. They carry a sorted tree of their open
  * sockets/file-descriptors. */
@@ -91,11 +128,20 @@ typedef struct {
      * the recv-bufsize parameter.*/
     UA_ByteString rxBuffer;
 
+    /* Reused send buffers. Configured via the send-pool-size and
+     * send-pool-bufsize parameters. */
+    UA_NetworkBufferPool sendPool;
+
     /* Sorted tree of the FDs */
     size_t fdsSize;
     UA_FDTree fds;
 } UA_POSIXConnectionManager;
 
+#if defined(UA_HAVE_IO_URING)
+struct UA_URing;
+typedef struct UA_URing UA_URing;
+#endif
+
 typedef struct {
     UA_EventLoop eventLoop;
 
@@ -110,7 +156,10 @@ typedef struct {
     UA_Boolean executing;
 
 #if defined(UA_HAVE_EPOLL)
-    UA_FD epollfd;
+    UA_FD epollfd; /* Not created if io_uring is used */
+#if defined(UA_HAVE_IO_URING)
+    UA_URing *uring; /* If set, used instead of epoll */
+#endif
 #else
     UA_RegisteredFD **fds;
     size_t fdsSize;
@@ -140,11 +189,59 @@ UA_EventLoopPOSIX_deregisterFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd);
 UA_StatusCode
 UA_EventLoopPOSIX_pollFDs(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout);
 
+/* Returns true if the backend receives and sends for the rfds that have the
+ * recvCB and sendCB set. Otherwise the EventSource does the I/O itself after
+ * the eventSourceCB signaled the readiness of the fd. */
+UA_Boolean
+UA_EventLoopPOSIX_asyncIO(UA_EventLoopPOSIX *el);
+
+/* Send asynchronously. Only one send per rfd can be in flight. The data must
+ * remain valid and the rfd registered until the sendCB is called. A partial
+ * send is possible. */
+UA_StatusCode
+UA_EventLoopPOSIX_sendAsync(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd,
+                            const UA_Byte *data, size_t length);
+
+#if defined(UA_HAVE_IO_URING)
+/* The io_uring backend is selected at runtime with the "backend" parameter of
+ * the EventLoop. The epoll functions forward to it if it is enabled. */
+
+UA_StatusCode
+UA_EventLoopPOSIX_startURing(UA_EventLoopPOSIX *el);
+
+void
+UA_EventLoopPOSIX_stopURing(UA_EventLoopPOSIX *el);
+
+UA_StatusCode
+UA_EventLoopPOSIX_registerFD_uring(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd);
+
+UA_StatusCode
+UA_EventLoopPOSIX_modifyFD_uring(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd);
+
+void
+UA_EventLoopPOSIX_deregisterFD_uring(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd);
+
+UA_StatusCode
+UA_EventLoopPOSIX_sendAsync_uring(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd,
+                                  const UA_Byte *data, size_t length);
+
+UA_StatusCode
+UA_EventLoopPOSIX_pollFDs_uring(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout);
+#endif
+
 /* Helper functions between EventSources */
 
 UA_StatusCode
 UA_EventLoopPOSIX_allocateRXBuffer(UA_POSIXConnectionManager *pcm);
 
+/* Read the send-pool parameters. Takes effect only until the first buffer
+ * was taken from the pool. */
+void
+UA_EventLoopPOSIX_configureSendPool(UA_POSIXConnectionManager *pcm);
+
+void
+UA_EventLoopPOSIX_clearSendPool(UA_POSIXConnectionManager *pcm);
+
 UA_StatusCode
 UA_EventLoopPOSIX_allocNetworkBuffer(UA_ConnectionManager *cm,
                                      uintptr_t connectionId,
@@ -11,6 +11,11 @@
 
 UA_StatusCode
 UA_EventLoopPOSIX_registerFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+#if defined(UA_HAVE_IO_URING)
+    if(el->uring)
+        return UA_EventLoopPOSIX_registerFD_uring(el, rfd);
+#endif
+
     struct epoll_event event;
     memset(&event, 0, sizeof(struct epoll_event));
     event.data.ptr = rfd;
@@ -33,6 +38,11 @@ UA_EventLoopPOSIX_registerFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
 
 UA_StatusCode
 UA_EventLoopPOSIX_modifyFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+#if defined(UA_HAVE_IO_URING)
+    if(el->uring)
+        return UA_EventLoopPOSIX_modifyFD_uring(el, rfd);
+#endif
+
     struct epoll_event event;
     memset(&event, 0, sizeof(struct epoll_event));
     event.data.ptr = rfd;
@@ -55,6 +65,13 @@ UA_EventLoopPOSIX_modifyFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
 
 void
 UA_EventLoopPOSIX_deregisterFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+#if defined(UA_HAVE_IO_URING)
+    if(el->uring) {
+        UA_EventLoopPOSIX_deregisterFD_uring(el, rfd);
+        return;
+    }
+#endif
+
     int res = epoll_ctl(el->epollfd, EPOLL_CTL_DEL, rfd->fd, NULL);
     if(res != 0) {
         UA_LOG_SOCKET_ERRNO_WRAP(
@@ -66,6 +83,11 @@ UA_EventLoopPOSIX_deregisterFD(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
 
 UA_StatusCode
 UA_EventLoopPOSIX_pollFDs(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout) {
+#if defined(UA_HAVE_IO_URING)
+    if(el->uring)
+        return UA_EventLoopPOSIX_pollFDs_uring(el, listenTimeout);
+#endif
+
     UA_assert(listenTimeout >= 0);
 
     /* Poll the registered sockets */
@@ -125,4 +147,23 @@ UA_EventLoopPOSIX_pollFDs(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout) {
     return UA_STATUSCODE_GOOD;
 }
 
+UA_Boolean
+UA_EventLoopPOSIX_asyncIO(UA_EventLoopPOSIX *el) {
+#if defined(UA_HAVE_IO_URING)
+    return (el->uring != NULL);
+#else
+    return false;
+#endif
+}
+
+UA_StatusCode
+UA_EventLoopPOSIX_sendAsync(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd,
+                            const UA_Byte *data, size_t length) {
+#if defined(UA_HAVE_IO_URING)
+    if(el->uring)
+        return UA_EventLoopPOSIX_sendAsync_uring(el, rfd, data, length);
+#endif
+    return UA_STATUSCODE_BADNOTSUPPORTED;
+}
+
 #endif /* defined(UA_HAVE_EPOLL) */
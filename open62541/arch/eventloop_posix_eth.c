@@ -754,9 +754,12 @@ ETH_shutdownConnection(UA_ConnectionManager *cm, uintptr_t connectionId) {
     return UA_STATUSCODE_GOOD;
 }
 
+/* Send the buffer without releasing it. The Ethernet header is written into
+ * the hidden space in front of the buffer. */
 static UA_StatusCode
-ETH_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
-                       const UA_KeyValueMap *params, UA_ByteString *buf) {
+ETH_sendRetainedWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
+                               const UA_KeyValueMap *params,
+                               const UA_ByteString *buf) {
     UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
     UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
 
@@ -771,12 +774,12 @@ ETH_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
     }
 
     /* Uncover and set the Ethernet header */
-    buf->data -= conn->headerSize;
-    buf->length += conn->headerSize;
-    memcpy(buf->data, conn->header, conn->headerSize);
+    UA_Byte *frame = buf->data - conn->headerSize;
+    size_t frameLength = buf->length + conn->headerSize;
+    memcpy(frame, conn->header, conn->headerSize);
     if(conn->lengthOffset) {
-        UA_UInt16 *ethLength =  (UA_UInt16*)&buf->data[conn->lengthOffset];
-        *ethLength = htons((UA_UInt16)(buf->length - conn->headerSize));
+        UA_UInt16 *ethLength =  (UA_UInt16*)&frame[conn->lengthOffset];
+        *ethLength = htons((UA_UInt16)buf->length);
     }
 
     /* Prevent OS signals when sending to a closed socket */
@@ -793,8 +796,8 @@ ETH_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
         do {
             UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
                          "ETH %u\t| Attempting to send", (unsigned)connectionId);
-            size_t bytes_to_send = buf->length - nWritten;
-            n = UA_sendto(conn->rfd.fd, (const char*)buf->data + nWritten, bytes_to_send,
+            size_t bytes_to_send = frameLength - nWritten;
+            n = UA_sendto(conn->rfd.fd, (const char*)frame + nWritten, bytes_to_send,
                           flags, (struct sockaddr*)&conn->sll, sizeof(conn->sll));
             if(n < 0) {
                 /* An error we cannot recover from? */
@@ -807,7 +810,6 @@ ETH_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
                                     (unsigned)connectionId, errno_str));
                     ETH_shutdown(pcm, conn);
                     UA_UNLOCK(&el->elMutex);
-                    UA_ByteString_clear(buf);
                     return UA_STATUSCODE_BADCONNECTIONCLOSED;
                 }
 
@@ -823,21 +825,26 @@ ETH_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
                                         (unsigned)connectionId, errno_str));
                         ETH_shutdown(pcm, conn);
                         UA_UNLOCK(&el->elMutex);
-                        UA_ByteString_clear(buf);
                         return UA_STATUSCODE_BADCONNECTIONCLOSED;
                     }
                 } while(poll_ret <= 0);
             }
         } while(n < 0);
         nWritten += (size_t)n;
-    } while(nWritten < buf->length);
+    } while(nWritten < frameLength);
 
-    /* Free the buffer */
     UA_UNLOCK(&el->elMutex);
-    UA_ByteString_clear(buf);
     return UA_STATUSCODE_GOOD;
 }
 
+static UA_StatusCode
+ETH_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
+                       const UA_KeyValueMap *params, UA_ByteString *buf) {
+    UA_StatusCode res = ETH_sendRetainedWithConnection(cm, connectionId, params, buf);
+    ETH_freeNetworkBuffer(cm, connectionId, buf);
+    return res;
+}
+
 static UA_StatusCode
 ETH_eventSourceStart(UA_ConnectionManager *cm) {
     UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
@@ -922,6 +929,7 @@ UA_ConnectionManager_new_POSIX_Ethernet(const UA_String eventSourceName) {
     cm->cm.allocNetworkBuffer = ETH_allocNetworkBuffer;
     cm->cm.freeNetworkBuffer = ETH_freeNetworkBuffer;
     cm->cm.sendWithConnection = ETH_sendWithConnection;
+    cm->cm.sendRetainedWithConnection = ETH_sendRetainedWithConnection;
     cm->cm.closeConnection = ETH_shutdownConnection;
     return &cm->cm;
 }
@@ -170,4 +170,15 @@ UA_EventLoopPOSIX_pollFDs(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout) {
     return UA_STATUSCODE_GOOD;
 }
 
+UA_Boolean
+UA_EventLoopPOSIX_asyncIO(UA_EventLoopPOSIX *el) {
+    return false;
+}
+
+UA_StatusCode
+UA_EventLoopPOSIX_sendAsync(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd,
+                            const UA_Byte *data, size_t length) {
+    return UA_STATUSCODE_BADNOTSUPPORTED;
+}
+
 #endif /* !defined(UA_HAVE_EPOLL) */
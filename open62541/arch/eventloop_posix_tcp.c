@@ -11,16 +11,26 @@
 #include "eventloop_common.h"
 
 /* Configuration parameters */
-#define TCP_PARAMETERSSIZE 6
+#define TCP_PARAMETERSSIZE 9
 #define TCP_PARAMINDEX_RECVBUF 0
-#define TCP_PARAMINDEX_ADDR 1
-#define TCP_PARAMINDEX_PORT 2
-#define TCP_PARAMINDEX_LISTEN 3
-#define TCP_PARAMINDEX_VALIDATE 4
-#define TCP_PARAMINDEX_REUSE 5
+#define TCP_PARAMINDEX_SENDQUEUE 1
+#define TCP_PARAMINDEX_SENDPOOL 2
+#define TCP_PARAMINDEX_SENDPOOLBUF 3
+#define TCP_PARAMINDEX_ADDR 4
+#define TCP_PARAMINDEX_PORT 5
+#define TCP_PARAMINDEX_LISTEN 6
+#define TCP_PARAMINDEX_VALIDATE 7
+#define TCP_PARAMINDEX_REUSE 8
+
+/* The first parameters configure the ConnectionManager. The others are
+ * parameters for opening a connection. */
+#define TCP_MANAGERPARAMETERSSIZE 4
 
 static UA_KeyValueRestriction TCPConfigParameters[TCP_PARAMETERSSIZE] = {
     {{0, UA_STRING_STATIC("recv-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("send-queue-limit")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("send-pool-size")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("send-pool-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
     {{0, UA_STRING_STATIC("address")}, &UA_TYPES[UA_TYPES_STRING], false, true, true},
     {{0, UA_STRING_STATIC("port")}, &UA_TYPES[UA_TYPES_UINT16], true, true, false},
     {{0, UA_STRING_STATIC("listen")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
@@ -28,12 +38,29 @@ static UA_KeyValueRestriction TCPConfigParameters[TCP_PARAMETERSSIZE] = {
     {{0, UA_STRING_STATIC("reuse")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false}
 };
 
+/* Outgoing data that could not be written to the socket right away. The
+ * buffer is taken over from the application. */
+typedef struct TCP_SendBuffer {
+    TAILQ_ENTRY(TCP_SendBuffer) pointers;
+    UA_ByteString buf;
+    size_t sent; /* Bytes of buf already written to the socket */
+} TCP_SendBuffer;
+
 typedef struct {
     UA_RegisteredFD rfd;
 
     UA_ConnectionManager_connectionCallback applicationCB;
     void *application;
     void *context;
+
+    /* The send queue is flushed when the socket signals writability */
+    TAILQ_HEAD(, TCP_SendBuffer) sendQueue;
+    size_t sendQueueSize; /* Total number of pending bytes */
+
+    /* With asynchronous I/O the EventLoop sends from the head of the send
+     * queue. The socket is closed only after that send has completed. */
+    UA_Boolean sendInFlight;
+    UA_Boolean closeDeferred;
 } TCP_FD;
 
 static void
@@ -62,6 +89,81 @@ TCP_checkStopped(UA_POSIXConnectionManager *pcm) {
     }
 }
 
+static void
+TCP_clearSendQueue(TCP_FD *conn) {
+    TCP_SendBuffer *sb, *sb_tmp;
+    TAILQ_FOREACH_SAFE(sb, &conn->sendQueue, pointers, sb_tmp) {
+        TAILQ_REMOVE(&conn->sendQueue, sb, pointers);
+        UA_EventLoopPOSIX_freeNetworkBuffer((UA_ConnectionManager*)conn->rfd.es,
+                                            (uintptr_t)conn->rfd.fd, &sb->buf);
+        UA_free(sb);
+    }
+    conn->sendQueueSize = 0;
+}
+
+/* Write as much of the buffer as the socket accepts without blocking. Returns
+ * false if the socket has failed. */
+static UA_Boolean
+TCP_sendNonBlocking(TCP_FD *conn, const UA_ByteString *buf, size_t *sent) {
+    while(*sent < buf->length) {
+        ssize_t n = UA_send(conn->rfd.fd, (const char*)buf->data + *sent,
+                            buf->length - *sent, MSG_NOSIGNAL);
+        if(n < 0) {
+            if(UA_ERRNO == UA_INTERRUPTED)
+                continue;
+            /* The socket is (temporarily) full */
+            return (UA_ERRNO == UA_WOULDBLOCK || UA_ERRNO == UA_AGAIN);
+        }
+        *sent += (size_t)n;
+    }
+    return true;
+}
+
+/* Send from the head of the queue until the socket is full. Once the queue is
+ * empty we are no longer interested in write-events. */
+static UA_StatusCode
+TCP_flushSendQueue(UA_EventLoopPOSIX *el, TCP_FD *conn) {
+    UA_LOCK_ASSERT(&el->elMutex, 1);
+
+    TCP_SendBuffer *sb;
+    while((sb = TAILQ_FIRST(&conn->sendQueue))) {
+        size_t before = sb->sent;
+        UA_Boolean ok = TCP_sendNonBlocking(conn, &sb->buf, &sb->sent);
+        conn->sendQueueSize -= sb->sent - before;
+        if(!ok)
+            return UA_STATUSCODE_BADCONNECTIONCLOSED;
+        if(sb->sent < sb->buf.length)
+            return UA_STATUSCODE_GOOD; /* Wait for the next write-event */
+        TAILQ_REMOVE(&conn->sendQueue, sb, pointers);
+        UA_EventLoopPOSIX_freeNetworkBuffer((UA_ConnectionManager*)conn->rfd.es,
+                                            (uintptr_t)conn->rfd.fd, &sb->buf);
+        UA_free(sb);
+    }
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                 "TCP %u\t| Send queue flushed", (unsigned)conn->rfd.fd);
+    if(conn->rfd.listenEvents & UA_FDEVENT_OUT) {
+        conn->rfd.listenEvents = UA_FDEVENT_IN;
+        UA_EventLoopPOSIX_modifyFD(el, &conn->rfd);
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Submit the head of the send queue to the EventLoop (asynchronous I/O) */
+static UA_StatusCode
+TCP_sendAsync(UA_EventLoopPOSIX *el, TCP_FD *conn) {
+    UA_LOCK_ASSERT(&el->elMutex, 1);
+    TCP_SendBuffer *sb = TAILQ_FIRST(&conn->sendQueue);
+    if(!sb || conn->sendInFlight)
+        return UA_STATUSCODE_GOOD;
+    UA_StatusCode res =
+        UA_EventLoopPOSIX_sendAsync(el, &conn->rfd, sb->buf.data + sb->sent,
+                                    sb->buf.length - sb->sent);
+    if(res == UA_STATUSCODE_GOOD)
+        conn->sendInFlight = true;
+    return res;
+}
+
 static void
 TCP_delayedClose(void *application, void *context) {
     UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)application;
@@ -71,6 +173,14 @@ TCP_delayedClose(void *application, void *context) {
 
     UA_LOCK(&el->elMutex);
 
+    /* The EventLoop still uses the head of the send queue. Continue when the
+     * send has completed (see TCP_sendCallback). */
+    if(conn->sendInFlight) {
+        conn->closeDeferred = true;
+        UA_UNLOCK(&el->elMutex);
+        return;
+    }
+
     UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
                  "TCP %u\t| Delayed closing of the connection",
                  (unsigned)conn->rfd.fd);
@@ -106,6 +216,13 @@ TCP_delayedClose(void *application, void *context) {
                           (unsigned)conn->rfd.fd, errno_str));
     }
 
+    /* Drop the data that could not be sent */
+    if(conn->sendQueueSize > 0)
+        UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "TCP %u\t| Dropping %lu unsent bytes",
+                     (unsigned)conn->rfd.fd, (unsigned long)conn->sendQueueSize);
+    TCP_clearSendQueue(conn);
+
     UA_free(conn);
 
     /* Check if this was the last connection for a closing ConnectionManager */
@@ -148,6 +265,24 @@ TCP_connectionSocketCallback(UA_ConnectionManager *cm, TCP_FD *conn,
         return;
     }
 
+    /* Flush the send queue of an open connection. Also for read-events, as
+     * these take precedence over write-events when the EventLoop dispatches. */
+    UA_Boolean isOpen = ((conn->rfd.listenEvents & UA_FDEVENT_IN) != 0);
+    if(isOpen && !TAILQ_EMPTY(&conn->sendQueue) && !conn->rfd.sendCB) {
+        if(TCP_flushSendQueue(el, conn) != UA_STATUSCODE_GOOD) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "TCP %u\t| Send failed with error %s",
+                            (unsigned)conn->rfd.fd, errno_str));
+            TCP_shutdown(cm, conn);
+            return;
+        }
+    }
+
+    /* Write-event for an open connection. The send queue was handled above. */
+    if(event == UA_FDEVENT_OUT && isOpen)
+        return;
+
     /* Write-Event, a new connection has opened. But some errors come as an
      * out-event. For example if the remote side could not be reached to
      * initiate the connection. So we check manually for error conditions on
@@ -166,9 +301,16 @@ TCP_connectionSocketCallback(UA_ConnectionManager *cm, TCP_FD *conn,
                      "TCP %u\t| Opening a new connection",
                      (unsigned)conn->rfd.fd);
 
-        /* Now we are interested in read-events. */
+        /* Now we are interested in read-events. And in write-events if data
+         * was queued while opening. */
         conn->rfd.listenEvents = UA_FDEVENT_IN;
+        if(!TAILQ_EMPTY(&conn->sendQueue) && !conn->rfd.sendCB)
+            conn->rfd.listenEvents |= UA_FDEVENT_OUT;
         UA_EventLoopPOSIX_modifyFD(el, &conn->rfd);
+        if(TCP_sendAsync(el, conn) != UA_STATUSCODE_GOOD) {
+            TCP_shutdown(cm, conn);
+            return;
+        }
 
         /* A new socket has opened. Signal it to the application. */
         conn->applicationCB(cm, (uintptr_t)conn->rfd.fd,
@@ -197,10 +339,13 @@ TCP_connectionSocketCallback(UA_ConnectionManager *cm, TCP_FD *conn,
 
     /* Receive has failed */
     if(ret <= 0) {
-        if(UA_ERRNO == UA_INTERRUPTED ||
-           UA_ERRNO == UA_WOULDBLOCK ||
-           UA_ERRNO == UA_AGAIN)
-            return; /* Temporary error on an non-blocking socket */
+        /* Temporary error on an non-blocking socket. Zero bytes signal an
+         * orderly shutdown and leave errno untouched. */
+        if(ret < 0 &&
+           (UA_ERRNO == UA_INTERRUPTED ||
+            UA_ERRNO == UA_WOULDBLOCK ||
+            UA_ERRNO == UA_AGAIN))
+            return;
 
         /* Orderly shutdown of the socket */
         UA_LOG_SOCKET_ERRNO_WRAP(
@@ -223,6 +368,85 @@ TCP_connectionSocketCallback(UA_ConnectionManager *cm, TCP_FD *conn,
                         &UA_KEYVALUEMAP_NULL, response);
 }
 
+/* Asynchronous I/O: The EventLoop has received data for the connection */
+static void
+TCP_recvCallback(UA_ConnectionManager *cm, TCP_FD *conn,
+                 const UA_ByteString *data) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    UA_LOCK_ASSERT(&el->elMutex, 1);
+
+    /* Orderly shutdown of the socket */
+    if(data->length == 0) {
+        UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "TCP %u\t| recv signaled the socket was shutdown",
+                     (unsigned)conn->rfd.fd);
+        TCP_shutdown(cm, conn);
+        return;
+    }
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                 "TCP %u\t| Received message of size %u",
+                 (unsigned)conn->rfd.fd, (unsigned)data->length);
+
+    /* Callback to the application layer */
+    conn->applicationCB(cm, (uintptr_t)conn->rfd.fd,
+                        conn->application, &conn->context,
+                        UA_CONNECTIONSTATE_ESTABLISHED,
+                        &UA_KEYVALUEMAP_NULL, *data);
+}
+
+/* Asynchronous I/O: The send from the head of the send queue has completed */
+static void
+TCP_sendCallback(UA_ConnectionManager *cm, TCP_FD *conn, int result) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    UA_LOCK_ASSERT(&el->elMutex, 1);
+    conn->sendInFlight = false;
+
+    /* Closing. Resume the delayed close that waited for the send. */
+    if(conn->rfd.dc.callback) {
+        if(conn->closeDeferred) {
+            conn->closeDeferred = false;
+            UA_DelayedCallback *dc = &conn->rfd.dc;
+            dc->next = el->delayedCallbacks;
+            el->delayedCallbacks = dc;
+        }
+        return;
+    }
+
+    if(result < 0) {
+        UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "TCP %u\t| Send failed with error %i",
+                     (unsigned)conn->rfd.fd, -result);
+        TCP_shutdown(cm, conn);
+        return;
+    }
+
+    /* Advance in the send queue */
+    TCP_SendBuffer *sb = TAILQ_FIRST(&conn->sendQueue);
+    UA_assert(sb);
+    sb->sent += (size_t)result;
+    conn->sendQueueSize -= (size_t)result;
+    if(sb->sent >= sb->buf.length) {
+        TAILQ_REMOVE(&conn->sendQueue, sb, pointers);
+        UA_EventLoopPOSIX_freeNetworkBuffer(cm, (uintptr_t)conn->rfd.fd, &sb->buf);
+        UA_free(sb);
+    }
+
+    /* Send the next buffer */
+    if(TCP_sendAsync(el, conn) != UA_STATUSCODE_GOOD)
+        TCP_shutdown(cm, conn);
+}
+
+/* Let the EventLoop receive and send for the connection socket if the backend
+ * supports it */
+static void
+TCP_setAsyncIO(UA_EventLoopPOSIX *el, TCP_FD *conn) {
+    if(!UA_EventLoopPOSIX_asyncIO(el))
+        return;
+    conn->rfd.recvCB = (UA_FDRecvCallback)TCP_recvCallback;
+    conn->rfd.sendCB = (UA_FDSendCallback)TCP_sendCallback;
+}
+
 /* Gets called when a new connection opens or if the listenSocket is closed */
 static void
 TCP_listenSocketCallback(UA_ConnectionManager *cm, TCP_FD *conn, short event) {
@@ -295,10 +519,12 @@ TCP_listenSocketCallback(UA_ConnectionManager *cm, TCP_FD *conn, short event) {
         return;
     }
 
+    TAILQ_INIT(&newConn->sendQueue);
     newConn->rfd.fd = newsockfd;
     newConn->rfd.listenEvents = UA_FDEVENT_IN;
     newConn->rfd.es = &cm->eventSource;
     newConn->rfd.eventSourceCB = (UA_FDCallback)TCP_connectionSocketCallback;
+    TCP_setAsyncIO(el, newConn);
     newConn->applicationCB = conn->applicationCB;
     newConn->application = conn->application;
     newConn->context = conn->context;
@@ -589,6 +815,13 @@ TCP_shutdown(UA_ConnectionManager *cm, TCP_FD *conn) {
         return;
     }
 
+    /* Last attempt to send the queued data without blocking. For example an
+     * error message that was queued right before the close. This has to
+     * happen before the shutdown, which disables further sends. */
+    if((conn->rfd.listenEvents & UA_FDEVENT_IN) && !conn->rfd.sendCB &&
+       !TAILQ_EMPTY(&conn->sendQueue))
+        TCP_flushSendQueue(el, conn);
+
     /* Shutdown the socket to cancel the current select/epoll */
     shutdown(conn->rfd.fd, UA_SHUT_RDWR);
 
@@ -633,57 +866,96 @@ TCP_shutdownConnection(UA_ConnectionManager *cm, uintptr_t connectionId) {
 static UA_StatusCode
 TCP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
                        const UA_KeyValueMap *params, UA_ByteString *buf) {
-    /* We may not have a lock. But we need not take it. As the connectionId is
-     * the fd, no need to do a lookup and access internal data strucures. */
-
-    /* Prevent OS signals when sending to a closed socket */
-    int flags = MSG_NOSIGNAL;
-
-    struct pollfd tmp_poll_fd;
-    tmp_poll_fd.fd = (UA_FD)connectionId;
-    tmp_poll_fd.events = UA_POLLOUT;
-
-    /* Send the full buffer. This may require several calls to send */
-    size_t nWritten = 0;
-    do {
-        ssize_t n = 0;
-        do {
-            UA_LOG_DEBUG(cm->eventSource.eventLoop->logger, UA_LOGCATEGORY_NETWORK,
-                         "TCP %u\t| Attempting to send", (unsigned)connectionId);
-            size_t bytes_to_send = buf->length - nWritten;
-            n = UA_send((UA_FD)connectionId,
-                        (const char*)buf->data + nWritten,
-                        bytes_to_send, flags);
-            if(n < 0) {
-                /* An error we cannot recover from? */
-                if(UA_ERRNO != UA_INTERRUPTED && UA_ERRNO != UA_WOULDBLOCK &&
-                   UA_ERRNO != UA_AGAIN)
-                    goto shutdown;
-
-                /* Poll for the socket resources to become available and retry
-                 * (blocking) */
-                int poll_ret;
-                do {
-                    poll_ret = UA_poll(&tmp_poll_fd, 1, 100);
-                    if(poll_ret < 0 && UA_ERRNO != UA_INTERRUPTED)
-                        goto shutdown;
-                } while(poll_ret <= 0);
-            }
-        } while(n < 0);
-        nWritten += (size_t)n;
-    } while(nWritten < buf->length);
-
-    /* Free the buffer */
-    UA_ByteString_clear(buf);
+    UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    UA_LOCK(&el->elMutex);
+
+    /* Look up the connection. Its send queue is accessed under the lock. */
+    UA_FD fd = (UA_FD)connectionId;
+    TCP_FD *conn = (TCP_FD*)ZIP_FIND(UA_FDTree, &pcm->fds, &fd);
+    if(!conn || conn->rfd.dc.callback) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                       "TCP %u\t| Cannot send - the connection is closed",
+                       (unsigned)connectionId);
+        UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+        UA_UNLOCK(&el->elMutex);
+        return UA_STATUSCODE_BADCONNECTIONCLOSED;
+    }
+
+    /* Send right away if the connection is open and nothing is queued before.
+     * Never block on a full socket. The remainder is queued and sent when the
+     * socket becomes writable again. So a slow receiver does not stall the
+     * EventLoop. With asynchronous I/O everything goes through the queue. */
+    size_t sent = 0;
+    if(TAILQ_EMPTY(&conn->sendQueue) && (conn->rfd.listenEvents & UA_FDEVENT_IN) &&
+       !conn->rfd.sendCB) {
+        UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "TCP %u\t| Attempting to send", (unsigned)connectionId);
+        if(!TCP_sendNonBlocking(conn, buf, &sent)) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "TCP %u\t| Send failed with error %s",
+                            (unsigned)connectionId, errno_str));
+            goto shutdown;
+        }
+        if(sent == buf->length) {
+            UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+            UA_UNLOCK(&el->elMutex);
+            return UA_STATUSCODE_GOOD;
+        }
+    }
+
+    /* Check the send queue limit. A receiver that cannot keep up with the
+     * outgoing data gets disconnected. */
+    const UA_UInt32 *limit = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(&cm->eventSource.params,
+                                 TCPConfigParameters[TCP_PARAMINDEX_SENDQUEUE].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    size_t pending = buf->length - sent;
+    if(limit && *limit > 0 && conn->sendQueueSize + pending > *limit) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                       "TCP %u\t| The send queue exceeds the limit of %u bytes",
+                       (unsigned)connectionId, (unsigned)*limit);
+        goto shutdown;
+    }
+
+    /* Queue the remaining data. Take over the buffer without copying. */
+    TCP_SendBuffer *sb = (TCP_SendBuffer*)UA_malloc(sizeof(TCP_SendBuffer));
+    if(!sb) {
+        UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "TCP %u\t| Could not allocate memory for the send queue",
+                     (unsigned)connectionId);
+        goto shutdown;
+    }
+    sb->buf = *buf;
+    sb->sent = sent;
+    UA_ByteString_init(buf);
+    TAILQ_INSERT_TAIL(&conn->sendQueue, sb, pointers);
+    conn->sendQueueSize += pending;
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                 "TCP %u\t| Queued %u bytes for sending (%u bytes pending)",
+                 (unsigned)connectionId, (unsigned)pending,
+                 (unsigned)conn->sendQueueSize);
+
+    /* With asynchronous I/O, the EventLoop sends once the connection is
+     * open. Otherwise trigger when the socket becomes writable. */
+    if(conn->rfd.sendCB) {
+        if((conn->rfd.listenEvents & UA_FDEVENT_IN) &&
+           TCP_sendAsync(el, conn) != UA_STATUSCODE_GOOD)
+            goto shutdown;
+    } else if(!(conn->rfd.listenEvents & UA_FDEVENT_OUT)) {
+        conn->rfd.listenEvents |= UA_FDEVENT_OUT;
+        UA_EventLoopPOSIX_modifyFD(el, &conn->rfd);
+    }
+
+    UA_UNLOCK(&el->elMutex);
     return UA_STATUSCODE_GOOD;
 
  shutdown:
-    UA_LOG_SOCKET_ERRNO_WRAP(
-       UA_LOG_ERROR(cm->eventSource.eventLoop->logger, UA_LOGCATEGORY_NETWORK,
-                    "TCP %u\t| Send failed with error %s",
-                    (unsigned)connectionId, errno_str));
-    TCP_shutdownConnection(cm, connectionId);
-    UA_ByteString_clear(buf);
+    TCP_shutdown(cm, conn);
+    UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+    UA_UNLOCK(&el->elMutex);
     return UA_STATUSCODE_BADCONNECTIONCLOSED;
 }
 
@@ -867,11 +1139,13 @@ TCP_openActiveConnection(UA_POSIXConnectionManager *pcm, const UA_KeyValueMap *p
         return UA_STATUSCODE_BADOUTOFMEMORY;
     }
 
+    TAILQ_INIT(&newConn->sendQueue);
     newConn->rfd.fd = newSock;
     newConn->rfd.es = &pcm->cm.eventSource;
     newConn->rfd.eventSourceCB = (UA_FDCallback)TCP_connectionSocketCallback;
     newConn->rfd.listenEvents = UA_FDEVENT_OUT; /* Switched to _IN once the
                                                  * connection is open */
+    TCP_setAsyncIO(el, newConn);
     newConn->applicationCB = connectionCallback;
     newConn->application = application;
     newConn->context = context;
@@ -922,8 +1196,9 @@ TCP_openConnection(UA_ConnectionManager *cm, const UA_KeyValueMap *params,
     /* Check the parameters */
     UA_StatusCode res =
         UA_KeyValueRestriction_validate(el->eventLoop.logger, "TCP",
-                                        &TCPConfigParameters[1],
-                                        TCP_PARAMETERSSIZE-1, params);
+                                        &TCPConfigParameters[TCP_MANAGERPARAMETERSSIZE],
+                                        TCP_PARAMETERSSIZE-TCP_MANAGERPARAMETERSSIZE,
+                                        params);
     if(res != UA_STATUSCODE_GOOD) {
         UA_UNLOCK(&el->elMutex);
         return res;
@@ -980,7 +1255,7 @@ TCP_eventSourceStart(UA_ConnectionManager *cm) {
     /* Check the parameters */
     UA_StatusCode res =
         UA_KeyValueRestriction_validate(el->eventLoop.logger, "TCP",
-                                        TCPConfigParameters, 1,
+                                        TCPConfigParameters, TCP_MANAGERPARAMETERSSIZE,
                                         &cm->eventSource.params);
     if(res != UA_STATUSCODE_GOOD)
         goto finish;
@@ -990,6 +1265,9 @@ TCP_eventSourceStart(UA_ConnectionManager *cm) {
     if(res != UA_STATUSCODE_GOOD)
         goto finish;
 
+    /* Configure the pool of send buffers */
+    UA_EventLoopPOSIX_configureSendPool(pcm);
+
     /* Set the EventSource to the started state */
     cm->eventSource.state = UA_EVENTSOURCESTATE_STARTED;
 
@@ -1038,6 +1316,7 @@ TCP_eventSourceDelete(UA_ConnectionManager *cm) {
     }
 
     UA_ByteString_clear(&pcm->rxBuffer);
+    UA_EventLoopPOSIX_clearSendPool(pcm);
     UA_KeyValueMap_clear(&cm->eventSource.params);
     UA_String_clear(&cm->eventSource.name);
     UA_free(cm);
@@ -17,20 +17,30 @@
 #endif
 
 /* Configuration parameters */
-#define UDP_PARAMETERSSIZE 10
+#define UDP_PARAMETERSSIZE 13
 #define UDP_PARAMINDEX_RECVBUF 0
-#define UDP_PARAMINDEX_LISTEN 1
-#define UDP_PARAMINDEX_ADDR 2
-#define UDP_PARAMINDEX_PORT 3
-#define UDP_PARAMINDEX_INTERFACE 4
-#define UDP_PARAMINDEX_TTL 5
-#define UDP_PARAMINDEX_LOOPBACK 6
-#define UDP_PARAMINDEX_REUSE 7
-#define UDP_PARAMINDEX_SOCKPRIO 8
-#define UDP_PARAMINDEX_VALIDATE 9
+#define UDP_PARAMINDEX_RECVBATCH 1
+#define UDP_PARAMINDEX_SENDPOOL 2
+#define UDP_PARAMINDEX_SENDPOOLBUF 3
+#define UDP_PARAMINDEX_LISTEN 4
+#define UDP_PARAMINDEX_ADDR 5
+#define UDP_PARAMINDEX_PORT 6
+#define UDP_PARAMINDEX_INTERFACE 7
+#define UDP_PARAMINDEX_TTL 8
+#define UDP_PARAMINDEX_LOOPBACK 9
+#define UDP_PARAMINDEX_REUSE 10
+#define UDP_PARAMINDEX_SOCKPRIO 11
+#define UDP_PARAMINDEX_VALIDATE 12
+
+/* The first parameters configure the ConnectionManager. The others are
+ * parameters for opening a connection. */
+#define UDP_MANAGERPARAMETERSSIZE 4
 
 static UA_KeyValueRestriction UDPConfigParameters[UDP_PARAMETERSSIZE] = {
     {{0, UA_STRING_STATIC("recv-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("recv-batchsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("send-pool-size")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
+    {{0, UA_STRING_STATIC("send-pool-bufsize")}, &UA_TYPES[UA_TYPES_UINT32], false, true, false},
     {{0, UA_STRING_STATIC("listen")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false},
     {{0, UA_STRING_STATIC("address")}, &UA_TYPES[UA_TYPES_STRING], false, true, true},
     {{0, UA_STRING_STATIC("port")}, &UA_TYPES[UA_TYPES_UINT16], true, true, false},
@@ -42,6 +52,21 @@ static UA_KeyValueRestriction UDPConfigParameters[UDP_PARAMETERSSIZE] = {
     {{0, UA_STRING_STATIC("validate")}, &UA_TYPES[UA_TYPES_BOOLEAN], false, true, false}
 };
 
+/* Receive and send several datagrams with a single system call */
+#if defined(__linux__)
+# define UA_HAVE_MMSG
+#endif
+
+/* Upper limit for the number of datagrams handled in one system call */
+#define UDP_MAXBATCHSIZE 64
+
+typedef struct {
+    UA_POSIXConnectionManager pcm;
+
+    /* The rxBuffer is split into rxBatchSize receive buffers of equal size */
+    size_t rxBatchSize;
+} UDP_ConnectionManager;
+
 /* A registered file descriptor with an additional method pointer */
 typedef struct {
     UA_RegisteredFD rfd;
@@ -627,6 +652,102 @@ UDP_delayedClose(void *application, void *context) {
     UA_UNLOCK(&el->elMutex);
 }
 
+/* Forward a received datagram to the application */
+static void
+UDP_deliver(UA_POSIXConnectionManager *pcm, UDP_FD *conn,
+            struct sockaddr_storage *source, UA_ByteString response) {
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)pcm->cm.eventSource.eventLoop;
+
+    /* Extract message source and port */
+    char sourceAddr[64];
+    UA_UInt16 sourcePort;
+    switch(source->ss_family) {
+        case AF_INET:
+            inet_ntop(AF_INET, &((struct sockaddr_in *)source)->sin_addr,
+                    sourceAddr, 64);
+            sourcePort = htons(((struct sockaddr_in *)source)->sin_port);
+            break;
+        case AF_INET6:
+            inet_ntop(AF_INET6, &(((struct sockaddr_in6 *)source)->sin6_addr),
+                    sourceAddr, 64);
+            sourcePort = htons(((struct sockaddr_in6 *)source)->sin6_port);
+            break;
+        default:
+            sourceAddr[0] = 0;
+            sourcePort = 0;
+    }
+
+    UA_String sourceAddrStr = UA_STRING(sourceAddr);
+    UA_KeyValuePair kvp[2];
+    kvp[0].key = UA_QUALIFIEDNAME(0, "remote-address");
+    UA_Variant_setScalar(&kvp[0].value, &sourceAddrStr, &UA_TYPES[UA_TYPES_STRING]);
+    kvp[1].key = UA_QUALIFIEDNAME(0, "remote-port");
+    UA_Variant_setScalar(&kvp[1].value, &sourcePort, &UA_TYPES[UA_TYPES_UINT16]);
+    UA_KeyValueMap kvm = {2, kvp};
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                 "UDP %u\t| Received message of size %u from %s on port %u",
+                 (unsigned)conn->rfd.fd, (unsigned)response.length,
+                 sourceAddr, sourcePort);
+
+    /* Callback to the application layer */
+    conn->applicationCB(&pcm->cm, (uintptr_t)conn->rfd.fd,
+                        conn->application, &conn->context,
+                        UA_CONNECTIONSTATE_ESTABLISHED,
+                        &kvm, response);
+}
+
+#ifdef UA_HAVE_MMSG
+/* Receive up to rxBatchSize datagrams with one system call. Each datagram is
+ * received into its own slice of the rxBuffer. Then they are forwarded to the
+ * application in one pass. */
+static void
+UDP_receiveBatch(UDP_ConnectionManager *ucm, UDP_FD *conn) {
+    UA_POSIXConnectionManager *pcm = &ucm->pcm;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)pcm->cm.eventSource.eventLoop;
+
+    struct mmsghdr msgs[UDP_MAXBATCHSIZE];
+    struct iovec iovs[UDP_MAXBATCHSIZE];
+    struct sockaddr_storage sources[UDP_MAXBATCHSIZE];
+    size_t bufSize = pcm->rxBuffer.length / ucm->rxBatchSize;
+    memset(msgs, 0, sizeof(struct mmsghdr) * ucm->rxBatchSize);
+    for(size_t i = 0; i < ucm->rxBatchSize; i++) {
+        iovs[i].iov_base = pcm->rxBuffer.data + (i * bufSize);
+        iovs[i].iov_len = bufSize;
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &sources[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+    }
+
+    int ret = recvmmsg(conn->rfd.fd, msgs, (unsigned)ucm->rxBatchSize,
+                       MSG_DONTWAIT, NULL);
+    if(ret <= 0) {
+        if(UA_ERRNO == UA_INTERRUPTED || UA_ERRNO == UA_WOULDBLOCK ||
+           UA_ERRNO == UA_AGAIN)
+            return;
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                        "UDP %u\t| recv signaled the socket was shutdown (%s)",
+                        (unsigned)conn->rfd.fd, errno_str));
+        UDP_close(pcm, conn);
+        return;
+    }
+
+    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                 "UDP %u\t| Received a batch of %i messages",
+                 (unsigned)conn->rfd.fd, ret);
+
+    for(int i = 0; i < ret; i++) {
+        /* The application has closed the connection in the callback */
+        if(conn->rfd.dc.callback)
+            return;
+        UA_ByteString response = {msgs[i].msg_len, (UA_Byte*)iovs[i].iov_base};
+        UDP_deliver(pcm, conn, &sources[i], response);
+    }
+}
+#endif
+
 /* Gets called when a socket receives data or closes */
 static void
 UDP_connectionSocketCallback(UA_POSIXConnectionManager *pcm, UDP_FD *conn,
@@ -647,6 +768,15 @@ UDP_connectionSocketCallback(UA_POSIXConnectionManager *pcm, UDP_FD *conn,
         return;
     }
 
+#ifdef UA_HAVE_MMSG
+    /* Drain several datagrams at once */
+    UDP_ConnectionManager *ucm = (UDP_ConnectionManager*)pcm;
+    if(ucm->rxBatchSize > 1) {
+        UDP_receiveBatch(ucm, conn);
+        return;
+    }
+#endif
+
     UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
                  "UDP %u\t| Allocate receive buffer", (unsigned)conn->rfd.fd);
 
@@ -682,44 +812,7 @@ UDP_connectionSocketCallback(UA_POSIXConnectionManager *pcm, UDP_FD *conn,
     }
 
     response.length = (size_t)ret; /* Set the length of the received buffer */
-
-    /* Extract message source and port */
-    char sourceAddr[64];
-    UA_UInt16 sourcePort;
-    switch(source.ss_family) {
-        case AF_INET:
-            inet_ntop(AF_INET, &((struct sockaddr_in *)&source)->sin_addr,
-                    sourceAddr, 64);
-            sourcePort = htons(((struct sockaddr_in *)&source)->sin_port);
-            break;
-        case AF_INET6:
-            inet_ntop(AF_INET6, &(((struct sockaddr_in6 *)&source)->sin6_addr),
-                    sourceAddr, 64);
-            sourcePort = htons(((struct sockaddr_in6 *)&source)->sin6_port);
-            break;
-        default:
-            sourceAddr[0] = 0;
-            sourcePort = 0;
-    }
-
-    UA_String sourceAddrStr = UA_STRING(sourceAddr);
-    UA_KeyValuePair kvp[2];
-    kvp[0].key = UA_QUALIFIEDNAME(0, "remote-address");
-    UA_Variant_setScalar(&kvp[0].value, &sourceAddrStr, &UA_TYPES[UA_TYPES_STRING]);
-    kvp[1].key = UA_QUALIFIEDNAME(0, "remote-port");
-    UA_Variant_setScalar(&kvp[1].value, &sourcePort, &UA_TYPES[UA_TYPES_UINT16]);
-    UA_KeyValueMap kvm = {2, kvp};
-
-    UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
-                 "UDP %u\t| Received message of size %u from %s on port %u",
-                 (unsigned)conn->rfd.fd, (unsigned)ret,
-                 sourceAddr, sourcePort);
-
-    /* Callback to the application layer */
-    conn->applicationCB(&pcm->cm, (uintptr_t)conn->rfd.fd,
-                        conn->application, &conn->context,
-                        UA_CONNECTIONSTATE_ESTABLISHED,
-                        &kvm, response);
+    UDP_deliver(pcm, conn, &source, response);
 }
 
 static UA_StatusCode
@@ -976,10 +1069,31 @@ UDP_shutdownConnection(UA_ConnectionManager *cm, uintptr_t connectionId) {
     return UA_STATUSCODE_GOOD;
 }
 
+/* Block until the socket can take more data. Returns false upon an error. */
+static UA_Boolean
+UDP_pollSend(UA_EventLoopPOSIX *el, UA_FD fd) {
+    int poll_ret;
+    struct pollfd tmp_poll_fd;
+    tmp_poll_fd.fd = fd;
+    tmp_poll_fd.events = UA_POLLOUT;
+    do {
+        poll_ret = UA_poll(&tmp_poll_fd, 1, 100);
+        if(poll_ret < 0 && UA_ERRNO != UA_INTERRUPTED) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "UDP %u\t| Send failed with error %s",
+                            (unsigned)fd, errno_str));
+            return false;
+        }
+    } while(poll_ret <= 0);
+    return true;
+}
+
+/* Send the buffer without releasing it */
 static UA_StatusCode
-UDP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
-                       const UA_KeyValueMap *params,
-                       UA_ByteString *buf) {
+UDP_sendRetainedWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
+                               const UA_KeyValueMap *params,
+                               const UA_ByteString *buf) {
     UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
     UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
 
@@ -990,7 +1104,6 @@ UDP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
     UDP_FD *conn = (UDP_FD*)ZIP_FIND(UA_FDTree, &pcm->fds, &fd);
     if(!conn) {
         UA_UNLOCK(&el->elMutex);
-        UA_ByteString_clear(buf);
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
@@ -1019,41 +1132,126 @@ UDP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
                                     (unsigned)connectionId, errno_str));
                     UA_UNLOCK(&el->elMutex);
                     UDP_shutdownConnection(cm, connectionId);
-                    UA_ByteString_clear(buf);
                     return UA_STATUSCODE_BADCONNECTIONCLOSED;
                 }
 
                 /* Poll for the socket resources to become available and retry
                  * (blocking) */
-                int poll_ret;
-                struct pollfd tmp_poll_fd;
-                tmp_poll_fd.fd = (UA_FD)connectionId;
-                tmp_poll_fd.events = UA_POLLOUT;
-                do {
-                    poll_ret = UA_poll(&tmp_poll_fd, 1, 100);
-                    if(poll_ret < 0 && UA_ERRNO != UA_INTERRUPTED) {
-                        UA_LOG_SOCKET_ERRNO_WRAP(
-                           UA_LOG_ERROR(el->eventLoop.logger,
-                                        UA_LOGCATEGORY_NETWORK,
-                                        "UDP %u\t| Send failed with error %s",
-                                        (unsigned)connectionId, errno_str));
-                        UA_UNLOCK(&el->elMutex);
-                        UDP_shutdownConnection(cm, connectionId);
-                        UA_ByteString_clear(buf);
-                        return UA_STATUSCODE_BADCONNECTIONCLOSED;
-                    }
-                } while(poll_ret <= 0);
+                if(!UDP_pollSend(el, (UA_FD)connectionId)) {
+                    UA_UNLOCK(&el->elMutex);
+                    UDP_shutdownConnection(cm, connectionId);
+                    return UA_STATUSCODE_BADCONNECTIONCLOSED;
+                }
             }
         } while(n < 0);
         nWritten += (size_t)n;
     } while(nWritten < buf->length);
 
-    /* Free the buffer */
     UA_UNLOCK(&el->elMutex);
-    UA_ByteString_clear(buf);
     return UA_STATUSCODE_GOOD;
 }
 
+static UA_StatusCode
+UDP_sendWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
+                       const UA_KeyValueMap *params,
+                       UA_ByteString *buf) {
+    UA_StatusCode res = UDP_sendRetainedWithConnection(cm, connectionId, params, buf);
+    UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, buf);
+    return res;
+}
+
+static UA_StatusCode
+UDP_sendBatchWithConnection(UA_ConnectionManager *cm, uintptr_t connectionId,
+                            const UA_KeyValueMap *params,
+                            UA_ByteString *bufs, size_t bufsSize) {
+#ifndef UA_HAVE_MMSG
+    /* Fall back to sending the datagrams one by one */
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    for(size_t i = 0; i < bufsSize; i++) {
+        if(res == UA_STATUSCODE_GOOD)
+            res = UDP_sendWithConnection(cm, connectionId, params, &bufs[i]);
+        else
+            UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, &bufs[i]);
+    }
+    return res;
+#else
+    UA_POSIXConnectionManager *pcm = (UA_POSIXConnectionManager*)cm;
+    UA_EventLoopPOSIX *el = (UA_EventLoopPOSIX*)cm->eventSource.eventLoop;
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+
+    UA_LOCK(&el->elMutex);
+
+    /* Look up the registered UDP socket */
+    UA_FD fd = (UA_FD)connectionId;
+    UDP_FD *conn = (UDP_FD*)ZIP_FIND(UA_FDTree, &pcm->fds, &fd);
+    if(!conn) {
+        UA_UNLOCK(&el->elMutex);
+        res = UA_STATUSCODE_BADINTERNALERROR;
+        goto cleanup;
+    }
+
+    /* Send up to UDP_MAXBATCHSIZE datagrams with every call to sendmmsg */
+    struct mmsghdr msgs[UDP_MAXBATCHSIZE];
+    struct iovec iovs[UDP_MAXBATCHSIZE];
+    size_t done = 0;
+    while(done < bufsSize) {
+        size_t batchSize = bufsSize - done;
+        if(batchSize > UDP_MAXBATCHSIZE)
+            batchSize = UDP_MAXBATCHSIZE;
+        memset(msgs, 0, sizeof(struct mmsghdr) * batchSize);
+        for(size_t i = 0; i < batchSize; i++) {
+            iovs[i].iov_base = bufs[done + i].data;
+            iovs[i].iov_len = bufs[done + i].length;
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &conn->sendAddr;
+            msgs[i].msg_hdr.msg_namelen = conn->sendAddrLength;
+        }
+
+        UA_LOG_DEBUG(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                     "UDP %u\t| Attempting to send a batch of %u messages",
+                     (unsigned)connectionId, (unsigned)batchSize);
+
+        /* Prevent OS signals when sending to a closed socket */
+        int ret = sendmmsg(fd, msgs, (unsigned)batchSize, MSG_NOSIGNAL);
+        if(ret >= 0) {
+            done += (size_t)ret;
+            continue;
+        }
+
+        /* Retry if interrupted */
+        if(UA_ERRNO == UA_INTERRUPTED)
+            continue;
+
+        /* Poll for the socket resources to become available and retry
+         * (blocking) */
+        if(UA_ERRNO == UA_WOULDBLOCK || UA_ERRNO == UA_AGAIN) {
+            if(UDP_pollSend(el, fd))
+                continue;
+        } else {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_ERROR(el->eventLoop.logger, UA_LOGCATEGORY_NETWORK,
+                            "UDP %u\t| Send failed with error %s",
+                            (unsigned)connectionId, errno_str));
+        }
+
+        /* An error we cannot recover from */
+        UA_UNLOCK(&el->elMutex);
+        UDP_shutdownConnection(cm, connectionId);
+        res = UA_STATUSCODE_BADCONNECTIONCLOSED;
+        goto cleanup;
+    }
+
+    UA_UNLOCK(&el->elMutex);
+
+ cleanup:
+    /* Free the buffers */
+    for(size_t i = 0; i < bufsSize; i++)
+        UA_EventLoopPOSIX_freeNetworkBuffer(cm, connectionId, &bufs[i]);
+    return res;
+#endif
+}
+
 static UA_StatusCode
 registerSocketAndDestinationForSend(const UA_KeyValueMap *params,
                                     const char *hostname, struct addrinfo *info,
@@ -1249,8 +1447,9 @@ UDP_openConnection(UA_ConnectionManager *cm, const UA_KeyValueMap *params,
     /* Check the parameters */
     UA_StatusCode res =
         UA_KeyValueRestriction_validate(el->eventLoop.logger, "UDP",
-                                        &UDPConfigParameters[1],
-                                        UDP_PARAMETERSSIZE-1, params);
+                                        &UDPConfigParameters[UDP_MANAGERPARAMETERSSIZE],
+                                        UDP_PARAMETERSSIZE-UDP_MANAGERPARAMETERSSIZE,
+                                        params);
     if(res != UA_STATUSCODE_GOOD) {
         UA_UNLOCK(&el->elMutex);
         return res;
@@ -1302,7 +1501,7 @@ UDP_eventSourceStart(UA_ConnectionManager *cm) {
     /* Check the parameters */
     UA_StatusCode res =
         UA_KeyValueRestriction_validate(el->eventLoop.logger, "UDP",
-                                        UDPConfigParameters, 1,
+                                        UDPConfigParameters, UDP_MANAGERPARAMETERSSIZE,
                                         &cm->eventSource.params);
     if(res != UA_STATUSCODE_GOOD)
         goto finish;
@@ -1312,6 +1511,29 @@ UDP_eventSourceStart(UA_ConnectionManager *cm) {
     if(res != UA_STATUSCODE_GOOD)
         goto finish;
 
+    /* Configure the pool of send buffers */
+    UA_EventLoopPOSIX_configureSendPool(pcm);
+
+    /* Extend the rx buffer for receiving a batch of datagrams at once */
+    UDP_ConnectionManager *ucm = (UDP_ConnectionManager*)cm;
+    ucm->rxBatchSize = 1;
+#ifdef UA_HAVE_MMSG
+    const UA_UInt32 *rxBatchSize = (const UA_UInt32*)
+        UA_KeyValueMap_getScalar(&cm->eventSource.params,
+                                 UDPConfigParameters[UDP_PARAMINDEX_RECVBATCH].name,
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+    if(rxBatchSize && *rxBatchSize > 1) {
+        size_t batchSize = (*rxBatchSize > UDP_MAXBATCHSIZE) ?
+            UDP_MAXBATCHSIZE : (size_t)*rxBatchSize;
+        size_t bufSize = pcm->rxBuffer.length;
+        UA_ByteString_clear(&pcm->rxBuffer);
+        res = UA_ByteString_allocBuffer(&pcm->rxBuffer, bufSize * batchSize);
+        if(res != UA_STATUSCODE_GOOD)
+            goto finish;
+        ucm->rxBatchSize = batchSize;
+    }
+#endif
+
     /* Set the EventSource to the started state */
     cm->eventSource.state = UA_EVENTSOURCESTATE_STARTED;
 
@@ -1360,6 +1582,7 @@ UDP_eventSourceDelete(UA_ConnectionManager *cm) {
     }
 
     UA_ByteString_clear(&pcm->rxBuffer);
+    UA_EventLoopPOSIX_clearSendPool(pcm);
     UA_KeyValueMap_clear(&cm->eventSource.params);
     UA_String_clear(&cm->eventSource.name);
     UA_free(cm);
@@ -1372,7 +1595,7 @@ static const char *udpName = "udp";
 UA_ConnectionManager *
 UA_ConnectionManager_new_POSIX_UDP(const UA_String eventSourceName) {
     UA_POSIXConnectionManager *cm = (UA_POSIXConnectionManager*)
-        UA_calloc(1, sizeof(UA_POSIXConnectionManager));
+        UA_calloc(1, sizeof(UDP_ConnectionManager));
     if(!cm)
         return NULL;
 
@@ -1386,6 +1609,8 @@ UA_ConnectionManager_new_POSIX_UDP(const UA_String eventSourceName) {
     cm->cm.allocNetworkBuffer = UA_EventLoopPOSIX_allocNetworkBuffer;
     cm->cm.freeNetworkBuffer = UA_EventLoopPOSIX_freeNetworkBuffer;
     cm->cm.sendWithConnection = UDP_sendWithConnection;
+    cm->cm.sendBatchWithConnection = UDP_sendBatchWithConnection;
+    cm->cm.sendRetainedWithConnection = UDP_sendRetainedWithConnection;
     cm->cm.closeConnection = UDP_shutdownConnection;
     return &cm->cm;
 }
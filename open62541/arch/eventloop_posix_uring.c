@@ -0,0 +1,651 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "eventloop_posix.h"
+
+#if defined(UA_HAVE_IO_URING)
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+/* The io_uring backend arms one request for every registered fd. After its
+ * completion was processed, the request is armed again.
+ *
+ * - If the EventSource has set the recvCB of the rfd, the request is an
+ *   IORING_OP_RECV. The kernel picks the target from a group of receive
+ *   buffers that were handed to it with IORING_OP_PROVIDE_BUFFERS. So a
+ *   pending receive does not hold on to memory of the EventSource. The buffer
+ *   is handed back to the kernel after the recvCB has returned.
+ * - Otherwise a one-shot IORING_OP_POLL_ADD waits for the readiness of the
+ *   fd. This is used for listen sockets, for connecting sockets and for the
+ *   EventSources that do their I/O themselves.
+ *
+ * Only the TCP ConnectionManager uses the recvCB and sendCB so far. The UDP
+ * and Ethernet ConnectionManagers are polled for readiness. The buffers are
+ * not registered with io_uring_register_buffers (IORING_REGISTER_BUFFERS).
+ * Fixed buffers only apply to the *_FIXED opcodes with a buffer chosen at
+ * submission. They cannot be combined with the buffer selection for
+ * receives.
+ *
+ * EventSources with the sendCB submit IORING_OP_SEND requests with
+ * UA_EventLoopPOSIX_sendAsync. At most one send per fd is in flight. The
+ * EventSource keeps the data and the fd registration until the sendCB was
+ * called.
+ *
+ * All requests and modifications from the EventSources are collected in the
+ * submission queue. They are submitted together with waiting for the next
+ * completions in a single io_uring_enter system call per EventLoop iteration.
+ *
+ * Completions can arrive for requests that were already replaced or removed.
+ * So the user_data does not point to the rfd. It contains the fd number
+ * (lower 32 bits) and a generation counter (upper bits). A completion is only
+ * dispatched if the generation matches the current registration of the fd.
+ * Sends are marked with the highest bit instead of a generation. The
+ * user_data zero is reserved for the internal requests (removal, providing
+ * buffers) whose completion is ignored. */
+
+#define UA_URING_ENTRIES 1024
+#define UA_URING_CQENTRIES 8192
+
+/* Provided receive buffers. TCP is a byte stream, so a message can be split
+ * over several receives. */
+#define UA_URING_BUFGROUP 0
+#define UA_URING_RECVBUFS 64
+#define UA_URING_RECVBUFSIZE (1u << 14)
+
+#define UA_URING_SEND ((UA_UInt64)1 << 63)
+#define UA_URING_GENERATIONMASK 0x7fffffffu
+
+/* Waiting for the completion of all requests before the ring is closed */
+#define UA_URING_DRAINTIMEOUT (100 * UA_DATETIME_MSEC)
+#define UA_URING_DRAINATTEMPTS 10
+
+typedef struct {
+    UA_RegisteredFD *rfd; /* NULL if the fd is not registered */
+    UA_UInt32 generation; /* Identifies the current request */
+    UA_Boolean recv;      /* The current request is a receive */
+    UA_Boolean sending;   /* A send request is in flight */
+} UA_URingFD;
+
+struct UA_URing {
+    int fd;
+
+    /* Mapped memory of the rings. The completion queue can be in the same
+     * mapping as the submission queue. */
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    struct io_uring_sqe *sqes;
+    size_t sqesSize;
+
+    /* Submission queue */
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    unsigned sqEntries;
+
+    /* Completion queue */
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned *cqMask;
+    struct io_uring_cqe *cqes;
+
+    /* Registered fds indexed by the fd number */
+    UA_URingFD *fds;
+    size_t fdsSize;
+    UA_UInt32 generation;
+
+    /* Submitted requests without a completion */
+    size_t inFlight;
+
+    /* Receive buffers. Allocated and provided to the kernel with the first
+     * receive request. */
+    UA_Byte *recvBufs;
+    UA_Boolean draining; /* Don't hand the buffers back when closing */
+
+    /* The EventLoop thread is blocked in io_uring_enter. Requests from other
+     * threads are then submitted right away. */
+    UA_Boolean waiting;
+};
+
+static int
+uringSetup(unsigned entries, struct io_uring_params *p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int
+uringEnter(int fd, unsigned toSubmit, unsigned minComplete,
+           unsigned flags, void *arg, size_t argSize) {
+    return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete,
+                        flags, arg, argSize);
+}
+
+static unsigned
+sqPending(UA_URing *ur) {
+    return *ur->sqTail - __atomic_load_n(ur->sqHead, __ATOMIC_ACQUIRE);
+}
+
+/* Submit the queued requests without waiting for completions */
+static UA_StatusCode
+submitRequests(UA_EventLoopPOSIX *el) {
+    UA_URing *ur = el->uring;
+    while(sqPending(ur) > 0) {
+        int ret = uringEnter(ur->fd, sqPending(ur), 0, 0, NULL, 0);
+        if(ret >= 0 || errno == EINTR)
+            continue;
+        if(errno == EAGAIN || errno == EBUSY)
+            return UA_STATUSCODE_GOOD; /* Retried during the next wait */
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                          "Eventloop\t| Could not submit to io_uring (%s)",
+                          errno_str));
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Get the next free entry in the submission queue. Submits the queued
+ * requests if the queue is full. */
+static struct io_uring_sqe *
+getSQE(UA_EventLoopPOSIX *el) {
+    UA_URing *ur = el->uring;
+    if(sqPending(ur) >= ur->sqEntries) {
+        submitRequests(el);
+        if(sqPending(ur) >= ur->sqEntries)
+            return NULL;
+    }
+    unsigned idx = *ur->sqTail & *ur->sqMask;
+    struct io_uring_sqe *sqe = &ur->sqes[idx];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    ur->sqArray[idx] = idx;
+    return sqe;
+}
+
+/* Make the prepared entry visible to the kernel */
+static void
+commitSQE(UA_EventLoopPOSIX *el) {
+    UA_URing *ur = el->uring;
+    ur->inFlight++;
+    __atomic_store_n(ur->sqTail, *ur->sqTail + 1, __ATOMIC_RELEASE);
+    if(ur->waiting)
+        submitRequests(el);
+}
+
+static UA_UInt64
+requestUserData(UA_FD fd, UA_UInt32 generation) {
+    return ((UA_UInt64)generation << 32) | (UA_UInt32)fd;
+}
+
+static struct io_uring_sqe *
+getSQEOrWarn(UA_EventLoopPOSIX *el) {
+    struct io_uring_sqe *sqe = getSQE(el);
+    if(!sqe)
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                       "Eventloop\t| The io_uring submission queue is full");
+    return sqe;
+}
+
+/* Hand (back) receive buffers to the kernel */
+static UA_StatusCode
+provideBuffers(UA_EventLoopPOSIX *el, UA_UInt16 bid, UA_UInt16 count) {
+    struct io_uring_sqe *sqe = getSQEOrWarn(el);
+    if(!sqe)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe->fd = count;
+    sqe->addr = (UA_UInt64)(uintptr_t)
+        &el->uring->recvBufs[(size_t)bid * UA_URING_RECVBUFSIZE];
+    sqe->len = UA_URING_RECVBUFSIZE;
+    sqe->off = bid;
+    sqe->buf_group = UA_URING_BUFGROUP;
+    sqe->user_data = 0;
+    commitSQE(el);
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+addRecvRequest(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd,
+               UA_UInt32 generation) {
+    UA_URing *ur = el->uring;
+    if(!ur->recvBufs) {
+        ur->recvBufs = (UA_Byte*)
+            UA_malloc((size_t)UA_URING_RECVBUFS * UA_URING_RECVBUFSIZE);
+        if(!ur->recvBufs)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        UA_StatusCode res = provideBuffers(el, 0, UA_URING_RECVBUFS);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_free(ur->recvBufs);
+            ur->recvBufs = NULL;
+            return res;
+        }
+    }
+
+    struct io_uring_sqe *sqe = getSQEOrWarn(el);
+    if(!sqe)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = rfd->fd;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = UA_URING_BUFGROUP;
+    sqe->len = UA_URING_RECVBUFSIZE;
+    sqe->user_data = requestUserData(rfd->fd, generation);
+    commitSQE(el);
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+addPollRequest(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd,
+               UA_UInt32 generation) {
+    struct io_uring_sqe *sqe = getSQEOrWarn(el);
+    if(!sqe)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    UA_UInt32 mask = 0;
+    if(rfd->listenEvents & UA_FDEVENT_IN)
+        mask |= POLLIN;
+    if(rfd->listenEvents & UA_FDEVENT_OUT)
+        mask |= POLLOUT;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    mask = (mask << 16) | (mask >> 16); /* The kernel expects swapped halves */
+#endif
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = rfd->fd;
+    sqe->poll32_events = mask;
+    sqe->user_data = requestUserData(rfd->fd, generation);
+    commitSQE(el);
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Receive if the EventSource lets the EventLoop do the I/O and is interested
+ * in incoming data. Poll otherwise. */
+static UA_StatusCode
+armRequest(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd, UA_URingFD *ufd) {
+    ufd->recv = (rfd->recvCB && (rfd->listenEvents & UA_FDEVENT_IN));
+    if(ufd->recv)
+        return addRecvRequest(el, rfd, ufd->generation);
+    return addPollRequest(el, rfd, ufd->generation);
+}
+
+static void
+cancelRequest(UA_EventLoopPOSIX *el, UA_FD fd, UA_UInt32 generation) {
+    /* The completion of the request is ignored in any case */
+    struct io_uring_sqe *sqe = getSQEOrWarn(el);
+    if(!sqe)
+        return;
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = requestUserData(fd, generation);
+    sqe->user_data = 0;
+    commitSQE(el);
+}
+
+static UA_UInt32
+nextGeneration(UA_URing *ur) {
+    ur->generation = (ur->generation + 1) & UA_URING_GENERATIONMASK;
+    if(ur->generation == 0)
+        ur->generation++;
+    return ur->generation;
+}
+
+UA_StatusCode
+UA_EventLoopPOSIX_registerFD_uring(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+    UA_URing *ur = el->uring;
+    if(rfd->fd < 0)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    /* Grow the index of registered fds */
+    size_t fd = (size_t)rfd->fd;
+    if(fd >= ur->fdsSize) {
+        size_t newSize = (ur->fdsSize > 0) ? ur->fdsSize : 64;
+        while(newSize <= fd)
+            newSize *= 2;
+        UA_URingFD *fds = (UA_URingFD*)
+            UA_realloc(ur->fds, sizeof(UA_URingFD) * newSize);
+        if(!fds)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        memset(&fds[ur->fdsSize], 0, sizeof(UA_URingFD) * (newSize - ur->fdsSize));
+        ur->fds = fds;
+        ur->fdsSize = newSize;
+    }
+
+    UA_URingFD *ufd = &ur->fds[fd];
+    if(ufd->rfd)
+        return UA_STATUSCODE_BADINTERNALERROR; /* Already registered */
+
+    ufd->generation = nextGeneration(ur);
+    UA_StatusCode res = armRequest(el, rfd, ufd);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    ufd->rfd = rfd;
+    ufd->sending = false;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_EventLoopPOSIX_modifyFD_uring(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+    UA_URing *ur = el->uring;
+    size_t fd = (size_t)rfd->fd;
+    if(rfd->fd < 0 || fd >= ur->fdsSize || ur->fds[fd].rfd != rfd)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    /* A pending receive stays. Replacing it could lose received data. */
+    UA_URingFD *ufd = &ur->fds[fd];
+    if(ufd->recv && rfd->recvCB && (rfd->listenEvents & UA_FDEVENT_IN))
+        return UA_STATUSCODE_GOOD;
+
+    /* Replace the request */
+    cancelRequest(el, rfd->fd, ufd->generation);
+    ufd->generation = nextGeneration(ur);
+    return armRequest(el, rfd, ufd);
+}
+
+void
+UA_EventLoopPOSIX_deregisterFD_uring(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd) {
+    UA_URing *ur = el->uring;
+    size_t fd = (size_t)rfd->fd;
+    if(rfd->fd < 0 || fd >= ur->fdsSize || ur->fds[fd].rfd != rfd)
+        return;
+    UA_URingFD *ufd = &ur->fds[fd];
+    UA_assert(!ufd->sending); /* The EventSource waits for the sendCB */
+    cancelRequest(el, rfd->fd, ufd->generation);
+    ufd->rfd = NULL;
+}
+
+UA_StatusCode
+UA_EventLoopPOSIX_sendAsync_uring(UA_EventLoopPOSIX *el, UA_RegisteredFD *rfd,
+                                  const UA_Byte *data, size_t length) {
+    UA_URing *ur = el->uring;
+    size_t fd = (size_t)rfd->fd;
+    if(rfd->fd < 0 || fd >= ur->fdsSize || ur->fds[fd].rfd != rfd ||
+       !rfd->sendCB || ur->fds[fd].sending)
+        return UA_STATUSCODE_BADINTERNALERROR;
+
+    struct io_uring_sqe *sqe = getSQEOrWarn(el);
+    if(!sqe)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = rfd->fd;
+    sqe->addr = (UA_UInt64)(uintptr_t)data;
+    sqe->len = (length > UA_UINT32_MAX) ? UA_UINT32_MAX : (UA_UInt32)length;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = UA_URING_SEND | (UA_UInt32)rfd->fd;
+    ur->fds[fd].sending = true;
+    commitSQE(el);
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+processSendCompletion(UA_EventLoopPOSIX *el, size_t fd, int result) {
+    /* The rfd stays registered until the send has completed. Also when the
+     * EventSource is closing it. */
+    UA_URing *ur = el->uring;
+    if(fd >= ur->fdsSize || !ur->fds[fd].rfd || !ur->fds[fd].sending)
+        return;
+    ur->fds[fd].sending = false;
+    UA_RegisteredFD *rfd = ur->fds[fd].rfd;
+    rfd->sendCB(rfd->es, rfd, result);
+}
+
+static void
+processCompletion(UA_EventLoopPOSIX *el, UA_UInt64 userData,
+                  int result, UA_UInt32 flags) {
+    UA_URing *ur = el->uring;
+
+    /* The kernel has put received data into one of the provided buffers.
+     * Hand the buffer back when done. */
+    UA_Boolean hasBuf = ((flags & IORING_CQE_F_BUFFER) != 0);
+    UA_UInt16 bid = (UA_UInt16)(flags >> IORING_CQE_BUFFER_SHIFT);
+
+    /* Completion of an internal request */
+    if(userData == 0)
+        goto release;
+
+    /* Completion of a send */
+    size_t fd = (size_t)(UA_UInt32)userData;
+    if(userData & UA_URING_SEND) {
+        processSendCompletion(el, fd, result);
+        return;
+    }
+
+    /* Completion of a request that was replaced or removed */
+    UA_UInt32 generation = (UA_UInt32)(userData >> 32);
+    if(fd >= ur->fdsSize || !ur->fds[fd].rfd ||
+       ur->fds[fd].generation != generation)
+        goto release;
+
+    /* The rfd is already registered for removal. Don't process incoming
+     * events any longer. */
+    UA_RegisteredFD *rfd = ur->fds[fd].rfd;
+    if(rfd->dc.callback)
+        goto release;
+
+    /* Dispatch the completion */
+    if(ur->fds[fd].recv) {
+        if(result >= 0) {
+            /* Zero bytes signal an orderly shutdown */
+            UA_ByteString data = UA_BYTESTRING_NULL;
+            if(result > 0 && hasBuf) {
+                data.data = &ur->recvBufs[(size_t)bid * UA_URING_RECVBUFSIZE];
+                data.length = (size_t)result;
+            }
+            rfd->recvCB(rfd->es, rfd, &data);
+        } else if(result != -ENOBUFS && result != -ECANCELED &&
+                  result != -EINTR && result != -EAGAIN) {
+            /* Only arm again for temporary errors. All receive buffers are
+             * in use if ENOBUFS. They are handed back before the next receive
+             * request is submitted. */
+            rfd->eventSourceCB(rfd->es, rfd, UA_FDEVENT_ERR);
+        }
+    } else {
+        short revent = 0;
+        if(result == -ECANCELED) {
+            revent = 0; /* Only arm again */
+        } else if(result >= 0 && (result & POLLIN)) {
+            revent = UA_FDEVENT_IN;
+        } else if(result >= 0 && (result & POLLOUT)) {
+            revent = UA_FDEVENT_OUT;
+        } else {
+            revent = UA_FDEVENT_ERR;
+        }
+        if(revent != 0)
+            rfd->eventSourceCB(rfd->es, rfd, revent);
+    }
+
+    /* Arm again if the registration is unchanged. The callback may have
+     * closed, modified or replaced the fd. */
+    if(fd < ur->fdsSize && ur->fds[fd].rfd == rfd &&
+       ur->fds[fd].generation == generation && !rfd->dc.callback)
+        armRequest(el, rfd, &ur->fds[fd]);
+
+ release:
+    if(hasBuf && !ur->draining)
+        provideBuffers(el, bid, 1);
+}
+
+UA_StatusCode
+UA_EventLoopPOSIX_pollFDs_uring(UA_EventLoopPOSIX *el, UA_DateTime listenTimeout) {
+    UA_assert(listenTimeout >= 0);
+    UA_URing *ur = el->uring;
+
+    /* Submit the pending requests and wait for completions in one system call.
+     * Don't wait if completions are already available. */
+    if(*ur->cqHead == __atomic_load_n(ur->cqTail, __ATOMIC_ACQUIRE)) {
+        struct __kernel_timespec ts;
+        ts.tv_sec = (long long)(listenTimeout / UA_DATETIME_SEC);
+        ts.tv_nsec = (long long)((listenTimeout % UA_DATETIME_SEC) * 100);
+        struct io_uring_getevents_arg arg;
+        memset(&arg, 0, sizeof(struct io_uring_getevents_arg));
+        arg.ts = (UA_UInt64)(uintptr_t)&ts;
+
+        int fd = ur->fd;
+        unsigned toSubmit = sqPending(ur);
+        ur->waiting = true;
+        UA_UNLOCK(&el->elMutex);
+        int ret = uringEnter(fd, toSubmit, 1,
+                             IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                             &arg, sizeof(struct io_uring_getevents_arg));
+        UA_LOCK(&el->elMutex);
+        ur->waiting = false;
+
+        /* Handle error conditions */
+        if(ret < 0 && errno != ETIME && errno != EINTR &&
+           errno != EAGAIN && errno != EBUSY) {
+            UA_LOG_SOCKET_ERRNO_WRAP(
+               UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                              "Eventloop\t| Error %s while waiting on io_uring",
+                              errno_str));
+            return UA_STATUSCODE_BADINTERNALERROR;
+        }
+    }
+
+    /* Process the completions that are available now. Completions arriving
+     * during the processing are handled in the next iteration. */
+    unsigned head = *ur->cqHead;
+    unsigned tail = __atomic_load_n(ur->cqTail, __ATOMIC_ACQUIRE);
+    while(head != tail) {
+        struct io_uring_cqe *cqe = &ur->cqes[head & *ur->cqMask];
+        UA_UInt64 userData = cqe->user_data;
+        int result = cqe->res;
+        UA_UInt32 flags = cqe->flags;
+        head++;
+        __atomic_store_n(ur->cqHead, head, __ATOMIC_RELEASE);
+        ur->inFlight--;
+        processCompletion(el, userData, result, flags);
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_EventLoopPOSIX_startURing(UA_EventLoopPOSIX *el) {
+    UA_URing *ur = (UA_URing*)UA_calloc(1, sizeof(UA_URing));
+    if(!ur)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(struct io_uring_params));
+    p.flags = IORING_SETUP_CQSIZE;
+    p.cq_entries = UA_URING_CQENTRIES;
+    ur->fd = uringSetup(UA_URING_ENTRIES, &p);
+    if(ur->fd < 0) {
+        UA_LOG_SOCKET_ERRNO_WRAP(
+           UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                          "Eventloop\t| Could not create the io_uring (%s)",
+                          errno_str));
+        UA_free(ur);
+        return UA_STATUSCODE_BADNOTSUPPORTED;
+    }
+
+    /* Waiting with a timeout requires Linux 5.11 */
+    if(!(p.features & IORING_FEAT_EXT_ARG) || !(p.features & IORING_FEAT_NODROP)) {
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                       "Eventloop\t| The kernel does not support the "
+                       "required io_uring features");
+        close(ur->fd);
+        UA_free(ur);
+        return UA_STATUSCODE_BADNOTSUPPORTED;
+    }
+
+    /* Map the rings */
+    ur->sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ur->cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if(p.features & IORING_FEAT_SINGLE_MMAP) {
+        if(ur->cqRingSize > ur->sqRingSize)
+            ur->sqRingSize = ur->cqRingSize;
+        ur->cqRingSize = 0;
+    }
+    ur->sqRing = mmap(NULL, ur->sqRingSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ur->fd, IORING_OFF_SQ_RING);
+    if(ur->sqRing == MAP_FAILED)
+        goto error;
+    ur->cqRing = ur->sqRing;
+    if(ur->cqRingSize > 0) {
+        ur->cqRing = mmap(NULL, ur->cqRingSize, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ur->fd, IORING_OFF_CQ_RING);
+        if(ur->cqRing == MAP_FAILED)
+            goto error;
+    }
+    ur->sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+    ur->sqes = (struct io_uring_sqe*)
+        mmap(NULL, ur->sqesSize, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, ur->fd, IORING_OFF_SQES);
+    if(ur->sqes == MAP_FAILED)
+        goto error;
+
+    UA_Byte *sq = (UA_Byte*)ur->sqRing;
+    ur->sqHead = (unsigned*)(sq + p.sq_off.head);
+    ur->sqTail = (unsigned*)(sq + p.sq_off.tail);
+    ur->sqMask = (unsigned*)(sq + p.sq_off.ring_mask);
+    ur->sqArray = (unsigned*)(sq + p.sq_off.array);
+    ur->sqEntries = p.sq_entries;
+
+    UA_Byte *cq = (UA_Byte*)ur->cqRing;
+    ur->cqHead = (unsigned*)(cq + p.cq_off.head);
+    ur->cqTail = (unsigned*)(cq + p.cq_off.tail);
+    ur->cqMask = (unsigned*)(cq + p.cq_off.ring_mask);
+    ur->cqes = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+
+    el->uring = ur;
+    UA_LOG_INFO(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                "Eventloop\t| Using the io_uring backend");
+    return UA_STATUSCODE_GOOD;
+
+ error:
+    UA_LOG_SOCKET_ERRNO_WRAP(
+       UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                      "Eventloop\t| Could not map the io_uring (%s)",
+                      errno_str));
+    if(ur->sqRing && ur->sqRing != MAP_FAILED)
+        munmap(ur->sqRing, ur->sqRingSize);
+    if(ur->cqRingSize > 0 && ur->cqRing && ur->cqRing != MAP_FAILED)
+        munmap(ur->cqRing, ur->cqRingSize);
+    close(ur->fd);
+    UA_free(ur);
+    return UA_STATUSCODE_BADINTERNALERROR;
+}
+
+/* Wait until the kernel has completed all requests. All fds are deregistered
+ * at this point. So the completions are not dispatched. */
+static UA_Boolean
+drainRequests(UA_EventLoopPOSIX *el) {
+    UA_URing *ur = el->uring;
+    ur->draining = true;
+    for(size_t i = 0; i < UA_URING_DRAINATTEMPTS && ur->inFlight > 0; i++) {
+        UA_StatusCode res = UA_EventLoopPOSIX_pollFDs_uring(el, UA_URING_DRAINTIMEOUT);
+        if(res != UA_STATUSCODE_GOOD)
+            break;
+    }
+    return (ur->inFlight == 0);
+}
+
+void
+UA_EventLoopPOSIX_stopURing(UA_EventLoopPOSIX *el) {
+    UA_URing *ur = el->uring;
+    if(!ur)
+        return;
+
+    if(!drainRequests(el))
+        UA_LOG_WARNING(el->eventLoop.logger, UA_LOGCATEGORY_EVENTLOOP,
+                       "Eventloop\t| %u io_uring requests did not complete "
+                       "and are canceled", (unsigned)ur->inFlight);
+
+    munmap(ur->sqes, ur->sqesSize);
+    if(ur->cqRingSize > 0)
+        munmap(ur->cqRing, ur->cqRingSize);
+    munmap(ur->sqRing, ur->sqRingSize);
+    close(ur->fd);
+
+    /* Closing the ring cancels the remaining requests. The kernel selects a
+     * receive buffer only when it completes a receive. So it no longer writes
+     * into the buffers afterwards. */
+    UA_free(ur->recvBufs);
+    UA_free(ur->fds);
+    UA_free(ur);
+    el->uring = NULL;
+}
+
+#endif /* defined(UA_HAVE_IO_URING) */
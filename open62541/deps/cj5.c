@@ -151,7 +151,7 @@ cj5__parse_string(cj5__parser *parser) {
             case 'u': // The next four characters are an utf8 code
                 parser->pos++;
                 if(parser->pos + 4 >= len) {
-                    parser->error = CJ5_ERROR_INVALID;
+                    parser->error = CJ5_ERROR_INCOMPLETE;
                     return;
                 }
                 for(unsigned int i = 0; i < 4; i++) {
@@ -202,7 +202,7 @@ cj5__parse_primitive(cj5__parser* parser) {
     // Fast comparison of bool, and null.
     // We have to use memcpy here or we can get unaligned accesses
     uint32_t fourcc = 0;
-    if(start + 4 < len)
+    if(start + 4 <= len)
         memcpy(&fourcc, &json5[start], 4);
     
     cj5_token_type type;
@@ -215,7 +215,11 @@ cj5__parse_primitive(cj5__parser* parser) {
     } else if(fourcc == CJ5__FALSE_FOURCC) {
         // "false" has five characters
         type = CJ5_TOKEN_BOOL;
-        if(start + 4 >= len || json5[start+4] != 'e') {
+        if(start + 4 >= len) {
+            parser->error = CJ5_ERROR_INCOMPLETE; // Truncated at the end
+            return;
+        }
+        if(json5[start+4] != 'e') {
             parser->error = CJ5_ERROR_INVALID;
             return;
         }
@@ -307,9 +311,9 @@ cj5__skip_comment(cj5__parser* parser) {
         return;
     }
 
-    // Comment begins with '/' but not enough space for another character
+    // Comment begins with '/' but the input ends before the next character
     if(parser->pos + 1 >= parser->len) {
-        parser->error = CJ5_ERROR_INVALID;
+        parser->error = CJ5_ERROR_INCOMPLETE;
         return;
     }
     parser->pos++;
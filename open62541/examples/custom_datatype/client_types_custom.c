@@ -21,7 +21,7 @@ int main(void) {
 
     /* Attention! Here the custom datatypes are allocated on the stack. So they
      * cannot be accessed from parallel (worker) threads. */
-    UA_DataTypeArray customDataTypes = {NULL, 4, types, UA_FALSE};
+    UA_DataTypeArray customDataTypes = {NULL, 4, types, UA_FALSE, NULL};
 
     UA_Client *client = UA_Client_new();
     UA_ClientConfig *cc = UA_Client_getConfig(client);
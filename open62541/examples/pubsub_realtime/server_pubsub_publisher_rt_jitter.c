@@ -0,0 +1,334 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information. */
+
+#include <open62541/plugin/eventloop.h>
+#include <open62541/plugin/log_stdout.h>
+#include <open62541/server.h>
+#include <open62541/server_pubsub.h>
+#include <open62541/types.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if UA_MULTITHREADING < 100
+#error The example publishes from a separate thread and requires UA_MULTITHREADING >= 100
+#endif
+
+#define PUBSUB_CONFIG_PUBLISH_CYCLE_NS 250000 /* 250 µs */
+#define PUBSUB_CONFIG_FIELD_COUNT 10
+#define PUBSUB_CONFIG_CYCLES 20000 /* 5 s per measurement */
+
+/**
+ * This example measures the latency jitter of a publisher that is driven from
+ * a dedicated thread. The publish cycle is 250 µs. At the same time the main
+ * thread keeps the server busy with long-running browse requests. These hold
+ * the server lock for several milliseconds each.
+ *
+ * The measurement is done twice:
+ *
+ * - With ``UA_PUBSUB_RT_FIXED_SIZE``. The publish callback takes the server
+ *   lock and waits until the current browse request has finished.
+ * - With ``UA_PUBSUB_RT_DETERMINISTIC`` (fixed size and direct value access).
+ *   The frozen WriterGroup publishes without taking the server lock.
+ *
+ * The PubSubConnection uses a dedicated EventLoop. Otherwise sending would
+ * wait for the EventLoop of the server, which is locked together with the
+ * server lock.
+ *
+ * For every cycle the latency from the planned start of the cycle until the
+ * message has been handed to the network is recorded. For meaningful numbers,
+ * run the example with realtime priority on an isolated core. */
+
+static UA_NodeId connectionIdent, publishedDataSetIdent, writerGroupIdent;
+
+/**
+ * Direct-access data source with double-buffering. The publisher reads the
+ * ``UA_DataValue`` behind the pointer. The application writes the new value
+ * into the currently unused ``UA_DataValue`` and switches the pointer
+ * atomically. The previous value must remain valid until the next cycle. */
+static UA_UInt32 valueStore[2][PUBSUB_CONFIG_FIELD_COUNT];
+static UA_DataValue dvStore[2][PUBSUB_CONFIG_FIELD_COUNT];
+static UA_DataValue *dvPointers[PUBSUB_CONFIG_FIELD_COUNT];
+
+static void
+updateValues(UA_UInt32 counter) {
+    for(size_t i = 0; i < PUBSUB_CONFIG_FIELD_COUNT; i++) {
+        UA_DataValue *next = (dvPointers[i] == &dvStore[0][i]) ?
+            &dvStore[1][i] : &dvStore[0][i];
+        *(UA_UInt32*)next->value.data = counter;
+        UA_atomic_xchg((void**)&dvPointers[i], next);
+    }
+}
+
+/**
+ * Publisher Thread
+ * ~~~~~~~~~~~~~~~~
+ * The WriterGroup uses the custom callback mechanism. So the publish callback
+ * is executed in a dedicated thread that wakes up at the exact cycle times. */
+
+static UA_ServerCallback publishCallback;
+static void *publishData;
+static pthread_t publisherThread;
+static volatile UA_Boolean publisherDone;
+static UA_UInt64 latencies[PUBSUB_CONFIG_CYCLES]; /* in ns */
+
+static UA_UInt64
+timespecDiff(const struct timespec *a, const struct timespec *b) {
+    return (UA_UInt64)((a->tv_sec - b->tv_sec) * 1000000000 +
+                       (a->tv_nsec - b->tv_nsec));
+}
+
+static void *
+publisherLoop(void *server) {
+    struct timespec next, done;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    for(UA_UInt32 i = 0; i < PUBSUB_CONFIG_CYCLES; i++) {
+        /* Wait for the next cycle */
+        next.tv_nsec += PUBSUB_CONFIG_PUBLISH_CYCLE_NS;
+        if(next.tv_nsec >= 1000000000) {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+
+        /* Update the values and publish */
+        updateValues(i);
+        publishCallback((UA_Server*)server, publishData);
+        clock_gettime(CLOCK_MONOTONIC, &done);
+        latencies[i] = timespecDiff(&done, &next);
+
+        /* Don't try to catch up with missed cycles */
+        if(latencies[i] > PUBSUB_CONFIG_PUBLISH_CYCLE_NS)
+            next = done;
+    }
+    publisherDone = true;
+    return NULL;
+}
+
+static UA_StatusCode
+addPublisherCallback(UA_Server *server, UA_NodeId identifier,
+                     UA_ServerCallback callback, void *data,
+                     UA_Double interval_ms, UA_DateTime *baseTime,
+                     UA_TimerPolicy timerPolicy, UA_UInt64 *callbackId) {
+    publishCallback = callback;
+    publishData = data;
+    publisherDone = false;
+    if(pthread_create(&publisherThread, NULL, publisherLoop, server) != 0)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    *callbackId = 1;
+
+    /* Run the publisher with realtime priority (if permitted) */
+    struct sched_param param;
+    param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+    if(pthread_setschedparam(publisherThread, SCHED_FIFO, &param) != 0)
+        UA_LOG_WARNING(UA_Log_Stdout, UA_LOGCATEGORY_USERLAND,
+                       "Could not set the realtime priority of the publisher");
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+changePublisherCallback(UA_Server *server, UA_NodeId identifier,
+                        UA_UInt64 callbackId, UA_Double interval_ms,
+                        UA_DateTime *baseTime, UA_TimerPolicy timerPolicy) {
+    return UA_STATUSCODE_BADNOTSUPPORTED;
+}
+
+static void
+removePublisherCallback(UA_Server *server, UA_NodeId identifier,
+                        UA_UInt64 callbackId) {
+    /* The thread has finished its cycles when the WriterGroup is disabled */
+    pthread_join(publisherThread, NULL);
+}
+
+/* Dedicated EventLoop for PubSub */
+static volatile UA_Boolean pubSubELRunning = true;
+static UA_EventLoop *pubSubEL;
+
+static void *
+runPubSubEL(void *_) {
+    while(pubSubELRunning)
+        pubSubEL->run(pubSubEL, 100);
+    return NULL;
+}
+
+/**
+ * PubSub Configuration
+ * ~~~~~~~~~~~~~~~~~~~~
+ * The connection and the PublishedDataSet are the same for both
+ * measurements. The WriterGroup is created for every measurement with the
+ * RT-level under test. */
+
+static void
+addPubSubConfiguration(UA_Server *server) {
+    UA_PubSubConnectionConfig connectionConfig;
+    memset(&connectionConfig, 0, sizeof(connectionConfig));
+    connectionConfig.name = UA_STRING("UDP-UADP Connection 1");
+    connectionConfig.transportProfileUri =
+        UA_STRING("http://opcfoundation.org/UA-Profile/Transport/pubsub-udp-uadp");
+    connectionConfig.enabled = true;
+    connectionConfig.eventLoop = pubSubEL;
+    UA_NetworkAddressUrlDataType networkAddressUrl =
+        {UA_STRING_NULL , UA_STRING("opc.udp://224.0.0.22:4840/")};
+    UA_Variant_setScalar(&connectionConfig.address, &networkAddressUrl,
+                         &UA_TYPES[UA_TYPES_NETWORKADDRESSURLDATATYPE]);
+    connectionConfig.publisherIdType = UA_PUBLISHERIDTYPE_UINT16;
+    connectionConfig.publisherId.uint16 = 2234;
+    UA_Server_addPubSubConnection(server, &connectionConfig, &connectionIdent);
+
+    UA_PublishedDataSetConfig publishedDataSetConfig;
+    memset(&publishedDataSetConfig, 0, sizeof(UA_PublishedDataSetConfig));
+    publishedDataSetConfig.publishedDataSetType = UA_PUBSUB_DATASET_PUBLISHEDITEMS;
+    publishedDataSetConfig.name = UA_STRING("Demo PDS");
+    UA_Server_addPublishedDataSet(server, &publishedDataSetConfig,
+                                  &publishedDataSetIdent);
+
+    UA_DataSetFieldConfig dsfConfig;
+    for(size_t i = 0; i < PUBSUB_CONFIG_FIELD_COUNT; i++) {
+        for(size_t j = 0; j < 2; j++) {
+            UA_Variant_setScalar(&dvStore[j][i].value, &valueStore[j][i],
+                                 &UA_TYPES[UA_TYPES_UINT32]);
+            dvStore[j][i].hasValue = true;
+        }
+        dvPointers[i] = &dvStore[0][i];
+
+        memset(&dsfConfig, 0, sizeof(UA_DataSetFieldConfig));
+        dsfConfig.field.variable.rtValueSource.rtFieldSourceEnabled = true;
+        dsfConfig.field.variable.rtValueSource.staticValueSource = &dvPointers[i];
+        UA_NodeId dataSetFieldIdent;
+        UA_Server_addDataSetField(server, publishedDataSetIdent, &dsfConfig,
+                                  &dataSetFieldIdent);
+    }
+}
+
+static void
+addWriterGroup(UA_Server *server, UA_PubSubRTLevel rtLevel) {
+    UA_WriterGroupConfig writerGroupConfig;
+    memset(&writerGroupConfig, 0, sizeof(UA_WriterGroupConfig));
+    writerGroupConfig.name = UA_STRING("Demo WriterGroup");
+    writerGroupConfig.publishingInterval = PUBSUB_CONFIG_PUBLISH_CYCLE_NS / 1e6;
+    writerGroupConfig.writerGroupId = 100;
+    writerGroupConfig.encodingMimeType = UA_PUBSUB_ENCODING_UADP;
+    writerGroupConfig.rtLevel = rtLevel;
+    writerGroupConfig.pubsubManagerCallback.addCustomCallback = addPublisherCallback;
+    writerGroupConfig.pubsubManagerCallback.changeCustomCallback = changePublisherCallback;
+    writerGroupConfig.pubsubManagerCallback.removeCustomCallback = removePublisherCallback;
+
+    UA_UadpWriterGroupMessageDataType writerGroupMessage;
+    UA_UadpWriterGroupMessageDataType_init(&writerGroupMessage);
+    writerGroupMessage.networkMessageContentMask = (UA_UadpNetworkMessageContentMask)
+        (UA_UADPNETWORKMESSAGECONTENTMASK_PUBLISHERID |
+         UA_UADPNETWORKMESSAGECONTENTMASK_GROUPHEADER |
+         UA_UADPNETWORKMESSAGECONTENTMASK_WRITERGROUPID |
+         UA_UADPNETWORKMESSAGECONTENTMASK_SEQUENCENUMBER |
+         UA_UADPNETWORKMESSAGECONTENTMASK_PAYLOADHEADER);
+    UA_ExtensionObject_setValue(&writerGroupConfig.messageSettings, &writerGroupMessage,
+                                &UA_TYPES[UA_TYPES_UADPWRITERGROUPMESSAGEDATATYPE]);
+    UA_Server_addWriterGroup(server, connectionIdent, &writerGroupConfig,
+                             &writerGroupIdent);
+
+    UA_DataSetWriterConfig dataSetWriterConfig;
+    memset(&dataSetWriterConfig, 0, sizeof(UA_DataSetWriterConfig));
+    dataSetWriterConfig.name = UA_STRING("Demo DataSetWriter");
+    dataSetWriterConfig.dataSetWriterId = 62541;
+    dataSetWriterConfig.dataSetFieldContentMask = UA_DATASETFIELDCONTENTMASK_RAWDATA;
+    UA_NodeId dataSetWriterIdent;
+    UA_Server_addDataSetWriter(server, writerGroupIdent, publishedDataSetIdent,
+                               &dataSetWriterConfig, &dataSetWriterIdent);
+}
+
+/**
+ * Measurement
+ * ~~~~~~~~~~~
+ * While the publisher thread runs, the main thread processes the server
+ * EventLoop and browses the entire information model recursively. */
+
+static int
+cmpLatency(const void *a, const void *b) {
+    UA_UInt64 la = *(const UA_UInt64*)a, lb = *(const UA_UInt64*)b;
+    return (la > lb) - (la < lb);
+}
+
+static void
+measure(UA_Server *server, UA_PubSubRTLevel rtLevel, const char *name) {
+    addWriterGroup(server, rtLevel);
+    UA_Server_freezeWriterGroupConfiguration(server, writerGroupIdent);
+    UA_Server_setWriterGroupOperational(server, writerGroupIdent);
+
+    /* Generate load on the server lock until the publisher is done */
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_ROOTFOLDER);
+    bd.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_REFERENCES);
+    bd.includeSubtypes = true;
+    bd.browseDirection = UA_BROWSEDIRECTION_BOTH;
+    size_t browses = 0;
+    while(!publisherDone) {
+        UA_Server_run_iterate(server, false);
+        size_t resultsSize = 0;
+        UA_ExpandedNodeId *results = NULL;
+        UA_Server_browseRecursive(server, &bd, &resultsSize, &results);
+        UA_Array_delete(results, resultsSize, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+        browses++;
+    }
+
+    UA_Server_setWriterGroupDisabled(server, writerGroupIdent);
+    UA_Server_unfreezeWriterGroupConfiguration(server, writerGroupIdent);
+    UA_Server_removeWriterGroup(server, writerGroupIdent);
+
+    /* Print the statistics */
+    UA_UInt64 sum = 0, missed = 0;
+    for(size_t i = 0; i < PUBSUB_CONFIG_CYCLES; i++) {
+        sum += latencies[i];
+        if(latencies[i] > PUBSUB_CONFIG_PUBLISH_CYCLE_NS)
+            missed++;
+    }
+    qsort(latencies, PUBSUB_CONFIG_CYCLES, sizeof(UA_UInt64), cmpLatency);
+    printf("%s (%lu concurrent recursive browse requests)\n"
+           "  latency min %lu us, avg %lu us, p99 %lu us, p99.9 %lu us, max %lu us\n"
+           "  %lu of %u cycles exceeded the publishing interval\n", name,
+           (unsigned long)browses, (unsigned long)(latencies[0] / 1000),
+           (unsigned long)(sum / PUBSUB_CONFIG_CYCLES / 1000),
+           (unsigned long)(latencies[PUBSUB_CONFIG_CYCLES * 99 / 100] / 1000),
+           (unsigned long)(latencies[PUBSUB_CONFIG_CYCLES * 999 / 1000] / 1000),
+           (unsigned long)(latencies[PUBSUB_CONFIG_CYCLES - 1] / 1000),
+           (unsigned long)missed, PUBSUB_CONFIG_CYCLES);
+}
+
+int main(void) {
+    UA_Server *server = UA_Server_new();
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    UA_Logger logger = UA_Log_Stdout_withLevel(UA_LOGLEVEL_WARNING);
+    logger.clear = config->logging->clear;
+    *config->logging = logger;
+
+    pubSubEL = UA_EventLoop_new_POSIX(config->logging);
+    UA_ConnectionManager *udpCM =
+        UA_ConnectionManager_new_POSIX_UDP(UA_STRING("udp connection manager"));
+    pubSubEL->registerEventSource(pubSubEL, (UA_EventSource *)udpCM);
+    pubSubEL->start(pubSubEL);
+    pthread_t pubSubELThread;
+    pthread_create(&pubSubELThread, NULL, runPubSubEL, NULL);
+
+    addPubSubConfiguration(server);
+    UA_StatusCode retval = UA_Server_run_startup(server);
+    if(retval == UA_STATUSCODE_GOOD) {
+        measure(server, UA_PUBSUB_RT_FIXED_SIZE,
+                "UA_PUBSUB_RT_FIXED_SIZE (publishing takes the server lock)");
+        measure(server, UA_PUBSUB_RT_DETERMINISTIC,
+                "UA_PUBSUB_RT_DETERMINISTIC (publishing without the server lock)");
+        retval = UA_Server_run_shutdown(server);
+    }
+
+    pubSubELRunning = false;
+    pthread_join(pubSubELThread, NULL);
+    pubSubEL->stop(pubSubEL);
+    while(pubSubEL->state != UA_EVENTLOOPSTATE_STOPPED)
+        pubSubEL->run(pubSubEL, 0);
+    pubSubEL->free(pubSubEL);
+
+    UA_Server_delete(server);
+    return retval == UA_STATUSCODE_GOOD ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -147,13 +147,19 @@ typedef void (*UA_Client_DeleteMonitoredItemCallback)
     (UA_Client *client, UA_UInt32 subId, void *subContext,
      UA_UInt32 monId, void *monContext);
 
-/* Callback for DataChange notifications */
+/* Callback for DataChange notifications. The value is released after the
+ * callback returns. It has to be copied with UA_DataValue_copy if it shall be
+ * kept. Moving the value out (taking over its pointers and resetting the
+ * DataValue) is no longer possible, since the Publish responses of the client
+ * are decoded into a memory arena that is released in one piece. */
 typedef void (*UA_Client_DataChangeNotificationCallback)
     (UA_Client *client, UA_UInt32 subId, void *subContext,
      UA_UInt32 monId, void *monContext,
      UA_DataValue *value);
 
-/* Callback for Event notifications */
+/* Callback for Event notifications. The event fields are released after the
+ * callback returns. Like the DataChange values, they have to be copied (not
+ * moved) if they shall be kept. */
 typedef void (*UA_Client_EventNotificationCallback)
     (UA_Client *client, UA_UInt32 subId, void *subContext,
      UA_UInt32 monId, void *monContext,
@@ -376,6 +376,32 @@ struct UA_ConnectionManager {
     void
     (*freeNetworkBuffer)(UA_ConnectionManager *cm, uintptr_t connectionId,
                          UA_ByteString *buf);
+
+    /* Batched Sending
+     * ~~~~~~~~~~~~~~~
+     * Send several messages over a Connection at once. This has the same
+     * semantics as calling sendWithConnection for every buffer in order. But
+     * the ConnectionManager can hand the messages to the operating system with
+     * fewer calls (e.g. with sendmmsg for UDP). All buffers are released
+     * internally, also if sending fails. This method is optional and can be
+     * NULL. Then sendWithConnection is used instead. */
+    UA_StatusCode
+    (*sendBatchWithConnection)(UA_ConnectionManager *cm, uintptr_t connectionId,
+                               const UA_KeyValueMap *params,
+                               UA_ByteString *bufs, size_t bufsSize);
+
+    /* Sending from a Retained Buffer
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     * Send a message from a buffer that remains with the caller. The buffer is
+     * allocated with allocNetworkBuffer and is not released, also not if
+     * sending fails. The message has been handed over to the operating system
+     * when the method returns. So the caller can modify the buffer and send it
+     * again. Eventually the buffer is released with freeNetworkBuffer. This
+     * method is optional and can be NULL. */
+    UA_StatusCode
+    (*sendRetainedWithConnection)(UA_ConnectionManager *cm, uintptr_t connectionId,
+                                  const UA_KeyValueMap *params,
+                                  const UA_ByteString *buf);
 };
 
 /**
@@ -430,7 +456,21 @@ struct UA_InterruptManager {
  * POSIX-Specific Implementation
  * -----------------------------
  * The POSIX compatibility of WIN32 is 'close enough'. So a joint implementation
- * is provided. */
+ * is provided.
+ *
+ * **Configuration parameters of the EventLoop:**
+ *
+ * 0:backend [string]
+ *    Mechanism for waiting on the sockets. Evaluated when the EventLoop is
+ *    started. With "io_uring" the EventLoop receives and sends for the TCP
+ *    connections asynchronously. Received data is placed in buffers that are
+ *    provided to the kernel (IORING_OP_PROVIDE_BUFFERS). All pending requests
+ *    are submitted together with the wait in a single system call per
+ *    iteration (Linux 5.11 or newer). The other sockets (e.g. UDP and
+ *    Ethernet) are only polled for readiness and do their I/O with the usual
+ *    system calls. Falls back to the default
+ *    if io_uring is not available (default: epoll on Linux, select
+ *    otherwise). */
 
 #if defined(UA_ARCHITECTURE_POSIX) || defined(UA_ARCHITECTURE_WIN32)
 
@@ -462,6 +502,25 @@ UA_EventLoop_new_POSIX(const UA_Logger *logger);
  * 0:recv-bufsize [uint32]
  *    Size of the buffer that is allocated for receiving messages (default 64kB).
  *
+ * 0:send-queue-limit [uint32]
+ *    Sending never blocks. Data that the socket cannot take right away is
+ *    queued per connection and sent when the socket becomes writable. If the
+ *    queued data would exceed this number of bytes, the connection is closed
+ *    (default: 0, no limit).
+ *
+ * 0:send-pool-size [uint32]
+ *    Number of network buffers for sending that are kept in a pool and reused.
+ *    This avoids heap allocations for every outgoing message. Buffers are
+ *    taken from the heap if the pool is exhausted. Set to zero to disable the
+ *    pool (default: 16).
+ *
+ * 0:send-pool-bufsize [uint32]
+ *    Size of each pooled send buffer. Larger buffers are taken from the heap.
+ *    Should match the negotiated send buffer size of the connections. If not
+ *    set, the size of the first requested buffer is used. The SecureChannels
+ *    request buffers of their negotiated send buffer size. So the pool adapts
+ *    to it if all connections negotiate the same size (default: not set).
+ *
  * **Open Connection Parameters:**
  *
  * 0:address [string | array of string]
@@ -513,6 +572,20 @@ UA_ConnectionManager_new_POSIX_TCP(const UA_String eventSourceName);
  *    Size of the buffer that is allocated for receiving messages (default
  *    64kB).
  *
+ * 0:recv-batchsize [uint32]
+ *    Maximum number of datagrams that are received with a single system call
+ *    (recvmmsg). Only used on Linux. Each datagram gets a receive buffer of
+ *    recv-bufsize (default: 1, no batching).
+ *
+ * 0:send-pool-size [uint32]
+ *    Number of pooled network buffers for sending (default: 16). See the TCP
+ *    ConnectionManager.
+ *
+ * 0:send-pool-bufsize [uint32]
+ *    Size of each pooled send buffer. If not set, the size of the first
+ *    requested buffer is used (e.g. the first PubSub NetworkMessage). See the
+ *    TCP ConnectionManager.
+ *
  * **Open Connection Parameters:**
  *
  * 0:listen [boolean]
@@ -568,6 +641,27 @@ UA_ConnectionManager_new_POSIX_TCP(const UA_String eventSourceName);
 UA_EXPORT UA_ConnectionManager *
 UA_ConnectionManager_new_POSIX_UDP(const UA_String eventSourceName);
 
+/**
+ * Send Buffer Pool Statistics
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * The TCP and UDP ConnectionManagers hand out network buffers from a pool of
+ * fixed-size buffers. The statistics show whether the pool is large enough to
+ * serve the steady-state sending without heap allocations. */
+
+typedef struct {
+    size_t bufSize;    /* Size of the pooled buffers (zero until the first
+                        * allocation if it is not configured) */
+    size_t poolSize;   /* Number of pooled buffers */
+    size_t inUse;      /* Pooled buffers currently handed out */
+    size_t maxInUse;   /* Maximum of inUse so far */
+    size_t poolAllocs; /* Buffers served from the pool */
+    size_t heapAllocs; /* Buffers allocated on the heap instead */
+} UA_NetworkBufferPoolStatistics;
+
+UA_EXPORT void
+UA_ConnectionManager_getSendPoolStatistics_POSIX(UA_ConnectionManager *cm,
+                                                 UA_NetworkBufferPoolStatistics *stats);
+
 #if defined(__linux__) /* Linux only so far */
 /**
  * Ethernet Connection Manager
@@ -267,6 +267,33 @@ struct UA_ServerConfig {
     UA_Server_AsyncOperationNotifyCallback asyncOperationNotifyCallback;
 #endif
 
+    /**
+     * Concurrent Services
+     * ^^^^^^^^^^^^^^^^^^^
+     * By default all services are serialized with a single server lock. With
+     * the shared service lock, read-only services (Read, Browse, BrowseNext,
+     * TranslateBrowsePathsToNodeIds, HistoryRead and the corresponding
+     * functions of the local server API) can execute in parallel from several
+     * threads. Services that modify the server take exclusive access. The
+     * option must not be changed while the server is running. User callbacks
+     * invoked from the read-only services (e.g. DataSources and the
+     * AccessControl plugin) must then be thread-safe and must not modify the
+     * information model. Attempts to add, delete or edit nodes from these
+     * callbacks fail with ``BadInvalidState``. The server serializes the calls into the
+     * HistoryDatabase plugin.
+     *
+     * The service requests received over the network are processed in the
+     * EventLoop thread by default. With ``serviceWorkers > 0``, the decoded
+     * requests are handed to a pool of worker threads instead. The requests of
+     * a SecureChannel are processed one after the other. So the responses are
+     * sent in the order of the requests. Requests of different SecureChannels
+     * are processed in parallel. Without the shared service lock, only the
+     * decoding and encoding happens concurrently to the other services. */
+#if UA_MULTITHREADING >= 100
+    UA_Boolean sharedServiceLock;
+    size_t serviceWorkers; /* 0 -> process in the EventLoop thread */
+#endif
+
     /**
      * Discovery
      * ^^^^^^^^^ */
@@ -1561,7 +1588,15 @@ UA_Server_deleteReference(UA_Server *server, const UA_NodeId sourceNodeId,
  * needed. ``deleteEventNode`` specifies whether the node representation of the
  * event should be deleted after invoking the method. This can be useful if
  * events with the similar attributes are triggered frequently. ``UA_TRUE``
- * would cause the node to be deleted. */
+ * would cause the node to be deleted.
+ *
+ * The method ``UA_Server_triggerEventFields`` triggers an event without
+ * creating a node representation. The event fields are given as a key-value
+ * map where the key is the BrowseName of the field (e.g. ``0:Severity``). The
+ * EventFilters of the monitored items are evaluated directly on the map. Only
+ * the value attribute of direct children of the event can be selected in this
+ * case. This avoids the overhead of adding and deleting nodes when many events
+ * are triggered. */
 
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
 
@@ -1590,6 +1625,22 @@ UA_Server_triggerEvent(UA_Server *server, const UA_NodeId eventNodeId,
                        const UA_NodeId originId, UA_ByteString *outEventId,
                        const UA_Boolean deleteEventNode);
 
+/* Triggers an event from a map of its fields without node representation.
+ * The fields EventId, EventType, SourceNode and ReceiveTime are set
+ * automatically. Time is set to the current time if not contained in the map.
+ * The eventType must not be a ConditionType. Use the A&C API for conditions.
+ *
+ * @param server The server object
+ * @param eventType The type of the event. Must be a subtype of BaseEventType.
+ * @param originId The node that emits the event
+ * @param fields The event fields with the BrowseName as key. Can be NULL.
+ * @param outEventId The EventId of the new event. Can be NULL.
+ * @return The StatusCode of the UA_Server_triggerEventFields method */
+UA_StatusCode UA_EXPORT UA_THREADSAFE
+UA_Server_triggerEventFields(UA_Server *server, const UA_NodeId eventType,
+                             const UA_NodeId originId, const UA_KeyValueMap *fields,
+                             UA_ByteString *outEventId);
+
 #endif /* UA_ENABLE_SUBSCRIPTIONS_EVENTS */
 
 /**
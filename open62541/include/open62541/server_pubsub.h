@@ -472,11 +472,26 @@ typedef enum {
  * UA_PUBSUB_RT_FIXED_SIZE
  *    Validate that the message constains only fields with a known size.
  *    Then the message fields have fixed offsets that are known ahead of time.
+ *    The pre-encoded message is kept in a send buffer of the
+ *    ConnectionManager. Each cycle only the changing fields are written into
+ *    that buffer, which is then sent without a copy. The UDP and Ethernet
+ *    ConnectionManagers support sending from a retained buffer. With other
+ *    ConnectionManagers the buffer is copied for each send.
  *
  * UA_PUBSUB_RT_DETERMINISTIC
  *    Both direct-access and fixed-size is being used. The server pre-allocates
  *    buffers when the configuration is frozen and uses only memcpy operations
- *    to update the PubSub network messages for sending.
+ *    to update the PubSub network messages for sending. Once the
+ *    configuration is frozen, publishing does not take the server lock. So
+ *    the publish callback is not delayed by long-running services and can be
+ *    driven from a dedicated thread (see the ``pubsubManagerCallback`` of the
+ *    WriterGroup). The ``UA_DataValue`` behind the double-pointer is read only
+ *    once per cycle. The application writes a new value into a second
+ *    ``UA_DataValue`` and then switches the pointer atomically
+ *    (double-buffering). The previous ``UA_DataValue`` must remain unchanged
+ *    until the next publish cycle has started. The PubSubConnection should
+ *    use a dedicated EventLoop. Otherwise sending waits for the EventLoop of
+ *    the server, which is locked together with the server.
  *
  * WARNING! For hard real time requirements the underlying system must be
  * RT-capable. Also note that each PubSubConnection can have a dedicated
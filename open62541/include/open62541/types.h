@@ -1077,6 +1077,10 @@ struct UA_DataType {
     UA_DataTypeMember *members;
 };
 
+/* Hash index for looking up data types by their NodeId */
+struct UA_DataTypeIndex;
+typedef struct UA_DataTypeIndex UA_DataTypeIndex;
+
 /* Datatype arrays with custom type definitions can be added in a linked list to
  * the client or server configuration. */
 typedef struct UA_DataTypeArray {
@@ -1086,8 +1090,32 @@ typedef struct UA_DataTypeArray {
     UA_Boolean cleanup; /* Free the array structure and its content
                            when the client or server configuration
                            containing it is cleaned up */
+    UA_DataTypeIndex *index; /* Optional, see UA_DataTypeArray_buildIndex */
 } UA_DataTypeArray;
 
+/* Build a hash index for looking up the types of the array by their typeId
+ * and binaryEncodingId. Without the index, a linear search is used. Does
+ * nothing if the index exists already. Afterwards the NodeIds of the types must
+ * not change, except for their namespace index. The index is freed by
+ * _clearIndex or together with the array if the cleanup flag is set. */
+UA_StatusCode UA_EXPORT
+UA_DataTypeArray_buildIndex(UA_DataTypeArray *customTypes);
+
+/* Declares storage for the index of an array with up to typesSize types */
+#define UA_DATATYPEINDEX_STORAGE(name, typesSize)                      \
+    void *name[4 + 8 * ((typesSize) < 4 ? 4 : (typesSize))]
+
+/* Build the index in the given storage instead of the heap. For statically
+ * allocated arrays (e.g. generated by the nodeset compiler) that live until
+ * the end of the program. Use UA_DATATYPEINDEX_STORAGE to declare the storage.
+ * Returns UA_STATUSCODE_BADINVALIDARGUMENT if it is too small. */
+UA_StatusCode UA_EXPORT
+UA_DataTypeArray_buildIndexStatic(UA_DataTypeArray *customTypes,
+                                  void *storage, size_t storageSize);
+
+void UA_EXPORT
+UA_DataTypeArray_clearIndex(UA_DataTypeArray *customTypes);
+
 /* Returns the offset and type of a structure member. The return value is false
  * if the member was not found.
  *
@@ -1215,6 +1243,52 @@ UA_INLINABLE(UA_Boolean
     return (UA_order(p1, p2, type) == UA_ORDER_EQ);
 })
 
+/**
+ * Memory Arena
+ * ------------
+ *
+ * An arena hands out memory from large blocks with a pointer bump. The
+ * individual allocations are not freed. Instead all memory is released at
+ * once with ``UA_Arena_reset``. This is used for the decoding of messages with
+ * a short lifetime, where the decoded value would otherwise require one heap
+ * allocation for every string and array.
+ *
+ * After a reset, the arena keeps one block for reuse. If the last usage
+ * required more than one block, the block size is increased (up to
+ * ``UA_ARENA_MAXBLOCKSIZE``) so that a similar message later fits into a
+ * single block. An arena is not thread-safe. */
+
+#define UA_ARENA_DEFAULTBLOCKSIZE 4096
+#define UA_ARENA_MAXBLOCKSIZE (1 << 20)
+
+struct UA_ArenaBlock;
+typedef struct UA_ArenaBlock UA_ArenaBlock;
+
+typedef struct {
+    UA_ArenaBlock *blocks; /* The current block is the first */
+    size_t blockSize;      /* Usable size of new blocks */
+
+    /* Statistics since the last reset */
+    size_t allocations;      /* Number of allocations from the arena */
+    size_t blockAllocations; /* Number of blocks allocated on the heap */
+} UA_Arena;
+
+/* A zeroed-out arena is also initialized with the default block size */
+UA_EXPORT void
+UA_Arena_init(UA_Arena *arena, size_t blockSize);
+
+/* Returns zeroed memory aligned to eight bytes or NULL if out of memory */
+UA_EXPORT void *
+UA_Arena_alloc(UA_Arena *arena, size_t size);
+
+/* Release all allocations at once. One block is kept for reuse. */
+UA_EXPORT void
+UA_Arena_reset(UA_Arena *arena);
+
+/* Free all memory held by the arena */
+UA_EXPORT void
+UA_Arena_clear(UA_Arena *arena);
+
 /**
  * Binary Encoding/Decoding
  * ------------------------
@@ -1241,6 +1315,14 @@ UA_encodeBinary(const void *p, const UA_DataType *type,
 typedef struct {
     const UA_DataTypeArray *customTypes; /* Begin of a linked list with custom
                                           * datatype definitions */
+    UA_Arena *arena; /* If set, all memory for the decoded value is taken from
+                      * the arena. Such values must not be cleared with
+                      * UA_clear. They are released with UA_Arena_reset. */
+    UA_Boolean zeroCopy; /* Strings, ByteStrings, XmlElements and arrays of
+                          * overlayable types (e.g. numeric arrays) point into
+                          * the input buffer instead of being copied. The
+                          * decoded value is only valid while the input buffer
+                          * is unchanged. Requires the arena to be set. */
 } UA_DecodeBinaryOptions;
 
 /* Decodes a data structure from the input buffer in the binary format. It is
@@ -1334,6 +1416,45 @@ UA_StatusCode UA_EXPORT
 UA_decodeJson(const UA_ByteString *src, void *dst, const UA_DataType *type,
               const UA_DecodeJsonOptions *options);
 
+/* UA_decodeJson tokenizes the entire document before decoding. For large
+ * documents with many values, the stream decoder takes the input in chunks and
+ * decodes one value at a time. The input is either a JSON array (the elements
+ * are decoded) or a sequence of JSON values separated by whitespace or commas
+ * (e.g. one value per line). Only the current value is buffered and tokenized.
+ * So the memory use is bounded by the largest value and the chunk size and not
+ * by the size of the document.
+ *
+ * Every decoded value is passed to the callback. The value is cleared after the
+ * callback returns. The callback can take over the content by moving it out and
+ * zeroing the value. Decoding aborts if the callback returns an error. */
+
+struct UA_DecodeJsonStream;
+typedef struct UA_DecodeJsonStream UA_DecodeJsonStream;
+
+typedef UA_StatusCode
+(*UA_DecodeJsonStreamCallback)(void *context, void *value);
+
+/* Create a stream decoder for values of the given type. The options (can be
+ * NULL) are copied. But the arrays they point to must remain valid. */
+UA_DecodeJsonStream UA_EXPORT *
+UA_DecodeJsonStream_new(const UA_DataType *type,
+                        const UA_DecodeJsonOptions *options,
+                        UA_DecodeJsonStreamCallback callback, void *context);
+
+/* Decode the values that are complete with the next chunk of input. Errors are
+ * sticky. After an error, every following call returns the same error. */
+UA_StatusCode UA_EXPORT
+UA_DecodeJsonStream_decode(UA_DecodeJsonStream *stream,
+                           const UA_ByteString *chunk);
+
+/* Signal the end of the input. Decodes a trailing value (e.g. a number) that
+ * could not be delimited before. Returns an error if the input is incomplete. */
+UA_StatusCode UA_EXPORT
+UA_DecodeJsonStream_finish(UA_DecodeJsonStream *stream);
+
+void UA_EXPORT
+UA_DecodeJsonStream_delete(UA_DecodeJsonStream *stream);
+
 #endif /* UA_ENABLE_JSON_ENCODING */
 
 /**
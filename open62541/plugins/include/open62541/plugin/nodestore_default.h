@@ -18,6 +18,16 @@ _UA_BEGIN_DECLS
 UA_EXPORT UA_StatusCode
 UA_Nodestore_HashMap(UA_Nodestore *ns);
 
+/* Variant of the HashMap Nodestore where ``getNode``, ``getNodeFromPtr`` and
+ * ``releaseNode`` can be called from several threads without any lock. Also
+ * while another thread modifies the Nodestore. The modifying operations
+ * (``insertNode``, ``replaceNode``, ``removeNode`` and ``iterate``) still need
+ * to be serialized, as is done by the server lock. Replaced and removed nodes
+ * are freed with a delay, once no reader can access them anymore. Requires
+ * UA_MULTITHREADING >= 100 for the atomic operations. */
+UA_EXPORT UA_StatusCode
+UA_Nodestore_HashMapConcurrent(UA_Nodestore *ns);
+
 /* The ZipTree Nodestore holds all nodes in RAM in a tree structure. The lookup
  * time is about O(log n). Adding/removing nodes does not require resizing of
  * the underlying array with the linear overhead.
@@ -902,145 +902,277 @@ const parseJsonSignature parseJsonJumpTable[UA_SERVERCONFIGFIELDKINDS] = {
     (parseJsonSignature)RuleHandlingField_parseJson,
 };
 
+/* Parse the value of a top-level field. The index points to the (key) token
+ * before the value. */
 static UA_StatusCode
-parseJSONConfig(UA_ServerConfig *config, UA_ByteString json_config) {
-    // Parsing json config
-    const char *json = (const char*)json_config.data;
-    cj5_token tokens[MAX_TOKENS];
-    cj5_result r = cj5_parse(json, (unsigned int)json_config.length, tokens, MAX_TOKENS, NULL);
-
-    ParsingCtx ctx;
-    ctx.json = json;
-    ctx.result = r;
-    ctx.tokens = r.tokens;
-    ctx.tokensSize = r.num_tokens;
-    ctx.index = 1; // The first token is ignored because it is known and not needed.
-
-    size_t serverConfigSize = 0;
-    if(ctx.tokens)
-        serverConfigSize = (ctx.tokens[ctx.index-1].size/2);
+parseJSONConfigField(UA_ServerConfig *config, ParsingCtx *ctx, const char *field) {
     UA_StatusCode retval = UA_STATUSCODE_GOOD;
-    for (size_t j = serverConfigSize; j > 0; j--) {
-        cj5_token tok = ctx.tokens[ctx.index];
-        switch (tok.type) {
-            case CJ5_TOKEN_STRING: {
-                char *field = (char*)UA_malloc(tok.size + 1);
-                unsigned int str_len = 0;
-                cj5_get_str(&ctx.result, (unsigned int)ctx.index, field, &str_len);
-                if(strcmp(field, "buildInfo") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_BUILDINFO](&ctx, &config->buildInfo, NULL);
-                else if(strcmp(field, "applicationDescription") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_APPLICATIONDESCRIPTION](&ctx, &config->applicationDescription, NULL);
-                else if(strcmp(field, "shutdownDelay") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_DOUBLE](&ctx, &config->shutdownDelay, NULL);
-                else if(strcmp(field, "verifyRequestTimestamp") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_RULEHANDLING](&ctx, &config->verifyRequestTimestamp, NULL);
-                else if(strcmp(field, "allowEmptyVariables") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_RULEHANDLING](&ctx, &config->allowEmptyVariables, NULL);
-                else if(strcmp(field, "serverUrls") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_STRINGARRAY](&ctx, &config->serverUrls, &config->serverUrlsSize);
-                else if(strcmp(field, "tcpEnabled") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](&ctx, &config->tcpEnabled, NULL);
-                else if(strcmp(field, "tcp") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_TCPCONFIGURATION](&ctx, config, NULL);
-                else if(strcmp(field, "securityPolicyNoneDiscoveryOnly") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](&ctx, &config->securityPolicyNoneDiscoveryOnly, NULL);
-                else if(strcmp(field, "modellingRulesOnInstances") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](&ctx, &config->modellingRulesOnInstances, NULL);
-                else if(strcmp(field, "maxSecureChannels") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT16](&ctx, &config->maxSecureChannels, NULL);
-                else if(strcmp(field, "maxSecurityTokenLifetime") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->maxSecurityTokenLifetime, NULL);
-                else if(strcmp(field, "maxSessions") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT16](&ctx, &config->maxSessions, NULL);
-                else if(strcmp(field, "maxSessionTimeout") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_DOUBLE](&ctx, &config->maxSessionTimeout, NULL);
-                else if(strcmp(field, "maxNodesPerRead") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->maxNodesPerRead, NULL);
-                else if(strcmp(field, "maxNodesPerWrite") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->maxNodesPerWrite, NULL);
-                else if(strcmp(field, "maxNodesPerMethodCall") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->maxNodesPerMethodCall, NULL);
-                else if(strcmp(field, "maxNodesPerBrowse") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->maxNodesPerBrowse, NULL);
-                else if(strcmp(field, "maxNodesPerRegisterNodes") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->maxNodesPerRegisterNodes, NULL);
-                else if(strcmp(field, "maxNodesPerTranslateBrowsePathsToNodeIds") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->maxNodesPerTranslateBrowsePathsToNodeIds, NULL);
-                else if(strcmp(field, "maxNodesPerNodeManagement") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->maxNodesPerNodeManagement, NULL);
-                else if(strcmp(field, "maxMonitoredItemsPerCall") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->maxMonitoredItemsPerCall, NULL);
-                else if(strcmp(field, "maxReferencesPerNode") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->maxReferencesPerNode, NULL);
-                else if(strcmp(field, "reverseReconnectInterval") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->reverseReconnectInterval, NULL);
+    if(strcmp(field, "buildInfo") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_BUILDINFO](ctx, &config->buildInfo, NULL);
+    else if(strcmp(field, "applicationDescription") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_APPLICATIONDESCRIPTION](ctx, &config->applicationDescription, NULL);
+    else if(strcmp(field, "shutdownDelay") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_DOUBLE](ctx, &config->shutdownDelay, NULL);
+    else if(strcmp(field, "verifyRequestTimestamp") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_RULEHANDLING](ctx, &config->verifyRequestTimestamp, NULL);
+    else if(strcmp(field, "allowEmptyVariables") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_RULEHANDLING](ctx, &config->allowEmptyVariables, NULL);
+    else if(strcmp(field, "serverUrls") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_STRINGARRAY](ctx, &config->serverUrls, &config->serverUrlsSize);
+    else if(strcmp(field, "tcpEnabled") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](ctx, &config->tcpEnabled, NULL);
+    else if(strcmp(field, "tcp") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_TCPCONFIGURATION](ctx, config, NULL);
+    else if(strcmp(field, "securityPolicyNoneDiscoveryOnly") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](ctx, &config->securityPolicyNoneDiscoveryOnly, NULL);
+    else if(strcmp(field, "modellingRulesOnInstances") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](ctx, &config->modellingRulesOnInstances, NULL);
+    else if(strcmp(field, "maxSecureChannels") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT16](ctx, &config->maxSecureChannels, NULL);
+    else if(strcmp(field, "maxSecurityTokenLifetime") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](ctx, &config->maxSecurityTokenLifetime, NULL);
+    else if(strcmp(field, "maxSessions") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT16](ctx, &config->maxSessions, NULL);
+    else if(strcmp(field, "maxSessionTimeout") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_DOUBLE](ctx, &config->maxSessionTimeout, NULL);
+    else if(strcmp(field, "maxNodesPerRead") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](ctx, &config->maxNodesPerRead, NULL);
+    else if(strcmp(field, "maxNodesPerWrite") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](ctx, &config->maxNodesPerWrite, NULL);
+    else if(strcmp(field, "maxNodesPerMethodCall") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](ctx, &config->maxNodesPerMethodCall, NULL);
+    else if(strcmp(field, "maxNodesPerBrowse") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](ctx, &config->maxNodesPerBrowse, NULL);
+    else if(strcmp(field, "maxNodesPerRegisterNodes") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](ctx, &config->maxNodesPerRegisterNodes, NULL);
+    else if(strcmp(field, "maxNodesPerTranslateBrowsePathsToNodeIds") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](ctx, &config->maxNodesPerTranslateBrowsePathsToNodeIds, NULL);
+    else if(strcmp(field, "maxNodesPerNodeManagement") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](ctx, &config->maxNodesPerNodeManagement, NULL);
+    else if(strcmp(field, "maxMonitoredItemsPerCall") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](ctx, &config->maxMonitoredItemsPerCall, NULL);
+    else if(strcmp(field, "maxReferencesPerNode") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](ctx, &config->maxReferencesPerNode, NULL);
+    else if(strcmp(field, "reverseReconnectInterval") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](ctx, &config->reverseReconnectInterval, NULL);
 
 #if UA_MULTITHREADING >= 100
-                else if(strcmp(field, "asyncOperationTimeout") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_DOUBLE](&ctx, &config->asyncOperationTimeout, NULL);
-                else if(strcmp(field, "maxAsyncOperationQueueSize") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT64](&ctx, &config->maxAsyncOperationQueueSize, NULL);
+    else if(strcmp(field, "asyncOperationTimeout") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_DOUBLE](ctx, &config->asyncOperationTimeout, NULL);
+    else if(strcmp(field, "maxAsyncOperationQueueSize") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT64](ctx, &config->maxAsyncOperationQueueSize, NULL);
 #endif
 
 #ifdef UA_ENABLE_DISCOVERY
-                else if(strcmp(field, "discoveryCleanupTimeout") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](&ctx, &config->discoveryCleanupTimeout, NULL);
+    else if(strcmp(field, "discoveryCleanupTimeout") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32](ctx, &config->discoveryCleanupTimeout, NULL);
 #ifdef UA_ENABLE_DISCOVERY_MULTICAST
-                else if(strcmp(field, "mdnsEnabled") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](&ctx, &config->mdnsEnabled, NULL);
-                else if(strcmp(field, "mdns") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_MDNSCONFIGURATION](&ctx, config, NULL);
+    else if(strcmp(field, "mdnsEnabled") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](ctx, &config->mdnsEnabled, NULL);
+    else if(strcmp(field, "mdns") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_MDNSCONFIGURATION](ctx, config, NULL);
 #if !defined(UA_HAS_GETIFADDR)
-                else if(strcmp(field, "mdnsIpAddressList") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32ARRAY](&ctx, &config->mdnsIpAddressList, &config->mdnsIpAddressListSize);
+    else if(strcmp(field, "mdnsIpAddressList") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_UINT32ARRAY](ctx, &config->mdnsIpAddressList, &config->mdnsIpAddressListSize);
 #endif
 #endif
 #endif
 
 #ifdef UA_ENABLE_SUBSCRIPTIONS
-                else if(strcmp(field, "subscriptionsEnabled") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](&ctx, &config->subscriptionsEnabled, NULL);
-                else if(strcmp(field, "subscriptions") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_SUBSCRIPTIONCONFIGURATION](&ctx, config, NULL);
+    else if(strcmp(field, "subscriptionsEnabled") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](ctx, &config->subscriptionsEnabled, NULL);
+    else if(strcmp(field, "subscriptions") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_SUBSCRIPTIONCONFIGURATION](ctx, config, NULL);
 # endif
 
 #ifdef UA_ENABLE_HISTORIZING
-                else if(strcmp(field, "historizingEnabled") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](&ctx, &config->historizingEnabled, NULL);
-                else if(strcmp(field, "historizing") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_HISTORIZINGCONFIGURATION](&ctx, config, NULL);
+    else if(strcmp(field, "historizingEnabled") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](ctx, &config->historizingEnabled, NULL);
+    else if(strcmp(field, "historizing") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_HISTORIZINGCONFIGURATION](ctx, config, NULL);
 #endif
 
 #ifdef UA_ENABLE_PUBSUB
-                else if(strcmp(field, "pubsubEnabled") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](&ctx, &config->pubsubEnabled, NULL);
-                else if(strcmp(field, "pubsub") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_PUBSUBCONFIGURATION](&ctx, config, NULL);
+    else if(strcmp(field, "pubsubEnabled") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_BOOLEAN](ctx, &config->pubsubEnabled, NULL);
+    else if(strcmp(field, "pubsub") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_PUBSUBCONFIGURATION](ctx, &config->pubSubConfig, NULL);
 #endif
 #ifdef UA_ENABLE_ENCRYPTION
-                else if(strcmp(field, "securityPolicies") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_SECURITYPOLICIES](&ctx, config, NULL);
-                else if(strcmp(field, "secureChannelPKI") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_SECURITYPKI](&ctx, &config->secureChannelPKI, NULL);
-                else if(strcmp(field, "sessionPKI") == 0)
-                    retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_SECURITYPKI](&ctx, &config->sessionPKI, NULL);
+    else if(strcmp(field, "securityPolicies") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_SECURITYPOLICIES](ctx, config, NULL);
+    else if(strcmp(field, "secureChannelPKI") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_SECURITYPKI](ctx, &config->secureChannelPKI, NULL);
+    else if(strcmp(field, "sessionPKI") == 0)
+        retval = parseJsonJumpTable[UA_SERVERCONFIGFIELD_SECURITYPKI](ctx, &config->sessionPKI, NULL);
 #endif
-                else {
-                    UA_LOG_WARNING(UA_Log_Stdout, UA_LOGCATEGORY_USERLAND, "Field name '%s' unknown or misspelled. Maybe the feature is not enabled either.", field);
-                }
-                UA_free(field);
-                if(retval != UA_STATUSCODE_GOOD) {
-                    UA_LOG_ERROR(UA_Log_Stdout, UA_LOGCATEGORY_USERLAND, "An error occurred while parsing the configuration file.");
-                    return retval;
-                }
-                break;
+    else {
+        UA_LOG_WARNING(UA_Log_Stdout, UA_LOGCATEGORY_USERLAND, "Field name '%s' unknown or misspelled. Maybe the feature is not enabled either.", field);
+    }
+    return retval;
+}
+
+/* Skip whitespace and comments */
+static size_t
+skipJsonSpace(const char *json, size_t pos, size_t len) {
+    while(pos < len) {
+        char c = json[pos];
+        if(c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            pos++;
+        } else if(c == '#' || (c == '/' && pos + 1 < len && json[pos+1] == '/')) {
+            while(pos < len && json[pos] != '\n')
+                pos++;
+        } else if(c == '/' && pos + 1 < len && json[pos+1] == '*') {
+            for(pos += 2; pos + 1 < len; pos++) {
+                if(json[pos] == '*' && json[pos+1] == '/')
+                    break;
             }
-            default:
-                break;
+            pos += 2; /* Beyond len if the comment is not terminated */
+        } else {
+            break;
         }
-        ctx.index += 1;
     }
+    return pos;
+}
+
+/* Returns the number of bytes of the tokenized value. The closing quote of
+ * strings is not part of the token. */
+static size_t
+jsonValueLength(const cj5_token *tok) {
+    return tok->end + ((tok->type == CJ5_TOKEN_STRING) ? 2u : 1u);
+}
+
+/* The configuration is parsed one top-level field at a time. Only the value of
+ * the current field is tokenized. So the token memory is bounded by the
+ * largest field and not by the size of the file. */
+static UA_StatusCode
+parseJSONConfig(UA_ServerConfig *config, UA_ByteString json_config) {
+    const char *json = (const char*)json_config.data;
+    size_t len = json_config.length;
+    if(len > UA_UINT32_MAX)
+        return UA_STATUSCODE_BADOUTOFRANGE;
+
+    cj5_options options;
+    options.stop_early = true;
+    cj5_token stackTokens[MAX_TOKENS];
+    cj5_token *tokens = stackTokens;
+    char *field = NULL;
+    UA_StatusCode retval = UA_STATUSCODE_GOOD;
+
+    /* JSON5 allows to omit the braces of the root object */
+    size_t pos = skipJsonSpace(json, 0, len);
+    UA_Boolean braces = (pos < len && json[pos] == '{');
+    if(braces)
+        pos++;
+
+    while(true) {
+        pos = skipJsonSpace(json, pos, len);
+        if(pos >= len) {
+            if(braces)
+                goto error; /* Not closed */
+            break;
+        }
+        if(braces && json[pos] == '}')
+            break;
+
+        /* Parse the key. Unquoted keys are identifiers. */
+        cj5_result r;
+        size_t keyLen;
+        if(json[pos] == '"' || json[pos] == '\'') {
+            r = cj5_parse(json + pos, (unsigned int)(len - pos),
+                          stackTokens, 1, &options);
+            if(r.error != CJ5_ERROR_NONE || stackTokens[0].type != CJ5_TOKEN_STRING)
+                goto error;
+            field = (char*)UA_malloc(stackTokens[0].size + 1);
+            if(!field) {
+                retval = UA_STATUSCODE_BADOUTOFMEMORY;
+                goto cleanup;
+            }
+            unsigned int str_len = 0;
+            cj5_get_str(&r, 0, field, &str_len);
+            keyLen = jsonValueLength(&stackTokens[0]);
+        } else {
+            for(keyLen = 0; pos + keyLen < len; keyLen++) {
+                char c = json[pos + keyLen];
+                if(!(c >= 'a' && c <= 'z') && !(c >= 'A' && c <= 'Z') &&
+                   !(c >= '0' && c <= '9' && keyLen > 0) && c != '_' && c != '$')
+                    break;
+            }
+            if(keyLen == 0)
+                goto error;
+            field = (char*)UA_malloc(keyLen + 1);
+            if(!field) {
+                retval = UA_STATUSCODE_BADOUTOFMEMORY;
+                goto cleanup;
+            }
+            memcpy(field, json + pos, keyLen);
+            field[keyLen] = 0;
+        }
+
+        pos = skipJsonSpace(json, pos + keyLen, len);
+        if(pos >= len || json[pos] != ':')
+            goto error;
+        pos++;
+
+        /* Tokenize the value into tokens[1...]. The field parsers advance the
+         * index before reading. So tokens[0] takes the place of the key. Large
+         * values get a token array on the heap. */
+        size_t tokensSize = MAX_TOKENS;
+        memset(&stackTokens[0], 0, sizeof(cj5_token));
+    parse_value:
+        r = cj5_parse(json + pos, (unsigned int)(len - pos), tokens + 1,
+                      (unsigned int)tokensSize - 1, &options);
+        if(r.error == CJ5_ERROR_OVERFLOW && tokens == stackTokens) {
+            tokensSize = (size_t)r.num_tokens + 1;
+            tokens = (cj5_token*)UA_calloc(tokensSize, sizeof(cj5_token));
+            if(!tokens) {
+                tokens = stackTokens;
+                retval = UA_STATUSCODE_BADOUTOFMEMORY;
+                goto cleanup;
+            }
+            goto parse_value;
+        }
+        if(r.error != CJ5_ERROR_NONE)
+            goto error;
+
+        ParsingCtx ctx;
+        ctx.json = json + pos;
+        ctx.tokens = tokens;
+        ctx.result = r;
+        ctx.result.tokens = tokens;
+        ctx.result.num_tokens = r.num_tokens + 1;
+        ctx.tokensSize = r.num_tokens + 1;
+        ctx.index = 0;
+        ctx.depth = 0;
+        retval = parseJSONConfigField(config, &ctx, field);
+        if(retval != UA_STATUSCODE_GOOD)
+            goto cleanup;
+        pos += jsonValueLength(&tokens[1]);
+
+        if(tokens != stackTokens) {
+            UA_free(tokens);
+            tokens = stackTokens;
+        }
+        UA_free(field);
+        field = NULL;
+
+        /* Members are separated by commas */
+        pos = skipJsonSpace(json, pos, len);
+        if(pos < len && json[pos] == ',')
+            pos++;
+        else if(pos < len && !(braces && json[pos] == '}'))
+            goto error;
+    }
+    goto cleanup;
+
+ error:
+    retval = UA_STATUSCODE_BADDECODINGERROR;
+ cleanup:
+    if(tokens != stackTokens)
+        UA_free(tokens);
+    UA_free(field);
+    if(retval != UA_STATUSCODE_GOOD)
+        UA_LOG_ERROR(UA_Log_Stdout, UA_LOGCATEGORY_USERLAND, "An error occurred while parsing the configuration file.");
     return retval;
 }
 
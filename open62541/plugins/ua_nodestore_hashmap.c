@@ -22,8 +22,10 @@
  * - NULL: Abort the search */
 
 typedef struct UA_NodeMapEntry {
-    struct UA_NodeMapEntry *orig; /* the version this is a copy from (or NULL) */
-    UA_UInt16 refCount; /* How many consumers have a reference to the node? */
+    struct UA_NodeMapEntry *orig; /* the version this is a copy from (or NULL).
+                                   * Reused as the link in the list of retired
+                                   * entries once the entry was removed. */
+    volatile int refCount; /* How many consumers have a reference to the node? */
     UA_Boolean deleted; /* Node was marked as deleted and can be deleted when refCount == 0 */
     UA_Node node;
 } UA_NodeMapEntry;
@@ -31,20 +33,64 @@ typedef struct UA_NodeMapEntry {
 #define UA_NODEMAP_MINSIZE 64
 #define UA_NODEMAP_TOMBSTONE ((UA_NodeMapEntry*)0x01)
 
+/* The refCount is modified atomically. So several readers can get and release
+ * nodes concurrently (see the sharedServiceLock server option). The refCount is
+ * set to a negative value while the references of an entry are restructured.
+ * Readers wait until that is finished. */
+#define UA_NODEMAP_REFCOUNT_LOCKED (-0x40000000)
+
 typedef struct {
-    UA_NodeMapEntry *entry;
+    UA_NodeMapEntry * volatile entry;
     UA_UInt32 nodeIdHash;
 } UA_NodeMapSlot;
 
-typedef struct {
-    UA_NodeMapSlot *slots;
+/* The slots are allocated together with the table header. So readers get a
+ * consistent view of the slots and their number with a single pointer. */
+typedef struct UA_NodeMapTable {
+    struct UA_NodeMapTable *retiredNext;
     UA_UInt32 size;
-    UA_UInt32 count;
     UA_UInt32 sizePrimeIndex;
+    UA_NodeMapSlot *slots;
+} UA_NodeMapTable;
+
+/* Concurrent Nodestore
+ * --------------------
+ * In the concurrent variant, getNode and releaseNode can be called from any
+ * thread without holding a lock. Only the modifying operations (insert,
+ * replace, remove, iterate) are serialized by the server lock.
+ *
+ * The writer never frees memory that a reader might still access. Replaced
+ * and removed entries and the tables of an expand are "retired" instead. The
+ * readers announce their read section in a counter for the current epoch. The
+ * writer advances the epoch once no readers from the previous epoch remain.
+ * Then everything retired before the previous epoch change can no longer be
+ * reached and is freed (if not referenced anymore by the refCount). The
+ * readers are spread over several padded counters to avoid contention on a
+ * single cache line. */
+
+#define UA_NODEMAP_READERSTRIPES 16
+
+typedef struct {
+    volatile int count;
+    char padding[64 - sizeof(int)];
+} UA_NodeMapReaders;
+
+typedef struct {
+    UA_NodeMapTable * volatile table;
+    UA_UInt32 count;
 
     /* Maps ReferenceTypeIndex to the NodeId of the ReferenceType */
     UA_NodeId referenceTypeIds[UA_REFERENCETYPESET_MAX];
     UA_Byte referenceTypeCounter;
+
+    /* Epoch-based reclamation for the concurrent variant */
+    UA_Boolean concurrent;
+    volatile int epoch;
+    UA_NodeMapReaders readers[2][UA_NODEMAP_READERSTRIPES];
+    UA_NodeMapEntry *retired;         /* Retired in the current epoch */
+    UA_NodeMapEntry *retiredOld;      /* Retired before the last epoch change */
+    UA_NodeMapTable *retiredTables;
+    UA_NodeMapTable *retiredTablesOld;
 } UA_NodeMap;
 
 /*********************/
@@ -78,18 +124,31 @@ higher_prime_index(UA_UInt32 n) {
     return low;
 }
 
+static UA_NodeMapTable *
+newTable(UA_UInt32 sizePrimeIndex) {
+    UA_UInt32 size = primes[sizePrimeIndex];
+    UA_NodeMapTable *table = (UA_NodeMapTable*)
+        UA_calloc(1, sizeof(UA_NodeMapTable) + (size * sizeof(UA_NodeMapSlot)));
+    if(!table)
+        return NULL;
+    table->size = size;
+    table->sizePrimeIndex = sizePrimeIndex;
+    table->slots = (UA_NodeMapSlot*)&table[1];
+    return table;
+}
+
 /* Returns an empty slot or null if the nodeid exists or if no empty slot is found. */
 static UA_NodeMapSlot *
-findFreeSlot(const UA_NodeMap *ns, const UA_NodeId *nodeid) {
+findFreeSlot(const UA_NodeMapTable *table, const UA_NodeId *nodeid) {
     UA_UInt32 h = UA_NodeId_hash(nodeid);
-    UA_UInt32 size = ns->size;
+    UA_UInt32 size = table->size;
     UA_UInt64 idx = mod(h, size); /* Use 64bit container to avoid overflow  */
     UA_UInt32 startIdx = (UA_UInt32)idx;
     UA_UInt32 hash2 = mod2(h, size);
 
     UA_NodeMapSlot *candidate = NULL;
     do {
-        UA_NodeMapSlot *slot = &ns->slots[(UA_UInt32)idx];
+        UA_NodeMapSlot *slot = &table->slots[(UA_UInt32)idx];
 
         if(slot->entry > UA_NODEMAP_TOMBSTONE) {
             /* A Node with the NodeId does already exist */
@@ -113,38 +172,50 @@ findFreeSlot(const UA_NodeMap *ns, const UA_NodeId *nodeid) {
     return candidate;
 }
 
+/* Publish a pointer for the concurrent readers. The compare-and-swap is a
+ * full memory barrier. So all prior writes are visible before the pointer. */
+static void
+publishPointer(void * volatile *addr, void *ptr) {
+    void *old = *addr;
+    while(UA_atomic_cmpxchg(addr, old, ptr) != old)
+        old = *addr;
+}
+
+static void retireTable(UA_NodeMap *ns, UA_NodeMapTable *table);
+
 /* The occupancy of the table after the call will be about 50% */
 static UA_StatusCode
 expand(UA_NodeMap *ns) {
-    UA_UInt32 osize = ns->size;
+    UA_NodeMapTable *otable = ns->table;
+    UA_UInt32 osize = otable->size;
     UA_UInt32 count = ns->count;
     /* Resize only when table after removal of unused elements is either too
        full or too empty */
     if(count * 2 < osize && (count * 8 > osize || osize <= UA_NODEMAP_MINSIZE))
         return UA_STATUSCODE_GOOD;
 
-    UA_NodeMapSlot *oslots = ns->slots;
-    UA_UInt32 nindex = higher_prime_index(count * 2);
-    UA_UInt32 nsize = primes[nindex];
-    UA_NodeMapSlot *nslots= (UA_NodeMapSlot*)UA_calloc(nsize, sizeof(UA_NodeMapSlot));
-    if(!nslots)
+    UA_NodeMapTable *ntable = newTable(higher_prime_index(count * 2));
+    if(!ntable)
         return UA_STATUSCODE_BADOUTOFMEMORY;
 
-    ns->slots = nslots;
-    ns->size = nsize;
-    ns->sizePrimeIndex = nindex;
-
     /* recompute the position of every entry and insert the pointer */
+    UA_NodeMapSlot *oslots = otable->slots;
     for(size_t i = 0, j = 0; i < osize && j < count; ++i) {
         if(oslots[i].entry <= UA_NODEMAP_TOMBSTONE)
             continue;
-        UA_NodeMapSlot *s = findFreeSlot(ns, &oslots[i].entry->node.head.nodeId);
+        UA_NodeMapSlot *s = findFreeSlot(ntable, &oslots[i].entry->node.head.nodeId);
         UA_assert(s);
-        *s = oslots[i];
+        s->entry = oslots[i].entry;
+        s->nodeIdHash = oslots[i].nodeIdHash;
         ++j;
     }
 
-    UA_free(oslots);
+    /* Switch to the new table. Concurrent readers may still use the old one. */
+    publishPointer((void * volatile *)&ns->table, ntable);
+    if(ns->concurrent)
+        retireTable(ns, otable);
+    else
+        UA_free(otable);
     return UA_STATUSCODE_GOOD;
 }
 
@@ -193,36 +264,174 @@ deleteNodeMapEntry(UA_NodeMapEntry *entry) {
 }
 
 static void
-cleanupNodeMapEntry(UA_NodeMapEntry *entry) {
+cleanupNodeMapEntry(UA_NodeMap *ns, UA_NodeMapEntry *entry) {
     if(entry->refCount > 0)
         return;
     if(entry->deleted) {
-        deleteNodeMapEntry(entry);
+        /* Retired entries of the concurrent variant are freed by the writer */
+        if(!ns->concurrent)
+            deleteNodeMapEntry(entry);
         return;
     }
+    UA_Boolean doSwitch = false;
+    for(size_t i = 0; i < entry->node.head.referencesSize; i++) {
+        UA_NodeReferenceKind *rk = &entry->node.head.references[i];
+        if(rk->targetsSize > 16 && !rk->hasRefTree) {
+            doSwitch = true;
+            break;
+        }
+    }
+    if(!doSwitch)
+        return;
+
+    /* Lock the entry. Abort if another reader acquired the node meanwhile. */
+    if(UA_atomic_cmpxchgInt(&entry->refCount, 0, UA_NODEMAP_REFCOUNT_LOCKED) != 0)
+        return;
     for(size_t i = 0; i < entry->node.head.referencesSize; i++) {
         UA_NodeReferenceKind *rk = &entry->node.head.references[i];
         if(rk->targetsSize > 16 && !rk->hasRefTree)
             UA_NodeReferenceKind_switch(rk);
     }
+    UA_atomic_addInt(&entry->refCount, -UA_NODEMAP_REFCOUNT_LOCKED);
+}
+
+static void
+acquireNodeMapEntry(UA_NodeMapEntry *entry) {
+    /* Wait while the entry is locked for restructuring */
+    while(UA_atomic_addInt(&entry->refCount, 1) <= 0)
+        UA_atomic_addInt(&entry->refCount, -1);
+}
+
+/*****************************/
+/* Epoch-Based Reclamation   */
+/*****************************/
+
+/* Each thread uses one of the reader counters */
+static volatile int readerStripeCounter;
+static UA_THREAD_LOCAL int readerStripe = -1;
+
+static volatile int *
+enterReadSection(UA_NodeMap *ns) {
+    if(!ns->concurrent)
+        return NULL;
+    if(UA_UNLIKELY(readerStripe < 0))
+        readerStripe = UA_atomic_addInt(&readerStripeCounter, 1) %
+            UA_NODEMAP_READERSTRIPES;
+
+    /* Announce the reader in the current epoch. Retry if the epoch has
+     * changed meanwhile. The writer might have missed the announcement. */
+    while(true) {
+        int epoch = ns->epoch;
+        volatile int *count = &ns->readers[epoch & 1][readerStripe].count;
+        UA_atomic_addInt(count, 1);
+        if(ns->epoch == epoch)
+            return count;
+        UA_atomic_addInt(count, -1);
+    }
+}
+
+static void
+leaveReadSection(volatile int *count) {
+    if(count)
+        UA_atomic_addInt(count, -1);
+}
+
+/* Free the retired entries that are no longer referenced and push the rest
+ * back to the list */
+static void
+freeRetired(UA_NodeMapEntry **list, UA_NodeMapEntry *entry) {
+    while(entry) {
+        UA_NodeMapEntry *next = entry->orig;
+        if(entry->refCount == 0) {
+            deleteNodeMapEntry(entry);
+        } else {
+            entry->orig = *list;
+            *list = entry;
+        }
+        entry = next;
+    }
+}
+
+static void
+freeRetiredTables(UA_NodeMapTable *table) {
+    while(table) {
+        UA_NodeMapTable *next = table->retiredNext;
+        UA_free(table);
+        table = next;
+    }
+}
+
+/* Called by the writer. Advance the epoch if no readers from the previous
+ * epoch remain. */
+static void
+reclaim(UA_NodeMap *ns) {
+    if(!ns->retired && !ns->retiredOld && !ns->retiredTables && !ns->retiredTablesOld)
+        return;
+    int epoch = ns->epoch;
+    UA_NodeMapReaders *readers = ns->readers[(epoch - 1) & 1];
+    for(size_t i = 0; i < UA_NODEMAP_READERSTRIPES; i++) {
+        if(readers[i].count != 0)
+            return;
+    }
+
+    /* What was retired before the previous epoch change is unreachable */
+    UA_NodeMapEntry *old = ns->retiredOld;
+    ns->retiredOld = ns->retired;
+    ns->retired = NULL;
+    freeRetired(&ns->retiredOld, old);
+    freeRetiredTables(ns->retiredTablesOld);
+    ns->retiredTablesOld = ns->retiredTables;
+    ns->retiredTables = NULL;
+    UA_atomic_addInt(&ns->epoch, 1);
+}
+
+static void
+retireEntry(UA_NodeMap *ns, UA_NodeMapEntry *entry) {
+    entry->orig = ns->retired;
+    ns->retired = entry;
+}
+
+static void
+retireTable(UA_NodeMap *ns, UA_NodeMapTable *table) {
+    table->retiredNext = ns->retiredTables;
+    ns->retiredTables = table;
+}
+
+static void
+releaseNodeMapEntry(UA_NodeMap *ns, UA_NodeMapEntry *entry) {
+    UA_assert(entry->refCount > 0);
+
+    /* The entry is retired. The writer frees it once the refCount is zero.
+     * Don't touch the entry after the decrement. */
+    volatile int *section = enterReadSection(ns);
+    if(ns->concurrent && entry->deleted) {
+        UA_atomic_addInt(&entry->refCount, -1);
+        leaveReadSection(section);
+        return;
+    }
+
+    if(UA_atomic_addInt(&entry->refCount, -1) == 0)
+        cleanupNodeMapEntry(ns, entry);
+    leaveReadSection(section);
 }
 
 static UA_NodeMapSlot *
-findOccupiedSlot(const UA_NodeMap *ns, const UA_NodeId *nodeid) {
+findOccupiedSlot(const UA_NodeMapTable *table, const UA_NodeId *nodeid) {
     UA_UInt32 h = UA_NodeId_hash(nodeid);
-    UA_UInt32 size = ns->size;
+    UA_UInt32 size = table->size;
     UA_UInt64 idx = mod(h, size); /* Use 64bit container to avoid overflow */
     UA_UInt32 hash2 = mod2(h, size);
     UA_UInt32 startIdx = (UA_UInt32)idx;
 
     do {
-        UA_NodeMapSlot *slot= &ns->slots[(UA_UInt32)idx];
-        if(slot->entry > UA_NODEMAP_TOMBSTONE) {
+        UA_NodeMapSlot *slot= &table->slots[(UA_UInt32)idx];
+        UA_NodeMapEntry *entry = slot->entry;
+        if(entry > UA_NODEMAP_TOMBSTONE) {
             if(slot->nodeIdHash == h &&
-               UA_NodeId_equal(&slot->entry->node.head.nodeId, nodeid))
+               UA_NodeId_equal(&entry->node.head.nodeId, nodeid))
                 return slot;
         } else {
-            if(slot->entry == NULL)
+            if(entry == NULL)
                 return NULL; /* No further entry possible */
         }
 
@@ -259,11 +468,17 @@ UA_NodeMap_getNode(void *context, const UA_NodeId *nodeid,
                    UA_ReferenceTypeSet references,
                    UA_BrowseDirection referenceDirections) {
     UA_NodeMap *ns = (UA_NodeMap*)context;
-    UA_NodeMapSlot *slot = findOccupiedSlot(ns, nodeid);
-    if(!slot)
+    volatile int *section = enterReadSection(ns);
+    UA_NodeMapSlot *slot = findOccupiedSlot(ns->table, nodeid);
+    UA_NodeMapEntry *entry = (slot) ? slot->entry : NULL;
+    if(entry <= UA_NODEMAP_TOMBSTONE) {
+        /* Removed concurrently after the slot was found */
+        leaveReadSection(section);
         return NULL;
-    ++slot->entry->refCount;
-    return &slot->entry->node;
+    }
+    acquireNodeMapEntry(entry);
+    leaveReadSection(section);
+    return &entry->node;
 }
 
 static const UA_Node *
@@ -283,23 +498,26 @@ UA_NodeMap_releaseNode(void *context, const UA_Node *node) {
         return;
     UA_NodeMapEntry *entry = container_of(node, UA_NodeMapEntry, node);
     UA_assert(&entry->node == node);
-    UA_assert(entry->refCount > 0);
-    --entry->refCount;
-    cleanupNodeMapEntry(entry);
+    releaseNodeMapEntry((UA_NodeMap*)context, entry);
 }
 
 static UA_StatusCode
 UA_NodeMap_getNodeCopy(void *context, const UA_NodeId *nodeid,
                        UA_Node **outNode) {
     UA_NodeMap *ns = (UA_NodeMap*)context;
-    UA_NodeMapSlot *slot = findOccupiedSlot(ns, nodeid);
+    UA_NodeMapSlot *slot = findOccupiedSlot(ns->table, nodeid);
     if(!slot)
         return UA_STATUSCODE_BADNODEIDUNKNOWN;
     UA_NodeMapEntry *entry = slot->entry;
     UA_NodeMapEntry *newItem = createEntry(entry->node.head.nodeClass);
     if(!newItem)
         return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    /* Hold a reference during the copy. So concurrent readers don't
+     * restructure the references of the entry meanwhile. */
+    acquireNodeMapEntry(entry);
     UA_StatusCode retval = UA_Node_copy(&entry->node, &newItem->node);
+    releaseNodeMapEntry(ns, entry);
     if(retval == UA_STATUSCODE_GOOD) {
         newItem->orig = entry; /* Store the pointer to the original */
         *outNode = &newItem->node;
@@ -312,18 +530,23 @@ UA_NodeMap_getNodeCopy(void *context, const UA_NodeId *nodeid,
 static UA_StatusCode
 UA_NodeMap_removeNode(void *context, const UA_NodeId *nodeid) {
     UA_NodeMap *ns = (UA_NodeMap*)context;
-    UA_NodeMapSlot *slot = findOccupiedSlot(ns, nodeid);
+    UA_NodeMapSlot *slot = findOccupiedSlot(ns->table, nodeid);
     if(!slot)
         return UA_STATUSCODE_BADNODEIDUNKNOWN;
 
     UA_NodeMapEntry *entry = slot->entry;
-    slot->entry = UA_NODEMAP_TOMBSTONE;
     entry->deleted = true;
-    cleanupNodeMapEntry(entry);
+    publishPointer((void * volatile *)&slot->entry, UA_NODEMAP_TOMBSTONE);
+    if(ns->concurrent)
+        retireEntry(ns, entry);
+    else
+        cleanupNodeMapEntry(ns, entry);
     --ns->count;
     /* Downsize the hashmap if it is very empty */
-    if(ns->count * 8 < ns->size && ns->size > UA_NODEMAP_MINSIZE)
+    if(ns->count * 8 < ns->table->size && ns->table->size > UA_NODEMAP_MINSIZE)
         expand(ns); /* Can fail. Just continue with the bigger hashmap. */
+    if(ns->concurrent)
+        reclaim(ns);
     return UA_STATUSCODE_GOOD;
 }
 
@@ -335,7 +558,9 @@ static UA_StatusCode
 UA_NodeMap_insertNode(void *context, UA_Node *node,
                       UA_NodeId *addedNodeId) {
     UA_NodeMap *ns = (UA_NodeMap*)context;
-    if(ns->size * 3 <= ns->count * 4) {
+    if(ns->concurrent)
+        reclaim(ns);
+    if(ns->table->size * 3 <= ns->count * 4) {
         if(expand(ns) != UA_STATUSCODE_GOOD){
             deleteNodeMapEntry(container_of(node, UA_NodeMapEntry, node));
             return UA_STATUSCODE_BADINTERNALERROR;
@@ -352,7 +577,7 @@ UA_NodeMap_insertNode(void *context, UA_Node *node,
          * val, we will reach the starting id again. E.g. adding a nodeset will
          * create children while there are still other nodes which need to be
          * created. Thus the node ids may collide. */
-        UA_UInt32 size = ns->size;
+        UA_UInt32 size = ns->table->size;
         UA_UInt64 identifier = mod(50000 + size+1, UA_UINT32_MAX); /* Use 64bit to
                                                                     * avoid overflow */
         UA_UInt32 increase = mod2(ns->count+1, size);
@@ -361,7 +586,7 @@ UA_NodeMap_insertNode(void *context, UA_Node *node,
 
         do {
             node->head.nodeId.identifier.numeric = (UA_UInt32)identifier;
-            slot = findFreeSlot(ns, &node->head.nodeId);
+            slot = findFreeSlot(ns->table, &node->head.nodeId);
             if(slot)
                 break;
             identifier += increase;
@@ -376,7 +601,7 @@ UA_NodeMap_insertNode(void *context, UA_Node *node,
 #endif
         } while((UA_UInt32)identifier != startId);
     } else {
-        slot = findFreeSlot(ns, &node->head.nodeId);
+        slot = findFreeSlot(ns->table, &node->head.nodeId);
     }
 
     if(!slot) {
@@ -418,7 +643,7 @@ UA_NodeMap_insertNode(void *context, UA_Node *node,
     /* Insert the node */
     UA_NodeMapEntry *newEntry = container_of(node, UA_NodeMapEntry, node);
     slot->nodeIdHash = UA_NodeId_hash(&node->head.nodeId);
-    slot->entry = newEntry;
+    publishPointer((void * volatile *)&slot->entry, newEntry);
     ++ns->count;
     return retval;
 }
@@ -429,7 +654,7 @@ UA_NodeMap_replaceNode(void *context, UA_Node *node) {
     UA_NodeMapEntry *newEntry = container_of(node, UA_NodeMapEntry, node);
 
     /* Find the node */
-    UA_NodeMapSlot *slot = findOccupiedSlot(ns, &node->head.nodeId);
+    UA_NodeMapSlot *slot = findOccupiedSlot(ns->table, &node->head.nodeId);
     if(!slot) {
         deleteNodeMapEntry(newEntry);
         return UA_STATUSCODE_BADNODEIDUNKNOWN;
@@ -443,9 +668,15 @@ UA_NodeMap_replaceNode(void *context, UA_Node *node) {
     }
 
     /* Replace the entry */
-    slot->entry = newEntry;
+    newEntry->orig = NULL;
     oldEntry->deleted = true;
-    cleanupNodeMapEntry(oldEntry);
+    publishPointer((void * volatile *)&slot->entry, newEntry);
+    if(ns->concurrent) {
+        retireEntry(ns, oldEntry);
+        reclaim(ns);
+    } else {
+        cleanupNodeMapEntry(ns, oldEntry);
+    }
     return UA_STATUSCODE_GOOD;
 }
 
@@ -461,14 +692,14 @@ static void
 UA_NodeMap_iterate(void *context, UA_NodestoreVisitor visitor,
                    void *visitorContext) {
     UA_NodeMap *ns = (UA_NodeMap*)context;
-    for(UA_UInt32 i = 0; i < ns->size; ++i) {
-        UA_NodeMapSlot *slot = &ns->slots[i];
+    for(UA_UInt32 i = 0; i < ns->table->size; ++i) {
+        UA_NodeMapSlot *slot = &ns->table->slots[i];
         if(slot->entry > UA_NODEMAP_TOMBSTONE) {
             /* The visitor can delete the node. So refcount here. */
-            slot->entry->refCount++;
-            visitor(visitorContext, &slot->entry->node);
-            slot->entry->refCount--;
-            cleanupNodeMapEntry(slot->entry);
+            UA_NodeMapEntry *entry = slot->entry;
+            acquireNodeMapEntry(entry);
+            visitor(visitorContext, &entry->node);
+            releaseNodeMapEntry(ns, entry);
         }
     }
 }
@@ -480,8 +711,8 @@ UA_NodeMap_delete(void *context) {
         return;
 
     UA_NodeMap *ns = (UA_NodeMap*)context;
-    UA_UInt32 size = ns->size;
-    UA_NodeMapSlot *slots = ns->slots;
+    UA_UInt32 size = ns->table->size;
+    UA_NodeMapSlot *slots = ns->table->slots;
     for(UA_UInt32 i = 0; i < size; ++i) {
         if(slots[i].entry > UA_NODEMAP_TOMBSTONE) {
             /* On debugging builds, check that all nodes were release */
@@ -490,7 +721,20 @@ UA_NodeMap_delete(void *context) {
             deleteNodeMapEntry(slots[i].entry);
         }
     }
-    UA_free(ns->slots);
+    UA_free(ns->table);
+
+    /* No more readers at this point. Free all retired entries and tables. */
+    UA_NodeMapEntry *lists[2] = {ns->retired, ns->retiredOld};
+    for(size_t i = 0; i < 2; i++) {
+        UA_NodeMapEntry *entry = lists[i];
+        while(entry) {
+            UA_NodeMapEntry *next = entry->orig;
+            deleteNodeMapEntry(entry);
+            entry = next;
+        }
+    }
+    freeRetiredTables(ns->retiredTables);
+    freeRetiredTables(ns->retiredTablesOld);
 
     /* Clean up the ReferenceTypes index array */
     for(size_t i = 0; i < ns->referenceTypeCounter; i++)
@@ -499,23 +743,18 @@ UA_NodeMap_delete(void *context) {
     UA_free(ns);
 }
 
-UA_StatusCode
-UA_Nodestore_HashMap(UA_Nodestore *ns) {
+static UA_StatusCode
+createNodeMap(UA_Nodestore *ns, UA_Boolean concurrent) {
     /* Allocate and initialize the nodemap */
-    UA_NodeMap *nodemap = (UA_NodeMap*)UA_malloc(sizeof(UA_NodeMap));
+    UA_NodeMap *nodemap = (UA_NodeMap*)UA_calloc(1, sizeof(UA_NodeMap));
     if(!nodemap)
         return UA_STATUSCODE_BADOUTOFMEMORY;
-    nodemap->sizePrimeIndex = higher_prime_index(UA_NODEMAP_MINSIZE);
-    nodemap->size = primes[nodemap->sizePrimeIndex];
-    nodemap->count = 0;
-    nodemap->slots = (UA_NodeMapSlot*)
-        UA_calloc(nodemap->size, sizeof(UA_NodeMapSlot));
-    if(!nodemap->slots) {
+    nodemap->table = newTable(higher_prime_index(UA_NODEMAP_MINSIZE));
+    if(!nodemap->table) {
         UA_free(nodemap);
         return UA_STATUSCODE_BADOUTOFMEMORY;
     }
-
-    nodemap->referenceTypeCounter = 0;
+    nodemap->concurrent = concurrent;
 
     /* Populate the nodestore */
     ns->context = nodemap;
@@ -533,3 +772,13 @@ UA_Nodestore_HashMap(UA_Nodestore *ns) {
     ns->iterate = UA_NodeMap_iterate;
     return UA_STATUSCODE_GOOD;
 }
+
+UA_StatusCode
+UA_Nodestore_HashMap(UA_Nodestore *ns) {
+    return createNodeMap(ns, false);
+}
+
+UA_StatusCode
+UA_Nodestore_HashMapConcurrent(UA_Nodestore *ns) {
+    return createNodeMap(ns, true);
+}
@@ -21,7 +21,7 @@ typedef struct NodeEntry NodeEntry;
 struct NodeEntry {
     ZIP_ENTRY(NodeEntry) zipfields;
     UA_UInt32 nodeIdHash;
-    UA_UInt16 refCount; /* How many consumers have a reference to the node? */
+    volatile int refCount; /* How many consumers have a reference to the node? */
     UA_Boolean deleted; /* Node was marked as deleted and can be deleted when refCount == 0 */
     NodeEntry *orig;    /* If a copy is made to replace a node, track that we
                          * replace only the node from which the copy was made.
@@ -103,6 +103,10 @@ deleteEntry(NodeEntry *entry) {
     UA_free(entry);
 }
 
+/* The refCount is modified atomically. So several readers can get and release
+ * nodes concurrently. It is negative while the references are restructured. */
+#define NODEENTRY_REFCOUNT_LOCKED (-0x40000000)
+
 static void
 cleanupEntry(NodeEntry *entry) {
     if(entry->refCount > 0)
@@ -112,11 +116,26 @@ cleanupEntry(NodeEntry *entry) {
         return;
     }
     UA_NodeHead *head = (UA_NodeHead*)&entry->nodeId;
+    UA_Boolean doSwitch = false;
+    for(size_t i = 0; i < head->referencesSize; i++) {
+        UA_NodeReferenceKind *rk = &head->references[i];
+        if(rk->targetsSize > 16 && !rk->hasRefTree) {
+            doSwitch = true;
+            break;
+        }
+    }
+    if(!doSwitch)
+        return;
+
+    /* Lock the entry. Abort if another reader acquired the node meanwhile. */
+    if(UA_atomic_cmpxchgInt(&entry->refCount, 0, NODEENTRY_REFCOUNT_LOCKED) != 0)
+        return;
     for(size_t i = 0; i < head->referencesSize; i++) {
         UA_NodeReferenceKind *rk = &head->references[i];
         if(rk->targetsSize > 16 && !rk->hasRefTree)
             UA_NodeReferenceKind_switch(rk);
     }
+    UA_atomic_addInt(&entry->refCount, -NODEENTRY_REFCOUNT_LOCKED);
 }
 
 /***********************/
@@ -150,7 +169,9 @@ zipNsGetNode(void *nsCtx, const UA_NodeId *nodeId,
     NodeEntry *entry = ZIP_FIND(NodeTree, &ns->root, &dummy);
     if(!entry)
         return NULL;
-    ++entry->refCount;
+    /* Wait while the entry is locked for restructuring */
+    while(UA_atomic_addInt(&entry->refCount, 1) <= 0)
+        UA_atomic_addInt(&entry->refCount, -1);
     return (const UA_Node*)&entry->nodeId;
 }
 
@@ -172,8 +193,8 @@ zipNsReleaseNode(void *nsCtx, const UA_Node *node) {
         return;
     NodeEntry *entry = container_of(node, NodeEntry, nodeId);
     UA_assert(entry->refCount > 0);
-    --entry->refCount;
-    cleanupEntry(entry);
+    if(UA_atomic_addInt(&entry->refCount, -1) == 0)
+        cleanupEntry(entry);
 }
 
 static UA_StatusCode
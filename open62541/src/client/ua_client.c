@@ -116,6 +116,7 @@ UA_Client_newWithConfig(const UA_ClientConfig *config) {
     UA_SecureChannel_init(&client->channel);
     client->channel.config = client->config.localConnectionConfig;
     client->connectStatus = UA_STATUSCODE_GOOD;
+    UA_Arena_init(&client->responseArena, UA_ARENA_DEFAULTBLOCKSIZE);
 
 #if UA_MULTITHREADING >= 100
     UA_LOCK_INIT(&client->clientMutex);
@@ -227,6 +228,7 @@ UA_Client_clear(UA_Client *client) {
     client->houseKeepingCallbackId = 0;
 
     UA_SecureChannel_clear(&client->channel);
+    UA_Arena_clear(&client->responseArena);
 
 #if UA_MULTITHREADING >= 100
     UA_LOCK_DESTROY(&client->clientMutex);
@@ -414,6 +416,21 @@ processMSGResponse(UA_Client *client, UA_UInt32 requestId,
     /* Dequeue ac. We might disconnect the client (remove all ac) in the callback. */
     LIST_REMOVE(ac, pointers);
 
+    /* The responses to the Publish requests of the client subscriptions are
+     * decoded into the arena. They are processed internally and released right
+     * after the callback. Other responses (also Publish responses for requests
+     * sent by the user) are handed to the user or parts of them are taken over
+     * by the internal callbacks. The arena is not used if a Publish response
+     * is processed within the callback of another. */
+    UA_Arena *arena = NULL;
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    if(!ac->syncResponse && !client->responseArenaInUse &&
+       ac->callback == __Client_Subscriptions_processPublishResponseAsync) {
+        arena = &client->responseArena;
+        client->responseArenaInUse = true;
+    }
+#endif
+
     /* Decode the response type */
     size_t offset = 0;
     UA_NodeId responseTypeId;
@@ -449,8 +466,9 @@ processMSGResponse(UA_Client *client, UA_UInt32 requestId,
                  "Decode a message of type %" PRIu32,
                  responseTypeId.identifier.numeric);
 #endif
-    retval = UA_decodeBinaryInternal(msg, &offset, response, responseType,
-                                     client->config.customDataTypes);
+    retval = UA_decodeBinaryInternalArena(msg, &offset, response, responseType,
+                                          client->config.customDataTypes,
+                                          arena, false);
 
  process:
     /* Process the received MSG response */
@@ -493,7 +511,12 @@ processMSGResponse(UA_Client *client, UA_UInt32 requestId,
     /* Clean up */
     UA_NodeId_clear(&responseTypeId);
     if(!ac->syncResponse) {
-        UA_clear(response, ac->responseType);
+        if(arena) {
+            UA_Arena_reset(arena);
+            client->responseArenaInUse = false;
+        } else {
+            UA_clear(response, ac->responseType);
+        }
         UA_free(ac);
     } else {
         /* Return a special status code after processing a synchronous message.
@@ -73,6 +73,12 @@ __Client_preparePublishRequest(UA_Client *client, UA_PublishRequest *request);
 void
 __Client_Subscriptions_backgroundPublish(UA_Client *client);
 
+/* Callback of the Publish requests sent by __Client_Subscriptions_backgroundPublish.
+ * Their responses are decoded into the arena of the client. */
+void
+__Client_Subscriptions_processPublishResponseAsync(UA_Client *client, void *userdata,
+                                                   UA_UInt32 requestId, void *response);
+
 void
 __Client_Subscriptions_backgroundPublishInactivityCheck(UA_Client *client);
 
@@ -159,6 +165,11 @@ struct UA_Client {
     /* Async Service */
     UA_AsyncServiceList asyncServiceCalls;
 
+    /* Publish responses are decoded into the arena. It is reset after the
+     * response was processed. */
+    UA_Arena responseArena;
+    UA_Boolean responseArenaInUse;
+
     /* Subscriptions */
     LIST_HEAD(, UA_Client_NotificationsAckNumber) pendingNotificationsAcks;
     LIST_HEAD(, UA_Client_Subscription) subscriptions;
@@ -1296,9 +1296,9 @@ __Client_Subscriptions_processPublishResponse(UA_Client *client, UA_PublishReque
     }
 }
 
-static void
-processPublishResponseAsync(UA_Client *client, void *userdata,
-                            UA_UInt32 requestId, void *response) {
+void
+__Client_Subscriptions_processPublishResponseAsync(UA_Client *client, void *userdata,
+                                                   UA_UInt32 requestId, void *response) {
     UA_PublishRequest *req = (UA_PublishRequest*)userdata;
     UA_PublishResponse *res = (UA_PublishResponse*)response;
 
@@ -1391,7 +1391,7 @@ __Client_Subscriptions_backgroundPublish(UA_Client *client) {
 
         retval = __Client_AsyncService(client, request,
                                          &UA_TYPES[UA_TYPES_PUBLISHREQUEST],
-                                         processPublishResponseAsync,
+                                         __Client_Subscriptions_processPublishResponseAsync,
                                          &UA_TYPES[UA_TYPES_PUBLISHRESPONSE],
                                          (void*)request, NULL);
         if(retval != UA_STATUSCODE_GOOD) {
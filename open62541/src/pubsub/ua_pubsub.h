@@ -40,6 +40,9 @@ typedef struct UA_WriterGroup UA_WriterGroup;
 struct UA_ReaderGroup;
 typedef struct UA_ReaderGroup UA_ReaderGroup;
 
+struct UA_DataSetReader;
+typedef struct UA_DataSetReader UA_DataSetReader;
+
 struct UA_SecurityGroup;
 typedef struct UA_SecurityGroup UA_SecurityGroup;
 
@@ -130,6 +133,37 @@ UA_StandaloneSubscribedDataSet_clear(UA_Server *server,
 /*               Connection                   */
 /**********************************************/
 
+/* The DataSetReaders of all ReaderGroups (with UADP encoding) of a
+ * PubSubConnection are indexed by the identifiers of the DataSetWriter they
+ * subscribe to. NetworkMessages that contain the PublisherId, the WriterGroupId
+ * and the DataSetWriterIds are dispatched with a hash lookup for each
+ * DataSetMessage instead of checking every DataSetReader.
+ *
+ * The index is rebuilt lazily before the next lookup after the ReaderGroups or
+ * DataSetReaders of the connection have changed. */
+typedef struct {
+    UA_PublisherIdType publisherIdType;
+    UA_PublisherId publisherId; /* The string is not copied */
+    UA_UInt16 writerGroupId;
+    UA_UInt16 dataSetWriterId;
+} UA_DataSetReaderKey;
+
+typedef struct {
+    UA_DataSetReaderKey key;
+    UA_UInt32 hash;
+    UA_UInt32 next; /* Next entry in the bucket or UA_UINT32_MAX */
+    UA_ReaderGroup *rg;
+    UA_DataSetReader *dsr;
+} UA_DataSetReaderIndexEntry;
+
+typedef struct {
+    UA_Boolean valid; /* Rebuild before the next lookup if false */
+    UA_UInt32 entriesSize;
+    UA_DataSetReaderIndexEntry *entries;
+    UA_UInt32 bucketsSize; /* Power of two */
+    UA_UInt32 *buckets; /* First entry of each bucket or UA_UINT32_MAX */
+} UA_DataSetReaderIndex;
+
 typedef struct UA_PubSubConnection {
     UA_PubSubComponentEnumType componentType;
 
@@ -159,6 +193,7 @@ typedef struct UA_PubSubConnection {
 
     size_t readerGroupsSize;
     LIST_HEAD(, UA_ReaderGroup) readerGroups;
+    UA_DataSetReaderIndex readerIndex;
 
     UA_UInt16 configurationFreezeCounter;
 
@@ -351,6 +386,29 @@ struct UA_WriterGroup {
     uintptr_t sendChannel;
     UA_Boolean deleteFlag;
 
+    /* Send buffer of the RT fast path (fixed-size messages). It is allocated
+     * from the ConnectionManager of the send channel and prefilled with the
+     * pre-encoded message. Every cycle only the offset table is patched into
+     * the buffer, which is then sent without giving it away. Only used if the
+     * ConnectionManager implements sendRetainedWithConnection. Otherwise a
+     * network buffer is allocated and prefilled for every message. */
+    UA_ByteString sendBuffer;
+    uintptr_t sendBufferChannel; /* Channel the buffer was allocated for */
+
+    /* Frozen WriterGroups with UA_PUBSUB_RT_DETERMINISTIC publish without the
+     * server lock. The rtLock protects the state used for publishing (offset
+     * table, send buffers, send channels and security context) instead. It is
+     * only held briefly and never while calling into the ConnectionManager. */
+#if UA_MULTITHREADING >= 100
+    UA_Lock rtLock;
+#endif
+    UA_Boolean rtPublishLockFree;
+
+    /* Lock-free publishes that have not finished yet. A WriterGroup that is
+     * removed meanwhile is freed by the last of them (rtFreeDeferred). */
+    UA_UInt32 rtPublishInFlight;
+    UA_Boolean rtFreeDeferred;
+
 #ifdef UA_ENABLE_PUBSUB_ENCRYPTION
     UA_UInt32 securityTokenId;
     UA_UInt32 nonceSequenceNumber; /* To be part of the MessageNonce */
@@ -396,6 +454,12 @@ UA_WriterGroup_freezeConfiguration(UA_Server *server, UA_WriterGroup *wg);
 UA_StatusCode
 UA_WriterGroup_unfreezeConfiguration(UA_Server *server, UA_WriterGroup *wg);
 
+/* Return the prepared send buffer of the RT fast path to the
+ * ConnectionManager. Called when the configuration is unfrozen and when the
+ * channel it was allocated for closes. */
+void
+UA_WriterGroup_releaseSendBuffer(UA_WriterGroup *wg);
+
 UA_StatusCode
 UA_WriterGroup_setPubSubState(UA_Server *server,
                               UA_WriterGroup *writerGroup,
@@ -477,7 +541,7 @@ UA_PubSubDataSetField_sampleValue(UA_Server *server, UA_DataSetField *field,
 /**********************************************/
 
 /* DataSetReader Type definition */
-typedef struct UA_DataSetReader {
+struct UA_DataSetReader {
     UA_PubSubComponentEnumType componentType;
     UA_DataSetReaderConfig config;
     UA_NodeId identifier;
@@ -495,7 +559,7 @@ typedef struct UA_DataSetReader {
     UA_Boolean msgRcvTimeoutTimerRunning;
 #endif
     UA_DateTime lastHeartbeatReceived;
-} UA_DataSetReader;
+};
 
 /* Process Network Message using DataSetReader */
 void
@@ -509,6 +573,29 @@ UA_DataSetReader_checkIdentifier(UA_Server *server, UA_NetworkMessage *msg,
                                  UA_DataSetReader *reader,
                                  UA_ReaderGroupConfig readerGroupConfig);
 
+/* Get the lookup key for the DataSetMessages of the NetworkMessage. Returns
+ * false if the NetworkMessage does not contain all identifiers. Then the
+ * DataSetReaders have to be checked with UA_DataSetReader_checkIdentifier. The
+ * DataSetWriterId of the key is set for each DataSetMessage. */
+UA_Boolean
+UA_DataSetReaderKey_fromNetworkMessage(const UA_NetworkMessage *nm,
+                                       UA_DataSetReaderKey *key);
+
+/* Get the (rebuilt) index of the DataSetReaders of the connection. Returns
+ * NULL if the index cannot be built. */
+const UA_DataSetReaderIndex *
+UA_PubSubConnection_getReaderIndex(UA_PubSubConnection *c);
+
+/* Returns the next entry of the index that matches the key. Start with prev ==
+ * NULL. */
+const UA_DataSetReaderIndexEntry *
+UA_DataSetReaderIndex_find(const UA_DataSetReaderIndex *index,
+                           const UA_DataSetReaderKey *key,
+                           const UA_DataSetReaderIndexEntry *prev);
+
+void
+UA_DataSetReaderIndex_clear(UA_DataSetReaderIndex *index);
+
 UA_StatusCode
 UA_DataSetReader_create(UA_Server *server, UA_NodeId readerGroupIdentifier,
                         const UA_DataSetReaderConfig *dataSetReaderConfig,
@@ -35,36 +35,50 @@ decodeNetworkMessage(UA_Server *server, UA_ByteString *buffer, size_t *pos,
     }
 
 #ifdef UA_ENABLE_PUBSUB_ENCRYPTION
-    UA_Boolean processed = false;
-    UA_ReaderGroup *readerGroup;
-    UA_DataSetReader *reader;
-
-    /* Choose a correct readergroup for decrypt/verify this message
-     * (there could be multiple) */
-    LIST_FOREACH(readerGroup, &connection->readerGroups, listEntry) {
-        LIST_FOREACH(reader, &readerGroup->readers, listEntry) {
-            UA_StatusCode retval =
-                UA_DataSetReader_checkIdentifier(server, nm, reader, readerGroup->config);
-            if(retval != UA_STATUSCODE_GOOD)
-                continue;
-            processed = true;
-            rv = verifyAndDecryptNetworkMessage(server->config.logging, buffer, pos,
-                                                nm, readerGroup);
-            if(rv != UA_STATUSCODE_GOOD) {
-                UA_LOG_WARNING_CONNECTION(server->config.logging, connection,
-                                          "Subscribe failed, verify and decrypt "
-                                          "network message failed.");
-                UA_NetworkMessage_clear(nm);
-                return rv;
+    UA_ReaderGroup *readerGroup = NULL;
+
+    /* Choose a correct readergroup for decrypt/verify this message (there
+     * could be multiple). Look up the readers in the index if the message
+     * contains all identifiers. */
+    UA_DataSetReaderKey key;
+    const UA_DataSetReaderIndex *index = NULL;
+    if(UA_DataSetReaderKey_fromNetworkMessage(nm, &key))
+        index = UA_PubSubConnection_getReaderIndex(connection);
+    if(index) {
+        UA_Byte totalDataSets = nm->payloadHeader.dataSetPayloadHeader.count;
+        for(UA_Byte i = 0; i < totalDataSets && !readerGroup; i++) {
+            key.dataSetWriterId = nm->payloadHeader.dataSetPayloadHeader.dataSetWriterIds[i];
+            const UA_DataSetReaderIndexEntry *e = UA_DataSetReaderIndex_find(index, &key, NULL);
+            if(e)
+                readerGroup = e->rg;
+        }
+    } else {
+        UA_ReaderGroup *rg;
+        UA_DataSetReader *reader;
+        LIST_FOREACH(rg, &connection->readerGroups, listEntry) {
+            LIST_FOREACH(reader, &rg->readers, listEntry) {
+                if(UA_DataSetReader_checkIdentifier(server, nm, reader,
+                                                    rg->config) == UA_STATUSCODE_GOOD)
+                    break;
+            }
+            if(reader) {
+                readerGroup = rg;
+                break;
             }
-
-            /* break out of all loops when first verify & decrypt was successful */
-            goto loops_exit;
         }
     }
 
-loops_exit:
-    if(!processed) {
+    if(readerGroup) {
+        rv = verifyAndDecryptNetworkMessage(server->config.logging, buffer, pos,
+                                            nm, readerGroup);
+        if(rv != UA_STATUSCODE_GOOD) {
+            UA_LOG_WARNING_CONNECTION(server->config.logging, connection,
+                                      "Subscribe failed, verify and decrypt "
+                                      "network message failed.");
+            UA_NetworkMessage_clear(nm);
+            return rv;
+        }
+    } else {
         UA_DateTime nowM = UA_DateTime_nowMonotonic();
         if(connection->silenceErrorUntil < nowM) {
             UA_LOG_INFO_CONNECTION(server->config.logging, connection,
@@ -296,6 +310,7 @@ UA_PubSubConnection_delete(UA_Server *server, UA_PubSubConnection *c) {
     TAILQ_REMOVE(&server->pubSubManager.connections, c, listEntry);
     server->pubSubManager.connectionsSize--;
 
+    UA_DataSetReaderIndex_clear(&c->readerIndex);
     UA_PubSubConnectionConfig_clear(&c->config);
     UA_NodeId_clear(&c->identifier);
     UA_free(c);
@@ -83,11 +83,36 @@ getCM(UA_EventLoop *el, UA_String protocol) {
     return NULL;
 }
 
+/* The RT publish path of the WriterGroups reads the send channel of the
+ * connection under their rtLock (and without the server lock) */
+static void
+UA_PubSubConnection_setSendChannel(UA_PubSubConnection *c,
+                                   uintptr_t connectionId) {
+#if UA_MULTITHREADING >= 100
+    UA_WriterGroup *wg;
+    LIST_FOREACH(wg, &c->writerGroups, listEntry) {
+        UA_LOCK(&wg->rtLock);
+    }
+#endif
+    c->sendChannel = connectionId;
+#if UA_MULTITHREADING >= 100
+    LIST_FOREACH(wg, &c->writerGroups, listEntry) {
+        UA_UNLOCK(&wg->rtLock);
+    }
+#endif
+}
+
 static void
 UA_PubSubConnection_removeConnection(UA_PubSubConnection *c,
                                      uintptr_t connectionId) {
     if(c->sendChannel == connectionId) {
-        c->sendChannel = 0;
+        UA_PubSubConnection_setSendChannel(c, 0);
+        /* Return the RT send buffer of the closed channel */
+        UA_WriterGroup *wg;
+        LIST_FOREACH(wg, &c->writerGroups, listEntry) {
+            if(wg->sendChannel == 0)
+                UA_WriterGroup_releaseSendBuffer(wg);
+        }
         return;
     }
     for(size_t i = 0; i < UA_PUBSUB_MAXCHANNELS; i++) {
@@ -104,7 +129,7 @@ UA_PubSubConnection_addSendConnection(UA_PubSubConnection *c,
                                       uintptr_t connectionId) {
     if(c->sendChannel != 0 && c->sendChannel != connectionId)
         return UA_STATUSCODE_BADINTERNALERROR;
-    c->sendChannel = connectionId;
+    UA_PubSubConnection_setSendChannel(c, connectionId);
     return UA_STATUSCODE_GOOD;
 }
 
@@ -533,7 +558,10 @@ WriterGroupChannelCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
     if(state == UA_CONNECTIONSTATE_CLOSING) {
         if(wg->sendChannel == connectionId) {
             /* Reset the connection channel */
+            UA_LOCK(&wg->rtLock);
             wg->sendChannel = 0;
+            UA_UNLOCK(&wg->rtLock);
+            UA_WriterGroup_releaseSendBuffer(wg);
 
             /* PSC marked for deletion and the last EventLoop connection has closed */
             if(wg->deleteFlag) {
@@ -561,7 +589,9 @@ WriterGroupChannelCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
         unlockServer(server);
         return;
     }
+    UA_LOCK(&wg->rtLock);
     wg->sendChannel = connectionId;
+    UA_UNLOCK(&wg->rtLock);
 
     /* Connection open, set to operational if not already done */
     if(wg->state != UA_PUBSUBSTATE_OPERATIONAL)
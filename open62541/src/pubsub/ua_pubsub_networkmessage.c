@@ -54,12 +54,24 @@ static UA_Boolean UA_NetworkMessage_ExtendedFlags2Enabled(const UA_NetworkMessag
 static UA_Boolean UA_DataSetMessageHeader_DataSetFlags2Enabled(const UA_DataSetMessageHeader* src);
 
 UA_StatusCode
-UA_NetworkMessage_updateBufferedMessage(UA_NetworkMessageOffsetBuffer *buffer) {
+UA_NetworkMessage_updateBufferedMessage(UA_NetworkMessageOffsetBuffer *buffer,
+                                        UA_ByteString *dst) {
+    if(dst->length < buffer->buffer.length)
+        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
     UA_StatusCode rv = UA_STATUSCODE_GOOD;
-    const UA_Byte *bufEnd = &buffer->buffer.data[buffer->buffer.length];
+    const UA_Byte *bufEnd = &dst->data[buffer->buffer.length];
     for(size_t i = 0; i < buffer->offsetsSize; ++i) {
         UA_NetworkMessageOffset *nmo = &buffer->offsets[i];
-        UA_Byte *bufPos = &buffer->buffer.data[nmo->offset];
+        UA_Byte *bufPos = &dst->data[nmo->offset];
+
+        /* The external value is switched atomically by the application (double
+         * buffering). Dereference it only once to encode a consistent value. */
+        const UA_DataValue *ext = NULL;
+        if(nmo->contentType == UA_PUBSUB_OFFSETTYPE_PAYLOAD_DATAVALUE_EXTERNAL ||
+           nmo->contentType == UA_PUBSUB_OFFSETTYPE_PAYLOAD_VARIANT_EXTERNAL ||
+           nmo->contentType == UA_PUBSUB_OFFSETTYPE_PAYLOAD_RAW_EXTERNAL)
+            ext = *(UA_DataValue * const volatile *)nmo->content.externalValue;
+
         switch(nmo->contentType) {
             case UA_PUBSUB_OFFSETTYPE_DATASETMESSAGE_SEQUENCENUMBER:
             case UA_PUBSUB_OFFSETTYPE_NETWORKMESSAGE_SEQUENCENUMBER:
@@ -70,13 +82,13 @@ UA_NetworkMessage_updateBufferedMessage(UA_NetworkMessageOffsetBuffer *buffer) {
                 rv = UA_DataValue_encodeBinary(&nmo->content.value, &bufPos, bufEnd);
                 break;
             case UA_PUBSUB_OFFSETTYPE_PAYLOAD_DATAVALUE_EXTERNAL:
-                rv = UA_DataValue_encodeBinary(*nmo->content.externalValue, &bufPos, bufEnd);
+                rv = UA_DataValue_encodeBinary(ext, &bufPos, bufEnd);
                 break;
             case UA_PUBSUB_OFFSETTYPE_PAYLOAD_VARIANT:
                 rv = UA_Variant_encodeBinary(&nmo->content.value.value, &bufPos, bufEnd);
                 break;
             case UA_PUBSUB_OFFSETTYPE_PAYLOAD_VARIANT_EXTERNAL:
-                rv = UA_Variant_encodeBinary(&(*nmo->content.externalValue)->value, &bufPos, bufEnd);
+                rv = UA_Variant_encodeBinary(&ext->value, &bufPos, bufEnd);
                 break;
             case UA_PUBSUB_OFFSETTYPE_PAYLOAD_RAW:
                 rv = UA_encodeBinaryInternal(nmo->content.value.value.data,
@@ -84,8 +96,7 @@ UA_NetworkMessage_updateBufferedMessage(UA_NetworkMessageOffsetBuffer *buffer) {
                                              &bufPos, &bufEnd, NULL, NULL);
                 break;
             case UA_PUBSUB_OFFSETTYPE_PAYLOAD_RAW_EXTERNAL:
-                rv = UA_encodeBinaryInternal((*nmo->content.externalValue)->value.data,
-                                             (*nmo->content.externalValue)->value.type,
+                rv = UA_encodeBinaryInternal(ext->value.data, ext->value.type,
                                              &bufPos, &bufEnd, NULL, NULL);
                 break;
             default:
@@ -1732,10 +1743,6 @@ UA_NetworkMessageOffsetBuffer_clear(UA_NetworkMessageOffsetBuffer *nmob) {
         UA_free(nmob->nm);
     }
 
-#ifdef UA_ENABLE_PUBSUB_ENCRYPTION
-    UA_ByteString_clear(&nmob->encryptBuffer);
-#endif
-
     if(nmob->offsetsSize == 0)
         return;
 
@@ -216,9 +216,6 @@ typedef struct {
     UA_NetworkMessage *nm; /* The precomputed NetworkMessage for subscriber */
     size_t rawMessageLength;
 #ifdef UA_ENABLE_PUBSUB_ENCRYPTION
-    UA_ByteString encryptBuffer; /* The precomputed message buffer is copied
-                                  * into the encrypt buffer for encryption and
-                                  * signing*/
     UA_Byte *payloadPosition; /* Payload Position of the message to encrypt*/
 #endif
 } UA_NetworkMessageOffsetBuffer;
@@ -226,8 +223,13 @@ typedef struct {
 void
 UA_NetworkMessageOffsetBuffer_clear(UA_NetworkMessageOffsetBuffer *nmob);
 
+/* Encode the changing fields of the offset table into dst. The static parts of
+ * dst must already contain the precomputed message buffer. Offsets are
+ * relative to the start of the buffer. So dst can be a copy of the
+ * precomputed buffer (e.g. a network buffer) or the buffer itself. */
 UA_StatusCode
-UA_NetworkMessage_updateBufferedMessage(UA_NetworkMessageOffsetBuffer *buffer);
+UA_NetworkMessage_updateBufferedMessage(UA_NetworkMessageOffsetBuffer *buffer,
+                                        UA_ByteString *dst);
 
 UA_StatusCode
 UA_NetworkMessage_updateBufferedNwMessage(UA_NetworkMessageOffsetBuffer *buffer,
@@ -334,6 +336,15 @@ UA_NetworkMessage_encodeJson(const UA_NetworkMessage *src,
                              size_t namespaceSize, UA_String *serverUris,
                              size_t serverUriSize, UA_Boolean useReversible);
 
+/* Encodes in a single pass into a newly allocated buffer. The buffer is
+ * enlarged during the encoding. Its length is set to the encoded size. The
+ * buffer can have more capacity than its length. */
+UA_StatusCode
+UA_NetworkMessage_encodeJsonAlloc(const UA_NetworkMessage *src, UA_ByteString *outBuf,
+                                  UA_String *namespaces, size_t namespaceSize,
+                                  UA_String *serverUris, size_t serverUriSize,
+                                  UA_Boolean useReversible);
+
 size_t
 UA_NetworkMessage_calcSizeJson(const UA_NetworkMessage *src,
                                UA_String *namespaces, size_t namespaceSize,
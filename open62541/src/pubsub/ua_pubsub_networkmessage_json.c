@@ -238,6 +238,36 @@ UA_NetworkMessage_encodeJson(const UA_NetworkMessage *src,
     return ret;
 }
 
+UA_StatusCode
+UA_NetworkMessage_encodeJsonAlloc(const UA_NetworkMessage *src, UA_ByteString *outBuf,
+                                  UA_String *namespaces, size_t namespaceSize,
+                                  UA_String *serverUris, size_t serverUriSize,
+                                  UA_Boolean useReversible) {
+    status ret = UA_ByteString_allocBuffer(outBuf, UA_JSON_INITIALBUFFERSIZE);
+    if(ret != UA_STATUSCODE_GOOD)
+        return ret;
+
+    /* Set up the context with the growable buffer */
+    CtxJson ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pos = outBuf->data;
+    ctx.end = &outBuf->data[outBuf->length];
+    ctx.growBuf = outBuf;
+    ctx.namespaces = namespaces;
+    ctx.namespacesSize = namespaceSize;
+    ctx.serverUris = serverUris;
+    ctx.serverUrisSize = serverUriSize;
+    ctx.useReversible = useReversible;
+
+    ret = UA_NetworkMessage_encodeJson_internal(src, &ctx);
+    if(ret != UA_STATUSCODE_GOOD) {
+        UA_ByteString_clear(outBuf);
+        return ret;
+    }
+    outBuf->length = (size_t)((uintptr_t)ctx.pos - (uintptr_t)outBuf->data);
+    return UA_STATUSCODE_GOOD;
+}
+
 size_t
 UA_NetworkMessage_calcSizeJson(const UA_NetworkMessage *src,
                                UA_String *namespaces, size_t namespaceSize,
@@ -103,6 +103,177 @@ UA_DataSetReader_checkIdentifier(UA_Server *server, UA_NetworkMessage *msg,
     return UA_STATUSCODE_BADNOTFOUND;
 }
 
+/************************/
+/* DataSetReader Index  */
+/************************/
+
+static UA_UInt32
+hashDataSetReaderKey(const UA_DataSetReaderKey *key) {
+    UA_UInt32 ids = ((UA_UInt32)key->writerGroupId << 16) | key->dataSetWriterId;
+    UA_UInt32 h = UA_ByteString_hash((UA_UInt32)key->publisherIdType,
+                                     (const UA_Byte*)&ids, sizeof(UA_UInt32));
+    UA_UInt64 numeric = 0;
+    switch(key->publisherIdType) {
+    case UA_PUBLISHERIDTYPE_BYTE: numeric = key->publisherId.byte; break;
+    case UA_PUBLISHERIDTYPE_UINT16: numeric = key->publisherId.uint16; break;
+    case UA_PUBLISHERIDTYPE_UINT32: numeric = key->publisherId.uint32; break;
+    case UA_PUBLISHERIDTYPE_UINT64: numeric = key->publisherId.uint64; break;
+    case UA_PUBLISHERIDTYPE_STRING:
+        return UA_ByteString_hash(h, key->publisherId.string.data,
+                                  key->publisherId.string.length);
+    default: break;
+    }
+    return UA_ByteString_hash(h, (const UA_Byte*)&numeric, sizeof(UA_UInt64));
+}
+
+static UA_Boolean
+equalDataSetReaderKey(const UA_DataSetReaderKey *a, const UA_DataSetReaderKey *b) {
+    if(a->publisherIdType != b->publisherIdType ||
+       a->writerGroupId != b->writerGroupId ||
+       a->dataSetWriterId != b->dataSetWriterId)
+        return false;
+    switch(a->publisherIdType) {
+    case UA_PUBLISHERIDTYPE_BYTE: return a->publisherId.byte == b->publisherId.byte;
+    case UA_PUBLISHERIDTYPE_UINT16: return a->publisherId.uint16 == b->publisherId.uint16;
+    case UA_PUBLISHERIDTYPE_UINT32: return a->publisherId.uint32 == b->publisherId.uint32;
+    case UA_PUBLISHERIDTYPE_UINT64: return a->publisherId.uint64 == b->publisherId.uint64;
+    case UA_PUBLISHERIDTYPE_STRING:
+        return UA_String_equal(&a->publisherId.string, &b->publisherId.string);
+    default: return false;
+    }
+}
+
+/* Returns false if the PublisherId of the reader has an unsupported type. Then
+ * the reader matches no message that contains a PublisherId. */
+static UA_Boolean
+getReaderKey(const UA_DataSetReader *dsr, UA_DataSetReaderKey *key) {
+    const UA_Variant *publisherId = &dsr->config.publisherId;
+    if(!UA_Variant_isScalar(publisherId))
+        return false;
+    if(publisherId->type == &UA_TYPES[UA_TYPES_BYTE]) {
+        key->publisherIdType = UA_PUBLISHERIDTYPE_BYTE;
+        key->publisherId.byte = *(UA_Byte*)publisherId->data;
+    } else if(publisherId->type == &UA_TYPES[UA_TYPES_UINT16]) {
+        key->publisherIdType = UA_PUBLISHERIDTYPE_UINT16;
+        key->publisherId.uint16 = *(UA_UInt16*)publisherId->data;
+    } else if(publisherId->type == &UA_TYPES[UA_TYPES_UINT32]) {
+        key->publisherIdType = UA_PUBLISHERIDTYPE_UINT32;
+        key->publisherId.uint32 = *(UA_UInt32*)publisherId->data;
+    } else if(publisherId->type == &UA_TYPES[UA_TYPES_UINT64]) {
+        key->publisherIdType = UA_PUBLISHERIDTYPE_UINT64;
+        key->publisherId.uint64 = *(UA_UInt64*)publisherId->data;
+    } else if(publisherId->type == &UA_TYPES[UA_TYPES_STRING]) {
+        key->publisherIdType = UA_PUBLISHERIDTYPE_STRING;
+        key->publisherId.string = *(UA_String*)publisherId->data;
+    } else {
+        return false;
+    }
+    key->writerGroupId = dsr->config.writerGroupId;
+    key->dataSetWriterId = dsr->config.dataSetWriterId;
+    return true;
+}
+
+UA_Boolean
+UA_DataSetReaderKey_fromNetworkMessage(const UA_NetworkMessage *nm,
+                                       UA_DataSetReaderKey *key) {
+    if(!nm->publisherIdEnabled || !nm->groupHeaderEnabled ||
+       !nm->groupHeader.writerGroupIdEnabled || !nm->payloadHeaderEnabled)
+        return false;
+    key->publisherIdType = nm->publisherIdType;
+    key->publisherId = nm->publisherId;
+    key->writerGroupId = nm->groupHeader.writerGroupId;
+    key->dataSetWriterId = 0;
+    return true;
+}
+
+void
+UA_DataSetReaderIndex_clear(UA_DataSetReaderIndex *index) {
+    UA_free(index->entries);
+    UA_free(index->buckets);
+    memset(index, 0, sizeof(UA_DataSetReaderIndex));
+}
+
+static UA_StatusCode
+buildReaderIndex(UA_PubSubConnection *c) {
+    UA_DataSetReaderIndex *index = &c->readerIndex;
+    UA_DataSetReaderIndex_clear(index);
+
+    /* Count the readers */
+    size_t readersSize = 0;
+    UA_ReaderGroup *rg;
+    LIST_FOREACH(rg, &c->readerGroups, listEntry) {
+        readersSize += rg->readersCount;
+    }
+    if(readersSize >= UA_UINT32_MAX)
+        return UA_STATUSCODE_BADOUTOFRANGE;
+
+    UA_UInt32 bucketsSize = 1;
+    while(bucketsSize < readersSize)
+        bucketsSize <<= 1;
+    index->buckets = (UA_UInt32*)UA_malloc(sizeof(UA_UInt32) * bucketsSize);
+    if(readersSize > 0)
+        index->entries = (UA_DataSetReaderIndexEntry*)
+            UA_malloc(sizeof(UA_DataSetReaderIndexEntry) * readersSize);
+    if(!index->buckets || (readersSize > 0 && !index->entries)) {
+        UA_DataSetReaderIndex_clear(index);
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+    index->bucketsSize = bucketsSize;
+    for(UA_UInt32 i = 0; i < bucketsSize; i++)
+        index->buckets[i] = UA_UINT32_MAX;
+
+    /* Insert the readers. The bucket lists follow the order of the readers. */
+    LIST_FOREACH(rg, &c->readerGroups, listEntry) {
+        if(rg->config.encodingMimeType != UA_PUBSUB_ENCODING_UADP)
+            continue;
+        UA_DataSetReader *dsr;
+        LIST_FOREACH(dsr, &rg->readers, listEntry) {
+            UA_DataSetReaderIndexEntry *e = &index->entries[index->entriesSize];
+            if(!getReaderKey(dsr, &e->key))
+                continue;
+            e->hash = hashDataSetReaderKey(&e->key);
+            e->next = UA_UINT32_MAX;
+            e->rg = rg;
+            e->dsr = dsr;
+            UA_UInt32 *pos = &index->buckets[e->hash & (bucketsSize - 1)];
+            while(*pos != UA_UINT32_MAX)
+                pos = &index->entries[*pos].next;
+            *pos = index->entriesSize++;
+        }
+    }
+
+    index->valid = true;
+    return UA_STATUSCODE_GOOD;
+}
+
+const UA_DataSetReaderIndex *
+UA_PubSubConnection_getReaderIndex(UA_PubSubConnection *c) {
+    if(!c->readerIndex.valid && buildReaderIndex(c) != UA_STATUSCODE_GOOD)
+        return NULL;
+    return &c->readerIndex;
+}
+
+const UA_DataSetReaderIndexEntry *
+UA_DataSetReaderIndex_find(const UA_DataSetReaderIndex *index,
+                           const UA_DataSetReaderKey *key,
+                           const UA_DataSetReaderIndexEntry *prev) {
+    UA_UInt32 hash;
+    UA_UInt32 next;
+    if(prev) {
+        hash = prev->hash;
+        next = prev->next;
+    } else {
+        hash = hashDataSetReaderKey(key);
+        next = index->buckets[hash & (index->bucketsSize - 1)];
+    }
+    for(; next != UA_UINT32_MAX; next = index->entries[next].next) {
+        const UA_DataSetReaderIndexEntry *e = &index->entries[next];
+        if(e->hash == hash && equalDataSetReaderKey(&e->key, key))
+            return e;
+    }
+    return NULL;
+}
+
 UA_StatusCode
 UA_DataSetReader_create(UA_Server *server, UA_NodeId readerGroupIdentifier,
                         const UA_DataSetReaderConfig *dataSetReaderConfig,
@@ -174,6 +345,7 @@ UA_DataSetReader_create(UA_Server *server, UA_NodeId readerGroupIdentifier,
     /* Add the new reader to the group */
     LIST_INSERT_HEAD(&readerGroup->readers, newDataSetReader, listEntry);
     readerGroup->readersCount++;
+    readerGroup->linkedConnection->readerIndex.valid = false;
 
     if(!UA_String_isEmpty(&newDataSetReader->config.linkedStandaloneSubscribedDataSetName)) {
         // find sds by name
@@ -322,6 +494,7 @@ UA_DataSetReader_remove(UA_Server *server, UA_DataSetReader *dsr) {
     /* Remove DataSetReader from group */
     LIST_REMOVE(dsr, listEntry);
     rg->readersCount--;
+    rg->linkedConnection->readerIndex.valid = false;
 
     /* THe offset buffer is only set when the dsr is frozen
      * UA_NetworkMessageOffsetBuffer_clear(&dsr->bufferedMessage); */
@@ -379,6 +552,7 @@ DataSetReader_updateConfig(UA_Server *server, UA_ReaderGroup *rg, UA_DataSetRead
         dsr->config.writerGroupId = config->writerGroupId;
     if(dsr->config.dataSetWriterId != config->dataSetWriterId)
         dsr->config.dataSetWriterId = config->dataSetWriterId;
+    rg->linkedConnection->readerIndex.valid = false;
 
     UA_TargetVariables *oldTV = &dsr->config.subscribedDataSet.subscribedDataSetTarget;
     const UA_TargetVariables *newTV = &config->subscribedDataSet.subscribedDataSetTarget;
@@ -1072,6 +1246,32 @@ UA_ReaderGroup_process(UA_Server *server, UA_ReaderGroup *readerGroup,
                                                      readerGroup->state, UA_STATUSCODE_GOOD);
         }
     }
+
+    /* Look up the readers for each DataSetMessage in the index */
+    UA_DataSetReaderKey key;
+    const UA_DataSetReaderIndex *index = NULL;
+    if(readerGroup->config.encodingMimeType == UA_PUBSUB_ENCODING_UADP &&
+       UA_DataSetReaderKey_fromNetworkMessage(nm, &key))
+        index = UA_PubSubConnection_getReaderIndex(readerGroup->linkedConnection);
+    if(index) {
+        UA_Byte totalDataSets = nm->payloadHeader.dataSetPayloadHeader.count;
+        for(UA_Byte i = 0; i < totalDataSets; i++) {
+            key.dataSetWriterId = nm->payloadHeader.dataSetPayloadHeader.dataSetWriterIds[i];
+            const UA_DataSetReaderIndexEntry *e = NULL;
+            while((e = UA_DataSetReaderIndex_find(index, &key, e))) {
+                if(e->rg != readerGroup)
+                    continue;
+                processed = true;
+                UA_LOG_DEBUG_READER(server->config.logging, e->dsr,
+                                    "Process Msg with DataSetReader!");
+                UA_DataSetReader_process(server, readerGroup, e->dsr,
+                                         &nm->payload.dataSetPayload.dataSetMessages[i]);
+            }
+        }
+        return processed;
+    }
+
+    /* Check every reader */
     LIST_FOREACH(reader, &readerGroup->readers, listEntry) {
         UA_StatusCode res =
             UA_DataSetReader_checkIdentifier(server, nm, reader, readerGroup->config);
@@ -1135,13 +1335,12 @@ UA_ReaderGroup_decodeAndProcessRT(UA_Server *server, UA_ReaderGroup *readerGroup
     useMembufAlloc();
 #endif
 
-    size_t i = 0;
     size_t pos = 0;
-    UA_Boolean match = false;
     UA_DataSetReader *dsr;
-    UA_STACKARRAY(UA_Boolean, matches, readerGroup->readersCount);
+    size_t matchesSize = 0;
+    UA_STACKARRAY(UA_DataSetReader*, matches, readerGroup->readersCount);
 #ifdef __clang_analyzer__
-    memset(matches, 0, sizeof(UA_Boolean)* readerGroup->readersCount); /* Pacify warning */
+    memset(matches, 0, sizeof(UA_DataSetReader*)* readerGroup->readersCount); /* Pacify warning */
 #endif
 
     /* Decode headers necessary for checking identifier. This can use malloc.
@@ -1155,21 +1354,48 @@ UA_ReaderGroup_decodeAndProcessRT(UA_Server *server, UA_ReaderGroup *readerGroup
         goto error;
     }
 
-    /* Check if the message is intended for each reader individually */
-    LIST_FOREACH(dsr, &readerGroup->readers, listEntry) {
-        rv = UA_DataSetReader_checkIdentifier(server, &currentNetworkMessage, dsr, readerGroup->config);
-        matches[i] = (rv == UA_STATUSCODE_GOOD);
-        i++;
-        if(rv != UA_STATUSCODE_GOOD) {
-            UA_LOG_INFO_READER(server->config.logging, dsr,
-                               "PubSub receive. Message intended for a different reader.");
-            continue;
+    /* Look up the readers in the index. Otherwise check if the message is
+     * intended for each reader individually. */
+    UA_DataSetReaderKey key;
+    const UA_DataSetReaderIndex *index = NULL;
+    if(readerGroup->config.encodingMimeType == UA_PUBSUB_ENCODING_UADP &&
+       UA_DataSetReaderKey_fromNetworkMessage(&currentNetworkMessage, &key))
+        index = UA_PubSubConnection_getReaderIndex(readerGroup->linkedConnection);
+    if(index) {
+        UA_Byte totalDataSets = currentNetworkMessage.payloadHeader.dataSetPayloadHeader.count;
+        for(UA_Byte i = 0; i < totalDataSets; i++) {
+            key.dataSetWriterId =
+                currentNetworkMessage.payloadHeader.dataSetPayloadHeader.dataSetWriterIds[i];
+            const UA_DataSetReaderIndexEntry *e = NULL;
+            while((e = UA_DataSetReaderIndex_find(index, &key, e))) {
+                if(e->rg != readerGroup)
+                    continue;
+                /* Add every reader only once */
+                size_t j = 0;
+                for(; j < matchesSize; j++) {
+                    if(matches[j] == e->dsr)
+                        break;
+                }
+                if(j == matchesSize) {
+                    UA_assert(matchesSize < readerGroup->readersCount);
+                    matches[matchesSize++] = e->dsr;
+                }
+            }
+        }
+    } else {
+        LIST_FOREACH(dsr, &readerGroup->readers, listEntry) {
+            rv = UA_DataSetReader_checkIdentifier(server, &currentNetworkMessage,
+                                                  dsr, readerGroup->config);
+            if(rv != UA_STATUSCODE_GOOD) {
+                UA_LOG_INFO_READER(server->config.logging, dsr,
+                                   "PubSub receive. Message intended for a different reader.");
+                continue;
+            }
+            matches[matchesSize++] = dsr;
         }
-        match = true;
     }
-    if(!match)
+    if(matchesSize == 0)
         goto error;
-    UA_assert(i == readerGroup->readersCount);
 
     /* Decrypt the message once for all readers */
 #ifdef UA_ENABLE_PUBSUB_ENCRYPTION
@@ -1193,14 +1419,8 @@ UA_ReaderGroup_decodeAndProcessRT(UA_Server *server, UA_ReaderGroup *readerGroup
 #endif
 
     /* Decode message for every reader. If this fails for one reader, abort overall. */
-    i = 0;
-    LIST_FOREACH(dsr, &readerGroup->readers, listEntry) {
-        UA_assert(i < readerGroup->readersCount);
-        UA_Boolean match = matches[i];
-        i++;
-        if(!match)
-            continue;
-
+    for(size_t i = 0; i < matchesSize; i++) {
+        dsr = matches[i];
         pos = 0; /* reset */
         if(!dsr->bufferedMessage.nm) {
             /* This is the first message being received for the RT fastpath.
@@ -1228,18 +1448,13 @@ UA_ReaderGroup_decodeAndProcessRT(UA_Server *server, UA_ReaderGroup *readerGroup
     }
 
     /* Process the decoded messages */
-    i = 0;
-    LIST_FOREACH(dsr, &readerGroup->readers, listEntry) {
-        UA_assert(i < readerGroup->readersCount);
-        UA_Boolean match = matches[i];
-        i++;
-        if(!match)
-            continue;
+    for(size_t i = 0; i < matchesSize; i++) {
+        dsr = matches[i];
         UA_DataSetReader_process(server, readerGroup, dsr,
                                  dsr->bufferedMessage.nm->payload.dataSetPayload.dataSetMessages);
     }
 
-    return match;
+    return true;
 
  error:
     UA_NetworkMessage_clear(&currentNetworkMessage);
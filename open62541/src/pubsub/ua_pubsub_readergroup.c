@@ -237,6 +237,7 @@ UA_ReaderGroup_remove(UA_Server *server, UA_ReaderGroup *rg) {
         /* Unlink from the connection */
         LIST_REMOVE(rg, listEntry);
         connection->readerGroupsSize--;
+        connection->readerIndex.valid = false;
         rg->linkedConnection = NULL;
 
         /* Actually remove the ReaderGroup */
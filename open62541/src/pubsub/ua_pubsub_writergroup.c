@@ -153,6 +153,8 @@ UA_WriterGroup_create(UA_Server *server, const UA_NodeId connection,
         newConfig->messageSettings.encoding = UA_EXTENSIONOBJECT_DECODED;
     }
 
+    UA_LOCK_INIT(&newWriterGroup->rtLock);
+
     /* Attach to the connection */
     LIST_INSERT_HEAD(&currentConnectionContext->writerGroups, newWriterGroup, listEntry);
     currentConnectionContext->writerGroupsSize++;
@@ -276,7 +278,18 @@ UA_WriterGroup_remove(UA_Server *server, UA_WriterGroup *wg) {
         UA_WriterGroupConfig_clear(&wg->config);
         UA_NodeId_clear(&wg->identifier);
         UA_NetworkMessageOffsetBuffer_clear(&wg->bufferedMessage);
-        UA_free(wg);
+
+        /* Waiting for a lock-free publish could deadlock, as it might need the
+         * EventLoop lock for sending. So the last in-flight publish frees the
+         * WriterGroup when it is done. */
+        UA_LOCK(&wg->rtLock);
+        UA_Boolean inFlight = (wg->rtPublishInFlight > 0);
+        wg->rtFreeDeferred = inFlight;
+        UA_UNLOCK(&wg->rtLock);
+        if(!inFlight) {
+            UA_LOCK_DESTROY(&wg->rtLock);
+            UA_free(wg);
+        }
     }
 
     /* Update the connection state */
@@ -391,7 +404,6 @@ UA_WriterGroup_freezeConfiguration(UA_Server *server, UA_WriterGroup *wg) {
         wg->bufferedMessage.payloadPosition = payloadPosition;
         wg->bufferedMessage.nm = (UA_NetworkMessage *)UA_calloc(1,sizeof(UA_NetworkMessage));
         wg->bufferedMessage.nm->securityHeader = networkMessage.securityHeader;
-        UA_ByteString_allocBuffer(&wg->bufferedMessage.encryptBuffer, msgSize);
     }
 #endif
 
@@ -436,6 +448,13 @@ UA_WriterGroup_freezeConfiguration(UA_Server *server, UA_WriterGroup *wg) {
         }
     }
 
+    /* Publish without the server lock from now on */
+    if((wg->config.rtLevel & UA_PUBSUB_RT_DETERMINISTIC) == UA_PUBSUB_RT_DETERMINISTIC) {
+        UA_LOCK(&wg->rtLock);
+        wg->rtPublishLockFree = true;
+        UA_UNLOCK(&wg->rtLock);
+    }
+
  cleanup:
     UA_free(networkMessage.payload.dataSetPayload.sizes);
 
@@ -478,8 +497,14 @@ UA_WriterGroup_unfreezeConfiguration(UA_Server *server, UA_WriterGroup *wg) {
         UA_DataSetWriter_unfreezeConfiguration(server, dsw);
     }
 
-    UA_NetworkMessageOffsetBuffer_clear(&wg->bufferedMessage);
+    /* Stop the RT publish path before the offset table is removed */
+    UA_LOCK(&wg->rtLock);
     wg->configurationFrozen = false;
+    wg->rtPublishLockFree = false;
+    UA_UNLOCK(&wg->rtLock);
+
+    UA_WriterGroup_releaseSendBuffer(wg);
+    UA_NetworkMessageOffsetBuffer_clear(&wg->bufferedMessage);
 
     return UA_STATUSCODE_GOOD;
 }
@@ -714,22 +739,28 @@ setWriterGroupEncryptionKeys(UA_Server *server, const UA_NodeId writerGroup,
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
+    /* The RT publish path might use the context without the server lock */
+    UA_StatusCode res;
+    UA_LOCK(&wg->rtLock);
     if(securityTokenId != wg->securityTokenId) {
         wg->securityTokenId = securityTokenId;
         wg->nonceSequenceNumber = 1;
     }
 
-    /* Create a new context */
     if(!wg->securityPolicyContext) {
-        return wg->config.securityPolicy->
+        /* Create a new context */
+        res = wg->config.securityPolicy->
             newContext(wg->config.securityPolicy->policyContext,
                        &signingKey, &encryptingKey, &keyNonce,
                        &wg->securityPolicyContext);
+    } else {
+        /* Update the context */
+        res = wg->config.securityPolicy->
+            setSecurityKeys(wg->securityPolicyContext, &signingKey,
+                            &encryptingKey, &keyNonce);
     }
-
-    /* Update the context */
-    return wg->config.securityPolicy->
-        setSecurityKeys(wg->securityPolicyContext, &signingKey, &encryptingKey, &keyNonce);
+    UA_UNLOCK(&wg->rtLock);
+    return res;
 }
 
 UA_StatusCode
@@ -995,8 +1026,9 @@ sendNetworkMessageBuffer(UA_Server *server, UA_WriterGroup *wg,
 
 #ifdef UA_ENABLE_JSON_ENCODING
 static UA_StatusCode
-sendNetworkMessageJson(UA_Server *server, UA_PubSubConnection *connection, UA_WriterGroup *wg,
-                       UA_DataSetMessage *dsm, UA_UInt16 *writerIds, UA_Byte dsmCount) {
+prepareNetworkMessageJson(UA_PubSubConnection *connection, uintptr_t sendChannel,
+                          UA_DataSetMessage *dsm, UA_UInt16 *writerIds,
+                          UA_Byte dsmCount, UA_ByteString *buf) {
     /* Prepare the NetworkMessage */
     UA_NetworkMessage nm;
     memset(&nm, 0, sizeof(UA_NetworkMessage));
@@ -1010,41 +1042,20 @@ sendNetworkMessageJson(UA_Server *server, UA_PubSubConnection *connection, UA_Wr
     nm.publisherIdType = connection->config.publisherIdType;
     nm.publisherId = connection->config.publisherId;
 
-    /* Compute the message length */
-    size_t msgSize = UA_NetworkMessage_calcSizeJson(&nm, NULL, 0, NULL, 0, true);
-
-    UA_ConnectionManager *cm = connection->cm;
-    if(!cm)
-        return UA_STATUSCODE_BADINTERNALERROR;
-
-    /* Select the wg sendchannel if configured */
-    uintptr_t sendChannel = connection->sendChannel;
-    if(wg->sendChannel != 0)
-        sendChannel = wg->sendChannel;
-    if(sendChannel == 0) {
-        UA_LOG_ERROR_WRITERGROUP(server->config.logging, wg,
-                                 "Cannot send, no open connection");
-        return UA_STATUSCODE_BADINTERNALERROR;
-    }
-
-    /* Allocate the buffer */
-    UA_ByteString buf;
-    UA_StatusCode res = cm->allocNetworkBuffer(cm, sendChannel, &buf, msgSize);
+    /* Encode the message in a single pass into a growable buffer. This is
+     * cheaper than computing the length with an additional encoding pass. */
+    UA_ByteString json;
+    UA_StatusCode res =
+        UA_NetworkMessage_encodeJsonAlloc(&nm, &json, NULL, 0, NULL, 0, true);
     UA_CHECK_STATUS(res, return res);
 
-    /* Encode the message */
-    UA_Byte *bufPos = buf.data;
-    const UA_Byte *bufEnd = &buf.data[msgSize];
-    res = UA_NetworkMessage_encodeJson(&nm, &bufPos, &bufEnd, NULL, 0, NULL, 0, true);
-    if(res != UA_STATUSCODE_GOOD) {
-        cm->freeNetworkBuffer(cm, sendChannel, &buf);
-        return res;
-    }
-    UA_assert(bufPos == bufEnd);
-
-    /* Send the prepared messages */
-    sendNetworkMessageBuffer(server, wg, connection, sendChannel, &buf);
-    return UA_STATUSCODE_GOOD;
+    /* Copy into the network buffer */
+    UA_ConnectionManager *cm = connection->cm;
+    res = cm->allocNetworkBuffer(cm, sendChannel, buf, json.length);
+    if(res == UA_STATUSCODE_GOOD)
+        memcpy(buf->data, json.data, json.length);
+    UA_ByteString_clear(&json);
+    return res;
 }
 #endif
 
@@ -1149,8 +1160,9 @@ generateNetworkMessage(UA_PubSubConnection *connection, UA_WriterGroup *wg,
 }
 
 static UA_StatusCode
-sendNetworkMessageBinary(UA_Server *server, UA_PubSubConnection *connection, UA_WriterGroup *wg,
-                         UA_DataSetMessage *dsm, UA_UInt16 *writerIds, UA_Byte dsmCount) {
+prepareNetworkMessageBinary(UA_PubSubConnection *connection, UA_WriterGroup *wg,
+                            uintptr_t sendChannel, UA_DataSetMessage *dsm,
+                            UA_UInt16 *writerIds, UA_Byte dsmCount, UA_ByteString *buf) {
     UA_NetworkMessage nm;
     memset(&nm, 0, sizeof(UA_NetworkMessage));
 
@@ -1172,38 +1184,21 @@ sendNetworkMessageBinary(UA_Server *server, UA_PubSubConnection *connection, UA_
     }
 #endif
 
+    /* Allocate the buffer */
     UA_ConnectionManager *cm = connection->cm;
-    if(!cm)
-        return UA_STATUSCODE_BADINTERNALERROR;
-
-    /* Select the wg sendchannel if configured */
-    uintptr_t sendChannel = connection->sendChannel;
-    if(wg->sendChannel != 0)
-        sendChannel = wg->sendChannel;
-    if(sendChannel == 0) {
-        UA_LOG_ERROR_WRITERGROUP(server->config.logging, wg,
-                                 "Cannot send, no open connection");
-        return UA_STATUSCODE_BADINTERNALERROR;
-    }
-
-    /* Allocate the buffer. Allocate on the stack if the buffer is small. */
-    UA_ByteString buf = UA_BYTESTRING_NULL;
-    rv = cm->allocNetworkBuffer(cm, sendChannel, &buf, msgSize);
-    UA_CHECK_STATUS(rv, return rv);
-
-    /* Encode and encrypt the message */
-    rv = encodeNetworkMessage(wg, &nm, &buf);
+    rv = cm->allocNetworkBuffer(cm, sendChannel, buf, msgSize);
     if(rv != UA_STATUSCODE_GOOD) {
-        cm->freeNetworkBuffer(cm, sendChannel, &buf);
         UA_free(nm.payload.dataSetPayload.sizes);
         return rv;
     }
 
-    /* Send out the message */
-    sendNetworkMessageBuffer(server, wg, connection, sendChannel, &buf);
+    /* Encode and encrypt the message */
+    rv = encodeNetworkMessage(wg, &nm, buf);
+    if(rv != UA_STATUSCODE_GOOD)
+        cm->freeNetworkBuffer(cm, sendChannel, buf);
 
     UA_free(nm.payload.dataSetPayload.sizes);
-    return UA_STATUSCODE_GOOD;
+    return rv;
 }
 
 static void
@@ -1250,6 +1245,190 @@ sampleOffsetPublishingValues(UA_Server *server, UA_WriterGroup *wg) {
     unlockServer(server);
 }
 
+/* Select the WriterGroup sendchannel if configured */
+static uintptr_t
+getSendChannel(UA_PubSubConnection *connection, UA_WriterGroup *wg) {
+    if(wg->sendChannel != 0)
+        return wg->sendChannel;
+    return connection->sendChannel;
+}
+
+/* The send buffer of the RT fast path is allocated and released outside of the
+ * rtLock. The ConnectionManager can take the EventLoop lock. And the EventLoop
+ * lock is held during the connection callbacks, which take the rtLock in
+ * turn. */
+void
+UA_WriterGroup_releaseSendBuffer(UA_WriterGroup *wg) {
+    UA_LOCK(&wg->rtLock);
+    uintptr_t channel = wg->sendBufferChannel;
+    UA_ByteString buf = wg->sendBuffer;
+    UA_ByteString_init(&wg->sendBuffer);
+    wg->sendBufferChannel = 0;
+    UA_UNLOCK(&wg->rtLock);
+
+    UA_ConnectionManager *cm = wg->linkedConnection->cm;
+    if(buf.length > 0 && cm)
+        cm->freeNetworkBuffer(cm, channel, &buf);
+}
+
+/* Without the server lock, the WriterGroup can be unfrozen and removed at any
+ * time. Its identifier is only printed while the configuration is still
+ * frozen. */
+static void
+logRTError(UA_Server *server, UA_WriterGroup *wg, const char *msg) {
+    UA_LOCK(&wg->rtLock);
+    if(wg->configurationFrozen)
+        UA_LOG_ERROR_WRITERGROUP(server->config.logging, wg, "%s", msg);
+    UA_UNLOCK(&wg->rtLock);
+}
+
+/* Keep the send buffer for the next cycle. It is released instead if the
+ * configuration was unfrozen or the send channel has changed in the
+ * meantime. */
+static void
+retainSendBuffer(UA_WriterGroup *wg, UA_ConnectionManager *cm,
+                 uintptr_t sendChannel, UA_ByteString *buf) {
+    UA_LOCK(&wg->rtLock);
+    if(wg->configurationFrozen && wg->sendBuffer.length == 0 &&
+       getSendChannel(wg->linkedConnection, wg) == sendChannel) {
+        wg->sendBuffer = *buf;
+        wg->sendBufferChannel = sendChannel;
+        UA_ByteString_init(buf);
+    }
+    UA_UNLOCK(&wg->rtLock);
+
+    if(buf->length > 0) {
+        cm->freeNetworkBuffer(cm, sendChannel, buf);
+        UA_ByteString_init(buf);
+    }
+}
+
+/* Patch the offset table into the prepared send buffer and send it. If the
+ * ConnectionManager supports sending from a retained buffer, the send buffer
+ * stays with the WriterGroup. Then the static parts of the message are only
+ * copied into it once. The WriterGroup is only accessed under its rtLock and
+ * while its configuration is frozen. This does not require the server lock.
+ * Returns the status of sending. Other errors are logged and not returned. */
+static UA_StatusCode
+sendWithOffsets(UA_Server *server, UA_WriterGroup *wg) {
+    /* Get the current send channel and take the send buffer out of the
+     * WriterGroup */
+    UA_LOCK(&wg->rtLock);
+    if(!wg->configurationFrozen) {
+        UA_UNLOCK(&wg->rtLock);
+        return UA_STATUSCODE_GOOD;
+    }
+    UA_PubSubConnection *connection = wg->linkedConnection;
+    UA_ConnectionManager *cm = connection->cm;
+    uintptr_t sendChannel = getSendChannel(connection, wg);
+    if(!cm || sendChannel == 0) {
+        if(cm)
+            UA_LOG_ERROR_WRITERGROUP(server->config.logging, wg,
+                                     "Cannot send, no open connection");
+        UA_UNLOCK(&wg->rtLock);
+        return UA_STATUSCODE_GOOD;
+    }
+    UA_Boolean retain = (cm->sendRetainedWithConnection != NULL);
+    size_t msgLength = wg->bufferedMessage.buffer.length;
+    uintptr_t bufChannel = wg->sendBufferChannel;
+    UA_ByteString buf = wg->sendBuffer;
+    UA_ByteString_init(&wg->sendBuffer);
+    UA_UNLOCK(&wg->rtLock);
+
+    /* The send buffer belongs to a different channel (e.g. after a
+     * reconnect) */
+    if(buf.length > 0 && bufChannel != sendChannel) {
+        cm->freeNetworkBuffer(cm, bufChannel, &buf);
+        UA_ByteString_init(&buf);
+    }
+
+    /* Usually the send buffer was retained from the previous cycle */
+    UA_Boolean prefill = (buf.length == 0);
+    if(prefill) {
+        UA_StatusCode res = cm->allocNetworkBuffer(cm, sendChannel, &buf, msgLength);
+        if(res != UA_STATUSCODE_GOOD) {
+            logRTError(server, wg, "PubSub message memory allocation failed");
+            return UA_STATUSCODE_GOOD;
+        }
+    }
+
+    UA_LOCK(&wg->rtLock);
+    if(!wg->configurationFrozen || getSendChannel(connection, wg) != sendChannel ||
+       wg->bufferedMessage.buffer.length != msgLength) {
+        /* Modified in parallel */
+        UA_UNLOCK(&wg->rtLock);
+        cm->freeNetworkBuffer(cm, sendChannel, &buf);
+        return UA_STATUSCODE_GOOD;
+    }
+
+    /* Encryption is done in-place. Then the static parts of the message have
+     * to be restored in every cycle. */
+#ifdef UA_ENABLE_PUBSUB_ENCRYPTION
+    UA_Boolean encrypt = (wg->config.securityMode > UA_MESSAGESECURITYMODE_NONE);
+    prefill |= encrypt;
+#endif
+    if(prefill)
+        memcpy(buf.data, wg->bufferedMessage.buffer.data, msgLength);
+
+    /* Patch the changing fields directly into the send buffer */
+    UA_StatusCode res =
+        UA_NetworkMessage_updateBufferedMessage(&wg->bufferedMessage, &buf);
+    if(res != UA_STATUSCODE_GOOD) {
+        /* Keep the send buffer. All fields are patched again next time. */
+        UA_LOG_DEBUG_WRITERGROUP(server->config.logging, wg,
+                                 "PubSub sending. Unknown field type.");
+        UA_UNLOCK(&wg->rtLock);
+        if(retain)
+            retainSendBuffer(wg, cm, sendChannel, &buf);
+        else
+            cm->freeNetworkBuffer(cm, sendChannel, &buf);
+        return UA_STATUSCODE_GOOD;
+    }
+
+#ifdef UA_ENABLE_PUBSUB_ENCRYPTION
+    /* Encrypt and sign in-place in the send buffer */
+    if(encrypt) {
+        size_t sigSize = wg->config.securityPolicy->symmetricModule.cryptoModule.
+            signatureAlgorithm.getLocalSignatureSize(wg->securityPolicyContext);
+        size_t payloadOffset = (size_t)(wg->bufferedMessage.payloadPosition -
+                                        wg->bufferedMessage.buffer.data);
+        res = encryptAndSign(wg, wg->bufferedMessage.nm, buf.data,
+                             buf.data + payloadOffset,
+                             buf.data + buf.length - sigSize);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_LOG_ERROR_WRITERGROUP(server->config.logging, wg,
+                                     "PubSub Encryption failed");
+            UA_UNLOCK(&wg->rtLock);
+            cm->freeNetworkBuffer(cm, sendChannel, &buf);
+            return UA_STATUSCODE_GOOD;
+        }
+    }
+#endif
+    UA_UNLOCK(&wg->rtLock);
+
+    if(retain) {
+        /* Send without giving the buffer away and keep it for the next
+         * cycle */
+        res = cm->sendRetainedWithConnection(cm, sendChannel,
+                                             &UA_KEYVALUEMAP_NULL, &buf);
+        retainSendBuffer(wg, cm, sendChannel, &buf);
+    } else {
+        /* The buffer is released by the ConnectionManager, also if sending
+         * fails */
+        res = cm->sendWithConnection(cm, sendChannel, &UA_KEYVALUEMAP_NULL, &buf);
+    }
+    if(res != UA_STATUSCODE_GOOD) {
+        logRTError(server, wg, "Sending NetworkMessage failed");
+        return res;
+    }
+
+    /* Sending successful - increase the sequence number */
+    UA_LOCK(&wg->rtLock);
+    wg->sequenceNumber++;
+    UA_UNLOCK(&wg->rtLock);
+    return UA_STATUSCODE_GOOD;
+}
+
 static void
 publishWithOffsets(UA_Server *server, UA_WriterGroup *writerGroup,
                    UA_PubSubConnection *connection) {
@@ -1261,94 +1440,163 @@ publishWithOffsets(UA_Server *server, UA_WriterGroup *writerGroup,
     if((writerGroup->config.rtLevel & UA_PUBSUB_RT_DIRECT_VALUE_ACCESS) == 0)
         sampleOffsetPublishingValues(server, writerGroup);
 
-    UA_StatusCode res =
-        UA_NetworkMessage_updateBufferedMessage(&writerGroup->bufferedMessage);
-
+    /* Failure, set the WriterGroup into an error mode */
+    UA_StatusCode res = sendWithOffsets(server, writerGroup);
     if(res != UA_STATUSCODE_GOOD) {
-        UA_LOG_DEBUG_WRITERGROUP(server->config.logging, writerGroup,
-                                 "PubSub sending. Unknown field type.");
-        return;
+        UA_WriterGroup_setPubSubState(server, writerGroup, UA_PUBSUBSTATE_ERROR, res);
+        UA_PubSubConnection_setPubSubState(server, connection, UA_PUBSUBSTATE_ERROR, res);
     }
+}
 
-    UA_ByteString *buf = &writerGroup->bufferedMessage.buffer;
-
-#ifdef UA_ENABLE_PUBSUB_ENCRYPTION
-    /* Send the encrypted buffered message if PubSub encryption is enabled */
-    if(writerGroup->config.securityMode > UA_MESSAGESECURITYMODE_NONE) {
-        size_t sigSize = writerGroup->config.securityPolicy->symmetricModule.cryptoModule.
-            signatureAlgorithm.getLocalSignatureSize(writerGroup->securityPolicyContext);
-
-        UA_Byte payloadOffset = (UA_Byte)(writerGroup->bufferedMessage.payloadPosition -
-                                          writerGroup->bufferedMessage.buffer.data);
-        memcpy(writerGroup->bufferedMessage.encryptBuffer.data,
-               writerGroup->bufferedMessage.buffer.data,
-               writerGroup->bufferedMessage.buffer.length);
-        res = encryptAndSign(writerGroup, writerGroup->bufferedMessage.nm,
-                             writerGroup->bufferedMessage.encryptBuffer.data,
-                             writerGroup->bufferedMessage.encryptBuffer.data + payloadOffset,
-                             writerGroup->bufferedMessage.encryptBuffer.data +
-                                 writerGroup->bufferedMessage.encryptBuffer.length - sigSize);
+/* The last in-flight lock-free publish frees a WriterGroup that has been
+ * removed in the meantime */
+static void
+endLockFreePublish(UA_WriterGroup *wg) {
+    UA_LOCK(&wg->rtLock);
+    wg->rtPublishInFlight--;
+    UA_Boolean freeWg = (wg->rtPublishInFlight == 0 && wg->rtFreeDeferred);
+    UA_UNLOCK(&wg->rtLock);
+    if(freeWg) {
+        UA_LOCK_DESTROY(&wg->rtLock);
+        UA_free(wg);
+    }
+}
 
-        if(res != UA_STATUSCODE_GOOD) {
-            UA_LOG_ERROR_WRITERGROUP(server->config.logging, writerGroup,
-                                     "PubSub Encryption failed");
-            return;
+/* Frozen WriterGroups with UA_PUBSUB_RT_DETERMINISTIC access neither the
+ * information model nor the PubSub configuration when publishing. So they
+ * publish without taking the server lock. The publish is counted as in-flight
+ * so that the WriterGroup is not freed before it has finished. Returns false
+ * if the WriterGroup needs the regular publish path. */
+static UA_Boolean
+publishLockFree(UA_Server *server, UA_WriterGroup *writerGroup) {
+    UA_LOCK(&writerGroup->rtLock);
+    UA_Boolean lockFree = writerGroup->rtPublishLockFree;
+    if(lockFree)
+        writerGroup->rtPublishInFlight++;
+    UA_UNLOCK(&writerGroup->rtLock);
+    if(!lockFree)
+        return false;
+
+    /* Sending failed. Only the state change needs the server lock. Skip it if
+     * the WriterGroup was removed in the meantime. */
+    UA_StatusCode res = sendWithOffsets(server, writerGroup);
+    if(res != UA_STATUSCODE_GOOD) {
+        lockServer(server);
+        UA_LOCK(&writerGroup->rtLock);
+        UA_Boolean removed = writerGroup->rtFreeDeferred;
+        UA_UNLOCK(&writerGroup->rtLock);
+        if(!removed) {
+            UA_WriterGroup_setPubSubState(server, writerGroup,
+                                          UA_PUBSUBSTATE_ERROR, res);
+            UA_PubSubConnection_setPubSubState(server, writerGroup->linkedConnection,
+                                               UA_PUBSUBSTATE_ERROR, res);
         }
-
-        buf = &writerGroup->bufferedMessage.encryptBuffer;
+        unlockServer(server);
     }
-#endif
 
-    UA_ConnectionManager *cm = connection->cm;
-    if(!cm)
-        return;
+    endLockFreePublish(writerGroup);
+    return true;
+}
 
-    /* Select the wg sendchannel if configured */
-    uintptr_t sendChannel = connection->sendChannel;
-    if(writerGroup->sendChannel != 0)
-        sendChannel = writerGroup->sendChannel;
-    if(sendChannel == 0) {
-        UA_LOG_ERROR_WRITERGROUP(server->config.logging, writerGroup,
+/* Encode the NetworkMessage into a buffer of the ConnectionManager. If this
+ * fails, the WriterGroup is set into an error mode. */
+static UA_StatusCode
+prepareNetworkMessage(UA_Server *server, UA_WriterGroup *wg,
+                      UA_PubSubConnection *connection, uintptr_t sendChannel,
+                      UA_DataSetMessage *dsm, UA_UInt16 *writerIds,
+                      UA_Byte dsmCount, UA_ByteString *buf) {
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    if(!connection->cm) {
+        res = UA_STATUSCODE_BADINTERNALERROR;
+    } else if(sendChannel == 0) {
+        UA_LOG_ERROR_WRITERGROUP(server->config.logging, wg,
                                  "Cannot send, no open connection");
-        return;
+        res = UA_STATUSCODE_BADINTERNALERROR;
+    } else {
+        switch(wg->config.encodingMimeType) {
+        case UA_PUBSUB_ENCODING_UADP:
+            res = prepareNetworkMessageBinary(connection, wg, sendChannel, dsm,
+                                              writerIds, dsmCount, buf);
+            break;
+#ifdef UA_ENABLE_JSON_ENCODING
+        case UA_PUBSUB_ENCODING_JSON:
+            res = prepareNetworkMessageJson(connection, sendChannel, dsm,
+                                            writerIds, dsmCount, buf);
+            break;
+#endif
+        default:
+            res = UA_STATUSCODE_BADNOTSUPPORTED;
+            break;
+        }
     }
 
-    /* Copy into the network buffer */
-    UA_ByteString outBuf;
-    res = cm->allocNetworkBuffer(cm, sendChannel, &outBuf, buf->length);
+    /* If encoding failed, disable all writer of the writergroup */
     if(res != UA_STATUSCODE_GOOD) {
-        UA_LOG_ERROR_WRITERGROUP(server->config.logging, writerGroup,
-                                 "PubSub message memory allocation failed");
-        return;
+        UA_LOG_ERROR_WRITERGROUP(server->config.logging, wg,
+                                 "PubSub Publish: Could not send a NetworkMessage "
+                                 "with status code %s", UA_StatusCode_name(res));
+        UA_WriterGroup_setPubSubState(server, wg, UA_PUBSUBSTATE_ERROR, res);
     }
-    memcpy(outBuf.data, buf->data, buf->length);
-    sendNetworkMessageBuffer(server, writerGroup, connection, sendChannel, &outBuf);
+    return res;
 }
 
 static void
 sendNetworkMessage(UA_Server *server, UA_WriterGroup *wg, UA_PubSubConnection *connection,
                    UA_DataSetMessage *dsm, UA_UInt16 *writerIds, UA_Byte dsmCount) {
-    UA_StatusCode res = UA_STATUSCODE_GOOD;
-    switch(wg->config.encodingMimeType) {
-    case UA_PUBSUB_ENCODING_UADP:
-        res = sendNetworkMessageBinary(server, connection, wg, dsm, writerIds, dsmCount);
-        break;
-#ifdef UA_ENABLE_JSON_ENCODING
-    case UA_PUBSUB_ENCODING_JSON:
-        res = sendNetworkMessageJson(server, connection, wg, dsm, writerIds, dsmCount);
-        break;
-#endif
-    default:
-        res = UA_STATUSCODE_BADNOTSUPPORTED;
-        break;
+    UA_ByteString buf;
+    uintptr_t sendChannel = getSendChannel(connection, wg);
+    UA_StatusCode res = prepareNetworkMessage(server, wg, connection, sendChannel,
+                                              dsm, writerIds, dsmCount, &buf);
+    if(res != UA_STATUSCODE_GOOD)
+        return;
+    sendNetworkMessageBuffer(server, wg, connection, sendChannel, &buf);
+}
+
+/* Encode all NetworkMessages of the publish cycle up front and hand them to the
+ * ConnectionManager at once. Each NetworkMessage gets the next sequence number
+ * during the encoding. */
+static void
+sendNetworkMessageBatch(UA_Server *server, UA_WriterGroup *wg,
+                        UA_PubSubConnection *connection, UA_DataSetMessage *dsm,
+                        UA_UInt16 *writerIds, size_t dsmCount, UA_Byte maxDSM) {
+    UA_ConnectionManager *cm = connection->cm;
+    uintptr_t sendChannel = getSendChannel(connection, wg);
+    UA_UInt16 sequenceNumber = wg->sequenceNumber;
+
+    size_t nmCount = (dsmCount + maxDSM - 1) / maxDSM;
+    UA_STACKARRAY(UA_ByteString, bufs, nmCount);
+    size_t bufsSize = 0;
+
+    /* Encode the NetworkMessages */
+    UA_Byte nmDsmCount = 0;
+    for(size_t i = 0; i < dsmCount; i += nmDsmCount) {
+        nmDsmCount = (i + maxDSM > dsmCount) ? (UA_Byte)(dsmCount - i) : maxDSM;
+        UA_StatusCode res =
+            prepareNetworkMessage(server, wg, connection, sendChannel, &dsm[i],
+                                  &writerIds[i], nmDsmCount, &bufs[bufsSize]);
+        if(res != UA_STATUSCODE_GOOD)
+            continue;
+        bufsSize++;
+        wg->sequenceNumber++;
     }
 
-    /* If sending failed, disable all writer of the writergroup */
+    if(bufsSize == 0)
+        return;
+
+    /* Send out all messages */
+    wg->lastPublishTimeStamp = UA_DateTime_nowMonotonic();
+    UA_StatusCode res =
+        cm->sendBatchWithConnection(cm, sendChannel, &UA_KEYVALUEMAP_NULL,
+                                    bufs, bufsSize);
+
+    /* Failure, reset the sequence number and set the WriterGroup into an
+     * error mode */
     if(res != UA_STATUSCODE_GOOD) {
         UA_LOG_ERROR_WRITERGROUP(server->config.logging, wg,
-                                 "PubSub Publish: Could not send a NetworkMessage "
-                                 "with status code %s", UA_StatusCode_name(res));
+                                 "Sending NetworkMessage failed");
+        wg->sequenceNumber = sequenceNumber;
         UA_WriterGroup_setPubSubState(server, wg, UA_PUBSUBSTATE_ERROR, res);
+        UA_PubSubConnection_setPubSubState(server, connection, UA_PUBSUBSTATE_ERROR, res);
     }
 }
 
@@ -1359,6 +1607,10 @@ UA_WriterGroup_publishCallback(UA_Server *server, UA_WriterGroup *writerGroup) {
     UA_assert(writerGroup != NULL);
     UA_assert(server != NULL);
 
+    /* Realtime path without the server lock */
+    if(publishLockFree(server, writerGroup))
+        return;
+
     lockServer(server);
 
     UA_LOG_DEBUG_WRITERGROUP(server->config.logging, writerGroup, "Publish Callback");
@@ -1451,16 +1703,24 @@ UA_WriterGroup_publishCallback(UA_Server *server, UA_WriterGroup *writerGroup) {
         dsmCount++;
     }
 
-    /* Send the NetworkMessages with batched DataSetMessages */
-    UA_Byte nmDsmCount = 0;
-    for(size_t i = 0; i < dsmCount; i += nmDsmCount) {
-        /* How many dsm are batched in this iteration? */
-        nmDsmCount = (i + maxDSM > dsmCount) ? (UA_Byte)(dsmCount - i) : maxDSM;
+    /* Send the NetworkMessages with batched DataSetMessages. If several
+     * NetworkMessages are needed and the ConnectionManager supports it, they
+     * are handed over at once. */
+    if(dsmCount > maxDSM && connection->cm &&
+       connection->cm->sendBatchWithConnection) {
+        sendNetworkMessageBatch(server, writerGroup, connection, dsmStore,
+                                dsWriterIds, dsmCount, maxDSM);
+    } else {
+        UA_Byte nmDsmCount = 0;
+        for(size_t i = 0; i < dsmCount; i += nmDsmCount) {
+            /* How many dsm are batched in this iteration? */
+            nmDsmCount = (i + maxDSM > dsmCount) ? (UA_Byte)(dsmCount - i) : maxDSM;
 
-        writerGroup->lastPublishTimeStamp = UA_DateTime_nowMonotonic();
-        /* Send the batched messages */
-        sendNetworkMessage(server, writerGroup, connection, &dsmStore[i],
-                           &dsWriterIds[i], nmDsmCount);
+            writerGroup->lastPublishTimeStamp = UA_DateTime_nowMonotonic();
+            /* Send the batched messages */
+            sendNetworkMessage(server, writerGroup, connection, &dsmStore[i],
+                               &dsWriterIds[i], nmDsmCount);
+        }
     }
 
     /* Clean up DSM */
@@ -259,6 +259,7 @@ UA_Server_delete(UA_Server *server) {
     LIST_FOREACH_SAFE(current, &server->sessions, pointers, temp) {
         UA_Server_removeSession(server, current, UA_SHUTDOWNREASON_CLOSE);
     }
+    UA_Server_clearSessionIndex(server);
     UA_Array_delete(server->namespaces, server->namespacesSize, &UA_TYPES[UA_TYPES_STRING]);
 
 #ifdef UA_ENABLE_SUBSCRIPTIONS
@@ -280,6 +281,11 @@ UA_Server_delete(UA_Server *server) {
     UA_ConditionList_delete(server);
 #endif
 
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+    UA_EventEmitCache_clear(&server->eventEmitCache);
+    UA_EventTypeIndex_clear(&server->eventTypeIndex);
+#endif
+
 #endif
 
 #ifdef UA_ENABLE_PUBSUB
@@ -304,6 +310,10 @@ UA_Server_delete(UA_Server *server) {
 
 #if UA_MULTITHREADING >= 100
     UA_LOCK_DESTROY(&server->serviceMutex);
+    UA_RWLOCK_DESTROY(&server->serviceRWLock);
+# ifdef UA_ENABLE_HISTORIZING
+    UA_LOCK_DESTROY(&server->historyLock);
+# endif
 #endif
 
     /* Delete the server itself and return */
@@ -348,6 +358,10 @@ UA_Server_init(UA_Server *server) {
 #endif
 
     UA_LOCK_INIT(&server->serviceMutex);
+    UA_RWLOCK_INIT(&server->serviceRWLock);
+#ifdef UA_ENABLE_HISTORIZING
+    UA_LOCK_INIT(&server->historyLock);
+#endif
     lockServer(server);
 
     /* Initialize the adminSession */
@@ -921,14 +935,102 @@ UA_Server_run(UA_Server *server, const volatile UA_Boolean *running) {
     return UA_Server_run_shutdown(server);
 }
 
+#if UA_MULTITHREADING >= 100
+/* The address of the thread-local marker identifies the current thread */
+static UA_THREAD_LOCAL char lockThreadMarker;
+
+/* Server for which the current thread holds the shared lock (and the recursion
+ * depth). Only one server at a time can be locked in shared mode per thread. */
+static UA_THREAD_LOCAL UA_Server *sharedLockServer;
+static UA_THREAD_LOCAL size_t sharedLockDepth;
+#endif
+
 void lockServer(UA_Server *server) {
+#if UA_MULTITHREADING >= 100
+    /* Nested lock inside a read-only service. Stay in shared mode. */
+    if(sharedLockServer == server) {
+        sharedLockDepth++;
+        return;
+    }
+#endif
     if(UA_LIKELY(server->config.eventLoop && server->config.eventLoop->lock))
         server->config.eventLoop->lock(server->config.eventLoop);
+#if UA_MULTITHREADING >= 100
+    /* Get exclusive access against the concurrent readers. The rwlock is not
+     * reentrant, so take it only in the outermost lock. */
+    if(server->config.sharedServiceLock &&
+       server->serviceLockOwner != (void*)&lockThreadMarker) {
+        UA_RWLOCK_EXCLUSIVE(&server->serviceRWLock);
+        server->serviceLockOwner = (void*)&lockThreadMarker;
+    }
+#endif
     UA_LOCK(&server->serviceMutex);
 }
 
 void unlockServer(UA_Server *server) {
+#if UA_MULTITHREADING >= 100
+    /* Release the shared lock */
+    if(sharedLockServer == server) {
+        if(--sharedLockDepth > 0)
+            return;
+        sharedLockServer = NULL;
+        UA_atomic_addInt(&server->serviceMutex.mutexCounter, -1);
+        UA_RWUNLOCK_SHARED(&server->serviceRWLock);
+        return;
+    }
+
+    /* Leaving the outermost exclusive lock? */
+    UA_Boolean releaseRW =
+        (server->serviceLockOwner == (void*)&lockThreadMarker &&
+         server->serviceMutex.mutexCounter == 1);
+    if(releaseRW)
+        server->serviceLockOwner = NULL;
+#endif
     if(UA_LIKELY(server->config.eventLoop && server->config.eventLoop->unlock))
         server->config.eventLoop->unlock(server->config.eventLoop);
     UA_UNLOCK(&server->serviceMutex);
+#if UA_MULTITHREADING >= 100
+    if(releaseRW)
+        UA_RWUNLOCK_EXCLUSIVE(&server->serviceRWLock);
+#endif
+}
+
+void lockServerShared(UA_Server *server) {
+#if UA_MULTITHREADING >= 100
+    if(sharedLockServer == server) {
+        sharedLockDepth++;
+        return;
+    }
+
+    /* Take the shared lock if enabled. Fall back to the exclusive lock if
+     * another server is already locked in shared mode or if the current thread
+     * already has exclusive access. */
+    if(server->config.sharedServiceLock && !sharedLockServer &&
+       server->serviceLockOwner != (void*)&lockThreadMarker) {
+        UA_RWLOCK_SHARED(&server->serviceRWLock);
+        /* Count the readers in the service mutex to satisfy UA_LOCK_ASSERT */
+        UA_atomic_addInt(&server->serviceMutex.mutexCounter, 1);
+        sharedLockServer = server;
+        sharedLockDepth = 1;
+        return;
+    }
+#endif
+    lockServer(server);
+}
+
+void unlockServerShared(UA_Server *server) {
+    unlockServer(server);
+}
+
+UA_StatusCode
+checkServerLockedExclusive(UA_Server *server) {
+#if UA_MULTITHREADING >= 100
+    if(sharedLockServer == server) {
+        UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
+                       "Cannot modify the information model while "
+                       "the server is locked in shared mode");
+        return UA_STATUSCODE_BADINVALIDSTATE;
+    }
+#endif
+    return UA_STATUSCODE_GOOD;
 }
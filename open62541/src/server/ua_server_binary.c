@@ -46,10 +46,35 @@ void UA_debug_dumpCompleteChunk(UA_Server *const server, UA_Connection *const co
 /* Maximum numbers of sockets to listen on */
 #define UA_MAXSERVERCONNECTIONS 16
 
+#if UA_MULTITHREADING >= 100
+/* Decoded request that waits for processing in a worker thread */
+typedef struct UA_ServiceJob {
+    TAILQ_ENTRY(UA_ServiceJob) pointers;
+    UA_UInt32 requestId;
+    UA_Service service;
+    const UA_DataType *requestType;
+    const UA_DataType *responseType;
+    UA_Boolean sessionRequired;
+    UA_Boolean readOnly;
+    size_t counterOffset;
+    UA_Request request;
+} UA_ServiceJob;
+#endif
+
 /* SecureChannel Linked List */
 typedef struct channel_entry {
     UA_SecureChannel channel;
     TAILQ_ENTRY(channel_entry) pointers;
+#if UA_MULTITHREADING >= 100
+    /* The jobs of a SecureChannel are processed one after the other. So the
+     * responses are sent in the order of the requests. The fields are protected
+     * by the workerMutex of the BinaryProtocolManager. */
+    TAILQ_HEAD(, UA_ServiceJob) jobs;
+    TAILQ_ENTRY(channel_entry) readyPointers;
+    UA_Boolean ready;          /* Enqueued in the readyChannels list */
+    UA_Boolean processing;     /* A worker processes a job of the channel */
+    UA_Boolean deleteDeferred; /* Delete when the worker is done */
+#endif
 } channel_entry;
 
 typedef struct {
@@ -78,6 +103,23 @@ typedef struct reverse_connect_context {
     LIST_ENTRY(reverse_connect_context) next;
 } reverse_connect_context;
 
+#if UA_MULTITHREADING >= 100
+/* Threads for the worker pool */
+# ifdef _WIN32
+typedef HANDLE UA_WorkerThread;
+typedef CRITICAL_SECTION UA_WorkerMutex;
+typedef CONDITION_VARIABLE UA_WorkerCondition;
+#  define UA_WORKERTHREAD_CALLBACK(name) static DWORD WINAPI name(LPVOID param)
+#  define UA_WORKERTHREAD_RETURN 0
+# else
+typedef pthread_t UA_WorkerThread;
+typedef pthread_mutex_t UA_WorkerMutex;
+typedef pthread_cond_t UA_WorkerCondition;
+#  define UA_WORKERTHREAD_CALLBACK(name) static void * name(void *param)
+#  define UA_WORKERTHREAD_RETURN NULL
+# endif
+#endif
+
 /* Binary Protocol Manager */
 typedef struct {
     UA_ServerComponent sc;
@@ -101,6 +143,23 @@ typedef struct {
     LIST_HEAD(, reverse_connect_context) reverseConnects;
     UA_UInt64 reverseConnectsCheckHandle;
     UA_UInt64 lastReverseConnectHandle;
+
+    /* Decoded requests take their memory from the arena. After processing,
+     * the request is released in one step instead of freeing every string and
+     * array individually. */
+    UA_Arena requestArena;
+    UA_Boolean requestArenaInUse;
+
+#if UA_MULTITHREADING >= 100
+    /* Worker threads that process the service requests. SecureChannels with
+     * pending jobs are added to the readyChannels list. */
+    UA_WorkerMutex workerMutex;
+    UA_WorkerCondition workerCondition;
+    UA_WorkerThread *workers;
+    size_t workersSize;
+    UA_Boolean workersRunning;
+    TAILQ_HEAD(, channel_entry) readyChannels;
+#endif
 } UA_BinaryProtocolManager;
 
 void setReverseConnectState(UA_Server *server, reverse_connect_context *context,
@@ -109,6 +168,13 @@ UA_StatusCode attemptReverseConnect(UA_BinaryProtocolManager *bpm,
                                     reverse_connect_context *context);
 UA_StatusCode setReverseConnectRetryCallback(UA_BinaryProtocolManager *bpm,
                                              UA_Boolean enabled);
+#if UA_MULTITHREADING >= 100
+static void
+enqueueServiceJob(UA_BinaryProtocolManager *bpm, channel_entry *ce,
+                  UA_ServiceJob *job);
+static UA_Boolean
+deferDeleteServerSecureChannel(UA_BinaryProtocolManager *bpm, channel_entry *ce);
+#endif
 
 /********************/
 /* Helper Functions */
@@ -142,6 +208,16 @@ setBinaryProtocolManagerState(UA_Server *server,
 static void
 deleteServerSecureChannel(UA_BinaryProtocolManager *bpm,
                           UA_SecureChannel *channel) {
+#if UA_MULTITHREADING >= 100
+    /* Remove pending jobs. If a worker is still processing a job of the
+     * channel, the worker deletes the channel when it is done. */
+    channel_entry *ce = (channel_entry*)channel;
+    if(bpm->workersSize > 0) {
+        if(deferDeleteServerSecureChannel(bpm, ce))
+            return;
+    }
+#endif
+
     /* Detach the channel from the server list */
     TAILQ_REMOVE(&bpm->channels, (channel_entry*)channel, pointers);
 
@@ -229,7 +305,8 @@ decodeHeaderSendServiceFault(UA_SecureChannel *channel, const UA_ByteString *msg
 static void
 getServicePointers(UA_UInt32 requestTypeId, const UA_DataType **requestType,
                    const UA_DataType **responseType, UA_Service *service,
-                   UA_Boolean *requiresSession, size_t *counterOffset) {
+                   UA_Boolean *requiresSession, UA_Boolean *readOnly,
+                   size_t *counterOffset) {
     switch(requestTypeId) {
     case UA_NS0ID_GETENDPOINTSREQUEST_ENCODING_DEFAULTBINARY:
         *service = (UA_Service)Service_GetEndpoints;
@@ -291,6 +368,7 @@ getServicePointers(UA_UInt32 requestTypeId, const UA_DataType **requestType,
         *requestType = &UA_TYPES[UA_TYPES_READREQUEST];
         *responseType = &UA_TYPES[UA_TYPES_READRESPONSE];
         UA_SERVICECOUNTER_OFFSET(readCount);
+        *readOnly = true;
         break;
     case UA_NS0ID_WRITEREQUEST_ENCODING_DEFAULTBINARY:
         *service = (UA_Service)Service_Write;
@@ -303,12 +381,14 @@ getServicePointers(UA_UInt32 requestTypeId, const UA_DataType **requestType,
         *requestType = &UA_TYPES[UA_TYPES_BROWSEREQUEST];
         *responseType = &UA_TYPES[UA_TYPES_BROWSERESPONSE];
         UA_SERVICECOUNTER_OFFSET(browseCount);
+        *readOnly = true;
         break;
     case UA_NS0ID_BROWSENEXTREQUEST_ENCODING_DEFAULTBINARY:
         *service = (UA_Service)Service_BrowseNext;
         *requestType = &UA_TYPES[UA_TYPES_BROWSENEXTREQUEST];
         *responseType = &UA_TYPES[UA_TYPES_BROWSENEXTRESPONSE];
         UA_SERVICECOUNTER_OFFSET(browseNextCount);
+        *readOnly = true;
         break;
     case UA_NS0ID_REGISTERNODESREQUEST_ENCODING_DEFAULTBINARY:
         *service = (UA_Service)Service_RegisterNodes;
@@ -327,6 +407,7 @@ getServicePointers(UA_UInt32 requestTypeId, const UA_DataType **requestType,
         *requestType = &UA_TYPES[UA_TYPES_TRANSLATEBROWSEPATHSTONODEIDSREQUEST];
         *responseType = &UA_TYPES[UA_TYPES_TRANSLATEBROWSEPATHSTONODEIDSRESPONSE];
         UA_SERVICECOUNTER_OFFSET(translateBrowsePathsToNodeIdsCount);
+        *readOnly = true;
         break;
 
 #ifdef UA_ENABLE_SUBSCRIPTIONS
@@ -409,6 +490,7 @@ getServicePointers(UA_UInt32 requestTypeId, const UA_DataType **requestType,
         *requestType = &UA_TYPES[UA_TYPES_HISTORYREADREQUEST];
         *responseType = &UA_TYPES[UA_TYPES_HISTORYREADRESPONSE];
         UA_SERVICECOUNTER_OFFSET(historyReadCount);
+        *readOnly = true;
         break;
         /* For History update */
     case UA_NS0ID_HISTORYUPDATEREQUEST_ENCODING_DEFAULTBINARY:
@@ -661,6 +743,14 @@ sendResponse(UA_Server *server, UA_Session *session, UA_SecureChannel *channel,
     return UA_MessageContext_finish(&mc);
 }
 
+/* Called also from read-only services under the shared server lock. Writers of
+ * the counter with exclusive access cannot run at the same time. */
+static void
+countRejectedSession(UA_Server *server) {
+    UA_atomic_addInt((volatile int*)(uintptr_t)
+                     &server->serverDiagnosticsSummary.rejectedSessionCount, 1);
+}
+
 /* A Session is "bound" to a SecureChannel if it was created by the
  * SecureChannel or if it was activated on it. A Session can only be bound to
  * one SecureChannel. A Session can only be closed from the SecureChannel to
@@ -677,21 +767,23 @@ getBoundSession(UA_Server *server, const UA_SecureChannel *channel,
             continue;
         UA_Session *current = (UA_Session*)sh;
         /* Has the session timed out? */
-        if(current->validTill < now) {
-            server->serverDiagnosticsSummary.rejectedSessionCount++;
+        if(UA_Session_timedOut(current, now)) {
+            countRejectedSession(server);
             return UA_STATUSCODE_BADSESSIONCLOSED;
         }
         *session = current;
         return UA_STATUSCODE_GOOD;
     }
 
-    server->serverDiagnosticsSummary.rejectedSessionCount++;
+    countRejectedSession(server);
 
     /* Session exists on another SecureChannel. The CTT expect this error. */
     UA_Session *tmpSession = getSessionByToken(server, token);
     if(tmpSession) {
 #ifdef UA_ENABLE_DIAGNOSTICS
+        UA_LOCK(&tmpSession->statsLock);
         tmpSession->diagnostics.unauthorizedRequestCount++;
+        UA_UNLOCK(&tmpSession->statsLock);
 #endif
         return UA_STATUSCODE_BADSECURECHANNELIDINVALID;
     }
@@ -703,19 +795,26 @@ static const UA_String securityPolicyNone =
     UA_STRING_STATIC("http://opcfoundation.org/UA/SecurityPolicy#None");
 
 /* Returns a status of the SecureChannel. The detailed service status (usually
- * part of the response) is set in the serviceResult argument. */
+ * part of the response) is set in the serviceResult argument. If called from a
+ * worker thread, the EventLoop is locked for sending the response. */
 static UA_StatusCode
 processMSGDecoded(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 requestId,
                   UA_Service service, const UA_Request *request,
                   const UA_DataType *requestType, UA_Response *response,
                   const UA_DataType *responseType, UA_Boolean sessionRequired,
-                  size_t counterOffset) {
+                  UA_Boolean readOnly, size_t counterOffset, UA_Boolean worker) {
     UA_Session anonymousSession;
     UA_Session *session = NULL;
     UA_StatusCode channelRes = UA_STATUSCODE_GOOD;
     UA_ResponseHeader *rh = &response->responseHeader;
+    UA_Boolean sendRes = true;
 
-    lockServer(server);
+    /* Services that don't modify the information model can run concurrently
+     * if the server is configured for it (see the sharedServiceLock option) */
+    if(readOnly)
+        lockServerShared(server);
+    else
+        lockServer(server);
 
     /* If it is an unencrypted (#None) channel, only allow the discovery services */
     if(server->config.securityPolicyNoneDiscoveryOnly &&
@@ -727,7 +826,7 @@ processMSGDecoded(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 reques
 #endif
        ) {
         rh->serviceResult = UA_STATUSCODE_BADSECURITYPOLICYREJECTED;
-        goto send_response;
+        goto update_statistics;
     }
 
     /* Session lifecycle services. */
@@ -743,7 +842,7 @@ processMSGDecoded(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 reques
             UA_NodeId_copy(&res->authenticationToken, &unsafe_fuzz_authenticationToken);
         }
 #endif
-        goto send_response;
+        goto update_statistics;
     }
 
     /* Get the Session bound to the SecureChannel (not necessarily activated) */
@@ -751,7 +850,7 @@ processMSGDecoded(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 reques
         rh->serviceResult = getBoundSession(server, channel,
                       &request->requestHeader.authenticationToken, &session);
         if(rh->serviceResult != UA_STATUSCODE_GOOD)
-            goto send_response;
+            goto update_statistics;
     }
 
     /* Set an anonymous, inactive session for services that need no session */
@@ -767,7 +866,7 @@ processMSGDecoded(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 reques
                                    requestType->binaryEncodingId.identifier.numeric);
 #endif
             rh->serviceResult = UA_STATUSCODE_BADSESSIONIDINVALID;
-            goto send_response;
+            goto update_statistics;
         }
 
         UA_Session_init(&anonymousSession);
@@ -790,11 +889,18 @@ processMSGDecoded(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 reques
                                requestType->binaryEncodingId.identifier.numeric);
 #endif
         if(session != &anonymousSession) {
-            UA_Server_removeSessionByToken(server, &session->header.authenticationToken,
+            /* Removing the session requires exclusive access. Re-acquire the
+             * lock and look up the session again by its token. */
+            if(readOnly) {
+                unlockServer(server);
+                lockServer(server);
+                session = NULL;
+            }
+            UA_Server_removeSessionByToken(server, &request->requestHeader.authenticationToken,
                                            UA_SHUTDOWNREASON_ABORT);
         }
         rh->serviceResult = UA_STATUSCODE_BADSESSIONNOTACTIVATED;
-        goto send_response;
+        goto update_statistics;
     }
 
     /* Update the session lifetime */
@@ -807,7 +913,7 @@ processMSGDecoded(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 reques
             Service_Publish(server, session, &request->publishRequest, requestId);
 
         /* Don't send a response */
-        unlockServer(server);
+        sendRes = false;
         goto update_statistics;
     }
 #endif
@@ -822,9 +928,8 @@ processMSGDecoded(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 reques
         /* Async method calls remain. Don't send a response now. In case we have
          * an async call, count as a "good" request for the diagnostics
          * statistic. */
-        if(UA_LIKELY(finished))
-            goto send_response;
-        unlockServer(server);
+        if(UA_UNLIKELY(!finished))
+            sendRes = false;
         goto update_statistics;
     }
 #endif
@@ -832,35 +937,49 @@ processMSGDecoded(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 reques
     /* Execute the synchronous service call */
     service(server, session, request, response);
 
-    /* Upon success, send the response. Otherwise a ServiceFault. */
- send_response:
-    unlockServer(server);
-    channelRes = sendResponse(server, session, channel,
-                              requestId, response, responseType);
-
-    /* Update the diagnostics statistics */
+    /* Update the diagnostics statistics. While the server is locked, as the
+     * session can be removed by another thread afterwards. */
  update_statistics:
 #ifdef UA_ENABLE_DIAGNOSTICS
-    if(session && session != &server->adminSession) {
-        session->diagnostics.totalRequestCount.totalCount++;
-        if(rh->serviceResult != UA_STATUSCODE_GOOD)
-            session->diagnostics.totalRequestCount.errorCount++;
-        if(counterOffset != 0) {
-            UA_ServiceCounterDataType *serviceCounter = (UA_ServiceCounterDataType*)
-                (((uintptr_t)&session->diagnostics) + counterOffset);
-            serviceCounter->totalCount++;
-            if(rh->serviceResult != UA_STATUSCODE_GOOD)
-                serviceCounter->errorCount++;
-        }
-    }
+    if(session && session != &server->adminSession)
+        UA_Session_countRequest(session, counterOffset, rh->serviceResult);
 #endif
 
+    unlockServer(server);
+    if(session == &anonymousSession) {
+        UA_LOCK_DESTROY(&anonymousSession.statsLock);
+    }
+    if(!sendRes)
+        return UA_STATUSCODE_GOOD;
+
+    /* Upon success, send the response. Otherwise a ServiceFault. */
+    if(!worker)
+        return sendResponse(server, session, channel, requestId, response, responseType);
+
+    /* The session is not used in the worker thread after unlocking. It might
+     * have been removed in the meantime. */
+    UA_EventLoop *el = server->config.eventLoop;
+    el->lock(el);
+    channelRes = sendResponse(server, NULL, channel, requestId, response, responseType);
+    el->unlock(el);
     return channelRes;
 }
 
+static void
+clearRequest(UA_BinaryProtocolManager *bpm, UA_Arena *arena,
+             UA_Request *request, const UA_DataType *requestType) {
+    if(!arena) {
+        UA_clear(request, requestType);
+        return;
+    }
+    UA_Arena_reset(arena);
+    bpm->requestArenaInUse = false;
+}
+
 static UA_StatusCode
-processMSG(UA_Server *server, UA_SecureChannel *channel,
+processMSG(UA_BinaryProtocolManager *bpm, UA_SecureChannel *channel,
            UA_UInt32 requestId, const UA_ByteString *msg) {
+    UA_Server *server = bpm->server;
     if(channel->state != UA_SECURECHANNELSTATE_OPEN)
         return UA_STATUSCODE_BADINTERNALERROR;
     /* Decode the nodeid */
@@ -878,11 +997,12 @@ processMSG(UA_Server *server, UA_SecureChannel *channel,
     /* Get the service pointers */
     UA_Service service = NULL;
     UA_Boolean sessionRequired = true;
+    UA_Boolean readOnly = false;
     const UA_DataType *requestType = NULL;
     const UA_DataType *responseType = NULL;
     size_t counterOffset = 0;
-    getServicePointers(requestTypeId.identifier.numeric, &requestType,
-                       &responseType, &service, &sessionRequired, &counterOffset);
+    getServicePointers(requestTypeId.identifier.numeric, &requestType, &responseType,
+                       &service, &sessionRequired, &readOnly, &counterOffset);
     if(!requestType) {
         if(requestTypeId.identifier.numeric ==
            UA_NS0ID_CREATESUBSCRIPTIONREQUEST_ENCODING_DEFAULTBINARY) {
@@ -900,11 +1020,40 @@ processMSG(UA_Server *server, UA_SecureChannel *channel,
     }
     UA_assert(responseType);
 
+    /* Use the arena if the request is processed right away. Not if the
+     * request is moved to a worker thread or if the arena is already in use
+     * (reentrant processing). */
+    UA_Arena *arena = (bpm->requestArenaInUse) ? NULL : &bpm->requestArena;
+#if UA_MULTITHREADING >= 100
+    if(bpm->workersSize > 0)
+        arena = NULL;
+#endif
+#ifdef FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
+    arena = NULL; /* The authenticationToken is replaced below */
+#endif
+    if(arena)
+        bpm->requestArenaInUse = true;
+
+    /* Requests with potentially large payloads reference the strings and
+     * numeric arrays in the message buffer instead of copying them. The
+     * message buffer outlives the processing of the request. */
+    UA_Boolean zeroCopy = (requestType == &UA_TYPES[UA_TYPES_WRITEREQUEST]);
+#ifdef UA_ENABLE_METHODCALLS
+    if(requestType == &UA_TYPES[UA_TYPES_CALLREQUEST])
+        zeroCopy = true;
+#endif
+#ifdef UA_ENABLE_HISTORIZING
+    if(requestType == &UA_TYPES[UA_TYPES_HISTORYUPDATEREQUEST])
+        zeroCopy = true;
+#endif
+
     /* Decode the request */
     UA_Request request;
-    retval = UA_decodeBinaryInternal(msg, &offset, &request,
-                                     requestType, server->config.customDataTypes);
+    retval = UA_decodeBinaryInternalArena(msg, &offset, &request, requestType,
+                                          server->config.customDataTypes,
+                                          arena, zeroCopy);
     if(retval != UA_STATUSCODE_GOOD) {
+        clearRequest(bpm, arena, &request, requestType);
         UA_LOG_DEBUG_CHANNEL(server->config.logging, channel,
                              "Could not decode the request with StatusCode %s",
                              UA_StatusCode_name(retval));
@@ -922,7 +1071,7 @@ processMSG(UA_Server *server, UA_SecureChannel *channel,
         if(server->config.verifyRequestTimestamp <= UA_RULEHANDLING_ABORT) {
             retval = sendServiceFault(channel, requestId, requestHeader->requestHandle,
                                       UA_STATUSCODE_BADINVALIDTIMESTAMP);
-            UA_clear(&request, requestType);
+            clearRequest(bpm, arena, &request, requestType);
             return retval;
         }
     }
@@ -937,24 +1086,82 @@ processMSG(UA_Server *server, UA_SecureChannel *channel,
     }
 #endif
 
+#if UA_MULTITHREADING >= 100
+    /* Hand the request over to the worker threads */
+    if(bpm->workersSize > 0) {
+        UA_ServiceJob *job = (UA_ServiceJob*)UA_malloc(sizeof(UA_ServiceJob));
+        if(!job) {
+            UA_clear(&request, requestType);
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+        job->requestId = requestId;
+        job->service = service;
+        job->requestType = requestType;
+        job->responseType = responseType;
+        job->sessionRequired = sessionRequired;
+        job->readOnly = readOnly;
+        job->counterOffset = counterOffset;
+        job->request = request; /* Move the decoded request */
+        enqueueServiceJob(bpm, (channel_entry*)channel, job);
+        return UA_STATUSCODE_GOOD;
+    }
+#endif
+
     /* Prepare the respone and process the request */
     UA_Response response;
     UA_init(&response, responseType);
     response.responseHeader.requestHandle = requestHeader->requestHandle;
     retval = processMSGDecoded(server, channel, requestId, service, &request, requestType,
-                               &response, responseType, sessionRequired, counterOffset);
+                               &response, responseType, sessionRequired, readOnly,
+                               counterOffset, false);
 
     /* Clean up */
-    UA_clear(&request, requestType);
+    clearRequest(bpm, arena, &request, requestType);
     UA_clear(&response, responseType);
     return retval;
 }
 
 /* Takes decoded messages starting at the nodeid of the content type. */
+/* Send an ERR message and close the SecureChannel */
+static void
+processSecureChannelError(UA_Server *server, UA_SecureChannel *channel,
+                          UA_StatusCode retval) {
+    if(!UA_SecureChannel_isConnected(channel)) {
+        UA_LOG_INFO_CHANNEL(server->config.logging, channel,
+                            "Processing the message failed. Channel already closed "
+                            "with StatusCode %s. ", UA_StatusCode_name(retval));
+        return;
+    }
+
+    UA_LOG_INFO_CHANNEL(server->config.logging, channel,
+                        "Processing the message failed with StatusCode %s. "
+                        "Closing the channel.", UA_StatusCode_name(retval));
+    UA_TcpErrorMessage errMsg;
+    UA_TcpErrorMessage_init(&errMsg);
+    errMsg.error = retval;
+    UA_SecureChannel_sendError(channel, &errMsg);
+    UA_ShutdownReason reason;
+    switch(retval) {
+    case UA_STATUSCODE_BADSECURITYMODEREJECTED:
+    case UA_STATUSCODE_BADSECURITYCHECKSFAILED:
+    case UA_STATUSCODE_BADSECURECHANNELIDINVALID:
+    case UA_STATUSCODE_BADSECURECHANNELTOKENUNKNOWN:
+    case UA_STATUSCODE_BADSECURITYPOLICYREJECTED:
+    case UA_STATUSCODE_BADCERTIFICATEUSENOTALLOWED:
+        reason = UA_SHUTDOWNREASON_SECURITYREJECT;
+        break;
+    default:
+        reason = UA_SHUTDOWNREASON_CLOSE;
+        break;
+    }
+    UA_SecureChannel_shutdown(channel, reason);
+}
+
 static UA_StatusCode
-processSecureChannelMessage(UA_Server *server, UA_SecureChannel *channel,
+processSecureChannelMessage(UA_BinaryProtocolManager *bpm, UA_SecureChannel *channel,
                             UA_MessageType messagetype, UA_UInt32 requestId,
                             UA_ByteString *message) {
+    UA_Server *server = bpm->server;
     UA_StatusCode retval = UA_STATUSCODE_GOOD;
     switch(messagetype) {
     case UA_MESSAGETYPE_HEL:
@@ -967,7 +1174,7 @@ processSecureChannelMessage(UA_Server *server, UA_SecureChannel *channel,
         break;
     case UA_MESSAGETYPE_MSG:
         UA_LOG_TRACE_CHANNEL(server->config.logging, channel, "Process a MSG");
-        retval = processMSG(server, channel, requestId, message);
+        retval = processMSG(bpm, channel, requestId, message);
         break;
     case UA_MESSAGETYPE_CLO:
         UA_LOG_TRACE_CHANNEL(server->config.logging, channel, "Process a CLO");
@@ -978,41 +1185,270 @@ processSecureChannelMessage(UA_Server *server, UA_SecureChannel *channel,
         retval = UA_STATUSCODE_BADTCPMESSAGETYPEINVALID;
         break;
     }
-    if(retval != UA_STATUSCODE_GOOD) {
-        if(!UA_SecureChannel_isConnected(channel)) {
-            UA_LOG_INFO_CHANNEL(server->config.logging, channel,
-                                "Processing the message failed. Channel already closed "
-                                "with StatusCode %s. ", UA_StatusCode_name(retval));
-            return retval;
+    if(retval != UA_STATUSCODE_GOOD)
+        processSecureChannelError(server, channel, retval);
+    return retval;
+}
+
+#if UA_MULTITHREADING >= 100
+
+/***************/
+/* Worker Pool */
+/***************/
+
+static void
+workerMutexInit(UA_WorkerMutex *m) {
+#ifdef _WIN32
+    InitializeCriticalSection(m);
+#else
+    pthread_mutex_init(m, NULL);
+#endif
+}
+
+static void
+workerMutexDestroy(UA_WorkerMutex *m) {
+#ifdef _WIN32
+    DeleteCriticalSection(m);
+#else
+    pthread_mutex_destroy(m);
+#endif
+}
+
+static void
+workerMutexLock(UA_WorkerMutex *m) {
+#ifdef _WIN32
+    EnterCriticalSection(m);
+#else
+    pthread_mutex_lock(m);
+#endif
+}
+
+static void
+workerMutexUnlock(UA_WorkerMutex *m) {
+#ifdef _WIN32
+    LeaveCriticalSection(m);
+#else
+    pthread_mutex_unlock(m);
+#endif
+}
+
+static void
+workerConditionInit(UA_WorkerCondition *c) {
+#ifdef _WIN32
+    InitializeConditionVariable(c);
+#else
+    pthread_cond_init(c, NULL);
+#endif
+}
+
+static void
+workerConditionDestroy(UA_WorkerCondition *c) {
+#ifdef _WIN32
+    (void)c;
+#else
+    pthread_cond_destroy(c);
+#endif
+}
+
+static void
+workerConditionWait(UA_WorkerCondition *c, UA_WorkerMutex *m) {
+#ifdef _WIN32
+    SleepConditionVariableCS(c, m, INFINITE);
+#else
+    pthread_cond_wait(c, m);
+#endif
+}
+
+static void
+workerConditionSignal(UA_WorkerCondition *c) {
+#ifdef _WIN32
+    WakeConditionVariable(c);
+#else
+    pthread_cond_signal(c);
+#endif
+}
+
+static void
+workerConditionBroadcast(UA_WorkerCondition *c) {
+#ifdef _WIN32
+    WakeAllConditionVariable(c);
+#else
+    pthread_cond_broadcast(c);
+#endif
+}
+
+static void
+deleteServiceJob(UA_ServiceJob *job) {
+    UA_clear(&job->request, job->requestType);
+    UA_free(job);
+}
+
+/* Called from the EventLoop thread */
+static void
+enqueueServiceJob(UA_BinaryProtocolManager *bpm, channel_entry *ce,
+                  UA_ServiceJob *job) {
+    workerMutexLock(&bpm->workerMutex);
+    TAILQ_INSERT_TAIL(&ce->jobs, job, pointers);
+    if(!ce->ready && !ce->processing) {
+        TAILQ_INSERT_TAIL(&bpm->readyChannels, ce, readyPointers);
+        ce->ready = true;
+        workerConditionSignal(&bpm->workerCondition);
+    }
+    workerMutexUnlock(&bpm->workerMutex);
+}
+
+/* Remove the pending jobs. Returns true if a worker is processing a job of the
+ * channel. Then the deletion is deferred until the worker is done. */
+static UA_Boolean
+deferDeleteServerSecureChannel(UA_BinaryProtocolManager *bpm, channel_entry *ce) {
+    workerMutexLock(&bpm->workerMutex);
+    if(ce->ready) {
+        TAILQ_REMOVE(&bpm->readyChannels, ce, readyPointers);
+        ce->ready = false;
+    }
+    UA_ServiceJob *job, *job_tmp;
+    TAILQ_FOREACH_SAFE(job, &ce->jobs, pointers, job_tmp) {
+        TAILQ_REMOVE(&ce->jobs, job, pointers);
+        deleteServiceJob(job);
+    }
+    UA_Boolean processing = ce->processing;
+    if(processing)
+        ce->deleteDeferred = true;
+    workerMutexUnlock(&bpm->workerMutex);
+    return processing;
+}
+
+static void
+processServiceJob(UA_BinaryProtocolManager *bpm, channel_entry *ce,
+                  UA_ServiceJob *job) {
+    UA_Server *server = bpm->server;
+    UA_Response response;
+    UA_init(&response, job->responseType);
+    response.responseHeader.requestHandle = job->request.requestHeader.requestHandle;
+    UA_StatusCode res =
+        processMSGDecoded(server, &ce->channel, job->requestId, job->service,
+                          &job->request, job->requestType, &response,
+                          job->responseType, job->sessionRequired,
+                          job->readOnly, job->counterOffset, true);
+    UA_clear(&response, job->responseType);
+    deleteServiceJob(job);
+
+    /* Finish the job with the EventLoop locked. The channel can only be closed
+     * and deleted from the EventLoop thread otherwise. */
+    UA_EventLoop *el = server->config.eventLoop;
+    el->lock(el);
+    if(res != UA_STATUSCODE_GOOD)
+        processSecureChannelError(server, &ce->channel, res);
+
+    workerMutexLock(&bpm->workerMutex);
+    ce->processing = false;
+    UA_Boolean deleteChannel = ce->deleteDeferred;
+    if(!deleteChannel && !TAILQ_EMPTY(&ce->jobs)) {
+        /* Continue with the next job of the channel */
+        TAILQ_INSERT_TAIL(&bpm->readyChannels, ce, readyPointers);
+        ce->ready = true;
+        workerConditionSignal(&bpm->workerCondition);
+    }
+    workerMutexUnlock(&bpm->workerMutex);
+
+    if(deleteChannel) {
+        deleteServerSecureChannel(bpm, &ce->channel);
+
+        /* Set BinaryProtocolManager to STOPPED if it is STOPPING and the last
+         * channel was just deleted */
+        if(bpm->sc.state == UA_LIFECYCLESTATE_STOPPING &&
+           bpm->serverConnectionsSize == 0 &&
+           LIST_EMPTY(&bpm->reverseConnects) &&
+           TAILQ_EMPTY(&bpm->channels)) {
+            setBinaryProtocolManagerState(server, bpm, UA_LIFECYCLESTATE_STOPPED);
         }
+    }
+    el->unlock(el);
+}
 
-        UA_LOG_INFO_CHANNEL(server->config.logging, channel,
-                            "Processing the message failed with StatusCode %s. "
-                            "Closing the channel.", UA_StatusCode_name(retval));
-        UA_TcpErrorMessage errMsg;
-        UA_TcpErrorMessage_init(&errMsg);
-        errMsg.error = retval;
-        UA_SecureChannel_sendError(channel, &errMsg);
-        UA_ShutdownReason reason;
-        switch(retval) {
-        case UA_STATUSCODE_BADSECURITYMODEREJECTED:
-        case UA_STATUSCODE_BADSECURITYCHECKSFAILED:
-        case UA_STATUSCODE_BADSECURECHANNELIDINVALID:
-        case UA_STATUSCODE_BADSECURECHANNELTOKENUNKNOWN:
-        case UA_STATUSCODE_BADSECURITYPOLICYREJECTED:
-        case UA_STATUSCODE_BADCERTIFICATEUSENOTALLOWED:
-            reason = UA_SHUTDOWNREASON_SECURITYREJECT;
+UA_WORKERTHREAD_CALLBACK(serviceWorkerLoop) {
+    UA_BinaryProtocolManager *bpm = (UA_BinaryProtocolManager*)param;
+    workerMutexLock(&bpm->workerMutex);
+    while(true) {
+        while(bpm->workersRunning && TAILQ_EMPTY(&bpm->readyChannels))
+            workerConditionWait(&bpm->workerCondition, &bpm->workerMutex);
+        if(!bpm->workersRunning)
+            break;
+
+        /* Take the next job of the first ready channel */
+        channel_entry *ce = TAILQ_FIRST(&bpm->readyChannels);
+        TAILQ_REMOVE(&bpm->readyChannels, ce, readyPointers);
+        ce->ready = false;
+        UA_ServiceJob *job = TAILQ_FIRST(&ce->jobs);
+        TAILQ_REMOVE(&ce->jobs, job, pointers);
+        ce->processing = true;
+        workerMutexUnlock(&bpm->workerMutex);
+
+        processServiceJob(bpm, ce, job);
+
+        workerMutexLock(&bpm->workerMutex);
+    }
+    workerMutexUnlock(&bpm->workerMutex);
+    return UA_WORKERTHREAD_RETURN;
+}
+
+static UA_StatusCode
+startServiceWorkers(UA_BinaryProtocolManager *bpm, size_t workersSize) {
+    bpm->workers = (UA_WorkerThread*)UA_calloc(workersSize, sizeof(UA_WorkerThread));
+    if(!bpm->workers)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    bpm->workersRunning = true;
+    for(size_t i = 0; i < workersSize; i++) {
+#ifdef _WIN32
+        bpm->workers[i] = CreateThread(NULL, 0, serviceWorkerLoop, bpm, 0, NULL);
+        if(!bpm->workers[i])
             break;
-        default:
-            reason = UA_SHUTDOWNREASON_CLOSE;
+#else
+        if(pthread_create(&bpm->workers[i], NULL, serviceWorkerLoop, bpm) != 0)
             break;
-        }
-        UA_SecureChannel_shutdown(channel, reason);
+#endif
+        bpm->workersSize++;
     }
+    if(bpm->workersSize == 0) {
+        bpm->workersRunning = false;
+        UA_free(bpm->workers);
+        bpm->workers = NULL;
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+    UA_LOG_INFO(bpm->logging, UA_LOGCATEGORY_SERVER,
+                "Started %lu worker threads for processing the service requests",
+                (unsigned long)bpm->workersSize);
+    return UA_STATUSCODE_GOOD;
+}
 
-    return retval;
+/* Signal the workers to stop after the current job */
+static void
+stopServiceWorkers(UA_BinaryProtocolManager *bpm) {
+    workerMutexLock(&bpm->workerMutex);
+    bpm->workersRunning = false;
+    workerConditionBroadcast(&bpm->workerCondition);
+    workerMutexUnlock(&bpm->workerMutex);
+}
+
+/* The workers must be stopped and idle. Otherwise they might wait for the
+ * server lock to finish their current job. */
+static void
+joinServiceWorkers(UA_BinaryProtocolManager *bpm) {
+    for(size_t i = 0; i < bpm->workersSize; i++) {
+#ifdef _WIN32
+        WaitForSingleObject(bpm->workers[i], INFINITE);
+        CloseHandle(bpm->workers[i]);
+#else
+        pthread_join(bpm->workers[i], NULL);
+#endif
+    }
+    UA_free(bpm->workers);
+    bpm->workers = NULL;
+    bpm->workersSize = 0;
 }
 
+#endif /* UA_MULTITHREADING >= 100 */
+
 /* remove the first channel that has no session attached */
 static UA_Boolean
 purgeFirstChannelWithoutSession(UA_BinaryProtocolManager *bpm) {
@@ -1104,6 +1540,9 @@ createServerSecureChannel(UA_BinaryProtocolManager *bpm, UA_ConnectionManager *c
 
     /* Set up the new SecureChannel */
     UA_SecureChannel_init(&entry->channel);
+#if UA_MULTITHREADING >= 100
+    TAILQ_INIT(&entry->jobs);
+#endif
     entry->channel.config = connConfig;
     entry->channel.certificateVerification = &config->secureChannelPKI;
     entry->channel.processOPNHeader = configServerSecureChannel;
@@ -1288,7 +1727,7 @@ serverNetworkCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
                                                      &payload, &copied);
         if(retval != UA_STATUSCODE_GOOD || payload.length == 0)
             break;
-        retval = processSecureChannelMessage(bpm->server, channel,
+        retval = processSecureChannelMessage(bpm, channel,
                                              messageType, requestId, &payload);
         if(copied)
             UA_ByteString_clear(&payload);
@@ -1769,7 +2208,7 @@ serverReverseConnectCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
                                                      &requestId, &payload, &copied);
         if(retval != UA_STATUSCODE_GOOD || payload.length == 0)
             break;
-        retval = processSecureChannelMessage(bpm->server, context->channel,
+        retval = processSecureChannelMessage(bpm, context->channel,
                                              messageType, requestId, &payload);
         if(copied)
             UA_ByteString_clear(&payload);
@@ -1812,6 +2251,20 @@ UA_BinaryProtocolManager_start(UA_Server *server,
     if(retVal != UA_STATUSCODE_GOOD)
         return retVal;
 
+#if UA_MULTITHREADING >= 100
+    /* Start the worker threads. Join the workers from a previous run first. */
+    if(bpm->workers)
+        joinServiceWorkers(bpm);
+    if(config->serviceWorkers > 0) {
+        retVal = startServiceWorkers(bpm, config->serviceWorkers);
+        if(retVal != UA_STATUSCODE_GOOD) {
+            UA_LOG_WARNING(config->logging, UA_LOGCATEGORY_SERVER,
+                           "Could not start the worker threads. Processing the "
+                           "service requests in the EventLoop.");
+        }
+    }
+#endif
+
     /* Open server sockets */
     UA_Boolean haveServerSocket = false;
     if(config->serverUrlsSize == 0) {
@@ -1885,6 +2338,13 @@ UA_BinaryProtocolManager_stop(UA_Server *server,
     /* Stop the regular retry callback */
     setReverseConnectRetryCallback(bpm, false);
 
+#if UA_MULTITHREADING >= 100
+    /* Signal the worker threads to stop. They are joined when the component is
+     * freed or started again. */
+    if(bpm->workers)
+        stopServiceWorkers(bpm);
+#endif
+
     /* Close or free all reverse connections */
     reverse_connect_context *rev, *rev_tmp;
     LIST_FOREACH_SAFE(rev, &bpm->reverseConnects, next, rev_tmp) {
@@ -1932,6 +2392,15 @@ UA_BinaryProtocolManager_free(UA_Server *server,
     if(sc->state != UA_LIFECYCLESTATE_STOPPED)
         return UA_STATUSCODE_BADINTERNALERROR;
 
+#if UA_MULTITHREADING >= 100
+    UA_BinaryProtocolManager *bpm = (UA_BinaryProtocolManager*)sc;
+    if(bpm->workers)
+        joinServiceWorkers(bpm);
+    workerConditionDestroy(&bpm->workerCondition);
+    workerMutexDestroy(&bpm->workerMutex);
+#endif
+
+    UA_Arena_clear(&((UA_BinaryProtocolManager*)sc)->requestArena);
     UA_free(sc);
     return UA_STATUSCODE_GOOD;
 }
@@ -1949,6 +2418,15 @@ UA_BinaryProtocolManager_new(UA_Server *server) {
     /* Initialize SecureChannel */
     TAILQ_INIT(&bpm->channels);
 
+    UA_Arena_init(&bpm->requestArena, UA_ARENA_DEFAULTBLOCKSIZE);
+
+#if UA_MULTITHREADING >= 100
+    /* Initialize the worker pool */
+    TAILQ_INIT(&bpm->readyChannels);
+    workerMutexInit(&bpm->workerMutex);
+    workerConditionInit(&bpm->workerCondition);
+#endif
+
     /* TODO: use an ID that is likely to be unique after a restart */
     bpm->lastChannelId = STARTCHANNELID;
     bpm->lastTokenId = STARTTOKENID;
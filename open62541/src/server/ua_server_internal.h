@@ -114,6 +114,8 @@ getServerComponentByName(UA_Server *server, UA_String name);
 typedef struct session_list_entry {
     UA_DelayedCallback cleanupCallback;
     LIST_ENTRY(session_list_entry) pointers;
+    struct session_list_entry *tokenNext; /* Bucket chain of the token index */
+    struct session_list_entry *idNext;    /* Bucket chain of the id index */
     UA_Session session;
 } session_list_entry;
 
@@ -139,6 +141,9 @@ struct UA_Server {
     /* Session Management */
     LIST_HEAD(session_list, session_list_entry) sessions;
     UA_UInt32 sessionCount;
+    session_list_entry **sessionsByToken; /* Hash index by authenticationToken */
+    session_list_entry **sessionsById;    /* Hash index by sessionId */
+    UA_UInt32 sessionIndexSize;           /* Number of buckets (power of two) */
     UA_UInt32 activeSessionCount;
     UA_Session adminSession; /* Local access to the services (for startup and
                               * maintenance) uses this Session with all possible
@@ -161,10 +166,19 @@ struct UA_Server {
                                                  * from a session. */
     UA_UInt32 lastSubscriptionId; /* To generate unique SubscriptionIds */
 
+    /* MonitoredItems with a cyclic sampling, grouped by the sampling
+     * interval */
+    LIST_HEAD(, UA_SamplingGroup) samplingGroups;
+
     /* To be cast to UA_LocalMonitoredItem to get the callback and context */
     LIST_HEAD(, UA_MonitoredItem) localMonitoredItems;
     UA_UInt32 lastLocalMonitoredItemId;
 
+# ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+    UA_EventEmitCache eventEmitCache;
+    UA_EventTypeIndex eventTypeIndex;
+# endif
+
 # ifdef UA_ENABLE_SUBSCRIPTIONS_ALARMS_CONDITIONS
     LIST_HEAD(, UA_ConditionSource) conditionSources;
     UA_NodeId refreshEvents[2];
@@ -178,6 +192,11 @@ struct UA_Server {
 
 #if UA_MULTITHREADING >= 100
     UA_Lock serviceMutex;
+    UA_RWLock serviceRWLock; /* Used if config.sharedServiceLock is enabled */
+    void * volatile serviceLockOwner; /* Thread with exclusive access */
+# ifdef UA_ENABLE_HISTORIZING
+    UA_Lock historyLock; /* HistoryRead calls the backend under the shared lock */
+# endif
 #endif
 
     /* Statistics */
@@ -259,6 +278,9 @@ UA_Server_removeSessionByToken(UA_Server *server, const UA_NodeId *token,
 void
 UA_Server_cleanupSessions(UA_Server *server, UA_DateTime nowMonotonic);
 
+void
+UA_Server_clearSessionIndex(UA_Server *server);
+
 UA_Session *
 getSessionByToken(UA_Server *server, const UA_NodeId *token);
 
@@ -379,6 +401,21 @@ UA_Server_processServiceOperations(UA_Server *server, UA_Session *session,
 void lockServer(UA_Server *server);
 void unlockServer(UA_Server *server);
 
+/* Lock for read-only access. Multiple threads can hold the shared lock at the
+ * same time if config.sharedServiceLock is enabled. Otherwise (and when nested
+ * inside an exclusive lock) this is the same as lockServer. A lockServer inside
+ * a shared lock does not upgrade to exclusive access. Upgrading would require to
+ * release the shared lock first, and a writer could then remove state (e.g. the
+ * session) that the outer service still uses. Hence the code called in shared
+ * mode must not modify the server state. */
+void lockServerShared(UA_Server *server);
+void unlockServerShared(UA_Server *server);
+
+/* Returns UA_STATUSCODE_BADINVALIDSTATE (and logs a warning) if the current
+ * thread holds the shared lock. Called before the information model is
+ * modified, e.g. from a DataSource read callback that writes to the server. */
+UA_StatusCode checkServerLockedExclusive(UA_Server *server);
+
 /******************************************/
 /* Internal function calls, without locks */
 /******************************************/
@@ -493,11 +530,34 @@ triggerEvent(UA_Server *server, const UA_NodeId eventNodeId,
              const UA_NodeId origin, UA_ByteString *outEventId,
              const UA_Boolean deleteEventNode);
 
+/* Invalidate the cached emitting nodes of events. Called when a reference is
+ * added/deleted and when a node is removed. */
+void
+eventEmitCacheReferenceChanged(UA_Server *server, UA_Byte refTypeIndex);
+
+void
+eventEmitCacheNodeRemoved(UA_Server *server, const UA_NodeId *nodeId);
+
+/* Add/remove an Event-MonitoredItem to/from the index of the event types that
+ * its compiled where-clause can accept. The program can be NULL. Then the
+ * MonitoredItem accepts events of any type. */
+UA_StatusCode
+eventTypeIndexAdd(UA_Server *server, UA_MonitoredItem *mon,
+                  const UA_EventFilterProgram *program);
+
+void
+eventTypeIndexRemove(UA_Server *server, UA_MonitoredItem *mon,
+                     const UA_EventFilterProgram *program);
+
 /* Filters the given event with the given filter and writes the results into a
- * notification */
+ * notification. The event is either the node eventNode or, if eventFields is
+ * non-NULL, the map of its fields (keyed by their BrowseName). The program is
+ * the compiled where-clause of the filter. If it is NULL, the where-clause is
+ * compiled on the fly. */
 UA_StatusCode
 filterEvent(UA_Server *server, UA_Session *session,
-            const UA_NodeId *eventNode, UA_EventFilter *filter,
+            const UA_NodeId *eventNode, const UA_KeyValueMap *eventFields,
+            UA_EventFilter *filter, const UA_EventFilterProgram *program,
             UA_EventFieldList *efl, UA_EventFilterResult *result);
 
 #endif /* UA_ENABLE_SUBSCRIPTIONS_EVENTS */
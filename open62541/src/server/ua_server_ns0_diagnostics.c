@@ -271,7 +271,9 @@ setSessionSubscriptionDiagnostics(UA_Server *server, UA_Session *session,
 
 static void
 setSessionDiagnostics(UA_Session *session, UA_SessionDiagnosticsDataType *sd) {
+    UA_LOCK(&session->statsLock);
     UA_SessionDiagnosticsDataType_copy(&session->diagnostics, sd);
+    UA_UNLOCK(&session->statsLock);
     UA_NodeId_copy(&session->sessionId, &sd->sessionId);
     UA_String_copy(&session->sessionName, &sd->sessionName);
     UA_ApplicationDescription_copy(&session->clientDescription,
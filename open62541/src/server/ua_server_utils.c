@@ -269,6 +269,11 @@ UA_StatusCode
 UA_Server_editNode(UA_Server *server, UA_Session *session,
                    const UA_NodeId *nodeId, UA_EditNodeCallback callback,
                    void *data) {
+    /* Concurrent readers might access the node */
+    UA_StatusCode res = checkServerLockedExclusive(server);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
 #ifndef UA_ENABLE_IMMUTABLE_NODES
     /* Get the node and process it in-situ */
     const UA_Node *node = UA_NODESTORE_GET(server, nodeId);
@@ -718,9 +718,9 @@ readWithReadValue(UA_Server *server, const UA_NodeId *nodeId,
 UA_DataValue
 UA_Server_read(UA_Server *server, const UA_ReadValueId *item,
                UA_TimestampsToReturn timestamps) {
-    lockServer(server);
+    lockServerShared(server);
     UA_DataValue dv = readWithSession(server, &server->adminSession, item, timestamps);
-    unlockServer(server);
+    unlockServerShared(server);
     return dv;
 }
 
@@ -729,9 +729,9 @@ UA_Server_read(UA_Server *server, const UA_ReadValueId *item,
 UA_StatusCode
 __UA_Server_read(UA_Server *server, const UA_NodeId *nodeId,
                  const UA_AttributeId attributeId, void *v) {
-   lockServer(server);
+   lockServerShared(server);
    UA_StatusCode retval = readWithReadValue(server, nodeId, attributeId, v);
-   unlockServer(server);
+   unlockServerShared(server);
    return retval;
 }
 
@@ -776,9 +776,9 @@ UA_StatusCode
 UA_Server_readObjectProperty(UA_Server *server, const UA_NodeId objectId,
                              const UA_QualifiedName propertyName,
                              UA_Variant *value) {
-    lockServer(server);
+    lockServerShared(server);
     UA_StatusCode retval = readObjectProperty(server, objectId, propertyName, value);
-    unlockServer(server);
+    unlockServerShared(server);
     return retval;
 }
 
@@ -1985,6 +1985,10 @@ Service_HistoryRead(UA_Server *server, UA_Session *session,
                                     data, historyDataType);
         historyData[i] = data;
     }
+
+    /* HistoryRead runs under the shared server lock. The backend is not
+     * required to be thread-safe. Serialize the calls. */
+    UA_LOCK(&server->historyLock);
     readHistory(server, server->config.historyDatabase.context,
                 &session->sessionId, session->sessionHandle,
                 &request->requestHeader,
@@ -1993,6 +1997,7 @@ Service_HistoryRead(UA_Server *server, UA_Session *session,
                 request->releaseContinuationPoints,
                 request->nodesToReadSize, request->nodesToRead,
                 response, historyData);
+    UA_UNLOCK(&server->historyLock);
     UA_free(historyData);
 }
 
@@ -338,6 +338,19 @@ checkEventFilterParam(UA_Server *server, UA_Session *session,
         UA_ContentFilterElementResult_clear(&whereRes[i]);
     return res;
 }
+
+/* Compile the where-clause of an Event MonitoredItem. The program points into
+ * the filter in the parameters. */
+static UA_StatusCode
+compileEventFilter(const UA_MonitoredItem *mon, const UA_MonitoringParameters *params,
+                   UA_EventFilterProgram **program) {
+    *program = NULL;
+    if(mon->itemToMonitor.attributeId != UA_ATTRIBUTEID_EVENTNOTIFIER)
+        return UA_STATUSCODE_GOOD;
+    const UA_EventFilter *eventFilter = (const UA_EventFilter *)
+        params->filter.content.decoded.data;
+    return UA_EventFilterProgram_compile(&eventFilter->whereClause, program);
+}
 #endif
 
 static const UA_String
@@ -483,6 +496,9 @@ Operation_CreateMonitoredItem(UA_Server *server, UA_Session *session,
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
     result->statusCode |= checkEventFilterParam(server, session, newMon,
                                                 &newMon->parameters, result);
+    if(result->statusCode == UA_STATUSCODE_GOOD)
+        result->statusCode = compileEventFilter(newMon, &newMon->parameters,
+                                                &newMon->eventFilterProgram);
 #endif
     if(result->statusCode != UA_STATUSCODE_GOOD) {
         UA_LOG_INFO_SUBSCRIPTION(server->config.logging, cmc->sub,
@@ -625,12 +641,38 @@ Operation_ModifyMonitoredItem(UA_Server *server, UA_Session *session, UA_Subscri
         return;
     }
 
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+    /* Compile the new where-clause */
+    UA_EventFilterProgram *program = NULL;
+    result->statusCode = compileEventFilter(mon, &params, &program);
+    if(result->statusCode != UA_STATUSCODE_GOOD) {
+        UA_MonitoringParameters_clear(&params);
+        return;
+    }
+
+    /* Re-index with the event types of the new where-clause */
+    if(mon->samplingType == UA_MONITOREDITEMSAMPLINGTYPE_EVENT &&
+       mon->itemToMonitor.attributeId == UA_ATTRIBUTEID_EVENTNOTIFIER) {
+        result->statusCode = eventTypeIndexAdd(server, mon, program);
+        if(result->statusCode != UA_STATUSCODE_GOOD) {
+            UA_EventFilterProgram_delete(program);
+            UA_MonitoringParameters_clear(&params);
+            return;
+        }
+        eventTypeIndexRemove(server, mon, mon->eventFilterProgram);
+    }
+#endif
+
     /* Store the old sampling interval */
     UA_Double oldSamplingInterval = mon->parameters.samplingInterval;
 
     /* Move over the new settings */
     UA_MonitoringParameters_clear(&mon->parameters);
     mon->parameters = params;
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+    UA_EventFilterProgram_delete(mon->eventFilterProgram);
+    mon->eventFilterProgram = program;
+#endif
 
     /* Re-register the callback if necessary */
     if(oldSamplingInterval != mon->parameters.samplingInterval) {
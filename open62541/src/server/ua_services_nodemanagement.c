@@ -1029,6 +1029,11 @@ addNode_addRefs(UA_Server *server, UA_Session *session, const UA_NodeId *nodeId,
 UA_StatusCode
 addNode_raw(UA_Server *server, UA_Session *session, void *nodeContext,
             const UA_AddNodesItem *item, UA_NodeId *outNewNodeId) {
+    /* No modifications while locked in shared mode */
+    UA_StatusCode res = checkServerLockedExclusive(server);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
     /* Do not check access for server */
     if(session != &server->adminSession && server->config.accessControl.allowAddNode) {
         UA_LOCK_ASSERT(&server->serviceMutex, 1);
@@ -1935,6 +1940,9 @@ deleteNodeSet(UA_Server *server, UA_Session *session,
         UA_NODESTORE_RELEASE(server, member);
         if(removeTargetRefs)
             removeIncomingReferences(server, session, &member->head);
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+        eventEmitCacheNodeRemoved(server, &member->head.nodeId);
+#endif
         UA_NODESTORE_REMOVE(server, &member->head.nodeId);
     }
 }
@@ -1944,6 +1952,11 @@ deleteNodeOperation(UA_Server *server, UA_Session *session, void *context,
                     const UA_DeleteNodesItem *item, UA_StatusCode *result) {
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
 
+    /* No modifications while locked in shared mode */
+    *result = checkServerLockedExclusive(server);
+    if(*result != UA_STATUSCODE_GOOD)
+        return;
+
     /* Do not check access for server */
     if(session != &server->adminSession && server->config.accessControl.allowDeleteNode) {
         if(!server->config.accessControl.
@@ -2069,6 +2082,9 @@ struct AddNodeInfo {
 static UA_StatusCode
 addOneWayReference(UA_Server *server, UA_Session *session, UA_Node *node,
                    const struct AddNodeInfo *info) {
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+    eventEmitCacheReferenceChanged(server, info->refTypeIndex);
+#endif
     return UA_Node_addReference(node, info->refTypeIndex, info->isForward,
                                 info->targetNodeId, info->targetBrowseNameHash);
 }
@@ -2085,6 +2101,9 @@ deleteOneWayReference(UA_Server *server, UA_Session *session, UA_Node *node,
     }
     UA_Byte refTypeIndex = refType->referenceTypeNode.referenceTypeIndex;
     UA_NODESTORE_RELEASE(server, refType);
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+    eventEmitCacheReferenceChanged(server, refTypeIndex);
+#endif
     return UA_Node_deleteReference(node, refTypeIndex, item->isForward, &item->targetNodeId);
 }
 
@@ -16,6 +16,110 @@
 #include "ua_server_internal.h"
 #include "ua_services.h"
 
+/*****************/
+/* Session Index */
+/*****************/
+
+/* The sessions are indexed by their authenticationToken and sessionId in hash
+ * tables with chained buckets. The index grows with the number of sessions so
+ * that the lookup for every request remains O(1). */
+
+#define UA_SESSIONINDEX_MINSIZE 16
+
+static void
+indexSession(UA_Server *server, session_list_entry *sentry) {
+    UA_UInt32 mask = server->sessionIndexSize - 1;
+    UA_UInt32 t = UA_NodeId_hash(&sentry->session.header.authenticationToken) & mask;
+    sentry->tokenNext = server->sessionsByToken[t];
+    server->sessionsByToken[t] = sentry;
+    UA_UInt32 i = UA_NodeId_hash(&sentry->session.sessionId) & mask;
+    sentry->idNext = server->sessionsById[i];
+    server->sessionsById[i] = sentry;
+}
+
+static void
+unindexSession(UA_Server *server, session_list_entry *sentry) {
+    UA_UInt32 mask = server->sessionIndexSize - 1;
+    session_list_entry **e = &server->sessionsByToken[
+        UA_NodeId_hash(&sentry->session.header.authenticationToken) & mask];
+    for(; *e; e = &(*e)->tokenNext) {
+        if(*e == sentry) {
+            *e = sentry->tokenNext;
+            break;
+        }
+    }
+    e = &server->sessionsById[UA_NodeId_hash(&sentry->session.sessionId) & mask];
+    for(; *e; e = &(*e)->idNext) {
+        if(*e == sentry) {
+            *e = sentry->idNext;
+            break;
+        }
+    }
+}
+
+/* Double the number of buckets and rehash all sessions */
+static UA_StatusCode
+growSessionIndex(UA_Server *server) {
+    UA_UInt32 newSize = (server->sessionIndexSize > 0) ?
+        server->sessionIndexSize * 2 : UA_SESSIONINDEX_MINSIZE;
+    session_list_entry **byToken = (session_list_entry**)
+        UA_calloc(newSize, sizeof(session_list_entry*));
+    session_list_entry **byId = (session_list_entry**)
+        UA_calloc(newSize, sizeof(session_list_entry*));
+    if(!byToken || !byId) {
+        UA_free(byToken);
+        UA_free(byId);
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+
+    UA_free(server->sessionsByToken);
+    UA_free(server->sessionsById);
+    server->sessionsByToken = byToken;
+    server->sessionsById = byId;
+    server->sessionIndexSize = newSize;
+
+    session_list_entry *sentry;
+    LIST_FOREACH(sentry, &server->sessions, pointers) {
+        indexSession(server, sentry);
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+void
+UA_Server_clearSessionIndex(UA_Server *server) {
+    UA_free(server->sessionsByToken);
+    UA_free(server->sessionsById);
+    server->sessionsByToken = NULL;
+    server->sessionsById = NULL;
+    server->sessionIndexSize = 0;
+}
+
+static session_list_entry *
+findSessionByToken(UA_Server *server, const UA_NodeId *token) {
+    if(server->sessionIndexSize == 0)
+        return NULL;
+    session_list_entry *sentry = server->sessionsByToken[
+        UA_NodeId_hash(token) & (server->sessionIndexSize - 1)];
+    for(; sentry; sentry = sentry->tokenNext) {
+        if(UA_NodeId_equal(&sentry->session.header.authenticationToken, token))
+            return sentry;
+    }
+    return NULL;
+}
+
+static session_list_entry *
+findSessionById(UA_Server *server, const UA_NodeId *sessionId) {
+    if(server->sessionIndexSize == 0)
+        return NULL;
+    session_list_entry *sentry = server->sessionsById[
+        UA_NodeId_hash(sessionId) & (server->sessionIndexSize - 1)];
+    for(; sentry; sentry = sentry->idNext) {
+        if(UA_NodeId_equal(&sentry->session.sessionId, sessionId))
+            return sentry;
+    }
+    return NULL;
+}
+
 /* Delayed callback to free the session memory */
 static void
 removeSessionCallback(UA_Server *server, session_list_entry *entry) {
@@ -65,6 +169,7 @@ UA_Server_removeSession(UA_Server *server, session_list_entry *sentry,
     /* Detach the session from the session manager and make the capacity
      * available */
     LIST_REMOVE(sentry, pointers);
+    unindexSession(server, sentry);
     server->sessionCount--;
 
     switch(shutdownReason) {
@@ -101,14 +206,11 @@ UA_StatusCode
 UA_Server_removeSessionByToken(UA_Server *server, const UA_NodeId *token,
                                UA_ShutdownReason shutdownReason) {
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
-    session_list_entry *entry;
-    LIST_FOREACH(entry, &server->sessions, pointers) {
-        if(UA_NodeId_equal(&entry->session.header.authenticationToken, token)) {
-            UA_Server_removeSession(server, entry, shutdownReason);
-            return UA_STATUSCODE_GOOD;
-        }
-    }
-    return UA_STATUSCODE_BADSESSIONIDINVALID;
+    session_list_entry *entry = findSessionByToken(server, token);
+    if(!entry)
+        return UA_STATUSCODE_BADSESSIONIDINVALID;
+    UA_Server_removeSession(server, entry, shutdownReason);
+    return UA_STATUSCODE_GOOD;
 }
 
 void
@@ -117,7 +219,7 @@ UA_Server_cleanupSessions(UA_Server *server, UA_DateTime nowMonotonic) {
     session_list_entry *sentry, *temp;
     LIST_FOREACH_SAFE(sentry, &server->sessions, pointers, temp) {
         /* Session has timed out? */
-        if(sentry->session.validTill >= nowMonotonic)
+        if(!UA_Session_timedOut(&sentry->session, nowMonotonic))
             continue;
         UA_LOG_INFO_SESSION(server->config.logging, &sentry->session,
                             "Session has timed out");
@@ -133,42 +235,32 @@ UA_Session *
 getSessionByToken(UA_Server *server, const UA_NodeId *token) {
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
 
-    session_list_entry *current = NULL;
-    LIST_FOREACH(current, &server->sessions, pointers) {
-        /* Token does not match */
-        if(!UA_NodeId_equal(&current->session.header.authenticationToken, token))
-            continue;
+    session_list_entry *current = findSessionByToken(server, token);
+    if(!current)
+        return NULL;
 
-        /* Session has timed out */
-        if(UA_DateTime_nowMonotonic() > current->session.validTill) {
-            UA_LOG_INFO_SESSION(server->config.logging, &current->session,
-                                "Client tries to use a session that has timed out");
-            return NULL;
-        }
-
-        return &current->session;
+    /* Session has timed out */
+    if(UA_Session_timedOut(&current->session, UA_DateTime_nowMonotonic())) {
+        UA_LOG_INFO_SESSION(server->config.logging, &current->session,
+                            "Client tries to use a session that has timed out");
+        return NULL;
     }
 
-    return NULL;
+    return &current->session;
 }
 
 UA_Session *
 getSessionById(UA_Server *server, const UA_NodeId *sessionId) {
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
 
-    session_list_entry *current = NULL;
-    LIST_FOREACH(current, &server->sessions, pointers) {
-        /* Token does not match */
-        if(!UA_NodeId_equal(&current->session.sessionId, sessionId))
-            continue;
-
+    session_list_entry *current = findSessionById(server, sessionId);
+    if(current) {
         /* Session has timed out */
-        if(UA_DateTime_nowMonotonic() > current->session.validTill) {
+        if(UA_Session_timedOut(&current->session, UA_DateTime_nowMonotonic())) {
             UA_LOG_INFO_SESSION(server->config.logging, &current->session,
                                 "Client tries to use a session that has timed out");
             return NULL;
         }
-
         return &current->session;
     }
 
@@ -231,6 +323,13 @@ UA_Server_createSession(UA_Server *server, UA_SecureChannel *channel,
         return UA_STATUSCODE_BADTOOMANYSESSIONS;
     }
 
+    /* Grow the index before it becomes too crowded */
+    if(server->sessionCount >= server->sessionIndexSize) {
+        UA_StatusCode res = growSessionIndex(server);
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+    }
+
     session_list_entry *newentry = (session_list_entry*)
         UA_malloc(sizeof(session_list_entry));
     if(!newentry)
@@ -253,6 +352,7 @@ UA_Server_createSession(UA_Server *server, UA_SecureChannel *channel,
 
     /* Add to the server */
     LIST_INSERT_HEAD(&server->sessions, newentry, pointers);
+    indexSession(server, newentry);
     server->sessionCount++;
 
     *session = &newentry->session;
@@ -727,7 +827,7 @@ Service_ActivateSession(UA_Server *server, UA_SecureChannel *channel,
     }
 
     /* Has the session timed out? */
-    if(session->validTill < UA_DateTime_nowMonotonic()) {
+    if(UA_Session_timedOut(session, UA_DateTime_nowMonotonic())) {
         UA_LOG_WARNING_SESSION(server->config.logging, session,
                                "ActivateSession: The Session has timed out");
         resp->responseHeader.serviceResult = UA_STATUSCODE_BADSESSIONIDINVALID;
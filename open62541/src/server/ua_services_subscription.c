@@ -549,6 +549,11 @@ Operation_TransferSubscription(UA_Server *server, UA_Session *session,
     }
     sub->monitoredItemsSize = 0;
 
+    /* The id index is taken over by the new Subscription as well. The
+     * MonitoredItems keep their ids. */
+    sub->monitoredItemsIndex = NULL;
+    sub->monitoredItemsIndexSize = 0;
+
     /* Move over the notification queue */
     TAILQ_INIT(&newSub->notificationQueue);
     UA_Notification *nn, *nn_tmp;
@@ -432,14 +432,14 @@ browseRecursive(UA_Server *server, size_t startNodesSize, const UA_NodeId *start
 UA_StatusCode
 UA_Server_browseRecursive(UA_Server *server, const UA_BrowseDescription *bd,
                           size_t *resultsSize, UA_ExpandedNodeId **results) {
-    lockServer(server);
+    lockServerShared(server);
 
     /* Set the list of relevant reference types */
     UA_ReferenceTypeSet refTypes;
     UA_StatusCode retval = referenceTypeIndices(server, &bd->referenceTypeId,
                                                 &refTypes, bd->includeSubtypes);
     if(retval != UA_STATUSCODE_GOOD) {
-        unlockServer(server);
+        unlockServerShared(server);
         return retval;
     }
 
@@ -447,7 +447,7 @@ UA_Server_browseRecursive(UA_Server *server, const UA_BrowseDescription *bd,
     retval = browseRecursive(server, 1, &bd->nodeId, bd->browseDirection,
                              &refTypes, bd->nodeClassMask, false, resultsSize, results);
 
-    unlockServer(server);
+    unlockServerShared(server);
     return retval;
 }
 
@@ -899,12 +899,6 @@ Operation_Browse(UA_Server *server, UA_Session *session, const UA_UInt32 *maxref
     UA_Guid *ident = NULL;
     UA_StatusCode retval = UA_STATUSCODE_GOOD;
 
-    /* Enough space for the continuation point? */
-    if(session->availableContinuationPoints == 0) {
-        retval = UA_STATUSCODE_BADNOCONTINUATIONPOINTS;
-        goto cleanup;
-    }
-
     /* Allocate and fill the data structure */
     cp2 = (ContinuationPoint*)UA_calloc(1, sizeof(ContinuationPoint));
     if(!cp2) {
@@ -938,10 +932,17 @@ Operation_Browse(UA_Server *server, UA_Session *session, const UA_UInt32 *maxref
     if(retval != UA_STATUSCODE_GOOD)
         goto cleanup;
 
-    /* Attach the cp to the session */
+    /* Attach the cp to the session if there is enough space left */
+    UA_LOCK(&session->statsLock);
+    if(session->availableContinuationPoints == 0) {
+        UA_UNLOCK(&session->statsLock);
+        retval = UA_STATUSCODE_BADNOCONTINUATIONPOINTS;
+        goto cleanup;
+    }
     cp2->next = session->continuationPoints;
     session->continuationPoints = cp2;
     --session->availableContinuationPoints;
+    UA_UNLOCK(&session->statsLock);
     return;
 
  cleanup:
@@ -987,9 +988,9 @@ UA_Server_browse(UA_Server *server, UA_UInt32 maxReferences,
                  const UA_BrowseDescription *bd) {
     UA_BrowseResult result;
     UA_BrowseResult_init(&result);
-    lockServer(server);
+    lockServerShared(server);
     Operation_Browse(server, &server->adminSession, &maxReferences, bd, &result);
-    unlockServer(server);
+    unlockServerShared(server);
     return result;
 }
 
@@ -997,7 +998,10 @@ static void
 Operation_BrowseNext(UA_Server *server, UA_Session *session,
                      const UA_Boolean *releaseContinuationPoints,
                      const UA_ByteString *continuationPoint, UA_BrowseResult *result) {
-    /* Find the continuation point */
+    /* Find the continuation point and take it out of the session while
+     * browsing. BrowseNext can run concurrently for the same session under the
+     * shared server lock. Then the cp is not found by the other thread. */
+    UA_LOCK(&session->statsLock);
     ContinuationPoint **prev = &session->continuationPoints;
     ContinuationPoint *cp;
     while((cp = *prev)) {
@@ -1006,17 +1010,22 @@ Operation_BrowseNext(UA_Server *server, UA_Session *session,
         prev = &cp->next;
     }
     if(!cp) {
+        UA_UNLOCK(&session->statsLock);
         result->statusCode = UA_STATUSCODE_BADCONTINUATIONPOINTINVALID;
         return;
     }
+    *prev = cp->next;
+    cp->next = NULL;
 
     /* Remove the cp */
     if(*releaseContinuationPoints) {
-        *prev = ContinuationPoint_clear(cp);
-        UA_free(cp);
         ++session->availableContinuationPoints;
+        UA_UNLOCK(&session->statsLock);
+        ContinuationPoint_clear(cp);
+        UA_free(cp);
         return;
     }
+    UA_UNLOCK(&session->statsLock);
 
     /* Prepare the context */
     struct BrowseContext bc;
@@ -1062,13 +1071,21 @@ Operation_BrowseNext(UA_Server *server, UA_Session *session,
         UA_BrowseResult_clear(result);
         result->statusCode = bc.status;
     }
+
+    /* Put the cp back into the session */
+    UA_LOCK(&session->statsLock);
+    cp->next = session->continuationPoints;
+    session->continuationPoints = cp;
+    UA_UNLOCK(&session->statsLock);
     return;
 
  remove_cp:
     /* Remove the cp */
-    *prev = ContinuationPoint_clear(cp);
+    ContinuationPoint_clear(cp);
     UA_free(cp);
+    UA_LOCK(&session->statsLock);
     ++session->availableContinuationPoints;
+    UA_UNLOCK(&session->statsLock);
 }
 
 void
@@ -1096,10 +1113,10 @@ UA_Server_browseNext(UA_Server *server, UA_Boolean releaseContinuationPoint,
                      const UA_ByteString *continuationPoint) {
     UA_BrowseResult result;
     UA_BrowseResult_init(&result);
-    lockServer(server);
+    lockServerShared(server);
     Operation_BrowseNext(server, &server->adminSession, &releaseContinuationPoint,
                          continuationPoint, &result);
-    unlockServer(server);
+    unlockServerShared(server);
     return result;
 }
 
@@ -1372,9 +1389,9 @@ translateBrowsePathToNodeIds(UA_Server *server,
 UA_BrowsePathResult
 UA_Server_translateBrowsePathToNodeIds(UA_Server *server,
                                        const UA_BrowsePath *browsePath) {
-    lockServer(server);
+    lockServerShared(server);
     UA_BrowsePathResult result = translateBrowsePathToNodeIds(server, browsePath);
-    unlockServer(server);
+    unlockServerShared(server);
     return result;
 }
 
@@ -1441,9 +1458,9 @@ browseSimplifiedBrowsePath(UA_Server *server, const UA_NodeId origin,
 UA_BrowsePathResult
 UA_Server_browseSimplifiedBrowsePath(UA_Server *server, const UA_NodeId origin,
                            size_t browsePathSize, const UA_QualifiedName *browsePath) {
-    lockServer(server);
+    lockServerShared(server);
     UA_BrowsePathResult bpr = browseSimplifiedBrowsePath(server, origin, browsePathSize, browsePath);
-    unlockServer(server);
+    unlockServerShared(server);
     return bpr;
 }
 
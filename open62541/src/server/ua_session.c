@@ -23,6 +23,7 @@ void UA_Session_init(UA_Session *session) {
     SIMPLEQ_INIT(&session->responseQueue);
     TAILQ_INIT(&session->subscriptions);
 #endif
+    UA_LOCK_INIT(&session->statsLock);
 }
 
 void UA_Session_clear(UA_Session *session, UA_Server* server) {
@@ -68,6 +69,8 @@ void UA_Session_clear(UA_Session *session, UA_Server* server) {
     UA_SessionDiagnosticsDataType_clear(&session->diagnostics);
     UA_SessionSecurityDiagnosticsDataType_clear(&session->securityDiagnostics);
 #endif
+
+    UA_LOCK_DESTROY(&session->statsLock);
 }
 
 void
@@ -123,13 +126,42 @@ UA_Session_generateNonce(UA_Session *session) {
 }
 
 void UA_Session_updateLifetime(UA_Session *session) {
+    UA_LOCK(&session->statsLock);
     session->validTill = UA_DateTime_nowMonotonic() +
         (UA_DateTime)(session->timeout * UA_DATETIME_MSEC);
 #ifdef UA_ENABLE_DIAGNOSTICS
     session->diagnostics.clientLastContactTime = UA_DateTime_now();
 #endif
+    UA_UNLOCK(&session->statsLock);
+}
+
+UA_Boolean
+UA_Session_timedOut(UA_Session *session, UA_DateTime nowMonotonic) {
+    UA_LOCK(&session->statsLock);
+    UA_Boolean timedOut = (session->validTill < nowMonotonic);
+    UA_UNLOCK(&session->statsLock);
+    return timedOut;
 }
 
+#ifdef UA_ENABLE_DIAGNOSTICS
+void
+UA_Session_countRequest(UA_Session *session, size_t counterOffset,
+                        UA_StatusCode serviceResult) {
+    UA_LOCK(&session->statsLock);
+    session->diagnostics.totalRequestCount.totalCount++;
+    if(serviceResult != UA_STATUSCODE_GOOD)
+        session->diagnostics.totalRequestCount.errorCount++;
+    if(counterOffset != 0) {
+        UA_ServiceCounterDataType *serviceCounter = (UA_ServiceCounterDataType*)
+            (((uintptr_t)&session->diagnostics) + counterOffset);
+        serviceCounter->totalCount++;
+        if(serviceResult != UA_STATUSCODE_GOOD)
+            serviceCounter->errorCount++;
+    }
+    UA_UNLOCK(&session->statsLock);
+}
+#endif
+
 #ifdef UA_ENABLE_SUBSCRIPTIONS
 
 void
@@ -77,6 +77,14 @@ typedef struct {
     UA_SessionSecurityDiagnosticsDataType securityDiagnostics;
     UA_SessionDiagnosticsDataType diagnostics;
 #endif
+
+#if UA_MULTITHREADING >= 100
+    /* Read-only services run concurrently under the shared server lock. They
+     * all update the lifetime (validTill) and the diagnostics counters. Browse
+     * and BrowseNext add and remove continuation points. So these are only
+     * accessed under the statsLock. */
+    UA_Lock statsLock;
+#endif
 } UA_Session;
 
 /**
@@ -92,6 +100,16 @@ UA_StatusCode UA_Session_generateNonce(UA_Session *session);
 /* If any activity on a session happens, the timeout is extended */
 void UA_Session_updateLifetime(UA_Session *session);
 
+UA_Boolean UA_Session_timedOut(UA_Session *session, UA_DateTime nowMonotonic);
+
+#ifdef UA_ENABLE_DIAGNOSTICS
+/* Count the request in the session diagnostics. The counterOffset points to
+ * the service-specific counter in the UA_SessionDiagnosticsDataType (zero for
+ * none). */
+void UA_Session_countRequest(UA_Session *session, size_t counterOffset,
+                             UA_StatusCode serviceResult);
+#endif
+
 /**
  * Subscription handling
  * --------------------- */
@@ -92,6 +92,9 @@ UA_Subscription_delete(UA_Server *server, UA_Subscription *sub) {
         UA_MonitoredItem_delete(server, mon);
     }
     UA_assert(sub->monitoredItemsSize == 0);
+    UA_free(sub->monitoredItemsIndex);
+    sub->monitoredItemsIndex = NULL;
+    sub->monitoredItemsIndexSize = 0;
 
     /* Delete Retransmission Queue */
     UA_NotificationMessageEntry *nme, *nme_tmp;
@@ -122,13 +125,86 @@ Subscription_resetLifetime(UA_Subscription *sub) {
 UA_MonitoredItem *
 UA_Subscription_getMonitoredItem(UA_Subscription *sub, UA_UInt32 monitoredItemId) {
     UA_MonitoredItem *mon;
-    LIST_FOREACH(mon, &sub->monitoredItems, listEntry) {
+
+    /* No index could be allocated. Fall back to the list. */
+    if(UA_UNLIKELY(sub->monitoredItemsIndexSize == 0)) {
+        LIST_FOREACH(mon, &sub->monitoredItems, listEntry) {
+            if(mon->monitoredItemId == monitoredItemId)
+                break;
+        }
+        return mon;
+    }
+
+    /* The ids are assigned sequentially. So the lower bits alone already give
+     * an even distribution over the buckets. */
+    mon = sub->monitoredItemsIndex[monitoredItemId & (sub->monitoredItemsIndexSize - 1)];
+    for(; mon; mon = mon->idNext) {
         if(mon->monitoredItemId == monitoredItemId)
             break;
     }
     return mon;
 }
 
+/* Double the number of buckets when the index is full. If the allocation
+ * fails, the old index remains in place with longer bucket chains. */
+static void
+growMonitoredItemsIndex(UA_Subscription *sub) {
+    if(sub->monitoredItemsSize < sub->monitoredItemsIndexSize)
+        return;
+    UA_UInt32 newSize = (sub->monitoredItemsIndexSize > 0) ?
+        sub->monitoredItemsIndexSize * 2 : 16;
+    UA_MonitoredItem **newIndex = (UA_MonitoredItem**)
+        UA_calloc(newSize, sizeof(UA_MonitoredItem*));
+    if(!newIndex)
+        return;
+
+    /* Rebuild from the list. This also indexes the MonitoredItems that were
+     * added while no index could be allocated. */
+    UA_MonitoredItem *mon;
+    LIST_FOREACH(mon, &sub->monitoredItems, listEntry) {
+        UA_MonitoredItem **bucket = &newIndex[mon->monitoredItemId & (newSize - 1)];
+        mon->idNext = *bucket;
+        *bucket = mon;
+    }
+    UA_free(sub->monitoredItemsIndex);
+    sub->monitoredItemsIndex = newIndex;
+    sub->monitoredItemsIndexSize = newSize;
+}
+
+void
+UA_Subscription_addMonitoredItem(UA_Subscription *sub, UA_MonitoredItem *mon) {
+    LIST_INSERT_HEAD(&sub->monitoredItems, mon, listEntry);
+    sub->monitoredItemsSize++;
+
+    /* Growing the index also inserts the new MonitoredItem */
+    UA_UInt32 oldSize = sub->monitoredItemsIndexSize;
+    growMonitoredItemsIndex(sub);
+    if(sub->monitoredItemsIndexSize == 0 || sub->monitoredItemsIndexSize != oldSize)
+        return;
+
+    UA_MonitoredItem **bucket =
+        &sub->monitoredItemsIndex[mon->monitoredItemId & (sub->monitoredItemsIndexSize - 1)];
+    mon->idNext = *bucket;
+    *bucket = mon;
+}
+
+void
+UA_Subscription_removeMonitoredItem(UA_Subscription *sub, UA_MonitoredItem *mon) {
+    LIST_REMOVE(mon, listEntry);
+    sub->monitoredItemsSize--;
+    if(sub->monitoredItemsIndexSize == 0)
+        return;
+    UA_MonitoredItem **pos =
+        &sub->monitoredItemsIndex[mon->monitoredItemId & (sub->monitoredItemsIndexSize - 1)];
+    for(; *pos; pos = &(*pos)->idNext) {
+        if(*pos == mon) {
+            *pos = mon->idNext;
+            break;
+        }
+    }
+    mon->idNext = NULL;
+}
+
 static void
 removeOldestRetransmissionMessageFromSub(UA_Subscription *sub) {
     UA_NotificationMessageEntry *oldestEntry =
@@ -24,6 +24,7 @@
 
 #include "ua_session.h"
 #include "ua_util_internal.h"
+#include "ziptree.h"
 
 _UA_BEGIN_DECLS
 
@@ -106,16 +107,39 @@ typedef TAILQ_HEAD(NotificationMessageQueue, UA_NotificationMessageEntry)
  * <0: Attached to the subscription. Triggered just before every "publish". */
 typedef enum {
     UA_MONITOREDITEMSAMPLINGTYPE_NONE = 0,
-    UA_MONITOREDITEMSAMPLINGTYPE_CYCLIC, /* Cyclic callback */
+    UA_MONITOREDITEMSAMPLINGTYPE_CYCLIC, /* Cyclic callback of a SamplingGroup */
     UA_MONITOREDITEMSAMPLINGTYPE_EVENT,  /* Attached to the node. Can be a "write
                                           * event" for DataChange MonitoredItems
                                           * with a zero sampling interval .*/
     UA_MONITOREDITEMSAMPLINGTYPE_PUBLISH /* Attached to the subscription */
 } UA_MonitoredItemSamplingType;
 
+/* MonitoredItems with the same (positive) sampling interval share a single
+ * repeated callback. The SamplingGroup is created with the first MonitoredItem
+ * for the sampling interval and removed with the last. */
+typedef struct UA_SamplingGroup {
+    LIST_ENTRY(UA_SamplingGroup) listEntry; /* List in the server */
+    UA_Double samplingInterval;
+    UA_UInt64 callbackId;
+    size_t monitoredItemsSize;
+    LIST_HEAD(, UA_MonitoredItem) monitoredItems;
+    UA_MonitoredItem *sampleNext; /* Next MonitoredItem while sampling. Is
+                                   * advanced when the MonitoredItem is removed
+                                   * from within the sampling. */
+    UA_Boolean sampling;
+} UA_SamplingGroup;
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+/* The where-clause of an EventFilter compiled to a flat program. Defined in
+ * ua_subscription_events_filter.c. */
+struct UA_EventFilterProgram;
+typedef struct UA_EventFilterProgram UA_EventFilterProgram;
+#endif
+
 struct UA_MonitoredItem {
     UA_DelayedCallback delayedFreePointers;
     LIST_ENTRY(UA_MonitoredItem) listEntry; /* Linked list in the Subscription */
+    UA_MonitoredItem *idNext; /* Bucket chain of the id index */
     UA_Subscription *subscription; /* If NULL, then this is a Local MonitoredItem */
     UA_UInt32 monitoredItemId;
 
@@ -146,10 +170,20 @@ struct UA_MonitoredItem {
      * changed at runtime of the MonitoredItem */
     UA_MonitoringParameters parameters;
 
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+    /* Compiled where-clause of the EventFilter in the parameters. Points into
+     * the memory of the filter. */
+    UA_EventFilterProgram *eventFilterProgram;
+    UA_UInt64 eventSequence; /* Sequence number of the last event */
+#endif
+
     /* Sampling */
     UA_MonitoredItemSamplingType samplingType;
     union {
-        UA_UInt64 callbackId;
+        struct {
+            UA_SamplingGroup *group;
+            LIST_ENTRY(UA_MonitoredItem) groupEntry;
+        } cyclic;
         UA_MonitoredItem *nodeListNext; /* Event-Based: Attached to Node */
         LIST_ENTRY(UA_MonitoredItem) subscriptionSampling; /* Linked to publish
                                                             * interval */
@@ -174,8 +208,8 @@ void UA_MonitoredItem_removeOverflowInfoBits(UA_MonitoredItem *mon);
 void UA_MonitoredItem_sampleCallback(UA_Server *server, UA_MonitoredItem *mon);
 void UA_Server_registerMonitoredItem(UA_Server *server, UA_MonitoredItem *mon);
 
-/* Register sampling. Either by adding a repeated callback or by adding the
- * MonitoredItem to a linked list in the node. */
+/* Register sampling. Either by adding the MonitoredItem to the SamplingGroup
+ * for its sampling interval or by adding it to a linked list in the node. */
 UA_StatusCode
 UA_MonitoredItem_registerSampling(UA_Server *server, UA_MonitoredItem *mon);
 
@@ -262,6 +296,8 @@ struct UA_Subscription {
     UA_UInt32 lastMonitoredItemId; /* increase the identifiers */
     LIST_HEAD(, UA_MonitoredItem) monitoredItems;
     UA_UInt32 monitoredItemsSize;
+    UA_MonitoredItem **monitoredItemsIndex; /* Hash index by monitoredItemId */
+    UA_UInt32 monitoredItemsIndexSize;      /* Number of buckets (power of two) */
 
     /* MonitoredItems that are sampled in every publish callback (with the
      * publish interval of the subscription) */
@@ -317,6 +353,13 @@ UA_MonitoredItem *
 UA_Subscription_getMonitoredItem(UA_Subscription *sub,
                                  UA_UInt32 monitoredItemId);
 
+/* Add/remove the MonitoredItem to the list and the id index */
+void
+UA_Subscription_addMonitoredItem(UA_Subscription *sub, UA_MonitoredItem *mon);
+
+void
+UA_Subscription_removeMonitoredItem(UA_Subscription *sub, UA_MonitoredItem *mon);
+
 void
 UA_Subscription_publish(UA_Server *server, UA_Subscription *sub);
 
@@ -340,10 +383,65 @@ typedef struct UA_ConditionSource UA_ConditionSource;
 #define UA_EVENTFILTER_MAXELEMENTS 64 /* Max operator elements */
 #define UA_EVENTFILTER_MAXOPERANDS 64 /* Max operands per operator */
 #define UA_EVENTFILTER_MAXSELECT   64 /* Max select clauses */
+#define UA_EVENTFILTER_MAXFIELDS   16 /* Max cached field operands */
+
+/* Events propagate upwards from the origin to the nodes that emit it. Finding
+ * the emitting nodes requires a recursive browse. The result is cached per
+ * origin. The cache is cleared when a reference of a type that is relevant for
+ * the propagation is added or deleted. The cache is bounded and is cleared
+ * entirely when it runs full. */
+#define UA_EVENT_EMITCACHE_MAXSIZE 1024
+
+typedef struct UA_EventEmitEntry {
+    ZIP_ENTRY(UA_EventEmitEntry) treeEntry;
+    UA_NodeId origin;
+    size_t emitNodesSize;
+    UA_ExpandedNodeId *emitNodes;
+} UA_EventEmitEntry;
+
+typedef ZIP_HEAD(UA_EventEmitTree, UA_EventEmitEntry) UA_EventEmitTree;
+
+typedef struct {
+    UA_EventEmitTree tree;
+    size_t size;
+    UA_UInt64 generation; /* Incremented when the cache is cleared */
+    UA_ReferenceTypeSet refTypes; /* ReferenceTypes relevant for propagation */
+} UA_EventEmitCache;
+
+void
+UA_EventEmitCache_clear(UA_EventEmitCache *cache);
+
+/* Event MonitoredItems are indexed by their node and by the event types that
+ * their where-clause can accept. MonitoredItems that accept events of any type
+ * are indexed with BaseEventType. An event is dispatched only to the
+ * MonitoredItems indexed with its type or one of its supertypes. */
+typedef struct {
+    UA_NodeId nodeId;
+    UA_NodeId eventType;
+} UA_EventTypeIndexKey;
+
+typedef struct UA_EventTypeIndexEntry {
+    ZIP_ENTRY(UA_EventTypeIndexEntry) treeEntry;
+    UA_EventTypeIndexKey key;
+    size_t monitoredItemsSize;
+    UA_MonitoredItem **monitoredItems;
+} UA_EventTypeIndexEntry;
+
+typedef ZIP_HEAD(UA_EventTypeIndexTree, UA_EventTypeIndexEntry) UA_EventTypeIndexTree;
+
+typedef struct {
+    UA_EventTypeIndexTree tree;
+    UA_UInt64 sequence; /* Incremented for every event. A MonitoredItem that is
+                         * indexed with several matching types receives the
+                         * event only once. */
+} UA_EventTypeIndex;
+
+void
+UA_EventTypeIndex_clear(UA_EventTypeIndex *index);
 
 UA_StatusCode
 UA_MonitoredItem_addEvent(UA_Server *server, UA_MonitoredItem *mon,
-                          const UA_NodeId *event);
+                          const UA_NodeId *event, const UA_KeyValueMap *eventFields);
 
 UA_StatusCode
 generateEventId(UA_ByteString *generatedId);
@@ -359,9 +457,29 @@ UA_ContentFilterElementValidation(UA_Server *server, size_t operatorIndex,
                                   size_t operatorsCount,
                                   const UA_ContentFilterElement *ef);
 
+/* The where-clause is compiled once when the MonitoredItem is created or
+ * modified. Every operand is pre-resolved to a slot: the result of a prior
+ * element, a literal or an event field. Identical field operands share a slot
+ * and are resolved only once per event. The program points into the memory of
+ * the ContentFilter and has to be recompiled if the filter changes. */
+UA_StatusCode
+UA_EventFilterProgram_compile(const UA_ContentFilter *filter,
+                              UA_EventFilterProgram **program);
+
+void
+UA_EventFilterProgram_delete(UA_EventFilterProgram *program);
+
+/* The event types of which an event has to be a (sub-)type to match. Derived
+ * from the OfType operators of the where-clause. Returns zero if the program
+ * can match events of any type. */
+size_t
+UA_EventFilterProgram_getEventTypes(const UA_EventFilterProgram *program,
+                                    const UA_NodeId ***eventTypes);
+
 /* Evaluate content filter, exported only for unit testing */
 UA_StatusCode
 evaluateWhereClause(UA_Server *server, UA_Session *session, const UA_NodeId *eventNode,
+                    const UA_KeyValueMap *eventFields,
                     const UA_ContentFilter *contentFilter,
                     UA_ContentFilterResult *contentFilterResult);
 
@@ -1773,7 +1773,7 @@ refreshLogic(UA_Server *server, const UA_NodeId *refreshStartNodId,
                                    &fieldTimeValue, &UA_TYPES[UA_TYPES_DATETIME]);
     CONDITION_ASSERT_RETURN_RETVAL(retval, "Write Object Property scalar failed",);
 
-    retval = UA_MonitoredItem_addEvent(server, monitoredItem, refreshStartNodId);
+    retval = UA_MonitoredItem_addEvent(server, monitoredItem, refreshStartNodId, NULL);
     CONDITION_ASSERT_RETURN_RETVAL(retval, "Events: Could not add the event to a listening node",);
 
     /* 2. Refresh (see 5.5.7) */
@@ -1812,7 +1812,7 @@ refreshLogic(UA_Server *server, const UA_NodeId *refreshStartNodId,
                     continue;
 
                 /* Add the event */
-                retval = UA_MonitoredItem_addEvent(server, monitoredItem, &triggeredNode);
+                retval = UA_MonitoredItem_addEvent(server, monitoredItem, &triggeredNode, NULL);
                 CONDITION_ASSERT_RETURN_RETVAL(retval, "Events: Could not add the event to a listening node",);
             }
         }
@@ -1823,7 +1823,7 @@ refreshLogic(UA_Server *server, const UA_NodeId *refreshStartNodId,
     retval = writeObjectProperty_scalar(server, *refreshEndNodId, fieldTimeQN,
                                         &fieldTimeValue, &UA_TYPES[UA_TYPES_DATETIME]);
     CONDITION_ASSERT_RETURN_RETVAL(retval, "Write Object Property scalar failed",);
-    return UA_MonitoredItem_addEvent(server, monitoredItem, refreshEndNodId);
+    return UA_MonitoredItem_addEvent(server, monitoredItem, refreshEndNodId, NULL);
 }
 
 static UA_StatusCode
@@ -172,40 +172,47 @@ eventSetStandardFields(UA_Server *server, const UA_NodeId *event,
 }
 
 /* Filters an event according to the filter specified by mon and then adds it to
- * mons notification queue */
+ * mons notification queue. The event is either given by its node or, if
+ * eventFields is non-NULL, by the map of its fields. */
 UA_StatusCode
 UA_MonitoredItem_addEvent(UA_Server *server, UA_MonitoredItem *mon,
-                          const UA_NodeId *event) {
+                          const UA_NodeId *event, const UA_KeyValueMap *eventFields) {
     /* Get the filter */
     if(mon->parameters.filter.content.decoded.type != &UA_TYPES[UA_TYPES_EVENTFILTER])
         return UA_STATUSCODE_BADFILTERNOTALLOWED;
     UA_EventFilter *eventFilter = (UA_EventFilter*)
         mon->parameters.filter.content.decoded.data;
 
-    /* Allocate memory for the notification */
-    UA_Notification *notification = UA_Notification_new();
-    if(!notification)
-        return UA_STATUSCODE_BADOUTOFMEMORY;
-
     /* The MonitoredItem must be attached to a Subscription. This code path is
      * not taken for local MonitoredItems (once they are enabled for Events). */
     UA_assert(mon->subscription);
     UA_Subscription *sub = mon->subscription;
     UA_Session *session = sub->session;
 
+    /* Filter the event with the compiled where-clause of the MonitoredItem.
+     * The notification is allocated only if the event matches. */
+    UA_EventFieldList efl;
     UA_EventFilterResult res; /* FilterResult contains only statuscodes. Ignored
                                * outside the initial setup/validation. */
-    UA_EventFilterResult_init(&res);
-    UA_StatusCode retval = filterEvent(server, session, event, eventFilter,
-                                       &notification->data.event, &res);
+    UA_StatusCode retval = filterEvent(server, session, event, eventFields,
+                                       eventFilter, mon->eventFilterProgram,
+                                       &efl, &res);
+    if(retval == UA_STATUSCODE_BADNOMATCH)
+        return UA_STATUSCODE_GOOD; /* Nothing was allocated */
     UA_EventFilterResult_clear(&res);
     if(retval != UA_STATUSCODE_GOOD) {
-        UA_Notification_delete(notification);
-        if(retval == UA_STATUSCODE_BADNOMATCH)
-            return UA_STATUSCODE_GOOD;
+        UA_EventFieldList_clear(&efl);
         return retval;
     }
 
+    /* Allocate memory for the notification */
+    UA_Notification *notification = UA_Notification_new();
+    if(!notification) {
+        UA_EventFieldList_clear(&efl);
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+    notification->data.event = efl;
+
     notification->data.event.clientHandle = mon->parameters.clientHandle;
     notification->mon = mon;
 
@@ -216,7 +223,8 @@ UA_MonitoredItem_addEvent(UA_Server *server, UA_MonitoredItem *mon,
 #ifdef UA_ENABLE_HISTORIZING
 static void
 setHistoricalEvent(UA_Server *server, const UA_NodeId *origin,
-                   const UA_NodeId *emitNodeId, const UA_NodeId *eventNodeId) {
+                   const UA_NodeId *emitNodeId, const UA_NodeId *eventNodeId,
+                   const UA_KeyValueMap *eventFields) {
     UA_Variant historicalEventFilterValue;
     UA_Variant_init(&historicalEventFilterValue);
 
@@ -250,7 +258,8 @@ setHistoricalEvent(UA_Server *server, const UA_NodeId *origin,
     UA_EventFilter *filter = (UA_EventFilter*) historicalEventFilterValue.data;
     UA_EventFieldList efl;
     UA_EventFilterResult result;
-    retval = filterEvent(server, &server->adminSession, eventNodeId, filter, &efl, &result);
+    retval = filterEvent(server, &server->adminSession, eventNodeId, eventFields,
+                         filter, NULL, &efl, &result);
     if(retval == UA_STATUSCODE_GOOD)
         server->config.historyDatabase.setEvent(server, server->config.historyDatabase.context,
                                                 origin, emitNodeId, filter, &efl);
@@ -272,74 +281,142 @@ static const UA_NodeId isInFolderReferences[2] =
     {{0, UA_NODEIDTYPE_NUMERIC, {UA_NS0ID_ORGANIZES}},
      {0, UA_NODEIDTYPE_NUMERIC, {UA_NS0ID_HASCOMPONENT}}};
 
-UA_StatusCode
-triggerEvent(UA_Server *server, const UA_NodeId eventNodeId,
-             const UA_NodeId origin, UA_ByteString *outEventId,
-             const UA_Boolean deleteEventNode) {
-    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+/**********************/
+/* Emit Node Caching  */
+/**********************/
 
-    UA_LOG_NODEID_DEBUG(&origin,
-        UA_LOG_DEBUG(server->config.logging, UA_LOGCATEGORY_SERVER,
-            "Events: An event is triggered on node %.*s",
-            (int)nodeIdStr.length, nodeIdStr.data));
+static enum ZIP_CMP
+cmpEventEmitEntry(const UA_NodeId *a, const UA_NodeId *b) {
+    return (enum ZIP_CMP)UA_NodeId_order(a, b);
+}
 
-#ifdef UA_ENABLE_SUBSCRIPTIONS_ALARMS_CONDITIONS
-    UA_Boolean isCallerAC = false;
-    if(isConditionOrBranch(server, &eventNodeId, &origin, &isCallerAC)) {
-        if(!isCallerAC) {
-          UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
-                                 "Condition Events: Please use A&C API to trigger Condition Events 0x%08X",
-                                  UA_STATUSCODE_BADINVALIDARGUMENT);
-          return UA_STATUSCODE_BADINVALIDARGUMENT;
-        }
-    }
-#endif /* UA_ENABLE_SUBSCRIPTIONS_ALARMS_CONDITIONS */
+ZIP_FUNCTIONS(UA_EventEmitTree, UA_EventEmitEntry, treeEntry,
+              UA_NodeId, origin, cmpEventEmitEntry)
 
-    /* Check that the origin node exists */
-    const UA_Node *originNode = UA_NODESTORE_GET(server, &origin);
-    if(!originNode) {
-        UA_LOG_ERROR(server->config.logging, UA_LOGCATEGORY_USERLAND,
-                     "Origin node for event does not exist.");
-        return UA_STATUSCODE_BADNOTFOUND;
+static void *
+deleteEventEmitEntry(void *context, UA_EventEmitEntry *entry) {
+    UA_NodeId_clear(&entry->origin);
+    UA_Array_delete(entry->emitNodes, entry->emitNodesSize,
+                    &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+    UA_free(entry);
+    return NULL;
+}
+
+void
+UA_EventEmitCache_clear(UA_EventEmitCache *cache) {
+    cache->generation++;
+    if(cache->size == 0)
+        return;
+    ZIP_ITER(UA_EventEmitTree, &cache->tree, deleteEventEmitEntry, NULL);
+    ZIP_INIT(&cache->tree);
+    cache->size = 0;
+}
+
+/* The generation is always incremented. Entries that are currently taken out
+ * of the cache for emitting an event are not reinserted then. */
+void
+eventEmitCacheReferenceChanged(UA_Server *server, UA_Byte refTypeIndex) {
+    /* Changes to the ReferenceType hierarchy change the relevant types */
+    UA_EventEmitCache *cache = &server->eventEmitCache;
+    if(refTypeIndex == UA_REFERENCETYPEINDEX_HASSUBTYPE ||
+       UA_ReferenceTypeSet_contains(&cache->refTypes, refTypeIndex))
+        UA_EventEmitCache_clear(cache);
+}
+
+void
+eventEmitCacheNodeRemoved(UA_Server *server, const UA_NodeId *nodeId) {
+    UA_EventEmitCache *cache = &server->eventEmitCache;
+    cache->generation++;
+    if(cache->size == 0)
+        return;
+    UA_EventEmitEntry *entry = ZIP_FIND(UA_EventEmitTree, &cache->tree, nodeId);
+    if(!entry)
+        return;
+    ZIP_REMOVE(UA_EventEmitTree, &cache->tree, entry);
+    cache->size--;
+    deleteEventEmitEntry(NULL, entry);
+}
+
+/* Compute the ReferenceTypes over which the events propagate and over which
+ * the origin is found in the ObjectsFolder */
+static UA_StatusCode
+getEventRefTypes(UA_Server *server, UA_ReferenceTypeSet *emitRefTypes,
+                 UA_ReferenceTypeSet *folderRefTypes) {
+    UA_ReferenceTypeSet_init(emitRefTypes);
+    for(size_t i = 0; i < EMIT_REFS_ROOT_COUNT; i++) {
+        UA_ReferenceTypeSet tmpRefTypes;
+        UA_StatusCode retval =
+            referenceTypeIndices(server, &emitReferencesRoots[i], &tmpRefTypes, true);
+        if(retval != UA_STATUSCODE_GOOD) {
+            UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
+                           "Events: Could not create the list of references for event "
+                           "propagation with StatusCode %s", UA_StatusCode_name(retval));
+            return retval;
+        }
+        *emitRefTypes = UA_ReferenceTypeSet_union(*emitRefTypes, tmpRefTypes);
     }
-    UA_NODESTORE_RELEASE(server, originNode);
 
-    /* Make sure the origin is in the ObjectsFolder (TODO: or in the ViewsFolder) */
     /* Only use Organizes and HasComponent to check if we are below the ObjectsFolder */
-    UA_StatusCode retval;
-    UA_ReferenceTypeSet refTypes;
-    UA_ReferenceTypeSet_init(&refTypes);
+    UA_ReferenceTypeSet_init(folderRefTypes);
     for(int i = 0; i < 2; ++i) {
         UA_ReferenceTypeSet tmpRefTypes;
-        retval = referenceTypeIndices(server, &isInFolderReferences[i], &tmpRefTypes, true);
+        UA_StatusCode retval =
+            referenceTypeIndices(server, &isInFolderReferences[i], &tmpRefTypes, true);
         if(retval != UA_STATUSCODE_GOOD) {
             UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
                            "Events: Could not create the list of references and their subtypes "
                            "with StatusCode %s", UA_StatusCode_name(retval));
+            return retval;
         }
-        refTypes = UA_ReferenceTypeSet_union(refTypes, tmpRefTypes);
+        *folderRefTypes = UA_ReferenceTypeSet_union(*folderRefTypes, tmpRefTypes);
     }
+    return UA_STATUSCODE_GOOD;
+}
 
-    if(!isNodeInTree(server, &origin, &objectsFolderId, &refTypes)) {
+/* Check that the origin node exists and is in the ObjectsFolder. Then get the
+ * list of nodes that emit its events. The entry is taken out of the cache (or
+ * newly created) and must be returned with releaseEmitEntry. */
+static UA_StatusCode
+getEmitEntry(UA_Server *server, const UA_NodeId *origin, UA_EventEmitEntry **outEntry) {
+    const UA_Node *originNode = UA_NODESTORE_GET(server, origin);
+    if(!originNode) {
+        UA_LOG_ERROR(server->config.logging, UA_LOGCATEGORY_USERLAND,
+                     "Origin node for event does not exist.");
+        return UA_STATUSCODE_BADNOTFOUND;
+    }
+    UA_NODESTORE_RELEASE(server, originNode);
+
+    /* Cache hit */
+    UA_EventEmitCache *cache = &server->eventEmitCache;
+    UA_EventEmitEntry *entry = ZIP_FIND(UA_EventEmitTree, &cache->tree, origin);
+    if(entry) {
+        ZIP_REMOVE(UA_EventEmitTree, &cache->tree, entry);
+        cache->size--;
+        *outEntry = entry;
+        return UA_STATUSCODE_GOOD;
+    }
+
+    UA_ReferenceTypeSet emitRefTypes, folderRefTypes;
+    UA_StatusCode retval = getEventRefTypes(server, &emitRefTypes, &folderRefTypes);
+    if(retval != UA_STATUSCODE_GOOD)
+        return retval;
+
+    /* Make sure the origin is in the ObjectsFolder (TODO: or in the ViewsFolder) */
+    if(!isNodeInTree(server, origin, &objectsFolderId, &folderRefTypes)) {
         UA_LOG_ERROR(server->config.logging, UA_LOGCATEGORY_USERLAND,
                      "Node for event must be in ObjectsFolder!");
         return UA_STATUSCODE_BADINVALIDARGUMENT;
     }
 
-    /* Update the standard fields of the event */
-    retval = eventSetStandardFields(server, &eventNodeId, &origin, outEventId);
+    entry = (UA_EventEmitEntry*)UA_calloc(1, sizeof(UA_EventEmitEntry));
+    if(!entry)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    retval = UA_NodeId_copy(origin, &entry->origin);
     if(retval != UA_STATUSCODE_GOOD) {
-        UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
-                       "Events: Could not set the standard event fields with StatusCode %s",
-                       UA_StatusCode_name(retval));
+        UA_free(entry);
         return retval;
     }
 
-    /* List of nodes that emit the node. Events propagate upwards (bubble up) in
-     * the node hierarchy. */
-    UA_ExpandedNodeId *emitNodes = NULL;
-    size_t emitNodesSize = 0;
-
     /* Add the server node to the list of nodes from which the event is emitted.
      * The server node emits all events.
      *
@@ -348,39 +425,239 @@ triggerEvent(UA_Server *server, const UA_NodeId eventNodeId,
      * a Server and as such has implied HasEventSource References to every event
      * source in a Server. */
     UA_NodeId emitStartNodes[2];
-    emitStartNodes[0] = origin;
+    emitStartNodes[0] = *origin;
     emitStartNodes[1] = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER);
 
-    /* Get all ReferenceTypes over which the events propagate */
-    UA_ReferenceTypeSet emitRefTypes;
-    UA_ReferenceTypeSet_init(&emitRefTypes);
-    for(size_t i = 0; i < EMIT_REFS_ROOT_COUNT; i++) {
-        UA_ReferenceTypeSet tmpRefTypes;
-        retval = referenceTypeIndices(server, &emitReferencesRoots[i], &tmpRefTypes, true);
-        if(retval != UA_STATUSCODE_GOOD) {
-            UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
-                           "Events: Could not create the list of references for event "
-                           "propagation with StatusCode %s", UA_StatusCode_name(retval));
-            goto cleanup;
-        }
-        emitRefTypes = UA_ReferenceTypeSet_union(emitRefTypes, tmpRefTypes);
-    }
-
-    /* Get the list of nodes in the hierarchy that emits the event. */
+    /* Get the list of nodes in the hierarchy that emits the event. Events
+     * propagate upwards (bubble up) in the node hierarchy. */
     retval = browseRecursive(server, 2, emitStartNodes, UA_BROWSEDIRECTION_INVERSE,
                              &emitRefTypes, UA_NODECLASS_UNSPECIFIED, true,
-                             &emitNodesSize, &emitNodes);
+                             &entry->emitNodesSize, &entry->emitNodes);
     if(retval != UA_STATUSCODE_GOOD) {
         UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
                        "Events: Could not create the list of nodes listening on the "
                        "event with StatusCode %s", UA_StatusCode_name(retval));
-        goto cleanup;
+        deleteEventEmitEntry(NULL, entry);
+        return retval;
     }
 
-    /* Add the event to the listening MonitoredItems at each relevant node */
-    for(size_t i = 0; i < emitNodesSize; i++) {
+    /* The cache depends on all these ReferenceTypes */
+    if(cache->size == 0)
+        cache->refTypes = UA_ReferenceTypeSet_union(emitRefTypes, folderRefTypes);
+
+    *outEntry = entry;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Put the entry (back) into the cache. Unless the cache was cleared in the
+ * meantime, e.g. from a callback during the event processing. */
+static void
+releaseEmitEntry(UA_Server *server, UA_EventEmitEntry *entry, UA_UInt64 generation) {
+    UA_EventEmitCache *cache = &server->eventEmitCache;
+    if(generation != cache->generation ||
+       ZIP_FIND(UA_EventEmitTree, &cache->tree, &entry->origin)) {
+        deleteEventEmitEntry(NULL, entry);
+        return;
+    }
+    if(cache->size >= UA_EVENT_EMITCACHE_MAXSIZE) {
+        UA_EventEmitCache_clear(cache);
+        UA_ReferenceTypeSet emitRefTypes, folderRefTypes;
+        if(getEventRefTypes(server, &emitRefTypes, &folderRefTypes) != UA_STATUSCODE_GOOD) {
+            deleteEventEmitEntry(NULL, entry);
+            return;
+        }
+        cache->refTypes = UA_ReferenceTypeSet_union(emitRefTypes, folderRefTypes);
+    }
+    ZIP_INSERT(UA_EventEmitTree, &cache->tree, entry);
+    cache->size++;
+}
+
+/********************/
+/* Event Type Index */
+/********************/
+
+static enum ZIP_CMP
+cmpEventTypeIndexKey(const UA_EventTypeIndexKey *a, const UA_EventTypeIndexKey *b) {
+    UA_Order o = UA_NodeId_order(&a->nodeId, &b->nodeId);
+    if(o != UA_ORDER_EQ)
+        return (enum ZIP_CMP)o;
+    return (enum ZIP_CMP)UA_NodeId_order(&a->eventType, &b->eventType);
+}
+
+ZIP_FUNCTIONS(UA_EventTypeIndexTree, UA_EventTypeIndexEntry, treeEntry,
+              UA_EventTypeIndexKey, key, cmpEventTypeIndexKey)
+
+static void *
+deleteEventTypeIndexEntry(void *context, UA_EventTypeIndexEntry *entry) {
+    UA_NodeId_clear(&entry->key.nodeId);
+    UA_NodeId_clear(&entry->key.eventType);
+    UA_free(entry->monitoredItems);
+    UA_free(entry);
+    return NULL;
+}
+
+void
+UA_EventTypeIndex_clear(UA_EventTypeIndex *index) {
+    ZIP_ITER(UA_EventTypeIndexTree, &index->tree, deleteEventTypeIndexEntry, NULL);
+    ZIP_INIT(&index->tree);
+}
+
+/* MonitoredItems that accept events of any type are indexed with BaseEventType */
+static const UA_NodeId anyEventTypeId =
+    {0, UA_NODEIDTYPE_NUMERIC, {UA_NS0ID_BASEEVENTTYPE}};
+static const UA_NodeId *anyEventType[1] = {&anyEventTypeId};
+
+/* Get the event types under which the MonitoredItem is indexed */
+static size_t
+getIndexEventTypes(const UA_EventFilterProgram *program,
+                   const UA_NodeId ***eventTypes) {
+    size_t eventTypesSize = 0;
+    if(program)
+        eventTypesSize = UA_EventFilterProgram_getEventTypes(program, eventTypes);
+    if(eventTypesSize == 0) {
+        *eventTypes = anyEventType;
+        eventTypesSize = 1;
+    }
+    return eventTypesSize;
+}
+
+static void
+removeIndexedMonitoredItem(UA_Server *server, UA_MonitoredItem *mon,
+                           const UA_EventTypeIndexKey *key) {
+    UA_EventTypeIndex *index = &server->eventTypeIndex;
+    UA_EventTypeIndexEntry *entry = ZIP_FIND(UA_EventTypeIndexTree, &index->tree, key);
+    if(!entry)
+        return;
+    for(size_t i = 0; i < entry->monitoredItemsSize; i++) {
+        if(entry->monitoredItems[i] != mon)
+            continue;
+        entry->monitoredItemsSize--;
+        entry->monitoredItems[i] = entry->monitoredItems[entry->monitoredItemsSize];
+        break;
+    }
+    if(entry->monitoredItemsSize > 0)
+        return;
+    ZIP_REMOVE(UA_EventTypeIndexTree, &index->tree, entry);
+    deleteEventTypeIndexEntry(NULL, entry);
+}
+
+void
+eventTypeIndexRemove(UA_Server *server, UA_MonitoredItem *mon,
+                     const UA_EventFilterProgram *program) {
+    const UA_NodeId **eventTypes;
+    size_t eventTypesSize = getIndexEventTypes(program, &eventTypes);
+    UA_EventTypeIndexKey key;
+    key.nodeId = mon->itemToMonitor.nodeId;
+    for(size_t i = 0; i < eventTypesSize; i++) {
+        key.eventType = *eventTypes[i];
+        removeIndexedMonitoredItem(server, mon, &key);
+    }
+}
+
+UA_StatusCode
+eventTypeIndexAdd(UA_Server *server, UA_MonitoredItem *mon,
+                  const UA_EventFilterProgram *program) {
+    UA_EventTypeIndex *index = &server->eventTypeIndex;
+    const UA_NodeId **eventTypes;
+    size_t eventTypesSize = getIndexEventTypes(program, &eventTypes);
+    UA_EventTypeIndexKey key;
+    key.nodeId = mon->itemToMonitor.nodeId;
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    size_t i = 0;
+    for(; i < eventTypesSize; i++) {
+        key.eventType = *eventTypes[i];
+        UA_EventTypeIndexEntry *entry =
+            ZIP_FIND(UA_EventTypeIndexTree, &index->tree, &key);
+
+        /* Create a new entry */
+        if(!entry) {
+            entry = (UA_EventTypeIndexEntry*)UA_calloc(1, sizeof(UA_EventTypeIndexEntry));
+            if(!entry) {
+                res = UA_STATUSCODE_BADOUTOFMEMORY;
+                break;
+            }
+            res |= UA_NodeId_copy(&key.nodeId, &entry->key.nodeId);
+            res |= UA_NodeId_copy(&key.eventType, &entry->key.eventType);
+            if(res != UA_STATUSCODE_GOOD) {
+                deleteEventTypeIndexEntry(NULL, entry);
+                break;
+            }
+            ZIP_INSERT(UA_EventTypeIndexTree, &index->tree, entry);
+        }
+
+        /* Append the MonitoredItem */
+        UA_MonitoredItem **mons = (UA_MonitoredItem**)
+            UA_realloc(entry->monitoredItems,
+                       sizeof(UA_MonitoredItem*) * (entry->monitoredItemsSize + 1));
+        if(!mons) {
+            if(entry->monitoredItemsSize == 0) {
+                ZIP_REMOVE(UA_EventTypeIndexTree, &index->tree, entry);
+                deleteEventTypeIndexEntry(NULL, entry);
+            }
+            res = UA_STATUSCODE_BADOUTOFMEMORY;
+            break;
+        }
+        mons[entry->monitoredItemsSize++] = mon;
+        entry->monitoredItems = mons;
+    }
+
+    /* Roll back the partial insertion */
+    if(res != UA_STATUSCODE_GOOD) {
+        while(i > 0) {
+            i--;
+            key.eventType = *eventTypes[i];
+            removeIndexedMonitoredItem(server, mon, &key);
+        }
+    }
+    return res;
+}
+
+/*****************/
+/* Emit an Event */
+/*****************/
+
+static void
+addEventToMonitoredItem(UA_Server *server, UA_MonitoredItem *mon,
+                        const UA_NodeId *eventNodeId,
+                        const UA_KeyValueMap *eventFields) {
+    /* Only log problems with individual emit nodes */
+    UA_StatusCode retval =
+        UA_MonitoredItem_addEvent(server, mon, eventNodeId, eventFields);
+    if(retval != UA_STATUSCODE_GOOD) {
+        UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
+                       "Events: Could not add the event to a listening "
+                       "node with StatusCode %s", UA_StatusCode_name(retval));
+    }
+}
+
+/* Add the event to the MonitoredItems of all nodes that emit it. The event is
+ * either given by its node or by the map of its fields. If the event type is
+ * known, the event is added only to the MonitoredItems indexed with the type or
+ * one of its supertypes. Otherwise all Event-MonitoredItems of the emitting
+ * nodes are considered. */
+static void
+emitEvent(UA_Server *server, const UA_NodeId *origin, const UA_EventEmitEntry *emit,
+          const UA_NodeId *eventType, const UA_NodeId *eventNodeId,
+          const UA_KeyValueMap *eventFields) {
+    /* Get the event type and its supertypes */
+    size_t eventTypesSize = 0;
+    UA_ExpandedNodeId *eventTypes = NULL;
+    if(eventType) {
+        UA_ReferenceTypeSet hasSubtype =
+            UA_REFTYPESET(UA_REFERENCETYPEINDEX_HASSUBTYPE);
+        UA_StatusCode retval =
+            browseRecursive(server, 1, eventType, UA_BROWSEDIRECTION_INVERSE,
+                            &hasSubtype, UA_NODECLASS_UNSPECIFIED, true,
+                            &eventTypesSize, &eventTypes);
+        if(retval != UA_STATUSCODE_GOOD)
+            eventTypesSize = 0;
+    }
+
+    UA_EventTypeIndex *index = &server->eventTypeIndex;
+    UA_UInt64 sequence = ++index->sequence;
+    for(size_t i = 0; i < emit->emitNodesSize; i++) {
         /* Get the node */
-        const UA_Node *node = UA_NODESTORE_GET(server, &emitNodes[i].nodeId);
+        const UA_Node *node = UA_NODESTORE_GET(server, &emit->emitNodes[i].nodeId);
         if(!node)
             continue;
 
@@ -390,18 +667,32 @@ triggerEvent(UA_Server *server, const UA_NodeId eventNodeId,
             continue;
         }
 
-        /* Add event to monitoreditems */
-        UA_MonitoredItem *mon = node->head.monitoredItems;
-        for(; mon != NULL; mon = mon->sampling.nodeListNext) {
-            /* Is this an Event-MonitoredItem? */
-            if(mon->itemToMonitor.attributeId != UA_ATTRIBUTEID_EVENTNOTIFIER)
-                continue;
-            retval = UA_MonitoredItem_addEvent(server, mon, &eventNodeId);
-            if(retval != UA_STATUSCODE_GOOD) {
-                UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
-                               "Events: Could not add the event to a listening "
-                               "node with StatusCode %s", UA_StatusCode_name(retval));
-                retval = UA_STATUSCODE_GOOD; /* Only log problems with individual emit nodes */
+        if(eventTypesSize > 0) {
+            /* Add event to the monitoreditems indexed with a matching type */
+            UA_EventTypeIndexKey key;
+            key.nodeId = node->head.nodeId;
+            for(size_t j = 0; j < eventTypesSize; j++) {
+                key.eventType = eventTypes[j].nodeId;
+                UA_EventTypeIndexEntry *entry =
+                    ZIP_FIND(UA_EventTypeIndexTree, &index->tree, &key);
+                if(!entry)
+                    continue;
+                for(size_t k = 0; k < entry->monitoredItemsSize; k++) {
+                    UA_MonitoredItem *mon = entry->monitoredItems[k];
+                    if(mon->eventSequence == sequence)
+                        continue; /* Already indexed with another type */
+                    mon->eventSequence = sequence;
+                    addEventToMonitoredItem(server, mon, eventNodeId, eventFields);
+                }
+            }
+        } else {
+            /* Add event to all monitoreditems */
+            UA_MonitoredItem *mon = node->head.monitoredItems;
+            for(; mon != NULL; mon = mon->sampling.nodeListNext) {
+                /* Is this an Event-MonitoredItem? */
+                if(mon->itemToMonitor.attributeId != UA_ATTRIBUTEID_EVENTNOTIFIER)
+                    continue;
+                addEventToMonitoredItem(server, mon, eventNodeId, eventFields);
             }
         }
 
@@ -410,10 +701,70 @@ triggerEvent(UA_Server *server, const UA_NodeId eventNodeId,
         /* Add event entry in the historical database */
 #ifdef UA_ENABLE_HISTORIZING
         if(server->config.historyDatabase.setEvent)
-            setHistoricalEvent(server, &origin, &emitNodes[i].nodeId, &eventNodeId);
+            setHistoricalEvent(server, origin, &emit->emitNodes[i].nodeId,
+                               eventNodeId, eventFields);
 #endif
     }
 
+    UA_Array_delete(eventTypes, eventTypesSize, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+}
+
+UA_StatusCode
+triggerEvent(UA_Server *server, const UA_NodeId eventNodeId,
+             const UA_NodeId origin, UA_ByteString *outEventId,
+             const UA_Boolean deleteEventNode) {
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+
+    UA_LOG_NODEID_DEBUG(&origin,
+        UA_LOG_DEBUG(server->config.logging, UA_LOGCATEGORY_SERVER,
+            "Events: An event is triggered on node %.*s",
+            (int)nodeIdStr.length, nodeIdStr.data));
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS_ALARMS_CONDITIONS
+    UA_Boolean isCallerAC = false;
+    if(isConditionOrBranch(server, &eventNodeId, &origin, &isCallerAC)) {
+        if(!isCallerAC) {
+          UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
+                                 "Condition Events: Please use A&C API to trigger Condition Events 0x%08X",
+                                  UA_STATUSCODE_BADINVALIDARGUMENT);
+          return UA_STATUSCODE_BADINVALIDARGUMENT;
+        }
+    }
+#endif /* UA_ENABLE_SUBSCRIPTIONS_ALARMS_CONDITIONS */
+
+    /* Check the origin node and get the nodes that emit the event */
+    UA_EventEmitEntry *emit = NULL;
+    UA_StatusCode retval = getEmitEntry(server, &origin, &emit);
+    if(retval != UA_STATUSCODE_GOOD)
+        return retval;
+    UA_UInt64 generation = server->eventEmitCache.generation;
+
+    /* Update the standard fields of the event */
+    retval = eventSetStandardFields(server, &eventNodeId, &origin, outEventId);
+    if(retval != UA_STATUSCODE_GOOD) {
+        UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
+                       "Events: Could not set the standard event fields with StatusCode %s",
+                       UA_StatusCode_name(retval));
+        releaseEmitEntry(server, emit, generation);
+        return retval;
+    }
+
+    /* Get the event type. If it cannot be read, the event is emitted to all
+     * Event-MonitoredItems. */
+    const UA_NodeId *eventType = NULL;
+    UA_Variant eventTypeValue;
+    UA_Variant_init(&eventTypeValue);
+    retval = readObjectProperty(server, eventNodeId,
+                                UA_QUALIFIEDNAME(0, "EventType"), &eventTypeValue);
+    if(retval == UA_STATUSCODE_GOOD &&
+       UA_Variant_hasScalarType(&eventTypeValue, &UA_TYPES[UA_TYPES_NODEID]))
+        eventType = (const UA_NodeId*)eventTypeValue.data;
+
+    /* Emit the event */
+    emitEvent(server, &origin, emit, eventType, &eventNodeId, NULL);
+    UA_Variant_clear(&eventTypeValue);
+    releaseEmitEntry(server, emit, generation);
+
     /* Delete the node representation of the event */
     if(deleteEventNode) {
         retval = deleteNode(server, eventNodeId, true);
@@ -424,11 +775,102 @@ triggerEvent(UA_Server *server, const UA_NodeId eventNodeId,
         }
     }
 
- cleanup:
-    UA_Array_delete(emitNodes, emitNodesSize, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
     return retval;
 }
 
+/* The fields of an event without node representation. The standard fields
+ * (EventId, EventType, SourceNode, ReceiveTime and Time) are placed in front of
+ * the user-defined fields. Their values point into the arguments and are not
+ * copied. If the user defines a standard field, the automatic value is used. */
+#define EVENT_STANDARD_FIELDS 5
+
+static UA_StatusCode
+triggerEventFields(UA_Server *server, const UA_NodeId *eventType,
+                   const UA_NodeId *origin, const UA_KeyValueMap *fields,
+                   UA_ByteString *outEventId) {
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+
+    /* Make sure the eventType is a subtype of BaseEventType. Conditions have a
+     * state in the information model and cannot be triggered without a node. */
+    UA_NodeId baseEventTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEEVENTTYPE);
+    if(!isNodeInTree_singleRef(server, eventType, &baseEventTypeId,
+                               UA_REFERENCETYPEINDEX_HASSUBTYPE)) {
+        UA_LOG_ERROR(server->config.logging, UA_LOGCATEGORY_USERLAND,
+                     "Event type must be a subtype of BaseEventType!");
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+    }
+#ifdef UA_ENABLE_SUBSCRIPTIONS_ALARMS_CONDITIONS
+    UA_NodeId conditionTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_CONDITIONTYPE);
+    if(isNodeInTree_singleRef(server, eventType, &conditionTypeId,
+                              UA_REFERENCETYPEINDEX_HASSUBTYPE)) {
+        UA_LOG_WARNING(server->config.logging, UA_LOGCATEGORY_SERVER,
+                       "Condition Events: Please use A&C API to trigger Condition Events");
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+    }
+#endif
+
+    /* Check the origin node and get the nodes that emit the event */
+    UA_EventEmitEntry *emit = NULL;
+    UA_StatusCode retval = getEmitEntry(server, origin, &emit);
+    if(retval != UA_STATUSCODE_GOOD)
+        return retval;
+    UA_UInt64 generation = server->eventEmitCache.generation;
+
+    /* Generate the EventId */
+    UA_ByteString eventId = UA_BYTESTRING_NULL;
+    retval = generateEventId(&eventId);
+    if(retval != UA_STATUSCODE_GOOD) {
+        releaseEmitEntry(server, emit, generation);
+        return retval;
+    }
+
+    /* Assemble the fields. The user-defined fields are shallow copies. */
+    size_t fieldsSize = (fields) ? fields->mapSize : 0;
+    UA_KeyValuePair *pairs = (UA_KeyValuePair*)
+        UA_malloc(sizeof(UA_KeyValuePair) * (EVENT_STANDARD_FIELDS + fieldsSize));
+    if(!pairs) {
+        UA_ByteString_clear(&eventId);
+        releaseEmitEntry(server, emit, generation);
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+
+    UA_DateTime now = UA_DateTime_now();
+    pairs[0].key = UA_QUALIFIEDNAME(0, "EventId");
+    UA_Variant_setScalar(&pairs[0].value, &eventId, &UA_TYPES[UA_TYPES_BYTESTRING]);
+    pairs[1].key = UA_QUALIFIEDNAME(0, "EventType");
+    UA_Variant_setScalar(&pairs[1].value, (void*)(uintptr_t)eventType,
+                         &UA_TYPES[UA_TYPES_NODEID]);
+    pairs[2].key = UA_QUALIFIEDNAME(0, "SourceNode");
+    UA_Variant_setScalar(&pairs[2].value, (void*)(uintptr_t)origin,
+                         &UA_TYPES[UA_TYPES_NODEID]);
+    pairs[3].key = UA_QUALIFIEDNAME(0, "ReceiveTime");
+    UA_Variant_setScalar(&pairs[3].value, &now, &UA_TYPES[UA_TYPES_DATETIME]);
+    size_t pairsSize = 4;
+
+    /* Time is set to now only if it is not defined by the user */
+    UA_QualifiedName timeName = UA_QUALIFIEDNAME(0, "Time");
+    if(!fields || !UA_KeyValueMap_contains(fields, timeName)) {
+        pairs[pairsSize].key = timeName;
+        UA_Variant_setScalar(&pairs[pairsSize].value, &now,
+                             &UA_TYPES[UA_TYPES_DATETIME]);
+        pairsSize++;
+    }
+
+    for(size_t i = 0; i < fieldsSize; i++)
+        pairs[pairsSize++] = fields->map[i];
+
+    UA_KeyValueMap eventFields = {pairsSize, pairs};
+    emitEvent(server, origin, emit, eventType, NULL, &eventFields);
+    releaseEmitEntry(server, emit, generation);
+
+    UA_free(pairs);
+    if(outEventId)
+        *outEventId = eventId;
+    else
+        UA_ByteString_clear(&eventId);
+    return UA_STATUSCODE_GOOD;
+}
+
 UA_StatusCode
 UA_Server_triggerEvent(UA_Server *server, const UA_NodeId eventNodeId,
                        const UA_NodeId origin, UA_ByteString *outEventId,
@@ -439,4 +881,15 @@ UA_Server_triggerEvent(UA_Server *server, const UA_NodeId eventNodeId,
     unlockServer(server);
     return res;
 }
+
+UA_StatusCode
+UA_Server_triggerEventFields(UA_Server *server, const UA_NodeId eventType,
+                             const UA_NodeId origin, const UA_KeyValueMap *fields,
+                             UA_ByteString *outEventId) {
+    lockServer(server);
+    UA_StatusCode res =
+        triggerEventFields(server, &eventType, &origin, fields, outEventId);
+    unlockServer(server);
+    return res;
+}
 #endif /* UA_ENABLE_SUBSCRIPTIONS_EVENTS */
@@ -167,6 +167,14 @@ implicitCastTargetType(const UA_DataType *t1, const UA_DataType *t2) {
  * - Converting a value that is outside the range of the target type causes a
  *   conversion error. */
 
+/* Storage for a numerical value. Casts and bitwise operators write their result
+ * there instead of allocating. */
+typedef union {
+    UA_Int64 i;
+    UA_UInt64 u;
+    UA_Double d;
+} UA_FilterScalar;
+
 #define UA_CAST_SIGNED(t, T)                                         \
     if(i < T##_MIN || (i > 0 && (t)i > T##_MAX))                     \
         return;                                                      \
@@ -185,9 +193,12 @@ implicitCastTargetType(const UA_DataType *t1, const UA_DataType *t2) {
     *(t*)data = (t)(f + 0.5);                                        \
     do { } while(0)
 
-/* We can cast between any numerical type. So this can be reused for explicit casting. */
+/* We can cast between any numerical type. So this can be reused for explicit
+ * casting. The result is written to the scratch storage and the output variant
+ * does not own its data. */
 static void
-castNumerical(const UA_Variant *in, const UA_DataType *type, UA_Variant *out) {
+castNumerical(const UA_Variant *in, const UA_DataType *type, UA_Variant *out,
+              UA_FilterScalar *scratch) {
     UA_assert(UA_Variant_isScalar(in));
     UA_Variant_init(out); /* Set to null value */
 
@@ -212,9 +223,7 @@ castNumerical(const UA_Variant *in, const UA_DataType *type, UA_Variant *out) {
     default: return;
     }
 
-    void *data = UA_new(type);
-    if(!data)
-        return;
+    void *data = scratch;
 
     if(ink == UA_DATATYPEKIND_SBYTE || ink == UA_DATATYPEKIND_INT16 ||
        ink == UA_DATATYPEKIND_INT32 || ink == UA_DATATYPEKIND_INT64) {
@@ -231,7 +240,6 @@ castNumerical(const UA_Variant *in, const UA_DataType *type, UA_Variant *out) {
         case UA_DATATYPEKIND_FLOAT:  *(UA_Float*)data = (UA_Float)i; break;
         case UA_DATATYPEKIND_DOUBLE: *(UA_Double*)data = (UA_Double)i; break;
         default:
-            UA_free(data);
             return;
         }
     } else if(ink == UA_DATATYPEKIND_BYTE   || ink == UA_DATATYPEKIND_UINT16 ||
@@ -249,16 +257,12 @@ castNumerical(const UA_Variant *in, const UA_DataType *type, UA_Variant *out) {
         case UA_DATATYPEKIND_FLOAT:  *(UA_Float*)data = (UA_Float)u; break;
         case UA_DATATYPEKIND_DOUBLE: *(UA_Double*)data = (UA_Double)u; break;
         default:
-            UA_free(data);
             return;
         }
     } else {
         /* Cast from float */
-        if(f != f) {
-            /* NaN cannot be cast */
-            UA_free(data);
-            return;
-        }
+        if(f != f)
+            return; /* NaN cannot be cast */
         switch(type->typeKind) {
         case UA_DATATYPEKIND_SBYTE:  UA_CAST_FLOAT(UA_SByte, UA_SBYTE); break;
         case UA_DATATYPEKIND_INT16:  UA_CAST_FLOAT(UA_Int16, UA_INT16); break;
@@ -271,12 +275,12 @@ castNumerical(const UA_Variant *in, const UA_DataType *type, UA_Variant *out) {
         case UA_DATATYPEKIND_FLOAT:  *(UA_Float*)data = (UA_Float)f; break;
         case UA_DATATYPEKIND_DOUBLE: *(UA_Double*)data = (UA_Double)f; break;
         default:
-            UA_free(data);
             return;
         }
     }
 
     UA_Variant_setScalar(out, data, type);
+    out->storageType = UA_VARIANT_DATA_NODELETE;
 }
 
 /* Implicit Casting
@@ -285,7 +289,8 @@ castNumerical(const UA_Variant *in, const UA_DataType *type, UA_Variant *out) {
 static UA_INLINE UA_Byte uppercase(UA_Byte in) { return in | 32; }
 
 static UA_StatusCode
-castImplicitFromString(const UA_Variant *in, const UA_DataType *outType, UA_Variant *out) {
+castImplicitFromString(const UA_Variant *in, const UA_DataType *outType,
+                       UA_Variant *out, UA_FilterScalar *scratch) {
     UA_StatusCode res = UA_STATUSCODE_GOOD;
     if(outType == &UA_TYPES[UA_TYPES_BOOLEAN]) {
         /* String -> Boolean
@@ -327,15 +332,11 @@ castImplicitFromString(const UA_Variant *in, const UA_DataType *outType, UA_Vari
 #ifdef UA_ENABLE_JSON_ENCODING
     /* String -> Numerical, uses the JSON decoding */
     else if(UA_DataType_isNumeric(outType)) {
-        void *outData = UA_new(outType);
-        if(!outData)
-            return UA_STATUSCODE_BADOUTOFMEMORY;
-        res = UA_decodeJson((const UA_ByteString*)in->data, outData, outType, NULL);
-        if(res != UA_STATUSCODE_GOOD) {
-            UA_free(outData);
+        res = UA_decodeJson((const UA_ByteString*)in->data, scratch, outType, NULL);
+        if(res != UA_STATUSCODE_GOOD)
             return res;
-        }
-        UA_Variant_setScalar(out, outData, outType);
+        UA_Variant_setScalar(out, scratch, outType);
+        out->storageType = UA_VARIANT_DATA_NODELETE;
         return UA_STATUSCODE_GOOD;
     }
 #endif
@@ -344,8 +345,10 @@ castImplicitFromString(const UA_Variant *in, const UA_DataType *outType, UA_Vari
     return UA_STATUSCODE_BADTYPEMISMATCH;
 }
 
+/* Numerical results are written to the scratch storage without allocation */
 static UA_StatusCode
-castImplicit(const UA_Variant *in, const UA_DataType *outType, UA_Variant *out) {
+castImplicit(const UA_Variant *in, const UA_DataType *outType, UA_Variant *out,
+             UA_FilterScalar *scratch) {
     /* Of the input is empty, casting results in a NULL value */
     if(UA_Variant_isEmpty(in)) {
         UA_Variant_init(out);
@@ -409,7 +412,7 @@ castImplicit(const UA_Variant *in, const UA_DataType *outType, UA_Variant *out)
     }
 
     case UA_DATATYPEKIND_STRING:
-        res = castImplicitFromString(in, outType, out);
+        res = castImplicitFromString(in, outType, out, scratch);
         break;
 
     case UA_DATATYPEKIND_LOCALIZEDTEXT: {
@@ -440,12 +443,52 @@ castImplicit(const UA_Variant *in, const UA_DataType *outType, UA_Variant *out)
         /* Try casting between numericals (also works for Boolean and StatusCode
          * input). The conversion can fail if the limits of the output type are
          * exceeded and then results in a NULL value. */
-        castNumerical(in, outType, out);
+        castNumerical(in, outType, out, scratch);
     }
 
     return res;
 }
 
+/* Filter Program
+ * --------------
+ * The where-clause is compiled to a flat array of instructions, one per
+ * element of the ContentFilter. The operands of the instructions are slots
+ * that are resolved once during the compilation: the result of a prior
+ * element, a literal or a field of the event. Identical field operands share a
+ * slot. So they are resolved only once per event. */
+
+typedef enum {
+    UA_FILTEROPERANDKIND_INVALID = 0,
+    UA_FILTEROPERANDKIND_ELEMENT, /* Result of an element evaluated prior */
+    UA_FILTEROPERANDKIND_LITERAL,
+    UA_FILTEROPERANDKIND_FIELD    /* SimpleAttributeOperand of the event */
+} UA_FilterOperandKind;
+
+typedef struct {
+    UA_FilterOperandKind kind;
+    size_t index; /* Element index or field slot. Fields beyond
+                   * UA_EVENTFILTER_MAXFIELDS are not cached. */
+    const UA_Variant *literal;
+    const UA_SimpleAttributeOperand *field;
+} UA_FilterOperandSlot;
+
+typedef struct {
+    UA_FilterOperator op;
+    size_t operandsSize;
+    const UA_FilterOperandSlot *operands;
+} UA_FilterInstruction;
+
+struct UA_EventFilterProgram {
+    size_t instructionsSize;
+    const UA_FilterInstruction *instructions;
+    size_t fieldsSize; /* Number of cached field slots */
+
+    /* The event types of which an event has to be a (sub-)type to match. Empty
+     * if the where-clause can match events of any type. */
+    size_t eventTypesSize;
+    const UA_NodeId **eventTypes;
+};
+
 /* Filter Evaluation
  * ----------------- */
 
@@ -453,27 +496,75 @@ typedef struct {
     UA_Server *server;
     UA_Session *session;
     const UA_NodeId *eventNode;
-    const UA_ContentFilter *filter;
-    UA_ContentFilterResult *filterResult;
+    const UA_KeyValueMap *eventFields; /* Set for events without a node */
+    const UA_EventFilterProgram *program;
+    UA_ContentFilterResult *filterResult; /* Can be NULL */
     UA_Variant results[UA_EVENTFILTER_MAXELEMENTS];
+    UA_FilterScalar resultsData[UA_EVENTFILTER_MAXELEMENTS];
+
+    /* The fields of the event are resolved on first use and kept until the end
+     * of the evaluation */
+    UA_Boolean fieldsResolved[UA_EVENTFILTER_MAXFIELDS];
+    UA_StatusCode fieldsStatus[UA_EVENTFILTER_MAXFIELDS];
+    UA_Variant fields[UA_EVENTFILTER_MAXFIELDS];
+    UA_Boolean eventTypeResolved;
+    UA_StatusCode eventTypeStatus;
+    UA_Variant eventType;
 
     /* The stack contains temporary variants. Cleaned up after the evaluation of
      * each operator. */
     size_t top;
     UA_Variant stack[UA_EVENTFILTER_MAXOPERANDS];
+    UA_FilterScalar stackData[UA_EVENTFILTER_MAXOPERANDS];
 } UA_FilterEvalContext;
 
 /* Operand Resolving
  * ~~~~~~~~~~~~~~~~~
  * Methods that all resolve an operator operand to a Variant. */
 
+/* Events without a node representation have their fields in a key-value map.
+ * The key is the BrowseName of the field. So only the value attribute of the
+ * direct children of the event can be resolved. */
+static UA_StatusCode
+lookupEventField(const UA_KeyValueMap *eventFields,
+                 const UA_SimpleAttributeOperand *sao, const UA_Variant **field) {
+    if(sao->browsePathSize != 1 || sao->attributeId != UA_ATTRIBUTEID_VALUE)
+        return UA_STATUSCODE_BADNOTSUPPORTED;
+    *field = UA_KeyValueMap_get(eventFields, sao->browsePath[0]);
+    if(!*field)
+        return UA_STATUSCODE_BADNOTFOUND;
+    if(UA_Variant_isEmpty(*field))
+        return UA_STATUSCODE_BADNODATAAVAILABLE;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+resolveEventField(const UA_KeyValueMap *eventFields,
+                  const UA_SimpleAttributeOperand *sao, UA_Variant *value) {
+    const UA_Variant *field;
+    UA_StatusCode res = lookupEventField(eventFields, sao, &field);
+    UA_CHECK_STATUS(res, return res);
+    if(sao->indexRange.length == 0)
+        return UA_Variant_copy(field, value);
+    UA_NumericRange range;
+    res = UA_NumericRange_parse(&range, sao->indexRange);
+    UA_CHECK_STATUS(res, return res);
+    res = UA_Variant_copyRange(field, value, range);
+    UA_free(range.dimensions);
+    return res;
+}
+
 /* Part 4, 7.4.4.5 SimpleAttributeOperand: The clause can point to any attribute
  * of nodes. Either a child of the event node and also the event type. */
 static UA_StatusCode
 resolveSimpleAttributeOperand(UA_Server *server, UA_Session *session,
                               const UA_NodeId *origin,
+                              const UA_KeyValueMap *eventFields,
                               const UA_SimpleAttributeOperand *sao,
                               UA_Variant *value) {
+    if(eventFields)
+        return resolveEventField(eventFields, sao, value);
+
     /* Prepare the ReadValueId */
     UA_ReadValueId rvi;
     UA_ReadValueId_init(&rvi);
@@ -533,37 +624,61 @@ resolveSimpleAttributeOperand(UA_Server *server, UA_Session *session,
     return UA_STATUSCODE_GOOD;
 }
 
+/* Fields from the key-value map are used in-place if no IndexRange is set */
 static UA_StatusCode
-resolveOperand(UA_FilterEvalContext *ctx, UA_ExtensionObject *op, UA_Variant *out) {
-    if(op->encoding != UA_EXTENSIONOBJECT_DECODED &&
-       op->encoding != UA_EXTENSIONOBJECT_DECODED_NODELETE)
-        return UA_STATUSCODE_BADFILTEROPERATORUNSUPPORTED;
+resolveFieldOperand(UA_FilterEvalContext *ctx, const UA_FilterOperandSlot *slot,
+                    UA_Variant *out) {
+    /* Not cached */
+    if(slot->index >= UA_EVENTFILTER_MAXFIELDS)
+        return resolveSimpleAttributeOperand(ctx->server, ctx->session,
+                                             ctx->eventNode, ctx->eventFields,
+                                             slot->field, out);
+
+    /* Resolve on first use */
+    size_t i = slot->index;
+    if(!ctx->fieldsResolved[i]) {
+        UA_Variant_init(&ctx->fields[i]);
+        if(ctx->eventFields && slot->field->indexRange.length == 0) {
+            const UA_Variant *field = NULL;
+            ctx->fieldsStatus[i] = lookupEventField(ctx->eventFields, slot->field, &field);
+            if(ctx->fieldsStatus[i] == UA_STATUSCODE_GOOD) {
+                ctx->fields[i] = *field;
+                ctx->fields[i].storageType = UA_VARIANT_DATA_NODELETE;
+            }
+        } else {
+            ctx->fieldsStatus[i] =
+                resolveSimpleAttributeOperand(ctx->server, ctx->session,
+                                              ctx->eventNode, ctx->eventFields,
+                                              slot->field, &ctx->fields[i]);
+        }
+        ctx->fieldsResolved[i] = true;
+    }
+
+    UA_CHECK_STATUS(ctx->fieldsStatus[i], return ctx->fieldsStatus[i]);
+    *out = ctx->fields[i];
+    out->storageType = UA_VARIANT_DATA_NODELETE;
+    return UA_STATUSCODE_GOOD;
+}
 
-    /* Result of an operator that was evaluated prior */
-    if(op->content.decoded.type == &UA_TYPES[UA_TYPES_ELEMENTOPERAND]) {
-        UA_ElementOperand *eo = (UA_ElementOperand*)op->content.decoded.data;
-        *out = ctx->results[eo->index];
+static UA_StatusCode
+resolveOperand(UA_FilterEvalContext *ctx, const UA_FilterOperandSlot *slot,
+               UA_Variant *out) {
+    switch(slot->kind) {
+    case UA_FILTEROPERANDKIND_ELEMENT:
+        /* Result of an operator that was evaluated prior */
+        *out = ctx->results[slot->index];
         out->storageType = UA_VARIANT_DATA_NODELETE;
         return UA_STATUSCODE_GOOD;
-    }
-
-    /* Literal value */
-    if(op->content.decoded.type == &UA_TYPES[UA_TYPES_LITERALOPERAND]) {
-        UA_LiteralOperand *lo = (UA_LiteralOperand*)op->content.decoded.data;
-        *out = lo->value;
+    case UA_FILTEROPERANDKIND_LITERAL:
+        *out = *slot->literal;
         out->storageType = UA_VARIANT_DATA_NODELETE;
         return UA_STATUSCODE_GOOD;
+    case UA_FILTEROPERANDKIND_FIELD:
+        /* SimpleAttributeOperand with a BrowsePath */
+        return resolveFieldOperand(ctx, slot, out);
+    default:
+        return UA_STATUSCODE_BADFILTEROPERATORUNSUPPORTED;
     }
-
-    /* SimpleAttributeOperand with a BrowsePath */
-    if(op->content.decoded.type == &UA_TYPES[UA_TYPES_SIMPLEATTRIBUTEOPERAND]) {
-        UA_SimpleAttributeOperand *sao =
-            (UA_SimpleAttributeOperand*)op->content.decoded.data;
-        return resolveSimpleAttributeOperand(ctx->server, ctx->session,
-                                             ctx->eventNode, sao, out);
-    }
-
-    return UA_STATUSCODE_BADFILTEROPERATORUNSUPPORTED;
 }
 
 /* The operandIndex is within the operator arguments, not the operand index for
@@ -571,8 +686,11 @@ resolveOperand(UA_FilterEvalContext *ctx, UA_ExtensionObject *op, UA_Variant *ou
 static UA_StatusCode
 setOperandError(UA_FilterEvalContext *ctx, size_t elementIndex,
                 size_t operandIndex, UA_StatusCode statusCode) {
+    if(!ctx->filterResult || elementIndex >= ctx->filterResult->elementResultsSize)
+        return statusCode;
     UA_ContentFilterElementResult *res = &ctx->filterResult->elementResults[elementIndex];
-    res->operandStatusCodes[operandIndex] = statusCode;
+    if(operandIndex < res->operandStatusCodesSize)
+        res->operandStatusCodes[operandIndex] = statusCode;
     /* The operator status is set globally in a single location upwards the call chain
      * res->statusCode = statusCode; */
     return statusCode;
@@ -581,50 +699,70 @@ setOperandError(UA_FilterEvalContext *ctx, size_t elementIndex,
 /* Filter Operators
  * ~~~~~~~~~~~~~~~~ */
 
+/* The EventType is resolved once per event */
+static UA_StatusCode
+resolveEventType(UA_FilterEvalContext *ctx, const UA_NodeId **eventTypeId) {
+    if(!ctx->eventTypeResolved) {
+        UA_Variant_init(&ctx->eventType);
+        if(ctx->eventFields) {
+            const UA_Variant *field =
+                UA_KeyValueMap_get(ctx->eventFields, UA_QUALIFIEDNAME(0, "EventType"));
+            ctx->eventTypeStatus = UA_STATUSCODE_BADNOTFOUND;
+            if(field) {
+                ctx->eventType = *field;
+                ctx->eventType.storageType = UA_VARIANT_DATA_NODELETE;
+                ctx->eventTypeStatus = UA_STATUSCODE_GOOD;
+            }
+        } else {
+            ctx->eventTypeStatus =
+                readObjectProperty(ctx->server, *ctx->eventNode,
+                                   UA_QUALIFIEDNAME(0, "EventType"), &ctx->eventType);
+        }
+        if(ctx->eventTypeStatus == UA_STATUSCODE_GOOD &&
+           !UA_Variant_hasScalarType(&ctx->eventType, &UA_TYPES[UA_TYPES_NODEID])) {
+            UA_LOG_WARNING(ctx->server->config.logging, UA_LOGCATEGORY_SERVER,
+                           "EventType has an invalid type.");
+            ctx->eventTypeStatus = UA_STATUSCODE_BADINTERNALERROR;
+        }
+        ctx->eventTypeResolved = true;
+    }
+    *eventTypeId = (const UA_NodeId*)ctx->eventType.data;
+    return ctx->eventTypeStatus;
+}
+
 static UA_StatusCode
 ofTypeOperator(UA_FilterEvalContext *ctx, size_t index) {
-    const UA_ContentFilterElement *elm = &ctx->filter->elements[index];
-    UA_assert(elm->filterOperandsSize == 1);
+    const UA_FilterInstruction *ins = &ctx->program->instructions[index];
+    UA_assert(ins->operandsSize == 1);
 
     /* Get the operand. Must be a literal NodeId */
     UA_Variant *op0 = &ctx->stack[ctx->top++];
-    UA_StatusCode res = resolveOperand(ctx, &elm->filterOperands[0], op0);
+    UA_StatusCode res = resolveOperand(ctx, &ins->operands[0], op0);
     if(res != UA_STATUSCODE_GOOD || !UA_Variant_hasScalarType(op0, &UA_TYPES[UA_TYPES_NODEID]))
         return setOperandError(ctx, index, 0, UA_STATUSCODE_BADFILTEROPERATORUNSUPPORTED);
 
     /* Read the event type */
-    UA_Variant eventTypeVar;
-    UA_Variant_init(&eventTypeVar);
-    const UA_NodeId *operandTypeId = (const UA_NodeId *)op0->data;
-    res = readObjectProperty(ctx->server, *ctx->eventNode,
-                             UA_QUALIFIEDNAME(0, "EventType"), &eventTypeVar);
+    const UA_NodeId *eventTypeId = NULL;
+    res = resolveEventType(ctx, &eventTypeId);
     UA_CHECK_STATUS(res, return res);
 
-    if(!UA_Variant_hasScalarType(&eventTypeVar, &UA_TYPES[UA_TYPES_NODEID])) {
-        UA_LOG_WARNING(ctx->server->config.logging, UA_LOGCATEGORY_SERVER,
-                       "EventType has an invalid type.");
-        UA_Variant_clear(&eventTypeVar);
-        return UA_STATUSCODE_BADINTERNALERROR;
-    }
-
     /* Check if the eventtype is equal to the operand or a subtype of it */
-    const UA_NodeId *eventTypeId = (UA_NodeId*)eventTypeVar.data;
+    const UA_NodeId *operandTypeId = (const UA_NodeId *)op0->data;
     UA_Boolean ofType = isNodeInTree_singleRef(ctx->server, eventTypeId, operandTypeId,
                                                UA_REFERENCETYPEINDEX_HASSUBTYPE);
     ctx->results[index] = t2v(ofType ? UA_TERNARY_TRUE : UA_TERNARY_FALSE);
-    UA_Variant_clear(&eventTypeVar);
     return UA_STATUSCODE_GOOD;
 }
 
 static UA_StatusCode
 andOperator(UA_FilterEvalContext *ctx, size_t index) {
-    const UA_ContentFilterElement *elm = &ctx->filter->elements[index];
-    UA_assert(elm->filterOperandsSize == 2);
+    const UA_FilterInstruction *ins = &ctx->program->instructions[index];
+    UA_assert(ins->operandsSize == 2);
     UA_Variant *op0 = &ctx->stack[ctx->top++];
-    UA_StatusCode res = resolveOperand(ctx, &elm->filterOperands[0], op0);
+    UA_StatusCode res = resolveOperand(ctx, &ins->operands[0], op0);
     UA_CHECK_STATUS(res, return res);
     UA_Variant *op1 = &ctx->stack[ctx->top++];
-    res = resolveOperand(ctx, &elm->filterOperands[1], op1);
+    res = resolveOperand(ctx, &ins->operands[1], op1);
     UA_CHECK_STATUS(res, return res);
     ctx->results[index] = t2v(UA_Ternary_and(v2t(op0), v2t(op1)));
     return UA_STATUSCODE_GOOD;
@@ -632,13 +770,13 @@ andOperator(UA_FilterEvalContext *ctx, size_t index) {
 
 static UA_StatusCode
 orOperator(UA_FilterEvalContext *ctx, size_t index) {
-    const UA_ContentFilterElement *elm = &ctx->filter->elements[index];
-    UA_assert(elm->filterOperandsSize == 2);
+    const UA_FilterInstruction *ins = &ctx->program->instructions[index];
+    UA_assert(ins->operandsSize == 2);
     UA_Variant *op0 = &ctx->stack[ctx->top++];
-    UA_StatusCode res = resolveOperand(ctx, &elm->filterOperands[0], op0);
+    UA_StatusCode res = resolveOperand(ctx, &ins->operands[0], op0);
     UA_CHECK_STATUS(res, return res);
     UA_Variant *op1 = &ctx->stack[ctx->top++];
-    res = resolveOperand(ctx, &elm->filterOperands[1], op1);
+    res = resolveOperand(ctx, &ins->operands[1], op1);
     UA_CHECK_STATUS(res, return res);
     ctx->results[index] = t2v(UA_Ternary_or(v2t(op0), v2t(op1)));
     return UA_STATUSCODE_GOOD;
@@ -646,10 +784,10 @@ orOperator(UA_FilterEvalContext *ctx, size_t index) {
 
 static UA_StatusCode
 notOperator(UA_FilterEvalContext *ctx, size_t index) {
-    const UA_ContentFilterElement *elm = &ctx->filter->elements[index];
-    UA_assert(elm->filterOperandsSize == 1);
+    const UA_FilterInstruction *ins = &ctx->program->instructions[index];
+    UA_assert(ins->operandsSize == 1);
     UA_Variant *op0 = &ctx->stack[ctx->top++];
-    UA_StatusCode res = resolveOperand(ctx, &elm->filterOperands[0], op0);
+    UA_StatusCode res = resolveOperand(ctx, &ins->operands[0], op0);
     UA_CHECK_STATUS(res, return res);
     ctx->results[index] = t2v(UA_Ternary_not(v2t(op0)));
     return UA_STATUSCODE_GOOD;
@@ -660,15 +798,15 @@ notOperator(UA_FilterEvalContext *ctx, size_t index) {
 static UA_StatusCode
 castResolveOperands(UA_FilterEvalContext *ctx, size_t index, UA_Boolean setError) {
     /* Enough space on the stack left? */
-    const UA_ContentFilterElement *elm = &ctx->filter->elements[index];
-    if(ctx->top + elm->filterOperandsSize > UA_EVENTFILTER_MAXOPERANDS)
+    const UA_FilterInstruction *ins = &ctx->program->instructions[index];
+    if(ctx->top + ins->operandsSize > UA_EVENTFILTER_MAXOPERANDS)
         return UA_STATUSCODE_BADOUTOFMEMORY;
 
     /* Resolve all operands */
     UA_assert(ctx->top == 0); /* Assume the stack is empty */
     UA_StatusCode res = UA_STATUSCODE_GOOD;
-    for(size_t i = 0; i < elm->filterOperandsSize; i++) {
-        res = resolveOperand(ctx, &elm->filterOperands[i], &ctx->stack[ctx->top++]);
+    for(size_t i = 0; i < ins->operandsSize; i++) {
+        res = resolveOperand(ctx, &ins->operands[i], &ctx->stack[ctx->top++]);
         UA_CHECK_STATUS(res, return res);
     }
     UA_assert(ctx->top > 0); /* Assume the stack is no longer empty */
@@ -682,10 +820,11 @@ castResolveOperands(UA_FilterEvalContext *ctx, size_t index, UA_Boolean setError
             return (setError) ? setOperandError(ctx, index, pos, res) : res;
     }
 
-    /* Cast the operands. Put the result in the same location on the stack. */
+    /* Cast the operands. Put the result in the same location on the stack.
+     * Numerical casts use the scratch storage next to the stack. */
     for(size_t pos = 0; pos < ctx->top; pos++) {
         UA_Variant orig = ctx->stack[pos];
-        res = castImplicit(&orig, targetType, &ctx->stack[pos]);
+        res = castImplicit(&orig, targetType, &ctx->stack[pos], &ctx->stackData[pos]);
         if(res != UA_STATUSCODE_GOOD)
             return (setError) ? setOperandError(ctx, index, pos, res) : res;
         if(ctx->stack[pos].data == orig.data) {
@@ -702,7 +841,7 @@ castResolveOperands(UA_FilterEvalContext *ctx, size_t index, UA_Boolean setError
 
 static UA_StatusCode
 compareOperator(UA_FilterEvalContext *ctx, size_t index, UA_FilterOperator op) {
-    UA_assert(ctx->filter->elements[index].filterOperandsSize == 2);
+    UA_assert(ctx->program->instructions[index].operandsSize == 2);
 
     /* Resolve and cast the operands. A failed casting results in FALSE. Note
      * that operands could cast to NULL. */
@@ -783,7 +922,7 @@ lteOperator(UA_FilterEvalContext *ctx, size_t index) {
 
 static UA_StatusCode
 bitwiseOperator(UA_FilterEvalContext *ctx, size_t index, UA_FilterOperator op) {
-    UA_assert(ctx->filter->elements[index].filterOperandsSize == 2);
+    UA_assert(ctx->program->instructions[index].operandsSize == 2);
 
     /* Resolve and cast the operands. Note that operands could cast to NULL. */
     UA_assert(ctx->top == 0); /* Assume the stack is empty */
@@ -797,9 +936,12 @@ bitwiseOperator(UA_FilterEvalContext *ctx, size_t index, UA_FilterOperator op) {
        ctx->stack[0].type != ctx->stack[1].type)
         return UA_STATUSCODE_BADTYPEMISMATCH;
 
-    /* Copy the casted literal to the result */
-    res = UA_Variant_copy(&ctx->stack[0], &ctx->results[index]);
-    UA_CHECK_STATUS(res, return res);
+    /* Copy the casted literal to the result storage */
+    UA_assert(type->memSize <= sizeof(UA_FilterScalar));
+    memcpy(&ctx->resultsData[index], ctx->stack[0].data, type->memSize);
+    ctx->results[index] = ctx->stack[0];
+    ctx->results[index].data = &ctx->resultsData[index];
+    ctx->results[index].storageType = UA_VARIANT_DATA_NODELETE;
 
     /* Do the bitwise operation on the result data */
     UA_Byte *bytesOut = (UA_Byte*)ctx->results[index].data;
@@ -825,7 +967,7 @@ bitwiseOrOperator(UA_FilterEvalContext *ctx, size_t index) {
 
 static UA_StatusCode
 betweenOperator(UA_FilterEvalContext *ctx, size_t index) {
-    UA_assert(ctx->filter->elements[index].filterOperandsSize == 3);
+    UA_assert(ctx->program->instructions[index].operandsSize == 3);
 
     /* If no implicit conversion is available and the operands are of different
      * types, the particular result is FALSE. */
@@ -855,15 +997,15 @@ betweenOperator(UA_FilterEvalContext *ctx, size_t index) {
 
 static UA_StatusCode
 inListOperator(UA_FilterEvalContext *ctx, size_t index) {
-    const UA_ContentFilterElement *elm = &ctx->filter->elements[index];
-    UA_assert(elm->filterOperandsSize >= 2);
+    const UA_FilterInstruction *ins = &ctx->program->instructions[index];
+    UA_assert(ins->operandsSize >= 2);
     UA_Boolean found = false;
     UA_Variant *op0 = &ctx->stack[ctx->top++];
     UA_Variant *op1 = &ctx->stack[ctx->top++];
-    UA_StatusCode res = resolveOperand(ctx, &elm->filterOperands[0], op0);
+    UA_StatusCode res = resolveOperand(ctx, &ins->operands[0], op0);
     UA_CHECK_STATUS(res, return res);
-    for(size_t i = 1; i < elm->filterOperandsSize && !found; i++) {
-        res = resolveOperand(ctx, &elm->filterOperands[i], op1);
+    for(size_t i = 1; i < ins->operandsSize && !found; i++) {
+        res = resolveOperand(ctx, &ins->operands[i], op1);
         if(res != UA_STATUSCODE_GOOD)
             continue;
         if(op0->type == op1->type && UA_equal(op0->data, op1->data, op0->type))
@@ -876,10 +1018,10 @@ inListOperator(UA_FilterEvalContext *ctx, size_t index) {
 
 static UA_StatusCode
 isNullOperator(UA_FilterEvalContext *ctx, size_t index) {
-    const UA_ContentFilterElement *elm = &ctx->filter->elements[index];
-    UA_assert(elm->filterOperandsSize == 1);
+    const UA_FilterInstruction *ins = &ctx->program->instructions[index];
+    UA_assert(ins->operandsSize == 1);
     UA_Variant *op0 = &ctx->stack[ctx->top++];
-    UA_StatusCode res = resolveOperand(ctx, &elm->filterOperands[0], op0);
+    UA_StatusCode res = resolveOperand(ctx, &ins->operands[0], op0);
     UA_CHECK_STATUS(res, return res);
     ctx->results[index] = t2v(UA_Variant_isEmpty(op0) ? UA_TERNARY_TRUE : UA_TERNARY_FALSE);
     return UA_STATUSCODE_GOOD;
@@ -890,8 +1032,8 @@ notImplementedOperator(UA_FilterEvalContext *ctx, size_t index) {
     return UA_STATUSCODE_BADFILTEROPERATORUNSUPPORTED;
 }
 
-/* Filter Evaluation
- * ~~~~~~~~~~~~~~~~~ */
+/* Operator Jumptable
+ * ~~~~~~~~~~~~~~~~~~ */
 
 typedef struct {
     UA_StatusCode (*operatorMethod)(UA_FilterEvalContext *ctx, size_t index);
@@ -920,23 +1062,221 @@ static const UA_FilterOperatorJumptableElement operatorJumptable[18] = {
     {bitwiseOrOperator, 2, 2}
 };
 
+/* Filter Compilation
+ * ~~~~~~~~~~~~~~~~~~ */
+
+static void
+compileOperand(UA_EventFilterProgram *program, const UA_FilterOperandSlot *prior,
+               size_t priorSize, size_t elementIndex, size_t elementsSize,
+               const UA_ExtensionObject *op, UA_FilterOperandSlot *slot) {
+    slot->kind = UA_FILTEROPERANDKIND_INVALID;
+    if(op->encoding != UA_EXTENSIONOBJECT_DECODED &&
+       op->encoding != UA_EXTENSIONOBJECT_DECODED_NODELETE)
+        return;
+
+    /* The elements are evaluated back to front. So an ElementOperand can only
+     * point to an element with a higher index. */
+    const UA_DataType *type = op->content.decoded.type;
+    if(type == &UA_TYPES[UA_TYPES_ELEMENTOPERAND]) {
+        const UA_ElementOperand *eo = (const UA_ElementOperand*)op->content.decoded.data;
+        if(eo->index <= elementIndex || eo->index >= elementsSize)
+            return;
+        slot->kind = UA_FILTEROPERANDKIND_ELEMENT;
+        slot->index = eo->index;
+        return;
+    }
+
+    if(type == &UA_TYPES[UA_TYPES_LITERALOPERAND]) {
+        const UA_LiteralOperand *lo = (const UA_LiteralOperand*)op->content.decoded.data;
+        slot->kind = UA_FILTEROPERANDKIND_LITERAL;
+        slot->literal = &lo->value;
+        return;
+    }
+
+    if(type != &UA_TYPES[UA_TYPES_SIMPLEATTRIBUTEOPERAND])
+        return;
+
+    /* Share the field slot with an identical field operand */
+    slot->kind = UA_FILTEROPERANDKIND_FIELD;
+    slot->field = (const UA_SimpleAttributeOperand*)op->content.decoded.data;
+    for(size_t i = 0; i < priorSize; i++) {
+        if(prior[i].kind == UA_FILTEROPERANDKIND_FIELD &&
+           prior[i].index < UA_EVENTFILTER_MAXFIELDS &&
+           UA_equal(prior[i].field, slot->field,
+                    &UA_TYPES[UA_TYPES_SIMPLEATTRIBUTEOPERAND])) {
+            slot->index = prior[i].index;
+            return;
+        }
+    }
+    slot->index = UA_EVENTFILTER_MAXFIELDS; /* Not cached */
+    if(program->fieldsSize < UA_EVENTFILTER_MAXFIELDS)
+        slot->index = program->fieldsSize++;
+}
+
+/* Collect the event types of which an event has to be a (sub-)type for the
+ * first element to evaluate to TRUE. The set for each element is a bitmask of
+ * the OfType elements it depends on. The sets are computed once per element,
+ * back to front, as ElementOperands only point to elements with a higher
+ * index. An element that can be TRUE for events of any type has no set. The
+ * event types remain empty if the first element has no set. */
+static void
+collectEventTypes(UA_EventFilterProgram *p) {
+    UA_UInt64 types[UA_EVENTFILTER_MAXELEMENTS];
+    UA_Boolean restricted[UA_EVENTFILTER_MAXELEMENTS];
+    for(size_t i = p->instructionsSize; i > 0; i--) {
+        size_t index = i - 1;
+        const UA_FilterInstruction *ins = &p->instructions[index];
+        const UA_FilterOperandSlot *ops = ins->operands;
+        types[index] = 0;
+        restricted[index] = false;
+        switch(ins->op) {
+        case UA_FILTEROPERATOR_OFTYPE:
+            if(ops[0].kind == UA_FILTEROPERANDKIND_LITERAL &&
+               UA_Variant_hasScalarType(ops[0].literal, &UA_TYPES[UA_TYPES_NODEID])) {
+                types[index] = (UA_UInt64)1 << index;
+                restricted[index] = true;
+            }
+            break;
+
+        case UA_FILTEROPERATOR_AND:
+            /* Either operand restricts the event type */
+            for(size_t j = 0; j < 2; j++) {
+                if(ops[j].kind == UA_FILTEROPERANDKIND_ELEMENT &&
+                   restricted[ops[j].index]) {
+                    types[index] = types[ops[j].index];
+                    restricted[index] = true;
+                    break;
+                }
+            }
+            break;
+
+        case UA_FILTEROPERATOR_OR:
+            /* Both operands have to restrict the event type */
+            if(ops[0].kind == UA_FILTEROPERANDKIND_ELEMENT &&
+               ops[1].kind == UA_FILTEROPERANDKIND_ELEMENT &&
+               restricted[ops[0].index] && restricted[ops[1].index]) {
+                types[index] = types[ops[0].index] | types[ops[1].index];
+                restricted[index] = true;
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    if(!restricted[0])
+        return;
+
+    /* Add the distinct event types of the OfType elements in the set */
+    for(size_t i = 0; i < p->instructionsSize; i++) {
+        if(!(types[0] & ((UA_UInt64)1 << i)))
+            continue;
+        const UA_NodeId *eventType = (const UA_NodeId*)
+            p->instructions[i].operands[0].literal->data;
+        size_t j = 0;
+        for(; j < p->eventTypesSize; j++) {
+            if(UA_NodeId_equal(p->eventTypes[j], eventType))
+                break;
+        }
+        if(j == p->eventTypesSize)
+            p->eventTypes[p->eventTypesSize++] = eventType;
+    }
+}
+
 UA_StatusCode
-evaluateWhereClause(UA_Server *server, UA_Session *session, const UA_NodeId *eventNode,
-                    const UA_ContentFilter *contentFilter,
-                    UA_ContentFilterResult *contentFilterResult) {
+UA_EventFilterProgram_compile(const UA_ContentFilter *filter,
+                              UA_EventFilterProgram **program) {
+    if(filter->elementsSize > UA_EVENTFILTER_MAXELEMENTS)
+        return UA_STATUSCODE_BADEVENTFILTERINVALID;
+
+    /* Check the operators and count the operands */
+    size_t operandsSize = 0;
+    size_t ofTypeSize = 0;
+    for(size_t i = 0; i < filter->elementsSize; i++) {
+        const UA_ContentFilterElement *elm = &filter->elements[i];
+        if(elm->filterOperator < 0 || elm->filterOperator > UA_FILTEROPERATOR_BITWISEOR)
+            return UA_STATUSCODE_BADEVENTFILTERINVALID;
+        if(elm->filterOperandsSize < operatorJumptable[elm->filterOperator].minOperatorCount ||
+           elm->filterOperandsSize > operatorJumptable[elm->filterOperator].maxOperatorCount)
+            return UA_STATUSCODE_BADFILTEROPERANDCOUNTMISMATCH;
+        operandsSize += elm->filterOperandsSize;
+        if(elm->filterOperator == UA_FILTEROPERATOR_OFTYPE)
+            ofTypeSize++;
+    }
+
+    /* Allocate the program with the instructions, operand slots and event
+     * types behind */
+    UA_EventFilterProgram *p = (UA_EventFilterProgram*)
+        UA_calloc(1, sizeof(UA_EventFilterProgram) +
+                  (sizeof(UA_FilterInstruction) * filter->elementsSize) +
+                  (sizeof(UA_FilterOperandSlot) * operandsSize) +
+                  (sizeof(const UA_NodeId*) * ofTypeSize));
+    if(!p)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    UA_FilterInstruction *instructions = (UA_FilterInstruction*)&p[1];
+    UA_FilterOperandSlot *slots = (UA_FilterOperandSlot*)&instructions[filter->elementsSize];
+    p->instructionsSize = filter->elementsSize;
+    p->instructions = instructions;
+    p->eventTypes = (const UA_NodeId**)&slots[operandsSize];
+
+    /* Compile the elements */
+    size_t slotsSize = 0;
+    for(size_t i = 0; i < filter->elementsSize; i++) {
+        const UA_ContentFilterElement *elm = &filter->elements[i];
+        instructions[i].op = elm->filterOperator;
+        instructions[i].operandsSize = elm->filterOperandsSize;
+        instructions[i].operands = &slots[slotsSize];
+        for(size_t j = 0; j < elm->filterOperandsSize; j++) {
+            compileOperand(p, slots, slotsSize, i, filter->elementsSize,
+                           &elm->filterOperands[j], &slots[slotsSize]);
+            slotsSize++;
+        }
+    }
+
+    /* The first element has to evaluate to TRUE for the filter to match */
+    if(p->instructionsSize > 0)
+        collectEventTypes(p);
+
+    *program = p;
+    return UA_STATUSCODE_GOOD;
+}
+
+void
+UA_EventFilterProgram_delete(UA_EventFilterProgram *program) {
+    UA_free(program);
+}
+
+size_t
+UA_EventFilterProgram_getEventTypes(const UA_EventFilterProgram *program,
+                                    const UA_NodeId ***eventTypes) {
+    *eventTypes = program->eventTypes;
+    return program->eventTypesSize;
+}
+
+/* Filter Evaluation
+ * ~~~~~~~~~~~~~~~~~ */
+
+static UA_StatusCode
+evaluateProgram(UA_Server *server, UA_Session *session, const UA_NodeId *eventNode,
+                const UA_KeyValueMap *eventFields, const UA_EventFilterProgram *program,
+                UA_ContentFilterResult *contentFilterResult) {
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
 
     /* An empty filter always succeeds */
-    if(contentFilter->elementsSize == 0)
+    if(program->instructionsSize == 0)
         return UA_STATUSCODE_GOOD;
 
     /* Prepare the context */
     UA_FilterEvalContext ctx;
     ctx.filterResult = contentFilterResult;
-    ctx.filter = contentFilter;
+    ctx.program = program;
     ctx.server = server;
     ctx.session = session;
     ctx.eventNode = eventNode;
+    ctx.eventFields = eventFields;
+    ctx.eventTypeResolved = false;
+    memset(ctx.fieldsResolved, 0, sizeof(UA_Boolean) * program->fieldsSize);
     ctx.top = 0;
 
     /* Pacify some compilers by initializing the first result */
@@ -946,10 +1286,10 @@ evaluateWhereClause(UA_Server *server, UA_Session *session, const UA_NodeId *eve
      * resolve each. This ensures that all element-index operands point to an
      * evaluated element. */
     UA_StatusCode res = UA_STATUSCODE_GOOD;
-    int i = (int)contentFilter->elementsSize - 1;
+    int i = (int)program->instructionsSize - 1;
     for(; i >= 0; i--) {
-        UA_ContentFilterElement *cfe = &contentFilter->elements[i];
-        res = operatorJumptable[cfe->filterOperator].operatorMethod(&ctx, (size_t)i);
+        UA_FilterOperator op = program->instructions[i].op;
+        res = operatorJumptable[op].operatorMethod(&ctx, (size_t)i);
         for(size_t j = 0; j < ctx.top; j++)
             UA_Variant_clear(&ctx.stack[j]); /* clean up the stack */
         ctx.top = 0;
@@ -961,12 +1301,69 @@ evaluateWhereClause(UA_Server *server, UA_Session *session, const UA_NodeId *eve
     if(res == UA_STATUSCODE_GOOD && v2t(&ctx.results[0]) != UA_TERNARY_TRUE)
         res = UA_STATUSCODE_BADNOMATCH;
 
-    /* Clean up the element result variants */
-    for(int j = (int)contentFilter->elementsSize - 1; j > i; j--)
+    /* Clean up the element result variants and the resolved fields */
+    for(int j = (int)program->instructionsSize - 1; j > i; j--)
         UA_Variant_clear(&ctx.results[j]);
+    for(size_t j = 0; j < program->fieldsSize; j++) {
+        if(ctx.fieldsResolved[j])
+            UA_Variant_clear(&ctx.fields[j]);
+    }
+    if(ctx.eventTypeResolved)
+        UA_Variant_clear(&ctx.eventType);
+    return res;
+}
+
+UA_StatusCode
+evaluateWhereClause(UA_Server *server, UA_Session *session, const UA_NodeId *eventNode,
+                    const UA_KeyValueMap *eventFields,
+                    const UA_ContentFilter *contentFilter,
+                    UA_ContentFilterResult *contentFilterResult) {
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+
+    /* An empty filter always succeeds */
+    if(contentFilter->elementsSize == 0)
+        return UA_STATUSCODE_GOOD;
+
+    UA_EventFilterProgram *program = NULL;
+    UA_StatusCode res = UA_EventFilterProgram_compile(contentFilter, &program);
+    UA_CHECK_STATUS(res, return res);
+    res = evaluateProgram(server, session, eventNode, eventFields,
+                          program, contentFilterResult);
+    UA_EventFilterProgram_delete(program);
     return res;
 }
 
+static UA_Boolean
+isValidEventType(UA_Server *server, const UA_NodeId *validEventParent,
+                 const UA_NodeId *eventType) {
+    /* Check whether the EventType is a Subtype of CondtionType (Part 9 first
+     * implementation) */
+    UA_NodeId conditionTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_CONDITIONTYPE);
+    if(UA_NodeId_equal(validEventParent, &conditionTypeId) &&
+       isNodeInTree_singleRef(server, eventType, &conditionTypeId,
+                              UA_REFERENCETYPEINDEX_HASSUBTYPE))
+        return true;
+
+    /* EventType is not a Subtype of CondtionType (ConditionId Clause won't be
+     * present in Events, which are not Conditions) */
+    /* Check whether Valid Event other than Conditions */
+    UA_NodeId baseEventTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEEVENTTYPE);
+    return isNodeInTree_singleRef(server, eventType, &baseEventTypeId,
+                                  UA_REFERENCETYPEINDEX_HASSUBTYPE);
+}
+
+/* Check the EventType of an event without node representation */
+static UA_Boolean
+isValidEventFields(UA_Server *server, const UA_NodeId *validEventParent,
+                   const UA_KeyValueMap *eventFields) {
+    const UA_Variant *field =
+        UA_KeyValueMap_get(eventFields, UA_QUALIFIEDNAME(0, "EventType"));
+    if(!field || !UA_Variant_hasScalarType(field, &UA_TYPES[UA_TYPES_NODEID]))
+        return false;
+    return isValidEventType(server, validEventParent,
+                            (const UA_NodeId*)field->data);
+}
+
 static UA_Boolean
 isValidEvent(UA_Server *server, const UA_NodeId *validEventParent,
              const UA_NodeId *eventId) {
@@ -986,48 +1383,46 @@ isValidEvent(UA_Server *server, const UA_NodeId *validEventParent,
     /* Read the Value of EventType Property Node (the Value should be a NodeId) */
     UA_StatusCode retval = readWithReadValue(server, &bpr.targets[0].targetId.nodeId,
                                              UA_ATTRIBUTEID_VALUE, &tOutVariant);
+    UA_BrowsePathResult_clear(&bpr);
     if(retval != UA_STATUSCODE_GOOD ||
        !UA_Variant_hasScalarType(&tOutVariant, &UA_TYPES[UA_TYPES_NODEID])) {
-        UA_BrowsePathResult_clear(&bpr);
-        return false;
-    }
-
-    const UA_NodeId *tEventType = (UA_NodeId*)tOutVariant.data;
-
-    /* Check whether the EventType is a Subtype of CondtionType (Part 9 first
-     * implementation) */
-    UA_NodeId conditionTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_CONDITIONTYPE);
-    if(UA_NodeId_equal(validEventParent, &conditionTypeId) &&
-       isNodeInTree_singleRef(server, tEventType, &conditionTypeId,
-                              UA_REFERENCETYPEINDEX_HASSUBTYPE)) {
-        UA_BrowsePathResult_clear(&bpr);
         UA_Variant_clear(&tOutVariant);
-        return true;
+        return false;
     }
 
-    /* EventType is not a Subtype of CondtionType (ConditionId Clause won't be
-     * present in Events, which are not Conditions) */
-    /* Check whether Valid Event other than Conditions */
-    UA_NodeId baseEventTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEEVENTTYPE);
-    UA_Boolean isSubtypeOfBaseEvent =
-        isNodeInTree_singleRef(server, tEventType, &baseEventTypeId,
-                               UA_REFERENCETYPEINDEX_HASSUBTYPE);
-
-    UA_BrowsePathResult_clear(&bpr);
+    UA_Boolean valid = isValidEventType(server, validEventParent,
+                                        (const UA_NodeId*)tOutVariant.data);
     UA_Variant_clear(&tOutVariant);
-    return isSubtypeOfBaseEvent;
+    return valid;
 }
 
 UA_StatusCode
 filterEvent(UA_Server *server, UA_Session *session,
-            const UA_NodeId *eventNode, UA_EventFilter *filter,
+            const UA_NodeId *eventNode, const UA_KeyValueMap *eventFields,
+            UA_EventFilter *filter, const UA_EventFilterProgram *program,
             UA_EventFieldList *efl, UA_EventFilterResult *result) {
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
 
+    UA_EventFieldList_init(efl);
+    UA_EventFilterResult_init(result);
     if(filter->selectClausesSize == 0)
         return UA_STATUSCODE_BADEVENTFILTERINVALID;
 
-    UA_EventFieldList_init(efl);
+    /* Evaluate the where filter. Do we event need to consider the event? The
+     * where-clause is compiled on the fly if no program is given. The operand
+     * errors are not reported here. The filter is validated when it is
+     * registered. */
+    UA_StatusCode res;
+    if(program) {
+        res = evaluateProgram(server, session, eventNode, eventFields, program, NULL);
+    } else {
+        res = evaluateWhereClause(server, session, eventNode, eventFields,
+                                  &filter->whereClause, NULL);
+    }
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    /* Allocate the output only for matching events */
     efl->eventFields = (UA_Variant *)
         UA_Array_new(filter->selectClausesSize, &UA_TYPES[UA_TYPES_VARIANT]);
     if(!efl->eventFields)
@@ -1035,7 +1430,6 @@ filterEvent(UA_Server *server, UA_Session *session,
     efl->eventFieldsSize = filter->selectClausesSize;
 
     /* Empty event filter result */
-    UA_EventFilterResult_init(result);
     result->selectClauseResultsSize = filter->selectClausesSize;
     result->selectClauseResults = (UA_StatusCode *)
         UA_Array_new(filter->selectClausesSize, &UA_TYPES[UA_TYPES_STATUSCODE]);
@@ -1045,43 +1439,6 @@ filterEvent(UA_Server *server, UA_Session *session,
         return UA_STATUSCODE_BADOUTOFMEMORY;
     }
 
-    /* Prepare content filter result structure */
-    if(filter->whereClause.elementsSize > 0) {
-        result->whereClauseResult.elementResultsSize = filter->whereClause.elementsSize;
-        result->whereClauseResult.elementResults = (UA_ContentFilterElementResult *)
-            UA_Array_new(filter->whereClause.elementsSize,
-                         &UA_TYPES[UA_TYPES_CONTENTFILTERELEMENTRESULT]);
-        if(!result->whereClauseResult.elementResults) {
-            UA_EventFieldList_clear(efl);
-            UA_EventFilterResult_clear(result);
-            return UA_STATUSCODE_BADOUTOFMEMORY;
-        }
-
-        for(size_t i = 0; i < filter->whereClause.elementsSize; ++i) {
-            UA_ContentFilterElementResult *er =
-                &result->whereClauseResult.elementResults[i];
-            UA_ContentFilterElement *cf = &filter->whereClause.elements[i];
-            er->operandStatusCodesSize = cf->filterOperandsSize;
-            er->operandStatusCodes = (UA_StatusCode *)
-                UA_Array_new(er->operandStatusCodesSize, &UA_TYPES[UA_TYPES_STATUSCODE]);
-            if(!er->operandStatusCodes) {
-                UA_EventFieldList_clear(efl);
-                UA_EventFilterResult_clear(result);
-                return UA_STATUSCODE_BADOUTOFMEMORY;
-            }
-        }
-    }
-
-    /* Evaluate the where filter. Do we event need to consider the event? */
-    UA_StatusCode res = evaluateWhereClause(server, session, eventNode,
-                                            &filter->whereClause,
-                                            &result->whereClauseResult);
-    if(res != UA_STATUSCODE_GOOD){
-        UA_EventFieldList_clear(efl);
-        UA_EventFilterResult_clear(result);
-        return res;
-    }
-
     /* Apply the select filter */
     UA_NodeId baseEventTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEEVENTTYPE);
     for(size_t i = 0; i < filter->selectClausesSize; i++) {
@@ -1089,7 +1446,8 @@ filterEvent(UA_Server *server, UA_Session *session,
         /* Check if the browsePath is BaseEventType, in which case nothing more
          * needs to be checked */
         if(!UA_NodeId_equal(&sc->typeDefinitionId, &baseEventTypeId) &&
-           !isValidEvent(server, &sc->typeDefinitionId, eventNode)) {
+           !(eventFields ? isValidEventFields(server, &sc->typeDefinitionId, eventFields) :
+             isValidEvent(server, &sc->typeDefinitionId, eventNode))) {
             UA_Variant_init(&efl->eventFields[i]);
             /* EventFilterResult currently isn't being used
                notification->result.selectClauseResults[i] =
@@ -1100,7 +1458,7 @@ filterEvent(UA_Server *server, UA_Session *session,
         /* Lookup the field. The overall filter can succeed even if a single
          * select-field cannot be resolved. */
         result->selectClauseResults[i] =
-            resolveSimpleAttributeOperand(server, session, eventNode,
+            resolveSimpleAttributeOperand(server, session, eventNode, eventFields,
                                           sc, &efl->eventFields[i]);
     }
 
@@ -430,8 +430,7 @@ UA_Server_registerMonitoredItem(UA_Server *server, UA_MonitoredItem *mon) {
     UA_Subscription *sub = mon->subscription;
     if(sub) {
         mon->monitoredItemId = ++sub->lastMonitoredItemId;
-        sub->monitoredItemsSize++;
-        LIST_INSERT_HEAD(&sub->monitoredItems, mon, listEntry);
+        UA_Subscription_addMonitoredItem(sub, mon);
     } else {
         mon->monitoredItemId = ++server->lastLocalMonitoredItemId;
         LIST_INSERT_HEAD(&server->localMonitoredItems, mon, listEntry);
@@ -487,8 +486,9 @@ UA_Server_unregisterMonitoredItem(UA_Server *server, UA_MonitoredItem *mon) {
 
     /* Deregister in Subscription and server */
     if(sub)
-        sub->monitoredItemsSize--;
-    LIST_REMOVE(mon, listEntry); /* Also for LocalMonitoredItems */
+        UA_Subscription_removeMonitoredItem(sub, mon);
+    else
+        LIST_REMOVE(mon, listEntry); /* LocalMonitoredItem */
     server->monitoredItemsSize--;
 
     mon->registered = false;
@@ -589,6 +589,10 @@ UA_MonitoredItem_delete(UA_Server *server, UA_MonitoredItem *mon) {
     /* Remove the settings */
     UA_ReadValueId_clear(&mon->itemToMonitor);
     UA_MonitoringParameters_clear(&mon->parameters);
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+    UA_EventFilterProgram_delete(mon->eventFilterProgram);
+    mon->eventFilterProgram = NULL;
+#endif
 
     /* Remove the last samples */
     UA_DataValue_clear(&mon->lastValue);
@@ -700,6 +704,79 @@ UA_MonitoredItem_ensureQueueSpace(UA_Server *server, UA_MonitoredItem *mon) {
     }
 }
 
+/* Sample all MonitoredItems of the group in one go */
+static void
+samplingGroupCallback(UA_Server *server, UA_SamplingGroup *sg) {
+    lockServer(server);
+    sg->sampling = true;
+    UA_MonitoredItem *mon = LIST_FIRST(&sg->monitoredItems);
+    for(; mon; mon = sg->sampleNext) {
+        sg->sampleNext = LIST_NEXT(mon, sampling.cyclic.groupEntry);
+        monitoredItem_sampleCallback(server, mon);
+    }
+    sg->sampleNext = NULL;
+    sg->sampling = false;
+
+    /* The last MonitoredItem was removed during the sampling */
+    if(sg->monitoredItemsSize == 0) {
+        removeCallback(server, sg->callbackId);
+        LIST_REMOVE(sg, listEntry);
+        UA_free(sg);
+    }
+    unlockServer(server);
+}
+
+static UA_StatusCode
+addToSamplingGroup(UA_Server *server, UA_MonitoredItem *mon) {
+    /* Find the group for the sampling interval */
+    UA_SamplingGroup *sg;
+    LIST_FOREACH(sg, &server->samplingGroups, listEntry) {
+        if(sg->samplingInterval == mon->parameters.samplingInterval)
+            break;
+    }
+
+    /* Create a new group with a repeated callback */
+    if(!sg) {
+        sg = (UA_SamplingGroup*)UA_calloc(1, sizeof(UA_SamplingGroup));
+        if(!sg)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        sg->samplingInterval = mon->parameters.samplingInterval;
+        UA_StatusCode res =
+            addRepeatedCallback(server, (UA_ServerCallback)samplingGroupCallback,
+                                sg, sg->samplingInterval, &sg->callbackId);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_free(sg);
+            return res;
+        }
+        LIST_INSERT_HEAD(&server->samplingGroups, sg, listEntry);
+    }
+
+    /* Insert at the head. MonitoredItems created in the same request (often
+     * for the same nodes) end up next to each other. */
+    LIST_INSERT_HEAD(&sg->monitoredItems, mon, sampling.cyclic.groupEntry);
+    sg->monitoredItemsSize++;
+    mon->sampling.cyclic.group = sg;
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+removeFromSamplingGroup(UA_Server *server, UA_MonitoredItem *mon) {
+    UA_SamplingGroup *sg = mon->sampling.cyclic.group;
+    if(sg->sampleNext == mon)
+        sg->sampleNext = LIST_NEXT(mon, sampling.cyclic.groupEntry);
+    LIST_REMOVE(mon, sampling.cyclic.groupEntry);
+    mon->sampling.cyclic.group = NULL;
+    sg->monitoredItemsSize--;
+
+    /* Remove the group with the last MonitoredItem. If the group is currently
+     * sampled, it is removed at the end of the sampling callback. */
+    if(sg->monitoredItemsSize > 0 || sg->sampling)
+        return;
+    removeCallback(server, sg->callbackId);
+    LIST_REMOVE(sg, listEntry);
+    UA_free(sg);
+}
+
 UA_StatusCode
 UA_MonitoredItem_registerSampling(UA_Server *server, UA_MonitoredItem *mon) {
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
@@ -718,8 +795,20 @@ UA_MonitoredItem_registerSampling(UA_Server *server, UA_MonitoredItem *mon) {
             session = sub->session;
         res = UA_Server_editNode(server, session, &mon->itemToMonitor.nodeId,
                                  addMonitoredItemBackpointer, mon);
-        if(res == UA_STATUSCODE_GOOD)
-            mon->samplingType = UA_MONITOREDITEMSAMPLINGTYPE_EVENT;
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+        /* Index Event-MonitoredItems by the event types they accept */
+        if(mon->itemToMonitor.attributeId == UA_ATTRIBUTEID_EVENTNOTIFIER) {
+            res = eventTypeIndexAdd(server, mon, mon->eventFilterProgram);
+            if(res != UA_STATUSCODE_GOOD) {
+                UA_Server_editNode(server, session, &mon->itemToMonitor.nodeId,
+                                   removeMonitoredItemBackPointer, mon);
+                return res;
+            }
+        }
+#endif
+        mon->samplingType = UA_MONITOREDITEMSAMPLINGTYPE_EVENT;
         return res;
     } else if(sub && mon->parameters.samplingInterval == sub->publishingInterval) {
         /* Add to the subscription for sampling before every publish */
@@ -727,13 +816,9 @@ UA_MonitoredItem_registerSampling(UA_Server *server, UA_MonitoredItem *mon) {
                          sampling.subscriptionSampling);
         mon->samplingType = UA_MONITOREDITEMSAMPLINGTYPE_PUBLISH;
     } else {
-        /* DataChange MonitoredItems with a positive sampling interval have a
-         * repeated callback. Other MonitoredItems are attached to the Node in a
-         * linked list of backpointers. */
-        res = addRepeatedCallback(server,
-                                  (UA_ServerCallback)UA_MonitoredItem_sampleCallback,
-                                  mon, mon->parameters.samplingInterval,
-                                  &mon->sampling.callbackId);
+        /* DataChange MonitoredItems with a positive sampling interval are
+         * sampled by the repeated callback of their SamplingGroup */
+        res = addToSamplingGroup(server, mon);
         if(res == UA_STATUSCODE_GOOD)
             mon->samplingType = UA_MONITOREDITEMSAMPLINGTYPE_CYCLIC;
     }
@@ -747,8 +832,8 @@ UA_MonitoredItem_unregisterSampling(UA_Server *server, UA_MonitoredItem *mon) {
 
     switch(mon->samplingType) {
     case UA_MONITOREDITEMSAMPLINGTYPE_CYCLIC:
-        /* Remove repeated callback */
-        removeCallback(server, mon->sampling.callbackId);
+        /* Remove from the SamplingGroup */
+        removeFromSamplingGroup(server, mon);
         break;
 
     case UA_MONITOREDITEMSAMPLINGTYPE_EVENT: {
@@ -759,6 +844,10 @@ UA_MonitoredItem_unregisterSampling(UA_Server *server, UA_MonitoredItem *mon) {
             session = sub->session;
         UA_Server_editNode(server, session, &mon->itemToMonitor.nodeId,
                            removeMonitoredItemBackPointer, mon);
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+        if(mon->itemToMonitor.attributeId == UA_ATTRIBUTEID_EVENTNOTIFIER)
+            eventTypeIndexRemove(server, mon, mon->eventFilterProgram);
+#endif
         break;
     }
 
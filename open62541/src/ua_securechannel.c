@@ -828,11 +828,44 @@ UA_SecureChannel_loadBuffer(UA_SecureChannel *channel, const UA_ByteString buffe
     return UA_STATUSCODE_GOOD;
 }
 
+/* Append the chunk payload to the message that is being assembled. The buffer
+ * grows geometrically to keep the number of reallocations low. */
+static UA_StatusCode
+appendChunk(UA_SecureChannel *channel, UA_Chunk *msg, const UA_Chunk *chunk) {
+    if(chunk->messageType != msg->messageType)
+        return UA_STATUSCODE_BADTCPMESSAGETYPEINVALID;
+
+    size_t length = msg->bytes.length + chunk->bytes.length;
+    if(length > msg->capacity) {
+        size_t capacity = msg->capacity * 2;
+        if(capacity < length)
+            capacity = length;
+        if(channel->config.localMaxMessageSize != 0 &&
+           capacity > channel->config.localMaxMessageSize &&
+           length <= channel->config.localMaxMessageSize)
+            capacity = channel->config.localMaxMessageSize;
+        UA_Byte *data = (UA_Byte*)UA_realloc(msg->bytes.data, capacity);
+        if(!data)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        msg->bytes.data = data;
+        msg->capacity = capacity;
+    }
+
+    memcpy(msg->bytes.data + msg->bytes.length, chunk->bytes.data, chunk->bytes.length);
+    msg->bytes.length = length;
+    if(chunk->chunkType == UA_CHUNKTYPE_INTERMEDIATE) {
+        msg->chunksCount++;
+        channel->chunksCount++;
+        channel->chunksLength += chunk->bytes.length;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
 UA_StatusCode
 UA_SecureChannel_getCompleteMessage(UA_SecureChannel *channel,
                                     UA_MessageType *messageType, UA_UInt32 *requestId,
                                     UA_ByteString *payload, UA_Boolean *copied) {
-    UA_Chunk chunk, *pchunk;
+    UA_Chunk chunk;
     UA_StatusCode res = UA_STATUSCODE_GOOD;
 
  extract_chunk:
@@ -842,6 +875,13 @@ UA_SecureChannel_getCompleteMessage(UA_SecureChannel *channel,
     if(chunk.bytes.length == 0 || res != UA_STATUSCODE_GOOD)
         return res; /* Error or no complete chunk could be extracted */
 
+    /* Find the message assembled for the requestId so far */
+    UA_Chunk *msg;
+    TAILQ_FOREACH(msg, &channel->chunks, pointers) {
+        if(msg->requestId == chunk.requestId)
+            break;
+    }
+
     /* Process the chunk */
     switch(chunk.chunkType) {
     case UA_CHUNKTYPE_ABORT:
@@ -857,22 +897,30 @@ UA_SecureChannel_getCompleteMessage(UA_SecureChannel *channel,
             channel->chunksCount >= channel->config.localMaxChunkCount) ||
            (channel->config.localMaxMessageSize != 0 &&
             channel->chunksLength + chunk.bytes.length > channel->config.localMaxMessageSize)) {
-            if(chunk.copied)
-                UA_ByteString_clear(&chunk.bytes);
-            return UA_STATUSCODE_BADTCPMESSAGETOOLARGE;
+            res = UA_STATUSCODE_BADTCPMESSAGETOOLARGE;
+            goto error;
         }
 
-        /* Add the chunk to the queue. Then continue extracting more chunks. */
-        pchunk = (UA_Chunk*)UA_malloc(sizeof(UA_Chunk));
-        if(!pchunk) {
-            if(chunk.copied)
-                UA_ByteString_clear(&chunk.bytes);
-            return UA_STATUSCODE_BADOUTOFMEMORY;
+        /* Start assembling a new message */
+        if(!msg) {
+            msg = (UA_Chunk*)UA_calloc(1, sizeof(UA_Chunk));
+            if(!msg) {
+                res = UA_STATUSCODE_BADOUTOFMEMORY;
+                goto error;
+            }
+            msg->messageType = chunk.messageType;
+            msg->chunkType = UA_CHUNKTYPE_INTERMEDIATE;
+            msg->requestId = chunk.requestId;
+            msg->copied = true;
+            TAILQ_INSERT_TAIL(&channel->chunks, msg, pointers);
         }
-        *pchunk = chunk;
-        TAILQ_INSERT_TAIL(&channel->chunks, pchunk, pointers);
-        channel->chunksCount++;
-        channel->chunksLength += pchunk->bytes.length;
+
+        /* Append the chunk payload. Then continue extracting more chunks. */
+        res = appendChunk(channel, msg, &chunk);
+        if(res != UA_STATUSCODE_GOOD)
+            goto error;
+        if(chunk.copied)
+            UA_ByteString_clear(&chunk.bytes);
         goto extract_chunk;
 
     case UA_CHUNKTYPE_FINAL:
@@ -881,84 +929,31 @@ UA_SecureChannel_getCompleteMessage(UA_SecureChannel *channel,
         break; /* A final chunk was received -- assemble the message */
     }
 
-    /* Compute the message size */
-    size_t messageSize = chunk.bytes.length;
-    UA_Chunk *first = NULL;
-    TAILQ_FOREACH(pchunk, &channel->chunks, pointers) {
-        if(chunk.requestId != pchunk->requestId)
-            continue;
-        if(chunk.messageType != pchunk->messageType) {
-            if(chunk.copied)
-                UA_ByteString_clear(&chunk.bytes);
-            return UA_STATUSCODE_BADTCPMESSAGETYPEINVALID;
+    /* Complete the assembled message with the final chunk. Otherwise the
+     * payload is used directly from the final chunk. */
+    if(msg) {
+        /* Validate the assembled message size */
+        if(channel->config.localMaxMessageSize != 0 &&
+           msg->bytes.length + chunk.bytes.length > channel->config.localMaxMessageSize) {
+            res = UA_STATUSCODE_BADTCPMESSAGETOOLARGE;
+            goto error;
         }
-        if(!first)
-            first = pchunk;
-        messageSize += pchunk->bytes.length;
-    }
-
-    /* Validate the assembled message size */
-    if(channel->config.localMaxMessageSize != 0 &&
-       channel->chunksLength > channel->config.localMaxMessageSize) {
-        if(chunk.copied)
-            UA_ByteString_clear(&chunk.bytes);
-        return UA_STATUSCODE_BADTCPMESSAGETOOLARGE;
-    }
 
-    /* Assemble the full payload and store it in chunk.bytes */
-    if(messageSize > chunk.bytes.length) {
-        UA_assert(first != NULL);
+        /* Take the message from the queue */
+        channel->chunksCount -= msg->chunksCount;
+        channel->chunksLength -= msg->bytes.length;
+        TAILQ_REMOVE(&channel->chunks, msg, pointers);
 
-        /* Allocate the full memory and initialize with the first chunk content.
-         * Use realloc to speed up. */
-        UA_ByteString message;
-        if(first->copied) {
-            message.data = (UA_Byte*)UA_realloc(first->bytes.data, messageSize);
-        } else {
-            message.data = (UA_Byte*)UA_malloc(messageSize);
-            if(message.data)
-                memcpy(message.data, first->bytes.data, first->bytes.length);
-        }
-        if(!message.data) {
-            if(chunk.copied)
-                UA_ByteString_clear(&chunk.bytes);
-            return UA_STATUSCODE_BADOUTOFMEMORY;
-        }
-        message.length = first->bytes.length;
-
-        /* Remove the the first chunk */
-        pchunk = TAILQ_NEXT(first, pointers);
-        first->copied = false;
-        channel->chunksCount--;
-        channel->chunksLength -= first->bytes.length;
-        TAILQ_REMOVE(&channel->chunks, first, pointers);
-        UA_Chunk_delete(first);
-
-        /* Copy over the content from the remaining intermediate chunks.
-         * And remove them right away. */
-        UA_Chunk *next;
-        for(; pchunk; pchunk = next) {
-            next = TAILQ_NEXT(pchunk, pointers);
-            if(chunk.requestId != pchunk->requestId)
-                continue;
-            memcpy(message.data + message.length, pchunk->bytes.data, pchunk->bytes.length);
-            message.length += pchunk->bytes.length;
-            channel->chunksCount--;
-            channel->chunksLength -= pchunk->bytes.length;
-            TAILQ_REMOVE(&channel->chunks, pchunk, pointers);
-            UA_Chunk_delete(pchunk);
+        res = appendChunk(channel, msg, &chunk);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_Chunk_delete(msg);
+            goto error;
         }
-
-        /* Copy over the content from the final chunk */
-        memcpy(message.data + message.length, chunk.bytes.data, chunk.bytes.length);
-        message.length += chunk.bytes.length;
-        UA_assert(message.length == messageSize);
-
-        /* Set assembled message as the content of the final chunk */
         if(chunk.copied)
             UA_ByteString_clear(&chunk.bytes);
-        chunk.bytes = message;
+        chunk.bytes = msg->bytes;
         chunk.copied = true;
+        UA_free(msg);
     }
 
     /* Return the assembled message */
@@ -967,22 +962,18 @@ UA_SecureChannel_getCompleteMessage(UA_SecureChannel *channel,
     *payload = chunk.bytes;
     *copied = chunk.copied;
     return UA_STATUSCODE_GOOD;
+
+ error:
+    if(chunk.copied)
+        UA_ByteString_clear(&chunk.bytes);
+    return res;
 }
 
 UA_StatusCode
 UA_SecureChannel_persistBuffer(UA_SecureChannel *channel) {
     UA_StatusCode res = UA_STATUSCODE_GOOD;
 
-    /* Persist the chunks */
-    UA_Chunk *chunk;
-    TAILQ_FOREACH(chunk, &channel->chunks, pointers) {
-        if(chunk->copied)
-            continue;
-        UA_ByteString tmp = UA_BYTESTRING_NULL;
-        res |= UA_ByteString_copy(&chunk->bytes, &tmp);
-        chunk->bytes = tmp;
-        chunk->copied = true;
-    }
+    /* The intermediate chunks are already copied into the assembly buffers */
 
     /* No unprocessed bytes remaining */
     UA_assert(channel->unprocessed.length >= channel->unprocessedOffset);
@@ -67,7 +67,9 @@ typedef struct UA_SessionHeader {
     UA_SecureChannel *channel; /* The pointer back to the SecureChannel in the session. */
 } UA_SessionHeader;
 
-/* For chunked requests */
+/* For chunked requests. The payload of intermediate chunks is appended to one
+ * buffer per requestId right away. So a message is copied only once, no matter
+ * how many chunks and network packets it spans. */
 typedef struct UA_Chunk {
     TAILQ_ENTRY(UA_Chunk) pointers;
     UA_ByteString bytes;
@@ -76,6 +78,8 @@ typedef struct UA_Chunk {
     UA_UInt32 requestId;
     UA_Boolean copied; /* Do the bytes point to a buffer from the network or was
                         * memory allocated for the chunk separately */
+    size_t capacity;   /* Allocated size of the assembly buffer */
+    size_t chunksCount; /* Number of chunks appended to the assembly buffer */
 } UA_Chunk;
 
 typedef TAILQ_HEAD(UA_ChunkQueue, UA_Chunk) UA_ChunkQueue;
@@ -145,10 +149,11 @@ struct UA_SecureChannel {
     /* Sessions that are bound to the SecureChannel */
     SLIST_HEAD(, UA_SessionHeader) sessions;
 
-    /* (Decrypted) chunks waiting to be processed */
+    /* Messages assembled from (decrypted) intermediate chunks. Waiting for the
+     * final chunk. */
     UA_ChunkQueue chunks;
-    size_t chunksCount;
-    size_t chunksLength;
+    size_t chunksCount;  /* Total number of buffered chunks */
+    size_t chunksLength; /* Total size of the buffered payload */
 
     /* Received buffer from which no chunks have been extracted so far */
     UA_ByteString unprocessed;
@@ -60,36 +60,199 @@ expandedNodeIdOrder(const UA_ExpandedNodeId *p1, const UA_ExpandedNodeId *p2,
 static UA_Order
 guidOrder(const UA_Guid *p1, const UA_Guid *p2, const UA_DataType *_);
 
-const UA_DataType *
-UA_findDataTypeWithCustom(const UA_NodeId *typeId,
-                          const UA_DataTypeArray *customTypes) {
-    /* Always look in built-in types first (may contain data types from all
-     * namespaces).
-     *
-     * TODO: The standard-defined types are ordered. See if binary search is
-     * more efficient. */
-    for(size_t i = 0; i < UA_TYPES_COUNT; ++i) {
-        if(nodeIdOrder(&UA_TYPES[i].typeId, typeId, NULL) == UA_ORDER_EQ)
-            return &UA_TYPES[i];
+/* Hash index of the data types by their typeId and binaryEncodingId. The
+ * namespace index is not hashed. It may change after the index was built, e.g.
+ * when the types of a nodeset are loaded into a server. Every slot holds a
+ * pointer to the type. Collisions are resolved with linear probing. The first
+ * type for a NodeId is indexed, same as for a linear search. */
+struct UA_DataTypeIndex {
+    size_t mask; /* Number of slots minus one */
+    UA_Boolean isStatic; /* Built in static storage, not freed */
+    const UA_DataType **typeIds;
+    const UA_DataType **binaryEncodingIds;
+};
+
+static u32
+dataTypeIndexHash(const UA_NodeId *id) {
+    switch(id->identifierType) {
+    case UA_NODEIDTYPE_NUMERIC:
+    default:
+        return id->identifier.numeric * 2654435761u; /* Knuth's multiplicative hash */
+    case UA_NODEIDTYPE_STRING:
+    case UA_NODEIDTYPE_BYTESTRING:
+        return UA_ByteString_hash(0, id->identifier.string.data,
+                                  id->identifier.string.length);
+    case UA_NODEIDTYPE_GUID:
+        return UA_ByteString_hash(0, (const u8*)&id->identifier.guid,
+                                  sizeof(UA_Guid));
     }
+}
 
-    /* Search in the customTypes */
-    while(customTypes) {
-        for(size_t i = 0; i < customTypes->typesSize; ++i) {
-            if(nodeIdOrder(&customTypes->types[i].typeId, typeId, NULL) == UA_ORDER_EQ)
-                return &customTypes->types[i];
-        }
-        customTypes = customTypes->next;
+static const UA_DataType *
+dataTypeIndexFind(const UA_DataTypeIndex *index, const UA_DataType **slots,
+                  size_t idOffset, const UA_NodeId *id) {
+    size_t pos = dataTypeIndexHash(id) & index->mask;
+    for(const UA_DataType *type; (type = slots[pos]); pos = (pos + 1) & index->mask) {
+        const UA_NodeId *typeId = (const UA_NodeId*)((uintptr_t)type + idOffset);
+        if(nodeIdOrder(typeId, id, NULL) == UA_ORDER_EQ)
+            return type;
+    }
+    return NULL;
+}
+
+static void
+dataTypeIndexInsert(UA_DataTypeIndex *index, const UA_DataType **slots,
+                    size_t idOffset, const UA_DataType *type) {
+    const UA_NodeId *id = (const UA_NodeId*)((uintptr_t)type + idOffset);
+    size_t pos = dataTypeIndexHash(id) & index->mask;
+    for(const UA_DataType *t; (t = slots[pos]); pos = (pos + 1) & index->mask) {
+        const UA_NodeId *tid = (const UA_NodeId*)((uintptr_t)t + idOffset);
+        if(nodeIdOrder(tid, id, NULL) == UA_ORDER_EQ)
+            return; /* Keep the first type with the NodeId */
+    }
+    slots[pos] = type;
+}
+
+/* At most half of the slots are used */
+static size_t
+dataTypeIndexSlots(size_t typesSize) {
+    size_t slots = 16;
+    while(slots < typesSize * 2)
+        slots <<= 1;
+    return slots;
+}
+
+/* Memory with the size returned by dataTypeIndexSize. All zero. */
+static UA_DataTypeIndex *
+dataTypeIndexInit(void *mem, const UA_DataType *types, size_t typesSize) {
+    size_t slots = dataTypeIndexSlots(typesSize);
+    UA_DataTypeIndex *index = (UA_DataTypeIndex*)mem;
+    index->mask = slots - 1;
+    index->typeIds = (const UA_DataType**)&index[1];
+    index->binaryEncodingIds = &index->typeIds[slots];
+    for(size_t i = 0; i < typesSize; i++) {
+        dataTypeIndexInsert(index, index->typeIds,
+                            offsetof(UA_DataType, typeId), &types[i]);
+        dataTypeIndexInsert(index, index->binaryEncodingIds,
+                            offsetof(UA_DataType, binaryEncodingId), &types[i]);
+    }
+    return index;
+}
+
+static size_t
+dataTypeIndexSize(size_t typesSize) {
+    return sizeof(UA_DataTypeIndex) +
+        2 * dataTypeIndexSlots(typesSize) * sizeof(UA_DataType*);
+}
+
+/* The index for the builtin types is built in static storage on first use. So
+ * it does not need to be freed. Only one thread builds the index. The others
+ * use the linear search meanwhile. */
+static UA_DATATYPEINDEX_STORAGE(ns0IndexStorage, UA_TYPES_COUNT);
+static UA_DataTypeIndex * volatile ns0Index = NULL;
+static volatile int ns0IndexBuilding = 0;
+
+static const UA_DataTypeIndex *
+getNs0Index(void) {
+    UA_DataTypeIndex *index = ns0Index;
+    if(UA_LIKELY(index != NULL))
+        return index;
+    if(UA_atomic_cmpxchgInt(&ns0IndexBuilding, 0, 1) != 0)
+        return NULL;
+    UA_assert(dataTypeIndexSize(UA_TYPES_COUNT) <= sizeof(ns0IndexStorage));
+    index = dataTypeIndexInit(ns0IndexStorage, UA_TYPES, UA_TYPES_COUNT);
+    index->isStatic = true;
+    UA_atomic_xchg((void * volatile *)&ns0Index, index);
+    return index;
+}
+
+static const UA_DataType *
+findDataType(const UA_DataType *types, size_t typesSize,
+             const UA_DataTypeIndex *index, size_t idOffset,
+             const UA_NodeId *id) {
+    if(index)
+        return dataTypeIndexFind(index, (idOffset == offsetof(UA_DataType, typeId)) ?
+                                 index->typeIds : index->binaryEncodingIds,
+                                 idOffset, id);
+    for(size_t i = 0; i < typesSize; ++i) {
+        const UA_NodeId *typeId = (const UA_NodeId*)((uintptr_t)&types[i] + idOffset);
+        if(nodeIdOrder(typeId, id, NULL) == UA_ORDER_EQ)
+            return &types[i];
     }
+    return NULL;
+}
+
+static const UA_DataType *
+findDataTypeWithCustom(const UA_NodeId *id, const UA_DataTypeArray *customTypes,
+                       size_t idOffset) {
+    /* Always look in built-in types first (may contain data types from all
+     * namespaces) */
+    const UA_DataType *type =
+        findDataType(UA_TYPES, UA_TYPES_COUNT, getNs0Index(), idOffset, id);
+    if(type)
+        return type;
 
+    /* Search in the customTypes */
+    for(; customTypes; customTypes = customTypes->next) {
+        type = findDataType(customTypes->types, customTypes->typesSize,
+                            customTypes->index, idOffset, id);
+        if(type)
+            return type;
+    }
     return NULL;
 }
 
+const UA_DataType *
+UA_findDataTypeWithCustom(const UA_NodeId *typeId,
+                          const UA_DataTypeArray *customTypes) {
+    return findDataTypeWithCustom(typeId, customTypes, offsetof(UA_DataType, typeId));
+}
+
+const UA_DataType *
+UA_findDataTypeByBinaryWithCustom(const UA_NodeId *binaryEncodingId,
+                                  const UA_DataTypeArray *customTypes) {
+    return findDataTypeWithCustom(binaryEncodingId, customTypes,
+                                  offsetof(UA_DataType, binaryEncodingId));
+}
+
 const UA_DataType *
 UA_findDataType(const UA_NodeId *typeId) {
     return UA_findDataTypeWithCustom(typeId, NULL);
 }
 
+UA_StatusCode
+UA_DataTypeArray_buildIndex(UA_DataTypeArray *customTypes) {
+    if(customTypes->index)
+        return UA_STATUSCODE_GOOD;
+    void *mem = UA_calloc(1, dataTypeIndexSize(customTypes->typesSize));
+    if(!mem)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    customTypes->index = dataTypeIndexInit(mem, customTypes->types,
+                                           customTypes->typesSize);
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_DataTypeArray_buildIndexStatic(UA_DataTypeArray *customTypes,
+                                  void *storage, size_t storageSize) {
+    if(customTypes->index)
+        return UA_STATUSCODE_GOOD;
+    if(storageSize < dataTypeIndexSize(customTypes->typesSize))
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+    memset(storage, 0, storageSize);
+    customTypes->index = dataTypeIndexInit(storage, customTypes->types,
+                                           customTypes->typesSize);
+    customTypes->index->isStatic = true;
+    return UA_STATUSCODE_GOOD;
+}
+
+void
+UA_DataTypeArray_clearIndex(UA_DataTypeArray *customTypes) {
+    if(customTypes->index && !customTypes->index->isStatic)
+        UA_free(customTypes->index);
+    customTypes->index = NULL;
+}
+
 void
 UA_cleanupDataTypeWithCustom(const UA_DataTypeArray *customTypes) {
     while (customTypes) {
@@ -105,6 +268,7 @@ UA_cleanupDataTypeWithCustom(const UA_DataTypeArray *customTypes) {
                 UA_free((void*)type->members);
             }
             UA_free((void*)(uintptr_t)customTypes->types);
+            UA_DataTypeArray_clearIndex((UA_DataTypeArray*)(uintptr_t)customTypes);
             UA_free((void*)(uintptr_t)customTypes);
         }
         customTypes = next;
@@ -1482,6 +1646,126 @@ UA_delete(void *p, const UA_DataType *type) {
     UA_free(p);
 }
 
+/****************/
+/* Memory Arena */
+/****************/
+
+struct UA_ArenaBlock {
+    UA_ArenaBlock *next;
+    size_t size; /* Usable size after the header */
+    size_t used;
+};
+
+#define UA_ARENA_ALIGN(x) (((x) + 7) & ~(size_t)7)
+#define UA_ARENA_HEADERSIZE UA_ARENA_ALIGN(sizeof(UA_ArenaBlock))
+
+void
+UA_Arena_init(UA_Arena *arena, size_t blockSize) {
+    memset(arena, 0, sizeof(UA_Arena));
+    arena->blockSize = (blockSize > 0) ? blockSize : UA_ARENA_DEFAULTBLOCKSIZE;
+}
+
+static UA_ArenaBlock *
+Arena_newBlock(UA_Arena *arena, size_t size) {
+    UA_ArenaBlock *b = (UA_ArenaBlock*)UA_malloc(UA_ARENA_HEADERSIZE + size);
+    if(!b)
+        return NULL;
+    b->size = size;
+    b->used = 0;
+    arena->blockAllocations++;
+    return b;
+}
+
+void *
+UA_Arena_alloc(UA_Arena *arena, size_t size) {
+    if(arena->blockSize == 0)
+        arena->blockSize = UA_ARENA_DEFAULTBLOCKSIZE;
+    if(size > SIZE_MAX - UA_ARENA_HEADERSIZE - 8)
+        return NULL;
+    size = UA_ARENA_ALIGN(size);
+
+    /* Bump-allocate from the current block */
+    UA_ArenaBlock *b = arena->blocks;
+    if(!b || b->size - b->used < size) {
+        if(size > arena->blockSize || (b && size > arena->blockSize / 4)) {
+            /* Large allocations get a dedicated block. It is inserted behind
+             * the current block which can still be used for small
+             * allocations. */
+            b = Arena_newBlock(arena, size);
+            if(!b)
+                return NULL;
+            if(arena->blocks) {
+                b->next = arena->blocks->next;
+                arena->blocks->next = b;
+            } else {
+                b->next = NULL;
+                arena->blocks = b;
+            }
+        } else {
+            b = Arena_newBlock(arena, arena->blockSize);
+            if(!b)
+                return NULL;
+            b->next = arena->blocks;
+            arena->blocks = b;
+        }
+    }
+
+    void *p = (UA_Byte*)b + UA_ARENA_HEADERSIZE + b->used;
+    b->used += size;
+    arena->allocations++;
+    memset(p, 0, size);
+    return p;
+}
+
+void
+UA_Arena_reset(UA_Arena *arena) {
+    /* Grow the block size if more than one block was used. So that the next
+     * message of similar size fits into a single block. */
+    size_t total = 0;
+    size_t count = 0;
+    for(UA_ArenaBlock *b = arena->blocks; b; b = b->next) {
+        total += b->size;
+        count++;
+    }
+    if(count > 1) {
+        while(arena->blockSize < total && arena->blockSize < UA_ARENA_MAXBLOCKSIZE)
+            arena->blockSize *= 2;
+        if(arena->blockSize > UA_ARENA_MAXBLOCKSIZE)
+            arena->blockSize = UA_ARENA_MAXBLOCKSIZE;
+    }
+
+    /* Keep one block of the current block size and free the others */
+    UA_ArenaBlock *keep = NULL;
+    UA_ArenaBlock *b = arena->blocks;
+    while(b) {
+        UA_ArenaBlock *next = b->next;
+        if(!keep && b->size == arena->blockSize) {
+            keep = b;
+            keep->next = NULL;
+            keep->used = 0;
+        } else {
+            UA_free(b);
+        }
+        b = next;
+    }
+    arena->blocks = keep;
+    arena->allocations = 0;
+    arena->blockAllocations = 0;
+}
+
+void
+UA_Arena_clear(UA_Arena *arena) {
+    UA_ArenaBlock *b = arena->blocks;
+    while(b) {
+        UA_ArenaBlock *next = b->next;
+        UA_free(b);
+        b = next;
+    }
+    arena->blocks = NULL;
+    arena->allocations = 0;
+    arena->blockAllocations = 0;
+}
+
 /******************/
 /* Value Ordering */
 /******************/
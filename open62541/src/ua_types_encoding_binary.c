@@ -49,6 +49,13 @@ typedef struct {
     const UA_DataTypeArray *customTypes;
     UA_exchangeEncodeBuffer exchangeBufferCallback;
     void *exchangeBufferCallbackHandle;
+
+    /* Decoding takes the memory from the arena if it is set */
+    UA_Arena *arena;
+
+    /* Overlayable arrays (incl. strings) point into the source buffer instead
+     * of being copied. Only used together with an arena. */
+    UA_Boolean zeroCopy;
 } Ctx;
 
 typedef status
@@ -455,6 +462,36 @@ Array_encodeBinary(const void *src, size_t length, const UA_DataType *type, Ctx
     return ret;
 }
 
+/* Memory management during decoding. With an arena, the allocated memory is
+ * not released individually. It remains in the arena until the next reset. */
+
+static void *
+ctxCalloc(Ctx *ctx, size_t count, size_t size) {
+    if(!ctx->arena)
+        return UA_calloc(count, size);
+    if(count > SIZE_MAX / size)
+        return NULL;
+    return UA_Arena_alloc(ctx->arena, count * size);
+}
+
+static void
+ctxFree(Ctx *ctx, void *p) {
+    if(!ctx->arena)
+        UA_free(p);
+}
+
+static void
+ctxArrayDelete(Ctx *ctx, void *p, size_t size, const UA_DataType *type) {
+    if(!ctx->arena)
+        UA_Array_delete(p, size, type);
+}
+
+static void
+ctxNodeIdClear(Ctx *ctx, UA_NodeId *id) {
+    if(!ctx->arena)
+        UA_NodeId_clear(id);
+}
+
 static status
 Array_decodeBinary(void *UA_RESTRICT *UA_RESTRICT dst, size_t *out_length,
                    const UA_DataType *type, Ctx *ctx) {
@@ -484,14 +521,25 @@ Array_decodeBinary(void *UA_RESTRICT *UA_RESTRICT dst, size_t *out_length,
     UA_CHECK(ctx->pos + ((type->memSize * length) / 128) <= ctx->end,
              return UA_STATUSCODE_BADDECODINGERROR);
 
+    /* Point into the source buffer if the position is aligned for the type */
+    if(ctx->zeroCopy && type->overlayable &&
+       ((uintptr_t)ctx->pos % type->memSize) == 0) {
+        UA_CHECK(ctx->pos + (type->memSize * length) <= ctx->end,
+                 return UA_STATUSCODE_BADDECODINGERROR);
+        *dst = ctx->pos;
+        ctx->pos += type->memSize * length;
+        *out_length = length;
+        return UA_STATUSCODE_GOOD;
+    }
+
     /* Allocate memory */
-    *dst = UA_calloc(length, type->memSize);
+    *dst = ctxCalloc(ctx, length, type->memSize);
     UA_CHECK_MEM(*dst, return UA_STATUSCODE_BADOUTOFMEMORY);
 
     if(type->overlayable) {
         /* memcpy overlayable array */
         UA_CHECK(ctx->pos + (type->memSize * length) <= ctx->end,
-                 UA_free(*dst); *dst = NULL; return UA_STATUSCODE_BADDECODINGERROR);
+                 ctxFree(ctx, *dst); *dst = NULL; return UA_STATUSCODE_BADDECODINGERROR);
         memcpy(*dst, ctx->pos, type->memSize * length);
         ctx->pos += type->memSize * length;
     } else {
@@ -500,7 +548,7 @@ Array_decodeBinary(void *UA_RESTRICT *UA_RESTRICT dst, size_t *out_length,
         for(size_t i = 0; i < length; ++i) {
             ret = decodeBinaryJumpTable[type->typeKind]((void*)ptr, type, ctx);
             UA_CHECK_STATUS(ret, /* +1 because last element is also already initialized */
-                            UA_Array_delete(*dst, i+1, type); *dst = NULL; return ret);
+                            ctxArrayDelete(ctx, *dst, i+1, type); *dst = NULL; return ret);
             ptr += type->memSize;
         }
     }
@@ -769,38 +817,14 @@ DECODE_BINARY(LocalizedText) {
     return ret;
 }
 
-/* The binary encoding has a different nodeid from the data type. So it is not
- * possible to reuse UA_findDataType */
 static const UA_DataType *
 UA_findDataTypeByBinaryInternal(const UA_NodeId *typeId, Ctx *ctx) {
-    /* Always look in the built-in types first. Assume that only numeric
-     * identifiers are used for the builtin types. (They may contain data types
-     * from all namespaces though.) */
-    if(typeId->identifierType == UA_NODEIDTYPE_NUMERIC) {
-        for(size_t i = 0; i < UA_TYPES_COUNT; ++i) {
-            if(UA_TYPES[i].binaryEncodingId.identifier.numeric == typeId->identifier.numeric &&
-               UA_TYPES[i].binaryEncodingId.namespaceIndex == typeId->namespaceIndex)
-                return &UA_TYPES[i];
-        }
-    }
-
-    const UA_DataTypeArray *customTypes = ctx->customTypes;
-    while(customTypes) {
-        for(size_t i = 0; i < customTypes->typesSize; ++i) {
-            if(UA_NodeId_equal(typeId, &customTypes->types[i].binaryEncodingId))
-                return &customTypes->types[i];
-        }
-        customTypes = customTypes->next;
-    }
-
-    return NULL;
+    return UA_findDataTypeByBinaryWithCustom(typeId, ctx->customTypes);
 }
 
 const UA_DataType *
 UA_findDataTypeByBinary(const UA_NodeId *typeId) {
-    Ctx ctx;
-    ctx.customTypes = NULL;
-    return UA_findDataTypeByBinaryInternal(typeId, &ctx);
+    return UA_findDataTypeByBinaryWithCustom(typeId, NULL);
 }
 
 /* ExtensionObject */
@@ -869,12 +893,15 @@ ExtensionObject_decodeBinaryContent(UA_ExtensionObject *dst, const UA_NodeId *ty
     /* Unknown type, just take the binary content */
     if(!type) {
         dst->encoding = UA_EXTENSIONOBJECT_ENCODED_BYTESTRING;
-        UA_NodeId_copy(typeId, &dst->content.encoded.typeId);
+        if(ctx->arena)
+            dst->content.encoded.typeId = *typeId; /* Stays in the arena */
+        else
+            UA_NodeId_copy(typeId, &dst->content.encoded.typeId);
         return DECODE_DIRECT(&dst->content.encoded.body, String); /* ByteString */
     }
 
     /* Allocate memory */
-    dst->content.decoded.data = UA_new(type);
+    dst->content.decoded.data = ctxCalloc(ctx, 1, type->memSize);
     UA_CHECK_MEM(dst->content.decoded.data, return UA_STATUSCODE_BADOUTOFMEMORY);
 
     /* Jump over the length field (TODO: check if the decoded length matches) */
@@ -894,12 +921,12 @@ DECODE_BINARY(ExtensionObject) {
     status ret = UA_STATUSCODE_GOOD;
     ret |= DECODE_DIRECT(&binTypeId, NodeId);
     ret |= DECODE_DIRECT(&encoding, Byte);
-    UA_CHECK_STATUS(ret, UA_NodeId_clear(&binTypeId); return ret);
+    UA_CHECK_STATUS(ret, ctxNodeIdClear(ctx, &binTypeId); return ret);
 
     switch(encoding) {
     case UA_EXTENSIONOBJECT_ENCODED_BYTESTRING:
         ret = ExtensionObject_decodeBinaryContent(dst, &binTypeId, ctx);
-        UA_NodeId_clear(&binTypeId);
+        ctxNodeIdClear(ctx, &binTypeId);
         break;
     case UA_EXTENSIONOBJECT_ENCODED_NOBODY:
         dst->encoding = (UA_ExtensionObjectEncoding)encoding;
@@ -910,10 +937,10 @@ DECODE_BINARY(ExtensionObject) {
         dst->encoding = (UA_ExtensionObjectEncoding)encoding;
         dst->content.encoded.typeId = binTypeId; /* move to dst */
         ret = DECODE_DIRECT(&dst->content.encoded.body, String); /* ByteString */
-        UA_CHECK_STATUS(ret, UA_NodeId_clear(&dst->content.encoded.typeId));
+        UA_CHECK_STATUS(ret, ctxNodeIdClear(ctx, &dst->content.encoded.typeId));
         break;
     default:
-        UA_NodeId_clear(&binTypeId);
+        ctxNodeIdClear(ctx, &binTypeId);
         ret = UA_STATUSCODE_BADDECODINGERROR;
         break;
     }
@@ -1035,7 +1062,7 @@ Variant_decodeBinaryUnwrapExtensionObject(UA_Variant *dst, Ctx *ctx) {
     /* Decode the EncodingByte */
     u8 encoding;
     ret = DECODE_DIRECT(&encoding, Byte);
-    UA_CHECK_STATUS(ret, UA_NodeId_clear(&typeId); return ret);
+    UA_CHECK_STATUS(ret, ctxNodeIdClear(ctx, &typeId); return ret);
 
     /* Search for the datatype. Default to ExtensionObject. */
     if(encoding == UA_EXTENSIONOBJECT_ENCODED_BYTESTRING &&
@@ -1047,10 +1074,10 @@ Variant_decodeBinaryUnwrapExtensionObject(UA_Variant *dst, Ctx *ctx) {
         dst->type = &UA_TYPES[UA_TYPES_EXTENSIONOBJECT];
         ctx->pos = old_pos;
     }
-    UA_NodeId_clear(&typeId);
+    ctxNodeIdClear(ctx, &typeId);
 
     /* Allocate memory */
-    dst->data = UA_new(dst->type);
+    dst->data = ctxCalloc(ctx, 1, dst->type->memSize);
     UA_CHECK_MEM(dst->data, return UA_STATUSCODE_BADOUTOFMEMORY);
 
     /* Decode the content */
@@ -1097,7 +1124,7 @@ Variant_decodeBinaryUnwrapExtensionObjectArray(void *UA_RESTRICT *UA_RESTRICT ds
 
     /* Lookup the data type */
     const UA_DataType *contentType = UA_findDataTypeByBinaryInternal(&binTypeId, ctx);
-    UA_NodeId_clear(&binTypeId);
+    ctxNodeIdClear(ctx, &binTypeId);
     if(!contentType) {
         /* DataType unknown, decode as ExtensionObject array */
         ctx->pos = orig_pos;
@@ -1139,7 +1166,7 @@ Variant_decodeBinaryUnwrapExtensionObjectArray(void *UA_RESTRICT *UA_RESTRICT ds
     }
 
     /* Allocate memory for the unwrapped members */
-    *dst = UA_calloc(length, contentType->memSize);
+    *dst = ctxCalloc(ctx, length, contentType->memSize);
     UA_CHECK_MEM(*dst, return UA_STATUSCODE_BADOUTOFMEMORY);
     *out_length = length;
     *type = contentType;
@@ -1191,7 +1218,7 @@ DECODE_BINARY(Variant) {
     if(!isArray) {
         /* Decode scalar */
         if(typeKind != UA_DATATYPEKIND_EXTENSIONOBJECT) {
-            dst->data = UA_new(dst->type);
+            dst->data = ctxCalloc(ctx, 1, dst->type->memSize);
             UA_CHECK_MEM(dst->data, ctx->depth--; return UA_STATUSCODE_BADOUTOFMEMORY);
             ret = decodeBinaryJumpTable[typeKind](dst->data, dst->type, ctx);
         } else {
@@ -1388,7 +1415,7 @@ DECODE_BINARY(DiagnosticInfo) {
     if(encodingMask & 0x40u) {
         /* innerDiagnosticInfo is allocated on the heap */
         dst->innerDiagnosticInfo = (UA_DiagnosticInfo*)
-            UA_calloc(1, sizeof(UA_DiagnosticInfo));
+            ctxCalloc(ctx, 1, sizeof(UA_DiagnosticInfo));
         UA_CHECK_MEM(dst->innerDiagnosticInfo, return UA_STATUSCODE_BADOUTOFMEMORY);
         dst->hasInnerDiagnosticInfo = true;
 
@@ -1721,7 +1748,7 @@ decodeBinaryStructureWithOptFields(void *dst, const UA_DataType *type, Ctx *ctx)
                 ret = Array_decodeBinary((void *UA_RESTRICT *UA_RESTRICT)ptr, length, mt , ctx);
             } else {
                 /* Optional Scalar */
-                *(void *UA_RESTRICT *UA_RESTRICT) ptr = UA_calloc(1, mt->memSize);
+                *(void *UA_RESTRICT *UA_RESTRICT) ptr = ctxCalloc(ctx, 1, mt->memSize);
                 UA_CHECK_MEM(*(void *UA_RESTRICT *UA_RESTRICT) ptr, return UA_STATUSCODE_BADOUTOFMEMORY);
                 ret = decodeBinaryJumpTable[mt->typeKind](*(void *UA_RESTRICT *UA_RESTRICT) ptr, mt, ctx);
             }
@@ -1818,15 +1845,18 @@ const decodeBinarySignature decodeBinaryJumpTable[UA_DATATYPEKINDS] = {
 };
 
 status
-UA_decodeBinaryInternal(const UA_ByteString *src, size_t *offset,
-                        void *dst, const UA_DataType *type,
-                        const UA_DataTypeArray *customTypes) {
+UA_decodeBinaryInternalArena(const UA_ByteString *src, size_t *offset,
+                             void *dst, const UA_DataType *type,
+                             const UA_DataTypeArray *customTypes,
+                             UA_Arena *arena, UA_Boolean zeroCopy) {
     /* Set up the context */
     Ctx ctx;
     ctx.pos = &src->data[*offset];
     ctx.end = &src->data[src->length];
     ctx.depth = 0;
     ctx.customTypes = customTypes;
+    ctx.arena = arena;
+    ctx.zeroCopy = (arena != NULL) && zeroCopy;
 
     /* Decode */
     memset(dst, 0, type->memSize); /* Initialize the value */
@@ -1836,20 +1866,32 @@ UA_decodeBinaryInternal(const UA_ByteString *src, size_t *offset,
         /* Set the new offset */
         *offset = (size_t)(ctx.pos - src->data) / sizeof(u8);
     } else {
-        /* Clean up */
-        UA_clear(dst, type);
+        /* Clean up. Memory from the arena is released with the next reset. */
+        if(!arena)
+            UA_clear(dst, type);
         memset(dst, 0, type->memSize);
     }
     return ret;
 }
 
+status
+UA_decodeBinaryInternal(const UA_ByteString *src, size_t *offset,
+                        void *dst, const UA_DataType *type,
+                        const UA_DataTypeArray *customTypes) {
+    return UA_decodeBinaryInternalArena(src, offset, dst, type,
+                                        customTypes, NULL, false);
+}
+
 UA_StatusCode
 UA_decodeBinary(const UA_ByteString *inBuf,
                 void *p, const UA_DataType *type,
                 const UA_DecodeBinaryOptions *options) {
     size_t offset = 0;
-    const UA_DataTypeArray *customTypes = options ? options->customTypes : NULL;
-    return UA_decodeBinaryInternal(inBuf, &offset, p, type, customTypes);
+    if(!options)
+        return UA_decodeBinaryInternal(inBuf, &offset, p, type, NULL);
+    return UA_decodeBinaryInternalArena(inBuf, &offset, p, type,
+                                        options->customTypes, options->arena,
+                                        options->zeroCopy);
 }
 
 /**
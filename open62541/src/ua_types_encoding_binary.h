@@ -67,9 +67,30 @@ UA_decodeBinaryInternal(const UA_ByteString *src, size_t *offset,
                         const UA_DataTypeArray *customTypes)
     UA_FUNC_ATTR_WARN_UNUSED_RESULT;
 
+/* Same as UA_decodeBinaryInternal. But if the arena is non-NULL, all memory of
+ * the decoded value is taken from it. Such a value must not be cleared with
+ * UA_clear. Its memory is released with UA_Arena_reset. If decoding fails,
+ * the value is zeroed and the memory remains in the arena.
+ *
+ * With zeroCopy (requires the arena), strings and overlayable arrays point
+ * into the src buffer. Then the decoded value must not be used after the src
+ * buffer is released. */
+UA_StatusCode
+UA_decodeBinaryInternalArena(const UA_ByteString *src, size_t *offset,
+                             void *dst, const UA_DataType *type,
+                             const UA_DataTypeArray *customTypes,
+                             UA_Arena *arena, UA_Boolean zeroCopy)
+    UA_FUNC_ATTR_WARN_UNUSED_RESULT;
+
 const UA_DataType *
 UA_findDataTypeByBinary(const UA_NodeId *typeId);
 
+/* The binary encoding has a different nodeid from the data type. So it is not
+ * possible to reuse UA_findDataTypeWithCustom. */
+const UA_DataType *
+UA_findDataTypeByBinaryWithCustom(const UA_NodeId *binaryEncodingId,
+                                  const UA_DataTypeArray *customTypes);
+
 _UA_END_DECLS
 
 #endif /* UA_TYPES_ENCODING_BINARY_H_ */
@@ -57,10 +57,39 @@
 #define ENCODE_DIRECT_JSON(SRC, TYPE) \
     TYPE##_encodeJson(ctx, (const UA_##TYPE*)SRC, NULL)
 
+/* Enlarge the growable output buffer to fit at least len more bytes */
 static status UA_FUNC_ATTR_WARN_UNUSED_RESULT
-writeChar(CtxJson *ctx, char c) {
-    if(ctx->pos >= ctx->end)
+growBuffer(CtxJson *ctx, size_t len) {
+    UA_ByteString *buf = ctx->growBuf;
+    size_t used = (size_t)(ctx->pos - buf->data);
+    size_t newSize = buf->length * 2;
+    if(newSize < used + len)
+        newSize = used + len;
+    UA_Byte *newData = (UA_Byte*)UA_realloc(buf->data, newSize);
+    if(!newData)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    buf->data = newData;
+    buf->length = newSize;
+    ctx->pos = &newData[used];
+    ctx->end = &newData[newSize];
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Ensure that len bytes can be written at the current position */
+static UA_INLINE status UA_FUNC_ATTR_WARN_UNUSED_RESULT
+ensureSpace(CtxJson *ctx, size_t len) {
+    if(UA_LIKELY(ctx->pos + len <= ctx->end))
+        return UA_STATUSCODE_GOOD;
+    if(!ctx->growBuf)
         return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
+    return growBuffer(ctx, len);
+}
+
+static status UA_FUNC_ATTR_WARN_UNUSED_RESULT
+writeChar(CtxJson *ctx, char c) {
+    status res = ensureSpace(ctx, 1);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
     if(!ctx->calcOnly)
         *ctx->pos = (UA_Byte)c;
     ctx->pos++;
@@ -69,8 +98,9 @@ writeChar(CtxJson *ctx, char c) {
 
 static status UA_FUNC_ATTR_WARN_UNUSED_RESULT
 writeChars(CtxJson *ctx, const char *c, size_t len) {
-    if(ctx->pos + len > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
+    status res = ensureSpace(ctx, len);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
     if(!ctx->calcOnly)
         memcpy(ctx->pos, c, len);
     ctx->pos += len;
@@ -255,84 +285,42 @@ ENCODE_JSON(Boolean) {
 ENCODE_JSON(Byte) {
     char buf[4];
     UA_UInt16 digits = itoaUnsigned(*src, buf, 10);
-
-    /* Ensure destination can hold the data- */
-    if(ctx->pos + digits > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    /* Copy digits to the output string/buffer. */
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buf, digits);
-    ctx->pos += digits;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buf, digits);
 }
 
 /* signed Byte */
 ENCODE_JSON(SByte) {
     char buf[5];
     UA_UInt16 digits = itoaSigned(*src, buf);
-    if(ctx->pos + digits > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buf, digits);
-    ctx->pos += digits;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buf, digits);
 }
 
 /* UInt16 */
 ENCODE_JSON(UInt16) {
     char buf[6];
     UA_UInt16 digits = itoaUnsigned(*src, buf, 10);
-
-    if(ctx->pos + digits > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buf, digits);
-    ctx->pos += digits;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buf, digits);
 }
 
 /* Int16 */
 ENCODE_JSON(Int16) {
     char buf[7];
     UA_UInt16 digits = itoaSigned(*src, buf);
-
-    if(ctx->pos + digits > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buf, digits);
-    ctx->pos += digits;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buf, digits);
 }
 
 /* UInt32 */
 ENCODE_JSON(UInt32) {
     char buf[11];
     UA_UInt16 digits = itoaUnsigned(*src, buf, 10);
-
-    if(ctx->pos + digits > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buf, digits);
-    ctx->pos += digits;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buf, digits);
 }
 
 /* Int32 */
 ENCODE_JSON(Int32) {
     char buf[12];
     UA_UInt16 digits = itoaSigned(*src, buf);
-
-    if(ctx->pos + digits > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buf, digits);
-    ctx->pos += digits;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buf, digits);
 }
 
 /* UInt64 */
@@ -342,14 +330,7 @@ ENCODE_JSON(UInt64) {
     UA_UInt16 digits = itoaUnsigned(*src, buf + 1, 10);
     buf[digits + 1] = '\"';
     UA_UInt16 length = (UA_UInt16)(digits + 2);
-
-    if(ctx->pos + length > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buf, length);
-    ctx->pos += length;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buf, length);
 }
 
 /* Int64 */
@@ -359,14 +340,7 @@ ENCODE_JSON(Int64) {
     UA_UInt16 digits = itoaSigned(*src, buf + 1);
     buf[digits + 1] = '\"';
     UA_UInt16 length = (UA_UInt16)(digits + 2);
-
-    if(ctx->pos + length > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buf, length);
-    ctx->pos += length;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buf, length);
 }
 
 ENCODE_JSON(Float) {
@@ -385,13 +359,7 @@ ENCODE_JSON(Float) {
         len = dtoa((UA_Double)*src, buffer);
     }
 
-    if(ctx->pos + len > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buffer, len);
-    ctx->pos += len;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buffer, len);
 }
 
 ENCODE_JSON(Double) {
@@ -410,13 +378,7 @@ ENCODE_JSON(Double) {
         len = dtoa(*src, buffer);
     }
 
-    if(ctx->pos + len > ctx->end)
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, buffer, len);
-    ctx->pos += len;
-    return UA_STATUSCODE_GOOD;
+    return writeChars(ctx, buffer, len);
 }
 
 static status
@@ -528,11 +490,9 @@ ENCODE_JSON(String) {
 
         /* Write out the characters that don't need escaping */
         if(pos != str) {
-            if(ctx->pos + (pos - str) > ctx->end)
-                return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-            if(!ctx->calcOnly)
-                memcpy(ctx->pos, str, (size_t)(pos - str));
-            ctx->pos += pos - str;
+            ret |= writeChars(ctx, (const char*)str, (size_t)(pos - str));
+            if(ret != UA_STATUSCODE_GOOD)
+                return ret;
         }
 
         /* Reached the end of the utf8 encoding */
@@ -590,11 +550,9 @@ ENCODE_JSON(String) {
             }
             break;
         }
-        if(ctx->pos + length > ctx->end)
-            return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-        if(!ctx->calcOnly)
-            memcpy(ctx->pos, text, length);
-        ctx->pos += length;
+        ret |= writeChars(ctx, text, length);
+        if(ret != UA_STATUSCODE_GOOD)
+            return ret;
         str = pos = end;
     }
 
@@ -619,27 +577,23 @@ ENCODE_JSON(ByteString) {
     if(!ba64)
         return UA_STATUSCODE_BADENCODINGERROR;
 
-    if(ctx->pos + flen > ctx->end) {
-        UA_free(ba64);
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-    }
-
     /* Copy flen bytes to output stream. */
-    if(!ctx->calcOnly)
-        memcpy(ctx->pos, ba64, flen);
-    ctx->pos += flen;
+    ret |= writeChars(ctx, (const char*)ba64, flen);
 
     /* Base64 result no longer needed */
     UA_free(ba64);
+    if(ret != UA_STATUSCODE_GOOD)
+        return ret;
 
-    return ret | writeJsonQuote(ctx);
+    return writeJsonQuote(ctx);
 }
 
 /* Guid */
 ENCODE_JSON(Guid) {
-    if(ctx->pos + 38 > ctx->end) /* 36 + 2 (") */
-        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
-    status ret = writeJsonQuote(ctx);
+    status ret = ensureSpace(ctx, 38); /* 36 + 2 (") */
+    if(ret != UA_STATUSCODE_GOOD)
+        return ret;
+    ret = writeJsonQuote(ctx);
     if(!ctx->calcOnly)
         UA_Guid_to_hex(src, ctx->pos, false);
     ctx->pos += 36;
@@ -1278,20 +1232,22 @@ UA_encodeJson(const void *src, const UA_DataType *type, UA_ByteString *outBuf,
     if(!src || !type)
         return UA_STATUSCODE_BADINTERNALERROR;
 
-    /* Allocate buffer */
+    /* Set up the context */
+    CtxJson ctx;
+    memset(&ctx, 0, sizeof(ctx));
+
+    /* Allocate a buffer that grows during the encoding. This avoids a separate
+     * pass to compute the length upfront. */
     UA_Boolean allocated = false;
     status res = UA_STATUSCODE_GOOD;
     if(outBuf->length == 0) {
-        size_t len = UA_calcSizeJson(src, type, options);
-        res = UA_ByteString_allocBuffer(outBuf, len);
+        res = UA_ByteString_allocBuffer(outBuf, UA_JSON_INITIALBUFFERSIZE);
         if(res != UA_STATUSCODE_GOOD)
             return res;
         allocated = true;
+        ctx.growBuf = outBuf;
     }
 
-    /* Set up the context */
-    CtxJson ctx;
-    memset(&ctx, 0, sizeof(ctx));
     ctx.pos = outBuf->data;
     ctx.end = &outBuf->data[outBuf->length];
     ctx.depth = 0;
@@ -1312,11 +1268,20 @@ UA_encodeJson(const void *src, const UA_DataType *type, UA_ByteString *outBuf,
     res = encodeJsonJumpTable[type->typeKind](&ctx, src, type);
 
     /* Clean up */
-    if(res == UA_STATUSCODE_GOOD)
-        outBuf->length = (size_t)((uintptr_t)ctx.pos - (uintptr_t)outBuf->data);
-    else if(allocated)
-        UA_ByteString_clear(outBuf);
-    return res;
+    if(res != UA_STATUSCODE_GOOD) {
+        if(allocated)
+            UA_ByteString_clear(outBuf);
+        return res;
+    }
+    outBuf->length = (size_t)((uintptr_t)ctx.pos - (uintptr_t)outBuf->data);
+
+    /* Release the unused space of the allocated buffer */
+    if(allocated && outBuf->length > 0) {
+        UA_Byte *data = (UA_Byte*)UA_realloc(outBuf->data, outBuf->length);
+        if(data)
+            outBuf->data = data;
+    }
+    return UA_STATUSCODE_GOOD;
 }
 
 UA_StatusCode
@@ -1418,13 +1383,26 @@ UA_calcSizeJson(const void *src, const UA_DataType *type,
 /* If ctx->index points to the beginning of an object, move the index to the
  * next token after this object. Attention! The index can be moved after the
  * last parsed token. So the array length has to be checked afterwards. */
+/* Jump over the current token and its nested children. The tokens are sorted
+ * by their start position. So the first token after the subtree is found with
+ * a binary search instead of scanning the (possibly large) nested value. */
 static void
 skipObject(ParseCtx *ctx) {
     unsigned int end = ctx->tokens[ctx->index].end;
-    do {
-        ctx->index++;
-    } while(ctx->index < ctx->tokensSize &&
-            ctx->tokens[ctx->index].start < end);
+    size_t lo = ctx->index + 1;
+    size_t hi = ctx->tokensSize;
+    if(lo >= hi || ctx->tokens[lo].start > end) {
+        ctx->index = lo; /* No nested tokens */
+        return;
+    }
+    while(lo < hi) {
+        size_t mid = lo + ((hi - lo) / 2);
+        if(ctx->tokens[mid].start < end)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    ctx->index = lo;
 }
 
 static status
@@ -2607,8 +2585,81 @@ DiagnosticInfoInner_decodeJson(ParseCtx* ctx, void* dst, const UA_DataType* type
     return DiagnosticInfo_decodeJson(ctx, inner, type);
 }
 
-status
-decodeFields(ParseCtx *ctx, DecodeEntry *entries, size_t entryCount) {
+/* 32bit FNV-1a hash */
+static u32
+fnv1a(const char *data, size_t len) {
+    u32 h = 0x811c9dc5u;
+    for(size_t i = 0; i < len; i++) {
+        h ^= (u8)data[i];
+        h *= 0x01000193u;
+    }
+    return h;
+}
+
+/* Hash table from the field name hash to the entry index (+1, zero marks an
+ * empty slot). Open addressing with linear probing. The table is only built
+ * when a key does not appear at the position of its entry. The hashes of the
+ * field names are computed then and kept next to the table. */
+typedef struct {
+    u32 *hashes; /* Hash of the field name for every entry */
+    u8 *slots;
+    size_t mask;
+    UA_Boolean built;
+} MemberTable;
+
+static void
+buildMemberTable(MemberTable *mt, const DecodeEntry *entries, size_t entryCount) {
+    memset(mt->slots, 0, mt->mask + 1);
+    for(size_t i = 0; i < entryCount; ++i) {
+        u32 h = fnv1a(entries[i].fieldName, strlen(entries[i].fieldName));
+        mt->hashes[i] = h;
+        size_t slot = h & mt->mask;
+        while(mt->slots[slot] != 0)
+            slot = (slot + 1) & mt->mask;
+        mt->slots[slot] = (u8)(i + 1);
+    }
+    mt->built = true;
+}
+
+static DecodeEntry *
+findEntry(ParseCtx *ctx, DecodeEntry *entries, size_t entryCount,
+          MemberTable *mt, size_t key) {
+    const cj5_token *tok = &ctx->tokens[ctx->index];
+
+    /* Fast path if the key-order is the same as the entry-order */
+    if(key < entryCount && jsoneq(ctx->json5, tok, entries[key].fieldName) == 0)
+        return &entries[key];
+
+    /* Lookup in the hash table */
+    if(mt) {
+        if(!mt->built)
+            buildMemberTable(mt, entries, entryCount);
+        u32 h = fnv1a(&ctx->json5[tok->start], getTokenLength(tok));
+        for(size_t slot = h & mt->mask; mt->slots[slot] != 0;
+            slot = (slot + 1) & mt->mask) {
+            size_t i = (size_t)mt->slots[slot] - 1;
+            if(mt->hashes[i] == h &&
+               jsoneq(ctx->json5, tok, entries[i].fieldName) == 0)
+                return &entries[i];
+        }
+        return NULL;
+    }
+
+    /* Search for the decoding entry matching the key. Start after the key
+     * index (the entry at the key index was already tested). */
+    for(size_t i = key + 1; i < key + entryCount; i++) {
+        size_t ii = i;
+        while(ii >= entryCount)
+            ii -= entryCount;
+        if(jsoneq(ctx->json5, tok, entries[ii].fieldName) == 0)
+            return &entries[ii];
+    }
+    return NULL;
+}
+
+static status
+decodeFieldsInternal(ParseCtx *ctx, DecodeEntry *entries, size_t entryCount,
+                     MemberTable *mt) {
     CHECK_TOKEN_BOUNDS;
     CHECK_NULL_SKIP; /* null is treated like an empty object */
 
@@ -2629,31 +2680,8 @@ decodeFields(ParseCtx *ctx, DecodeEntry *entries, size_t entryCount) {
         UA_assert(ctx->index < ctx->tokensSize);
         UA_assert(currentTokenType(ctx) == CJ5_TOKEN_STRING);
 
-        /* Search for the decoding entry matching the key. Start at the key
-         * index to speed-up the case where they key-order is the same as the
-         * entry-order. */
-        DecodeEntry *entry = NULL;
-        for(size_t i = key; i < key + entryCount; i++) {
-            size_t ii = i;
-            while(ii >= entryCount)
-                ii -= entryCount;
-
-            /* Compare the key */
-            if(jsoneq(ctx->json5, &ctx->tokens[ctx->index],
-                      entries[ii].fieldName) != 0)
-                continue;
-
-            /* Key was already used -> duplicate, abort */
-            if(entries[ii].found) {
-                ctx->depth--;
-                return UA_STATUSCODE_BADDECODINGERROR;
-            }
-
-            /* Found the key */
-            entries[ii].found = true;
-            entry = &entries[ii];
-            break;
-        }
+        /* Find the decoding entry matching the key */
+        DecodeEntry *entry = findEntry(ctx, entries, entryCount, mt, key);
 
         /* The key is unknown */
         if(!entry) {
@@ -2661,6 +2689,13 @@ decodeFields(ParseCtx *ctx, DecodeEntry *entries, size_t entryCount) {
             break;
         }
 
+        /* Key was already used -> duplicate, abort */
+        if(entry->found) {
+            ctx->depth--;
+            return UA_STATUSCODE_BADDECODINGERROR;
+        }
+        entry->found = true;
+
         /* Go from key to value */
         ctx->index++;
         UA_assert(ctx->index < ctx->tokensSize);
@@ -2691,6 +2726,11 @@ decodeFields(ParseCtx *ctx, DecodeEntry *entries, size_t entryCount) {
     return ret;
 }
 
+status
+decodeFields(ParseCtx *ctx, DecodeEntry *entries, size_t entryCount) {
+    return decodeFieldsInternal(ctx, entries, entryCount, NULL);
+}
+
 static status
 Array_decodeJson(ParseCtx *ctx, void **dst, const UA_DataType *type) {
     /* Save the length of the array */
@@ -2767,7 +2807,22 @@ decodeJsonStructure(ParseCtx *ctx, void *dst, const UA_DataType *type) {
         }
     }
 
-    ret = decodeFields(ctx, entries, membersSize);
+    if(membersSize > 0) {
+        /* Hash table with a load factor <= 0.5 */
+        MemberTable table;
+        size_t slotsSize = 4;
+        while(slotsSize < 2 * (size_t)membersSize)
+            slotsSize <<= 1;
+        UA_STACKARRAY(u8, slots, slotsSize);
+        UA_STACKARRAY(u32, hashes, membersSize);
+        table.hashes = hashes;
+        table.slots = slots;
+        table.mask = slotsSize - 1;
+        table.built = false;
+        ret = decodeFieldsInternal(ctx, entries, membersSize, &table);
+    } else {
+        ret = decodeFields(ctx, entries, membersSize);
+    }
 
     if(ctx->depth == 0)
         return UA_STATUSCODE_BADENCODINGERROR;
@@ -2844,48 +2899,366 @@ tokenize(ParseCtx *ctx, const UA_ByteString *src, size_t tokensSize) {
     return UA_STATUSCODE_GOOD;
 }
 
+static void
+setDecodeOptions(ParseCtx *ctx, const UA_DecodeJsonOptions *options) {
+    if(!options)
+        return;
+    ctx->namespaces = options->namespaces;
+    ctx->namespacesSize = options->namespacesSize;
+    ctx->serverUris = options->serverUris;
+    ctx->serverUrisSize = options->serverUrisSize;
+    ctx->customTypes = options->customTypes;
+}
+
+/* Decode from the tokenized context into the zeroed dst. The value is cleared
+ * if decoding fails. */
+static status
+decodeJsonTokenized(ParseCtx *ctx, void *dst, const UA_DataType *type) {
+    status ret = decodeJsonJumpTable[type->typeKind](ctx, dst, type);
+
+    /* Sanity check if all tokens were processed */
+    if(ctx->index != ctx->tokensSize &&
+       ctx->index != ctx->tokensSize - 1)
+        ret = UA_STATUSCODE_BADDECODINGERROR;
+
+    if(ret != UA_STATUSCODE_GOOD)
+        UA_clear(dst, type);
+    return ret;
+}
+
 UA_StatusCode
 UA_decodeJson(const UA_ByteString *src, void *dst, const UA_DataType *type,
               const UA_DecodeJsonOptions *options) {
     if(!dst || !src || !type)
         return UA_STATUSCODE_BADARGUMENTSMISSING;
 
+    /* Initialize the value */
+    memset(dst, 0, type->memSize);
+
     /* Set up the context */
     cj5_token tokens[UA_JSON_MAXTOKENCOUNT];
     ParseCtx ctx;
     memset(&ctx, 0, sizeof(ParseCtx));
     ctx.tokens = tokens;
+    setDecodeOptions(&ctx, options);
 
-    if(options) {
-        ctx.namespaces = options->namespaces;
-        ctx.namespacesSize = options->namespacesSize;
-        ctx.serverUris = options->serverUris;
-        ctx.serverUrisSize = options->serverUrisSize;
-        ctx.customTypes = options->customTypes;
+    /* Decode */
+    status ret = tokenize(&ctx, src, UA_JSON_MAXTOKENCOUNT);
+    if(ret == UA_STATUSCODE_GOOD)
+        ret = decodeJsonTokenized(&ctx, dst, type);
+
+    /* Free token array on the heap */
+    if(ctx.tokens != tokens)
+        UA_free((void*)(uintptr_t)ctx.tokens);
+    return ret;
+}
+
+/*******************/
+/* Stream Decoding */
+/*******************/
+
+typedef enum {
+    JSONSTREAM_START,     /* Nothing read yet. Detect if this is an array. */
+    JSONSTREAM_ELEMENT,   /* Expect the next value */
+    JSONSTREAM_SEPARATOR, /* After a value. Expect a comma (or the array end). */
+    JSONSTREAM_END        /* After the array end. Only whitespace is allowed. */
+} JsonStreamState;
+
+struct UA_DecodeJsonStream {
+    const UA_DataType *type;
+    UA_DecodeJsonOptions options;
+    UA_DecodeJsonStreamCallback callback;
+    void *context;
+
+    /* The input that is not yet consumed */
+    u8 *buf;
+    size_t bufSize;
+    size_t length;
+
+    /* Don't retry to parse an incomplete value before this many bytes are
+     * buffered. Doubling the required input every time bounds the parsing
+     * effort for large values to be linear in their size. */
+    size_t waitFor;
+
+    /* Reused for every value. The token array grows to the size needed for
+     * the largest value. */
+    cj5_token *tokens;
+    size_t tokensSize;
+    void *value;
+
+    JsonStreamState state;
+    UA_Boolean array;
+    status error; /* Sticky */
+};
+
+UA_DecodeJsonStream *
+UA_DecodeJsonStream_new(const UA_DataType *type,
+                        const UA_DecodeJsonOptions *options,
+                        UA_DecodeJsonStreamCallback callback, void *context) {
+    if(!type || !callback)
+        return NULL;
+    UA_DecodeJsonStream *s = (UA_DecodeJsonStream*)
+        UA_calloc(1, sizeof(UA_DecodeJsonStream));
+    if(!s)
+        return NULL;
+    s->type = type;
+    if(options)
+        s->options = *options;
+    s->callback = callback;
+    s->context = context;
+    s->tokens = (cj5_token*)UA_malloc(sizeof(cj5_token) * UA_JSON_MAXTOKENCOUNT);
+    s->tokensSize = UA_JSON_MAXTOKENCOUNT;
+    s->value = UA_calloc(1, type->memSize);
+    if(!s->tokens || !s->value) {
+        UA_DecodeJsonStream_delete(s);
+        return NULL;
+    }
+    return s;
+}
+
+void
+UA_DecodeJsonStream_delete(UA_DecodeJsonStream *s) {
+    if(!s)
+        return;
+    UA_free(s->buf);
+    UA_free(s->tokens);
+    UA_free(s->value);
+    UA_free(s);
+}
+
+/* Skip whitespace and comments. Returns false if a comment might continue
+ * beyond the buffered input. Then *pos points to the start of the comment. */
+static UA_Boolean
+skipJsonStreamSpace(const char *json, size_t len, size_t *pos,
+                    UA_Boolean finished) {
+    size_t i = *pos;
+    while(i < len) {
+        char c = json[i];
+        if(c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            i++;
+            continue;
+        }
+        if(c != '#' && c != '/')
+            break;
+        *pos = i;
+        if(c == '/') {
+            if(i + 1 >= len)
+                return finished; /* Let the parser fail on the slash */
+            if(json[i+1] == '*') {
+                /* Block comment */
+                for(i += 2; i + 1 < len; i++) {
+                    if(json[i] == '*' && json[i+1] == '/')
+                        break;
+                }
+                if(i + 1 >= len)
+                    return finished;
+                i += 2;
+                continue;
+            }
+            if(json[i+1] != '/')
+                return true; /* Not a comment */
+        }
+        /* Line comment. Ends at the newline or with the input. */
+        while(i < len && json[i] != '\n')
+            i++;
+        if(i == len && !finished)
+            return false;
+    }
+    *pos = i;
+    return true;
+}
+
+/* Characters of unquoted primitives (numbers, true, false, null) */
+static UA_Boolean
+isJsonPrimitiveChar(char c) {
+    return ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') ||
+            (c >= 'A' && c <= 'Z') || c == '.' || c == '+' || c == '-');
+}
+
+/* Decode the next value that starts at json. Returns the number of consumed
+ * bytes in *consumed. If more input is needed, *consumed is set to zero. */
+static status
+decodeJsonStreamValue(UA_DecodeJsonStream *s, const char *json, size_t len,
+                      UA_Boolean finished, size_t *consumed) {
+    *consumed = 0;
+
+    /* An unquoted primitive that reaches the end of the input may continue in
+     * the next chunk. cj5 would decode it (or fail on it) only partially. */
+    if(!finished && isJsonPrimitiveChar(json[0])) {
+        size_t i = 1;
+        while(i < len && isJsonPrimitiveChar(json[i]))
+            i++;
+        if(i == len) {
+            s->waitFor = len + 1;
+            return UA_STATUSCODE_GOOD;
+        }
+    }
+
+    /* Tokenize only the next value */
+    cj5_options opts;
+    opts.stop_early = true;
+    cj5_result r;
+ parse:
+    r = cj5_parse(json, (unsigned int)len, s->tokens,
+                  (unsigned int)s->tokensSize, &opts);
+    if(r.error == CJ5_ERROR_OVERFLOW && r.num_tokens > s->tokensSize) {
+        cj5_token *tokens = (cj5_token*)
+            UA_realloc(s->tokens, sizeof(cj5_token) * r.num_tokens);
+        if(!tokens)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        s->tokens = tokens;
+        s->tokensSize = r.num_tokens;
+        goto parse;
     }
+    if(r.error == CJ5_ERROR_INCOMPLETE && !finished) {
+        s->waitFor = len * 2;
+        return UA_STATUSCODE_GOOD;
+    }
+    if(r.error != CJ5_ERROR_NONE)
+        return UA_STATUSCODE_BADDECODINGERROR;
+
+    /* The closing quote is not part of a string token */
+    const cj5_token *root = &s->tokens[0];
+    size_t end = (size_t)root->end + 1;
+    if(root->type == CJ5_TOKEN_STRING)
+        end++;
 
     /* Decode */
-    status ret = tokenize(&ctx, src, UA_JSON_MAXTOKENCOUNT);
+    ParseCtx ctx;
+    memset(&ctx, 0, sizeof(ParseCtx));
+    ctx.json5 = json;
+    ctx.tokens = s->tokens;
+    ctx.tokensSize = r.num_tokens;
+    setDecodeOptions(&ctx, &s->options);
+    status ret = decodeJsonTokenized(&ctx, s->value, s->type);
     if(ret != UA_STATUSCODE_GOOD)
-        goto cleanup;
+        return ret;
 
-    memset(dst, 0, type->memSize); /* Initialize the value */
-    ret = decodeJsonJumpTable[type->typeKind](&ctx, dst, type);
+    /* Hand over to the callback. Clearing also zeroes the value for reuse. */
+    ret = s->callback(s->context, s->value);
+    UA_clear(s->value, s->type);
+    s->waitFor = 0;
+    *consumed = end;
+    return ret;
+}
 
-    /* Sanity check if all tokens were processed */
-    if(ctx.index != ctx.tokensSize &&
-       ctx.index != ctx.tokensSize - 1)
-        ret = UA_STATUSCODE_BADDECODINGERROR;
+static status
+processJsonStream(UA_DecodeJsonStream *s, UA_Boolean finished) {
+    const char *json = (const char*)s->buf;
+    size_t pos = 0;
+    status ret = UA_STATUSCODE_GOOD;
+    while(ret == UA_STATUSCODE_GOOD) {
+        if(!skipJsonStreamSpace(json, s->length, &pos, finished) ||
+           pos == s->length)
+            break;
 
- cleanup:
+        char c = json[pos];
+        if(s->state == JSONSTREAM_START) {
+            s->state = JSONSTREAM_ELEMENT;
+            if(c == '[') {
+                s->array = true;
+                pos++;
+            }
+            continue;
+        }
 
-    /* Free token array on the heap */
-    if(ctx.tokens != tokens)
-        UA_free((void*)(uintptr_t)ctx.tokens);
+        if(s->state == JSONSTREAM_END) {
+            ret = UA_STATUSCODE_BADDECODINGERROR;
+            break;
+        }
 
-    if(ret != UA_STATUSCODE_GOOD)
-        UA_clear(dst, type);
+        /* The array can close after a value or after a (dangling) comma */
+        if(s->array && c == ']') {
+            s->state = JSONSTREAM_END;
+            pos++;
+            continue;
+        }
+
+        if(s->state == JSONSTREAM_SEPARATOR) {
+            if(c == ',') {
+                pos++;
+            } else if(s->array) {
+                ret = UA_STATUSCODE_BADDECODINGERROR;
+                break;
+            }
+            s->state = JSONSTREAM_ELEMENT; /* The comma is optional in a
+                                            * sequence of values */
+            continue;
+        }
+
+        /* Wait until enough input is buffered */
+        size_t len = s->length - pos;
+        if(!finished && len < s->waitFor)
+            break;
+
+        size_t consumed = 0;
+        ret = decodeJsonStreamValue(s, &json[pos], len, finished, &consumed);
+        if(consumed == 0)
+            break;
+        pos += consumed;
+        s->state = JSONSTREAM_SEPARATOR;
+    }
+
+    /* Move the remaining input to the beginning of the buffer */
+    if(pos > 0) {
+        memmove(s->buf, &s->buf[pos], s->length - pos);
+        s->length -= pos;
+    }
     return ret;
 }
 
+UA_StatusCode
+UA_DecodeJsonStream_decode(UA_DecodeJsonStream *s, const UA_ByteString *chunk) {
+    if(!s || !chunk)
+        return UA_STATUSCODE_BADARGUMENTSMISSING;
+    if(s->error != UA_STATUSCODE_GOOD)
+        return s->error;
+    if(chunk->length == 0)
+        return UA_STATUSCODE_GOOD;
+
+    /* Values are tokenized with 32bit offsets */
+    if(chunk->length > UA_UINT32_MAX - s->length) {
+        s->error = UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
+        return s->error;
+    }
+
+    /* Append the chunk to the buffer */
+    size_t needed = s->length + chunk->length;
+    if(needed > s->bufSize) {
+        size_t newSize = (s->bufSize > 0) ? s->bufSize * 2 : UA_JSON_INITIALBUFFERSIZE;
+        if(newSize < needed)
+            newSize = needed;
+        u8 *buf = (u8*)UA_realloc(s->buf, newSize);
+        if(!buf) {
+            s->error = UA_STATUSCODE_BADOUTOFMEMORY;
+            return s->error;
+        }
+        s->buf = buf;
+        s->bufSize = newSize;
+    }
+    memcpy(&s->buf[s->length], chunk->data, chunk->length);
+    s->length = needed;
+
+    s->error = processJsonStream(s, false);
+    return s->error;
+}
+
+UA_StatusCode
+UA_DecodeJsonStream_finish(UA_DecodeJsonStream *s) {
+    if(!s)
+        return UA_STATUSCODE_BADARGUMENTSMISSING;
+    if(s->error != UA_STATUSCODE_GOOD)
+        return s->error;
+    s->error = processJsonStream(s, true);
+
+    /* An opened array must also be closed */
+    if(s->error == UA_STATUSCODE_GOOD && s->array &&
+       s->state != JSONSTREAM_END)
+        s->error = UA_STATUSCODE_BADDECODINGERROR;
+
+    /* Reject input after the end */
+    s->state = JSONSTREAM_END;
+    return s->error;
+}
+
 #endif /* UA_ENABLE_JSON_ENCODING */
@@ -19,6 +19,7 @@ _UA_BEGIN_DECLS
 
 #define UA_JSON_MAXTOKENCOUNT 256
 #define UA_JSON_ENCODING_MAX_RECURSION 100
+#define UA_JSON_INITIALBUFFERSIZE 1024
 
 typedef struct {
     uint8_t *pos;
@@ -29,6 +30,11 @@ typedef struct {
     UA_Boolean useReversible;
     UA_Boolean calcOnly; /* Only compute the length of the decoding */
 
+    /* If set, the output buffer is enlarged when its end is reached. Then the
+     * value is encoded in a single pass without computing the length first.
+     * pos/end point into growBuf. */
+    UA_ByteString *growBuf;
+
     size_t namespacesSize;
     const UA_String *namespaces;
 
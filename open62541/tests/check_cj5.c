@@ -183,6 +183,28 @@ START_TEST(parseValue) {
     ck_assert(r.error == CJ5_ERROR_NONE);
 } END_TEST
 
+START_TEST(parseLiteralAtEnd) {
+    const char *json = "true";
+    cj5_token tokens[32];
+    cj5_result r = cj5_parse(json, (unsigned int)strlen(json), tokens, 32, NULL);
+    ck_assert(r.error == CJ5_ERROR_NONE);
+    ck_assert(tokens[0].type == CJ5_TOKEN_BOOL);
+
+    json = "[null]";
+    r = cj5_parse(json + 1, 4, tokens, 32, NULL);
+    ck_assert(r.error == CJ5_ERROR_NONE);
+    ck_assert(tokens[0].type == CJ5_TOKEN_NULL);
+
+    /* Truncated input is incomplete and not invalid */
+    json = "[fals";
+    r = cj5_parse(json, (unsigned int)strlen(json), tokens, 32, NULL);
+    ck_assert(r.error == CJ5_ERROR_INCOMPLETE);
+
+    json = "[1 /";
+    r = cj5_parse(json, (unsigned int)strlen(json), tokens, 32, NULL);
+    ck_assert(r.error == CJ5_ERROR_INCOMPLETE);
+} END_TEST
+
 START_TEST(parseValueStopEarly) {
     cj5_options opt;
     opt.stop_early = true;
@@ -232,6 +254,7 @@ static Suite *testSuite_builtin_json(void) {
     tcase_add_test(tc_parse, parseArrayStopEarly);
     tcase_add_test(tc_parse, parseValue);
     tcase_add_test(tc_parse, parseValueStopEarly);
+    tcase_add_test(tc_parse, parseLiteralAtEnd);
     tcase_add_test(tc_parse, parseInf);
     tcase_add_test(tc_parse, parseNegInf);
 
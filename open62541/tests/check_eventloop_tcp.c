@@ -17,6 +17,8 @@ static unsigned connCount;
 static char *testMsg = "open62541";
 static uintptr_t clientId;
 static UA_Boolean received;
+static size_t receivedBytes;
+static UA_String backend; /* Polling backend of the EventLoop */
 
 static void
 connectionCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
@@ -52,9 +54,18 @@ connectionCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
     }
 }
 
+static UA_EventLoop *
+newEventLoop(void) {
+    UA_EventLoop *newEl = UA_EventLoop_new_POSIX(UA_Log_Stdout);
+    if(backend.length > 0)
+        UA_KeyValueMap_setScalar(newEl->params, UA_QUALIFIEDNAME(0, "backend"),
+                                 &backend, &UA_TYPES[UA_TYPES_STRING]);
+    return newEl;
+}
+
 START_TEST(listenTCP) {
     UA_ConnectionManager *cm = UA_ConnectionManager_new_POSIX_TCP(UA_STRING("tcpCM"));
-    el = UA_EventLoop_new_POSIX(UA_Log_Stdout);
+    el = newEventLoop();
     el->registerEventSource(el, &cm->eventSource);
     el->start(el);
 
@@ -100,7 +111,7 @@ START_TEST(listenTCP) {
 
 START_TEST(connectTCP) {
     UA_ConnectionManager *cm = UA_ConnectionManager_new_POSIX_TCP(UA_STRING("tcpCM"));
-    el = UA_EventLoop_new_POSIX(UA_Log_Stdout);
+    el = newEventLoop();
     el->registerEventSource(el, &cm->eventSource);
     el->start(el);
 
@@ -180,13 +191,228 @@ START_TEST(connectTCP) {
     el = NULL;
 } END_TEST
 
+static void
+countingCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
+                 void *application, void **connectionContext,
+                 UA_ConnectionState status,
+                 const UA_KeyValueMap *params,
+                 UA_ByteString msg) {
+    if(*connectionContext != NULL)
+        clientId = connectionId;
+    if(msg.length == 0 && status == UA_CONNECTIONSTATE_ESTABLISHED)
+        connCount++;
+    if(status == UA_CONNECTIONSTATE_CLOSING)
+        connCount--;
+    receivedBytes += msg.length;
+}
+
+static size_t
+openClientConnection(UA_ConnectionManager *cm) {
+    UA_UInt16 port = 4840;
+    UA_Boolean listen = true;
+    UA_String host = UA_STRING("localhost");
+
+    UA_KeyValuePair params[3];
+    params[0].key = UA_QUALIFIEDNAME(0, "port");
+    UA_Variant_setScalar(&params[0].value, &port, &UA_TYPES[UA_TYPES_UINT16]);
+    params[1].key = UA_QUALIFIEDNAME(0, "listen");
+    UA_Variant_setScalar(&params[1].value, &listen, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    params[2].key = UA_QUALIFIEDNAME(0, "address");
+    UA_Variant_setScalar(&params[2].value, &host, &UA_TYPES[UA_TYPES_STRING]);
+
+    UA_KeyValueMap paramsMap;
+    paramsMap.map = params;
+    paramsMap.mapSize = 3;
+
+    connCount = 0;
+    receivedBytes = 0;
+    cm->openConnection(cm, &paramsMap, NULL, NULL, countingCallback);
+    size_t listenSockets = connCount;
+
+    clientId = 0;
+    listen = false;
+    UA_StatusCode retval =
+        cm->openConnection(cm, &paramsMap, NULL, (void*)0x01, countingCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < 2; i++) {
+        UA_DateTime next = el->run(el, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+    ck_assert(clientId != 0);
+    ck_assert_uint_eq(connCount, listenSockets + 2);
+    return listenSockets;
+}
+
+static void
+stopEventLoop(void) {
+    int max_stop_iteration_count = 10;
+    int iteration = 0;
+    el->stop(el);
+    while(el->state != UA_EVENTLOOPSTATE_STOPPED &&
+          iteration < max_stop_iteration_count) {
+        UA_DateTime next = el->run(el, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+        iteration++;
+    }
+    ck_assert(el->state == UA_EVENTLOOPSTATE_STOPPED);
+    el->free(el);
+    el = NULL;
+}
+
+#define SENDQUEUE_CHUNK (1u << 16)
+#define SENDQUEUE_CHUNKS 256
+
+/* Sending does not block while the receiver does not read. The data is queued
+ * and delivered once the EventLoop runs. */
+START_TEST(sendQueueTCP) {
+    UA_ConnectionManager *cm = UA_ConnectionManager_new_POSIX_TCP(UA_STRING("tcpCM"));
+    el = newEventLoop();
+    el->registerEventSource(el, &cm->eventSource);
+    el->start(el);
+
+    size_t listenSockets = openClientConnection(cm);
+
+    /* 16MB is more than the socket buffers can take */
+    for(size_t i = 0; i < SENDQUEUE_CHUNKS; i++) {
+        UA_ByteString snd;
+        UA_StatusCode retval =
+            cm->allocNetworkBuffer(cm, clientId, &snd, SENDQUEUE_CHUNK);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        memset(snd.data, (int)i, snd.length);
+        retval = cm->sendWithConnection(cm, clientId, NULL, &snd);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    size_t total = (size_t)SENDQUEUE_CHUNK * SENDQUEUE_CHUNKS;
+    for(size_t i = 0; i < 100000 && receivedBytes < total; i++)
+        el->run(el, 1);
+    ck_assert_uint_eq(receivedBytes, total);
+    ck_assert_uint_eq(connCount, listenSockets + 2);
+
+    stopEventLoop();
+} END_TEST
+
+/* Exceeding the send queue limit closes the connection */
+START_TEST(sendQueueLimitTCP) {
+    UA_ConnectionManager *cm = UA_ConnectionManager_new_POSIX_TCP(UA_STRING("tcpCM"));
+    UA_UInt32 limit = 1u << 20;
+    UA_KeyValueMap_setScalar(&cm->eventSource.params,
+                             UA_QUALIFIEDNAME(0, "send-queue-limit"),
+                             &limit, &UA_TYPES[UA_TYPES_UINT32]);
+    el = newEventLoop();
+    el->registerEventSource(el, &cm->eventSource);
+    el->start(el);
+
+    size_t listenSockets = openClientConnection(cm);
+
+    UA_StatusCode retval = UA_STATUSCODE_GOOD;
+    for(size_t i = 0; i < SENDQUEUE_CHUNKS && retval == UA_STATUSCODE_GOOD; i++) {
+        UA_ByteString snd;
+        retval = cm->allocNetworkBuffer(cm, clientId, &snd, SENDQUEUE_CHUNK);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        memset(snd.data, (int)i, snd.length);
+        retval = cm->sendWithConnection(cm, clientId, NULL, &snd);
+    }
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADCONNECTIONCLOSED);
+
+    /* Both sides of the connection close */
+    for(size_t i = 0; i < 1000 && connCount > listenSockets; i++)
+        el->run(el, 1);
+    ck_assert_uint_eq(connCount, listenSockets);
+
+    stopEventLoop();
+} END_TEST
+
+/* In the steady state, sending takes the network buffers from the pool */
+START_TEST(sendPoolTCP) {
+    UA_ConnectionManager *cm = UA_ConnectionManager_new_POSIX_TCP(UA_STRING("tcpCM"));
+    UA_UInt32 poolSize = 4;
+    UA_KeyValueMap_setScalar(&cm->eventSource.params,
+                             UA_QUALIFIEDNAME(0, "send-pool-size"),
+                             &poolSize, &UA_TYPES[UA_TYPES_UINT32]);
+    el = newEventLoop();
+    el->registerEventSource(el, &cm->eventSource);
+    el->start(el);
+
+    size_t listenSockets = openClientConnection(cm);
+
+    /* Send many messages. The buffer returns to the pool after every send. */
+    for(size_t i = 0; i < 1000; i++) {
+        UA_ByteString snd;
+        UA_StatusCode retval = cm->allocNetworkBuffer(cm, clientId, &snd, 512);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        memset(snd.data, (int)i, snd.length);
+        retval = cm->sendWithConnection(cm, clientId, NULL, &snd);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        el->run(el, 0);
+    }
+    for(size_t i = 0; i < 1000 && receivedBytes < 1000 * 512; i++)
+        el->run(el, 1);
+    ck_assert_uint_eq(receivedBytes, 1000 * 512);
+
+    UA_NetworkBufferPoolStatistics stats;
+    UA_ConnectionManager_getSendPoolStatistics_POSIX(cm, &stats);
+    ck_assert_uint_eq(stats.poolSize, poolSize);
+    ck_assert_uint_eq(stats.bufSize, 512); /* Sized from the first request */
+    ck_assert_uint_eq(stats.poolAllocs, 1000);
+    ck_assert_uint_eq(stats.heapAllocs, 0);
+    ck_assert_uint_eq(stats.maxInUse, 1);
+    ck_assert_uint_eq(stats.inUse, 0);
+
+    /* Exhaust the pool. Then the buffers come from the heap. */
+    UA_ByteString bufs[5];
+    for(size_t i = 0; i < 5; i++) {
+        UA_StatusCode retval = cm->allocNetworkBuffer(cm, clientId, &bufs[i], 512);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+    UA_ConnectionManager_getSendPoolStatistics_POSIX(cm, &stats);
+    ck_assert_uint_eq(stats.inUse, 4);
+    ck_assert_uint_eq(stats.heapAllocs, 1);
+    for(size_t i = 0; i < 5; i++)
+        cm->freeNetworkBuffer(cm, clientId, &bufs[i]);
+
+    /* Oversized buffers are taken from the heap */
+    UA_StatusCode retval =
+        cm->allocNetworkBuffer(cm, clientId, &bufs[0], stats.bufSize + 1);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    cm->freeNetworkBuffer(cm, clientId, &bufs[0]);
+
+    UA_ConnectionManager_getSendPoolStatistics_POSIX(cm, &stats);
+    ck_assert_uint_eq(stats.inUse, 0);
+    ck_assert_uint_eq(stats.heapAllocs, 2);
+    ck_assert_uint_eq(connCount, listenSockets + 2);
+
+    stopEventLoop();
+} END_TEST
+
+static void setupURing(void) {
+    backend = UA_STRING("io_uring");
+}
+
+static void teardownURing(void) {
+    backend = UA_STRING_NULL;
+}
+
 int main(void) {
     Suite *s  = suite_create("Test TCP EventLoop");
     TCase *tc = tcase_create("test cases");
     tcase_add_test(tc, listenTCP);
     tcase_add_test(tc, connectTCP);
+    tcase_add_test(tc, sendQueueTCP);
+    tcase_add_test(tc, sendQueueLimitTCP);
+    tcase_add_test(tc, sendPoolTCP);
     suite_add_tcase(s, tc);
 
+    /* Run with the io_uring backend (falls back if not available) */
+    TCase *tc_uring = tcase_create("io_uring backend");
+    tcase_add_checked_fixture(tc_uring, setupURing, teardownURing);
+    tcase_add_test(tc_uring, listenTCP);
+    tcase_add_test(tc_uring, connectTCP);
+    tcase_add_test(tc_uring, sendQueueTCP);
+    tcase_add_test(tc_uring, sendQueueLimitTCP);
+    tcase_add_test(tc_uring, sendPoolTCP);
+    suite_add_tcase(s, tc_uring);
+
     SRunner *sr = srunner_create(s);
     srunner_set_fork_status(sr, CK_NOFORK);
     srunner_run_all (sr, CK_NORMAL);
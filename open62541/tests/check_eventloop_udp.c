@@ -16,6 +16,7 @@ static UA_EventLoop *el;
 static char *testMsg = "open62541";
 static uintptr_t clientId;
 static UA_Boolean received;
+static size_t receivedCount;
 
 typedef struct TestContext {
     unsigned connCount;
@@ -62,6 +63,7 @@ connectionCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
         UA_ByteString rcv = UA_BYTESTRING(testMsg);
         ck_assert(UA_String_equal(&msg, &rcv));
         received = true;
+        receivedCount++;
     }
 }
 
@@ -284,6 +286,96 @@ START_TEST(connectUDP) {
     el = NULL;
 } END_TEST
 
+#define BATCH_MESSAGES 20
+
+START_TEST(connectUDPBatch) {
+    UA_ConnectionManager *cm = UA_ConnectionManager_new_POSIX_UDP(UA_STRING("udpCM"));
+    el = UA_EventLoop_new_POSIX(UA_Log_Stdout);
+
+    /* Receive up to 32 datagrams at once */
+    UA_UInt32 batchSize = 32;
+    UA_KeyValueMap_setScalar(&cm->eventSource.params,
+                             UA_QUALIFIEDNAME(0, "recv-batchsize"),
+                             &batchSize, &UA_TYPES[UA_TYPES_UINT32]);
+
+    el->registerEventSource(el, &cm->eventSource);
+    el->start(el);
+
+    UA_UInt16 port = 30000;
+    UA_Boolean listen = true;
+    UA_String targetHost = UA_STRING("localhost");
+
+    UA_KeyValuePair params[3];
+    params[0].key = UA_QUALIFIEDNAME(0, "port");
+    UA_Variant_setScalar(&params[0].value, &port, &UA_TYPES[UA_TYPES_UINT16]);
+    params[1].key = UA_QUALIFIEDNAME(0, "listen");
+    UA_Variant_setScalar(&params[1].value, &listen, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    params[2].key = UA_QUALIFIEDNAME(0, "address");
+    UA_Variant_setScalar(&params[2].value, &targetHost, &UA_TYPES[UA_TYPES_STRING]);
+
+    UA_KeyValueMap paramsMap = {2, params}; /* hide the third parameter */
+    TestContext testContext;
+    testContext.connCount = 0;
+
+    UA_StatusCode retval =
+        cm->openConnection(cm, &paramsMap, NULL, &testContext, connectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    size_t listenSockets = testContext.connCount;
+
+    /* Open a client connection */
+    listen = false;
+    paramsMap.mapSize = 3;
+    retval = cm->openConnection(cm, &paramsMap, NULL, &testContext, connectionCallback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < 2; i++) {
+        UA_DateTime next = el->run(el, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+    ck_assert(clientId != 0);
+    ck_assert_uint_eq(testContext.connCount, listenSockets + 1);
+
+    /* Send several messages from the client at once */
+    ck_assert(cm->sendBatchWithConnection != NULL);
+    UA_ByteString snd[BATCH_MESSAGES];
+    for(size_t i = 0; i < BATCH_MESSAGES; i++) {
+        retval = cm->allocNetworkBuffer(cm, clientId, &snd[i], strlen(testMsg));
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        memcpy(snd[i].data, testMsg, strlen(testMsg));
+    }
+    receivedCount = 0;
+    retval = cm->sendBatchWithConnection(cm, clientId, &UA_KEYVALUEMAP_NULL,
+                                         snd, BATCH_MESSAGES);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < BATCH_MESSAGES; i++)
+        ck_assert_uint_eq(snd[i].length, 0);
+
+    /* All messages arrive. With recvmmsg they are received in one iteration. */
+    for(size_t i = 0; i < BATCH_MESSAGES && receivedCount < BATCH_MESSAGES; i++) {
+        UA_DateTime next = el->run(el, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+    ck_assert_uint_eq(receivedCount, BATCH_MESSAGES);
+
+    /* Close the connection */
+    retval = cm->closeConnection(cm, clientId);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < 2; i++) {
+        UA_DateTime next = el->run(el, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+    ck_assert_uint_eq(testContext.connCount, listenSockets);
+
+    /* Stop the EventLoop */
+    el->stop(el);
+    for(size_t i = 0; i < 10 && el->state != UA_EVENTLOOPSTATE_STOPPED; i++) {
+        UA_DateTime next = el->run(el, 1);
+        UA_fakeSleep((UA_UInt32)((next - UA_DateTime_now()) / UA_DATETIME_MSEC));
+    }
+    el->free(el);
+    el = NULL;
+} END_TEST
+
 START_TEST(udpTalkerAndListener) {
     /* create listener eventloop */
     UA_EventLoop *elListener = UA_EventLoop_new_POSIX(UA_Log_Stdout);
@@ -522,6 +614,7 @@ int main(void) {
     TCase *tc = tcase_create("test cases");
     tcase_add_test(tc, listenUDP);
     tcase_add_test(tc, connectUDP);
+    tcase_add_test(tc, connectUDPBatch);
     tcase_add_test(tc, connectUDPValidationFails);
     tcase_add_test(tc, connectUDPValidationSucceeds);
     tcase_add_test(tc, udpTalkerAndListener);
@@ -546,6 +546,68 @@ START_TEST(SecureChannel_assemblePartialChunks) {
     ck_assert_int_eq(chunks_processed, 5);
 } END_TEST
 
+/* Encode a MSG chunk with a payload of the given length and fill byte */
+static size_t
+encodeMsgChunk(UA_Byte *buf, UA_ChunkType chunkType, UA_UInt32 sequenceNumber,
+               UA_UInt32 requestId, size_t payloadLength, UA_Byte fill) {
+    UA_UInt32 header[5];
+    header[0] = (UA_UInt32)(24 + payloadLength);
+    header[1] = testChannel.securityToken.channelId;
+    header[2] = testChannel.securityToken.tokenId;
+    header[3] = sequenceNumber;
+    header[4] = requestId;
+    UA_UInt32 typeAndChunk = UA_MESSAGETYPE_MSG + chunkType;
+    UA_Byte *pos = buf;
+    const UA_Byte *end = buf + 24;
+    UA_StatusCode res = UA_UInt32_encodeBinary(&typeAndChunk, &pos, end);
+    for(size_t i = 0; i < 5; i++)
+        res |= UA_UInt32_encodeBinary(&header[i], &pos, end);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    memset(pos, fill, payloadLength);
+    return 24 + payloadLength;
+}
+
+START_TEST(SecureChannel_assembleIntermediateChunks) {
+    testChannel.securityToken.createdAt = UA_DateTime_nowMonotonic();
+    testChannel.securityToken.revisedLifetime = 600000;
+
+    /* Three chunks of one message */
+    UA_Byte data[3 * (24 + 100)];
+    size_t len = 0;
+    len += encodeMsgChunk(&data[len], UA_CHUNKTYPE_INTERMEDIATE, 1, 7, 100, 'a');
+    len += encodeMsgChunk(&data[len], UA_CHUNKTYPE_INTERMEDIATE, 2, 7, 100, 'b');
+    len += encodeMsgChunk(&data[len], UA_CHUNKTYPE_FINAL, 3, 7, 100, 'c');
+
+    /* Receive the chunks in packets that cut across the chunk boundaries */
+    size_t cuts[4] = {0, 50, 200, len};
+    UA_ByteString payload = UA_BYTESTRING_NULL;
+    UA_UInt32 requestId = 0;
+    UA_Boolean copied = false;
+    for(size_t i = 0; i < 3; i++) {
+        UA_ByteString packet = {cuts[i+1] - cuts[i], &data[cuts[i]]};
+        UA_StatusCode res = UA_SecureChannel_loadBuffer(&testChannel, packet);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        UA_MessageType messageType;
+        res = UA_SecureChannel_getCompleteMessage(&testChannel, &messageType, &requestId,
+                                                  &payload, &copied);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        if(i < 2)
+            ck_assert_uint_eq(payload.length, 0);
+        ck_assert_uint_eq(UA_SecureChannel_persistBuffer(&testChannel),
+                          UA_STATUSCODE_GOOD);
+    }
+
+    /* The payload of all chunks was assembled */
+    ck_assert_uint_eq(requestId, 7);
+    ck_assert_uint_eq(payload.length, 300);
+    ck_assert(copied);
+    for(size_t i = 0; i < 300; i++)
+        ck_assert_uint_eq(payload.data[i], (UA_Byte)('a' + i / 100));
+    ck_assert_uint_eq(testChannel.chunksCount, 0);
+    ck_assert_uint_eq(testChannel.chunksLength, 0);
+    UA_ByteString_clear(&payload);
+} END_TEST
+
 
 static Suite *
 testSuite_SecureChannel(void) {
@@ -591,6 +653,7 @@ testSuite_SecureChannel(void) {
     tcase_add_checked_fixture(tc_processBuffer, setup_key_sizes, teardown_key_sizes);
     tcase_add_checked_fixture(tc_processBuffer, setup_secureChannel, teardown_secureChannel);
     tcase_add_test(tc_processBuffer, SecureChannel_assemblePartialChunks);
+    tcase_add_test(tc_processBuffer, SecureChannel_assembleIntermediateChunks);
     suite_add_tcase(s, tc_processBuffer);
 
     return s;
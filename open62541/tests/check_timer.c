@@ -3,6 +3,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "ua_timer.h"
+#include "testing_clock.h"
 
 #include <check.h>
 #include <stdlib.h>
@@ -10,6 +11,13 @@
 #include <stdio.h>
 
 #define N_EVENTS 10000
+#define N_BENCH_EVENTS 200000
+
+#ifdef UA_ENABLE_TIMER_WHEEL
+# define TIMER_IMPL "timing wheel"
+#else
+# define TIMER_IMPL "zip tree"
+#endif
 
 size_t count = 0;
 
@@ -52,10 +60,239 @@ START_TEST(benchmarkTimer) {
     UA_Timer_clear(&timer);
 } END_TEST
 
+/* Record the order of execution in the data pointer */
+static size_t order[64];
+static size_t orderCount = 0;
+
+static void
+orderCallback(void *application, void *data) {
+    order[orderCount++] = (size_t)(uintptr_t)data;
+}
+
+START_TEST(timedCallbackOrder) {
+    UA_Timer timer;
+    UA_Timer_init(&timer);
+    orderCount = 0;
+
+    /* Spread the callbacks over several levels of the timing wheel and insert
+     * them out of order */
+    UA_DateTime start = UA_DateTime_nowMonotonic();
+    const UA_DateTime offsets[8] = {
+        5 * UA_DATETIME_MSEC, 1 * UA_DATETIME_MSEC, 3600 * UA_DATETIME_SEC,
+        70 * UA_DATETIME_MSEC, 1 * UA_DATETIME_MSEC + 1, 5000 * UA_DATETIME_MSEC,
+        UA_DATETIME_USEC, 300 * UA_DATETIME_SEC};
+    const size_t expected[8] = {6, 1, 4, 0, 3, 5, 7, 2};
+    for(size_t i = 0; i < 8; i++) {
+        UA_StatusCode res =
+            UA_Timer_addTimedCallback(&timer, orderCallback, NULL, (void*)(uintptr_t)i,
+                                      start + offsets[i], NULL);
+        ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+    }
+    ck_assert_int_eq(UA_Timer_nextRepeatedTime(&timer), start + UA_DATETIME_USEC);
+
+    /* Nothing is due yet */
+    UA_DateTime next = UA_Timer_process(&timer, start);
+    ck_assert_uint_eq(orderCount, 0);
+    ck_assert_int_eq(next, start + UA_DATETIME_USEC);
+
+    /* The first three callbacks are due */
+    next = UA_Timer_process(&timer, start + 1 * UA_DATETIME_MSEC + 1);
+    ck_assert_uint_eq(orderCount, 3);
+    ck_assert_int_eq(next, start + 5 * UA_DATETIME_MSEC);
+
+    /* All callbacks are due. The timed callbacks are removed after execution. */
+    next = UA_Timer_process(&timer, start + 7200 * UA_DATETIME_SEC);
+    ck_assert_uint_eq(orderCount, 8);
+    ck_assert_int_eq(next, UA_INT64_MAX);
+    for(size_t i = 0; i < 8; i++)
+        ck_assert_uint_eq(order[i], expected[i]);
+
+    UA_Timer_clear(&timer);
+} END_TEST
+
+START_TEST(repeatedCallbackInterval) {
+    UA_Timer timer;
+    UA_Timer_init(&timer);
+    count = 0;
+
+    UA_DateTime start = UA_DateTime_nowMonotonic();
+    UA_UInt64 id = 0;
+    UA_StatusCode res =
+        UA_Timer_addRepeatedCallback(&timer, timerCallback, NULL, NULL, 10.0, NULL,
+                                     UA_TIMER_HANDLE_CYCLEMISS_WITH_CURRENTTIME, &id);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+
+    /* Advance in steps of 1ms */
+    for(size_t i = 1; i <= 1000; i++)
+        UA_Timer_process(&timer, start + (UA_DateTime)i * UA_DATETIME_MSEC);
+    ck_assert_uint_eq(count, 100);
+
+    /* Change the interval */
+    UA_fakeSleep(1000);
+    res = UA_Timer_changeRepeatedCallback(&timer, id, 100.0, NULL,
+                                          UA_TIMER_HANDLE_CYCLEMISS_WITH_CURRENTTIME);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(UA_Timer_nextRepeatedTime(&timer),
+                     UA_DateTime_nowMonotonic() + 100 * UA_DATETIME_MSEC);
+
+    /* Skip several cycles. With the CurrentTime policy the callback is executed
+     * only once and the next execution is one interval after now. */
+    count = 0;
+    UA_DateTime now = UA_DateTime_nowMonotonic() + 1050 * UA_DATETIME_MSEC;
+    UA_DateTime next = UA_Timer_process(&timer, now);
+    ck_assert_uint_eq(count, 1);
+    ck_assert_int_eq(next, now + 100 * UA_DATETIME_MSEC);
+
+    /* Remove the callback */
+    UA_Timer_removeCallback(&timer, id);
+    ck_assert_int_eq(UA_Timer_nextRepeatedTime(&timer), UA_INT64_MAX);
+    res = UA_Timer_changeRepeatedCallback(&timer, id, 100.0, NULL,
+                                          UA_TIMER_HANDLE_CYCLEMISS_WITH_CURRENTTIME);
+    ck_assert_int_eq(res, UA_STATUSCODE_BADNOTFOUND);
+
+    UA_Timer_clear(&timer);
+} END_TEST
+
+START_TEST(cycleMissBaseTime) {
+    UA_Timer timer;
+    UA_Timer_init(&timer);
+    count = 0;
+
+    UA_DateTime base = UA_DateTime_nowMonotonic();
+    UA_StatusCode res =
+        UA_Timer_addRepeatedCallback(&timer, timerCallback, NULL, NULL, 100.0, &base,
+                                     UA_TIMER_HANDLE_CYCLEMISS_WITH_BASETIME, NULL);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+
+    /* The next execution remains aligned with the base time */
+    UA_DateTime next = UA_Timer_process(&timer, base + 350 * UA_DATETIME_MSEC);
+    ck_assert_uint_eq(count, 1);
+    ck_assert_int_eq(next, base + 400 * UA_DATETIME_MSEC);
+
+    UA_Timer_clear(&timer);
+} END_TEST
+
+static UA_Timer *removeTimer;
+static UA_UInt64 removeIds[3];
+
+/* Removes itself and the other callbacks */
+static void
+removeCallback(void *application, void *data) {
+    count++;
+    for(size_t i = 0; i < 3; i++)
+        UA_Timer_removeCallback(removeTimer, removeIds[i]);
+}
+
+START_TEST(removeDuringProcessing) {
+    UA_Timer timer;
+    UA_Timer_init(&timer);
+    removeTimer = &timer;
+    count = 0;
+
+    UA_DateTime start = UA_DateTime_nowMonotonic();
+    for(size_t i = 0; i < 3; i++) {
+        UA_StatusCode res =
+            UA_Timer_addRepeatedCallback(&timer, removeCallback, NULL, NULL,
+                                         10.0 + (UA_Double)i, NULL,
+                                         UA_TIMER_HANDLE_CYCLEMISS_WITH_CURRENTTIME,
+                                         &removeIds[i]);
+        ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+    }
+
+    /* All three are due. Only the first is executed. */
+    UA_DateTime next = UA_Timer_process(&timer, start + 20 * UA_DATETIME_MSEC);
+    ck_assert_uint_eq(count, 1);
+    ck_assert_int_eq(next, UA_INT64_MAX);
+
+    UA_Timer_clear(&timer);
+} END_TEST
+
+START_TEST(farFutureCallback) {
+    UA_Timer timer;
+    UA_Timer_init(&timer);
+    count = 0;
+
+    /* Beyond the range of the timing wheel */
+    UA_DateTime start = UA_DateTime_nowMonotonic();
+    UA_DateTime far = start + (UA_DateTime)1000 * 24 * 3600 * UA_DATETIME_SEC;
+    UA_StatusCode res =
+        UA_Timer_addTimedCallback(&timer, timerCallback, NULL, NULL, far, NULL);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Timer_addTimedCallback(&timer, timerCallback, NULL, NULL,
+                                    far + UA_DATETIME_SEC, NULL);
+    ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(UA_Timer_nextRepeatedTime(&timer), far);
+
+    UA_DateTime next = UA_Timer_process(&timer, far - 1);
+    ck_assert_uint_eq(count, 0);
+    ck_assert_int_eq(next, far);
+
+    next = UA_Timer_process(&timer, far);
+    ck_assert_uint_eq(count, 1);
+    ck_assert_int_eq(next, far + UA_DATETIME_SEC);
+
+    next = UA_Timer_process(&timer, far + UA_DATETIME_SEC);
+    ck_assert_uint_eq(count, 2);
+    ck_assert_int_eq(next, UA_INT64_MAX);
+
+    UA_Timer_clear(&timer);
+} END_TEST
+
+/* Many repeated callbacks with a few distinct intervals. This is the typical
+ * load with many MonitoredItems. Measures the cost of adding, processing and
+ * removing callbacks. */
+START_TEST(benchmarkTimerManyCallbacks) {
+    const UA_Double intervals[5] = {50.0, 100.0, 250.0, 1000.0, 5000.0};
+    UA_UInt64 *ids = (UA_UInt64*)UA_malloc(N_BENCH_EVENTS * sizeof(UA_UInt64));
+    ck_assert_ptr_ne(ids, NULL);
+
+    UA_Timer timer;
+    UA_Timer_init(&timer);
+    count = 0;
+
+    clock_t begin = clock();
+    for(size_t i = 0; i < N_BENCH_EVENTS; i++) {
+        UA_StatusCode res =
+            UA_Timer_addRepeatedCallback(&timer, timerCallback, NULL, NULL,
+                                         intervals[i % 5] + (UA_Double)(i % 7),
+                                         NULL, UA_TIMER_HANDLE_CYCLEMISS_WITH_CURRENTTIME,
+                                         &ids[i]);
+        ck_assert_int_eq(res, UA_STATUSCODE_GOOD);
+    }
+    clock_t added = clock();
+
+    /* Process for one second in steps of 10 ms */
+    UA_DateTime now = UA_DateTime_nowMonotonic();
+    for(size_t i = 0; i < 100; i++) {
+        now += 10 * UA_DATETIME_MSEC;
+        UA_Timer_process(&timer, now);
+    }
+    clock_t processed = clock();
+
+    for(size_t i = 0; i < N_BENCH_EVENTS; i++)
+        UA_Timer_removeCallback(&timer, ids[i]);
+    clock_t removed = clock();
+    ck_assert_int_eq(UA_Timer_nextRepeatedTime(&timer), UA_INT64_MAX);
+
+    printf("%s: add %f s, process %f s (%lu callbacks), remove %f s\n", TIMER_IMPL,
+           (double)(added - begin) / CLOCKS_PER_SEC,
+           (double)(processed - added) / CLOCKS_PER_SEC, (unsigned long)count,
+           (double)(removed - processed) / CLOCKS_PER_SEC);
+
+    UA_Timer_clear(&timer);
+    UA_free(ids);
+} END_TEST
+
 int main(void) {
     Suite *s  = suite_create("Test Event Timer");
     TCase *tc = tcase_create("test cases");
+    tcase_add_test(tc, timedCallbackOrder);
+    tcase_add_test(tc, repeatedCallbackInterval);
+    tcase_add_test(tc, cycleMissBaseTime);
+    tcase_add_test(tc, removeDuringProcessing);
+    tcase_add_test(tc, farFutureCallback);
     tcase_add_test(tc, benchmarkTimer);
+    tcase_add_test(tc, benchmarkTimerManyCallbacks);
     suite_add_tcase(s, tc);
 
     SRunner *sr = srunner_create(s);
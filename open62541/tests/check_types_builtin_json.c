@@ -5295,6 +5295,35 @@ START_TEST(UA_DataTypeAttributes_json_decode) {
 }
 END_TEST
 
+START_TEST(UA_DataTypeAttributes_reorderedKeys_json_decode) {
+    UA_DataTypeAttributes out;
+    UA_DataTypeAttributes_init(&out);
+    UA_ByteString buf = UA_STRING("{\"IsAbstract\":true,"
+            "\"UserWriteMask\":63,"
+            "\"WriteMask\":53,"
+            "\"Description\":{\"Locale\":\"t3\",\"Text\":\"t4\"},"
+            "\"SpecifiedAttributes\":1}");
+    UA_StatusCode retval =
+        UA_decodeJson(&buf, &out, &UA_TYPES[UA_TYPES_DATATYPEATTRIBUTES], NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(out.isAbstract, true);
+    ck_assert_int_eq(out.writeMask, 53);
+    ck_assert_int_eq(out.userWriteMask, 63);
+    ck_assert_int_eq(out.specifiedAttributes, 1);
+    ck_assert_int_eq(out.description.text.data[1], '4');
+    ck_assert_uint_eq(out.displayName.text.length, 0);
+    UA_DataTypeAttributes_clear(&out);
+
+    /* Duplicate and unknown keys are rejected */
+    buf = UA_STRING("{\"WriteMask\":53,\"IsAbstract\":true,\"WriteMask\":53}");
+    retval = UA_decodeJson(&buf, &out, &UA_TYPES[UA_TYPES_DATATYPEATTRIBUTES], NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_BADDECODINGERROR);
+    buf = UA_STRING("{\"WriteMask\":53,\"IsAbstrac\":true}");
+    retval = UA_decodeJson(&buf, &out, &UA_TYPES[UA_TYPES_DATATYPEATTRIBUTES], NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_BADDECODINGERROR);
+}
+END_TEST
+
 //-------------------MISC heap free test cases--------------------------
 START_TEST(UA_VariantStringArrayBad_shouldFreeArray_json_decode) {
     // given
@@ -5465,6 +5494,131 @@ START_TEST(UA_Boolean_true_public_json_encode) {
 }
 END_TEST
 
+/* ----------------- Stream Decoding ---------------------*/
+typedef struct {
+    const UA_DataType *type;
+    const char **expected; /* Compare with the standard decoding */
+    size_t count;
+} StreamCheck;
+
+static UA_StatusCode
+checkStreamValue(void *context, void *value) {
+    StreamCheck *sc = (StreamCheck*)context;
+    UA_Byte expected[256];
+    UA_ByteString buf = UA_STRING((char*)(uintptr_t)sc->expected[sc->count]);
+    UA_StatusCode ret = UA_decodeJson(&buf, expected, sc->type, NULL);
+    ck_assert_uint_eq(ret, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(UA_order(value, expected, sc->type), UA_ORDER_EQ);
+    UA_clear(expected, sc->type);
+    sc->count++;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+decodeStreamChunked(const char *json, size_t chunkSize, StreamCheck *sc) {
+    UA_DecodeJsonStream *stream =
+        UA_DecodeJsonStream_new(sc->type, NULL, checkStreamValue, sc);
+    ck_assert_ptr_ne(stream, NULL);
+    UA_StatusCode ret = UA_STATUSCODE_GOOD;
+    size_t len = strlen(json);
+    for(size_t pos = 0; pos < len && ret == UA_STATUSCODE_GOOD; pos += chunkSize) {
+        UA_ByteString chunk;
+        chunk.data = (UA_Byte*)(uintptr_t)&json[pos];
+        chunk.length = (len - pos < chunkSize) ? len - pos : chunkSize;
+        ret = UA_DecodeJsonStream_decode(stream, &chunk);
+    }
+    if(ret == UA_STATUSCODE_GOOD)
+        ret = UA_DecodeJsonStream_finish(stream);
+    UA_DecodeJsonStream_delete(stream);
+    return ret;
+}
+
+START_TEST(UA_DecodeJsonStream_array) {
+    const char *values[] = {
+        "{\"Type\":6,\"Body\":-42}",
+        "{\"Type\":12,\"Body\":\"Lindestra\\u00dfe\"}",
+        "{\"Type\":1,\"Body\":true}",
+        "{\"Type\":11,\"Body\":[1.5,2,3e10]}",
+        "{\"Type\":7,\"Body\":[4294967295,0],\"Dimension\":[1,2]}",
+        "{}"
+    };
+    const size_t valuesSize = sizeof(values) / sizeof(values[0]);
+
+    /* Enough values to exceed the token limit of a single document */
+    char json[16384];
+    size_t pos = 0;
+    const char *expected[300];
+    json[pos++] = '[';
+    for(size_t i = 0; i < 300; i++) {
+        expected[i] = values[i % valuesSize];
+        pos += (size_t)snprintf(&json[pos], sizeof(json) - pos, "%s%s\n",
+                                (i > 0) ? ", " : "", expected[i]);
+    }
+    json[pos++] = ']';
+    json[pos] = 0;
+
+    size_t chunkSizes[] = {1, 7, 64, sizeof(json)};
+    for(size_t i = 0; i < 4; i++) {
+        StreamCheck sc = {&UA_TYPES[UA_TYPES_VARIANT], expected, 0};
+        UA_StatusCode ret = decodeStreamChunked(json, chunkSizes[i], &sc);
+        ck_assert_uint_eq(ret, UA_STATUSCODE_GOOD);
+        ck_assert_uint_eq(sc.count, 300);
+    }
+}
+END_TEST
+
+START_TEST(UA_DecodeJsonStream_sequence) {
+    /* Values separated by whitespace or commas. The last value is only
+     * delimited by the end of the input. */
+    const char *expected[] = {"true", "false", "false", "true"};
+    StreamCheck sc = {&UA_TYPES[UA_TYPES_BOOLEAN], expected, 0};
+    UA_StatusCode ret = decodeStreamChunked("true false\n/* c */ false // x\n,true", 1, &sc);
+    ck_assert_uint_eq(ret, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(sc.count, 4);
+
+    const char *numbers[] = {"123", "-4", "5"};
+    StreamCheck sc2 = {&UA_TYPES[UA_TYPES_INT32], numbers, 0};
+    ret = decodeStreamChunked("123\n-4,5", 2, &sc2);
+    ck_assert_uint_eq(ret, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(sc2.count, 3);
+}
+END_TEST
+
+START_TEST(UA_DecodeJsonStream_bad) {
+    const char *expected[] = {"1", "2", "3"};
+    const char *bad[] = {
+        "[1,2",         /* Unterminated array */
+        "[1,2] 3",      /* Content after the array */
+        "[1 2]",        /* Missing comma in the array */
+        "1, {\"a\":",   /* Truncated value */
+        "1 \"x\"",      /* Wrong type */
+        "1 2 ]"         /* Closing an array that was not opened */
+    };
+    for(size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        for(size_t chunkSize = 1; chunkSize < 4; chunkSize++) {
+            StreamCheck sc = {&UA_TYPES[UA_TYPES_INT32], expected, 0};
+            UA_StatusCode ret = decodeStreamChunked(bad[i], chunkSize, &sc);
+            ck_assert_uint_eq(ret, UA_STATUSCODE_BADDECODINGERROR);
+        }
+    }
+
+    /* Errors are sticky */
+    StreamCheck sc = {&UA_TYPES[UA_TYPES_INT32], expected, 0};
+    UA_DecodeJsonStream *stream =
+        UA_DecodeJsonStream_new(sc.type, NULL, checkStreamValue, &sc);
+    UA_ByteString chunk = UA_STRING("1 x ");
+    ck_assert_uint_eq(UA_DecodeJsonStream_decode(stream, &chunk),
+                      UA_STATUSCODE_BADDECODINGERROR);
+    chunk = UA_STRING("2 ");
+    ck_assert_uint_eq(UA_DecodeJsonStream_decode(stream, &chunk),
+                      UA_STATUSCODE_BADDECODINGERROR);
+    ck_assert_uint_eq(UA_DecodeJsonStream_finish(stream),
+                      UA_STATUSCODE_BADDECODINGERROR);
+    ck_assert_uint_eq(sc.count, 1);
+    UA_DecodeJsonStream_delete(stream);
+}
+END_TEST
+
 static Suite *testSuite_builtin_json(void) {
     Suite *s = suite_create("Built-in Data Types 62541-6 Json");
 
@@ -5826,6 +5980,7 @@ static Suite *testSuite_builtin_json(void) {
 
     tcase_add_test(tc_json_decode, UA_ViewDescription_json_decode);
     tcase_add_test(tc_json_decode, UA_DataTypeAttributes_json_decode);
+    tcase_add_test(tc_json_decode, UA_DataTypeAttributes_reorderedKeys_json_decode);
 
 
     tcase_add_test(tc_json_decode, UA_VariantStringArrayBad_shouldFreeArray_json_decode);
@@ -5842,6 +5997,10 @@ static Suite *testSuite_builtin_json(void) {
     tcase_add_test(tc_json_decode, UA_VariantBool_public_json_decode);
     tcase_add_test(tc_json_decode, UA_Boolean_true_public_json_encode);
 
+    tcase_add_test(tc_json_decode, UA_DecodeJsonStream_array);
+    tcase_add_test(tc_json_decode, UA_DecodeJsonStream_sequence);
+    tcase_add_test(tc_json_decode, UA_DecodeJsonStream_bad);
+
     suite_add_tcase(s, tc_json_decode);
 
     TCase *tc_json_helper = tcase_create("json_helper");
@@ -80,7 +80,7 @@ static const UA_DataType PointType = {
     members
 };
 
-const UA_DataTypeArray customDataTypes = {NULL, 1, &PointType, UA_FALSE};
+const UA_DataTypeArray customDataTypes = {NULL, 1, &PointType, UA_FALSE, NULL};
 
 typedef struct {
     UA_Int16 a;
@@ -139,7 +139,7 @@ static const UA_DataType OptType = {
         Opt_members
 };
 
-const UA_DataTypeArray customDataTypesOptStruct = {&customDataTypes, 2, &OptType, UA_FALSE};
+const UA_DataTypeArray customDataTypesOptStruct = {&customDataTypes, 2, &OptType, UA_FALSE, NULL};
 
 typedef struct {
     UA_String description;
@@ -197,7 +197,7 @@ static const UA_DataType ArrayOptType = {
     ArrayOptStruct_members
 };
 
-const UA_DataTypeArray customDataTypesOptArrayStruct = {&customDataTypesOptStruct, 3, &ArrayOptType, UA_FALSE};
+const UA_DataTypeArray customDataTypesOptArrayStruct = {&customDataTypesOptStruct, 3, &ArrayOptType, UA_FALSE, NULL};
 
 typedef enum {UA_UNISWITCH_NONE = 0, UA_UNISWITCH_OPTIONA = 1, UA_UNISWITCH_OPTIONB = 2} UA_UniSwitch;
 
@@ -238,7 +238,7 @@ static const UA_DataType UniType = {
         Uni_members
 };
 
-const UA_DataTypeArray customDataTypesUnion = {&customDataTypesOptArrayStruct, 2, &UniType, UA_FALSE};
+const UA_DataTypeArray customDataTypesUnion = {&customDataTypesOptArrayStruct, 2, &UniType, UA_FALSE, NULL};
 
 typedef enum {
     UA_SELFCONTAININGUNIONSWITCH_NONE = 0,
@@ -289,7 +289,7 @@ const UA_DataType selfContainingUnionType = {
     SelfContainingUnion_members  /* .members */
 };
 
-const UA_DataTypeArray customDataTypesSelfContainingUnion = {NULL, 1, &selfContainingUnionType, UA_FALSE};
+const UA_DataTypeArray customDataTypesSelfContainingUnion = {NULL, 1, &selfContainingUnionType, UA_FALSE, NULL};
 
 START_TEST(parseCustomScalar) {
     Point p;
@@ -697,6 +697,120 @@ START_TEST(parseSelfContainingUnionSelfMember) {
         UA_ByteString_clear(&buf);
     } END_TEST
 
+START_TEST(findBuiltinTypes) {
+    for(size_t i = 0; i < UA_TYPES_COUNT; i++) {
+        const UA_DataType *type = UA_findDataType(&UA_TYPES[i].typeId);
+        ck_assert(type != NULL);
+        ck_assert(UA_NodeId_equal(&type->typeId, &UA_TYPES[i].typeId));
+        type = UA_findDataTypeByBinary(&UA_TYPES[i].binaryEncodingId);
+        ck_assert(type != NULL);
+        ck_assert(UA_NodeId_equal(&type->binaryEncodingId,
+                                  &UA_TYPES[i].binaryEncodingId));
+    }
+    UA_NodeId unknown = UA_NODEID_NUMERIC(0, 999999);
+    ck_assert(UA_findDataType(&unknown) == NULL);
+    ck_assert(UA_findDataTypeByBinary(&unknown) == NULL);
+} END_TEST
+
+#define INDEXED_TYPES 500
+
+START_TEST(findCustomTypesWithIndex) {
+    /* Every second type has a string NodeId */
+    UA_DataType *types = (UA_DataType*)UA_calloc(INDEXED_TYPES, sizeof(UA_DataType));
+    char name[32];
+    for(size_t i = 0; i < INDEXED_TYPES; i++) {
+        types[i] = PointType;
+        if(i % 2 == 0) {
+            types[i].typeId = UA_NODEID_NUMERIC(1, (UA_UInt32)(1000 + i));
+            types[i].binaryEncodingId = UA_NODEID_NUMERIC(1, (UA_UInt32)(5000 + i));
+        } else {
+            snprintf(name, sizeof(name), "type-%u", (unsigned)i);
+            UA_NodeId id = UA_NODEID_STRING(1, name);
+            UA_NodeId_copy(&id, &types[i].typeId);
+            snprintf(name, sizeof(name), "encoding-%u", (unsigned)i);
+            id = UA_NODEID_STRING(1, name);
+            UA_NodeId_copy(&id, &types[i].binaryEncodingId);
+        }
+    }
+
+    UA_DataTypeArray customTypes = {&customDataTypes, INDEXED_TYPES, types, false, NULL};
+    UA_StatusCode res = UA_DataTypeArray_buildIndex(&customTypes);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(customTypes.index != NULL);
+
+    /* The namespace index may change after the index was built */
+    for(size_t i = 0; i < INDEXED_TYPES; i++) {
+        types[i].typeId.namespaceIndex = 2;
+        types[i].binaryEncodingId.namespaceIndex = 2;
+    }
+
+    for(size_t i = 0; i < INDEXED_TYPES; i++) {
+        ck_assert(UA_findDataTypeWithCustom(&types[i].typeId, &customTypes) == &types[i]);
+        ck_assert(UA_findDataTypeByBinaryWithCustom(&types[i].binaryEncodingId,
+                                                    &customTypes) == &types[i]);
+        UA_NodeId otherNs = types[i].typeId;
+        otherNs.namespaceIndex = 1;
+        ck_assert(UA_findDataTypeWithCustom(&otherNs, &customTypes) == NULL);
+    }
+
+    /* The next array in the chain has no index */
+    ck_assert(UA_findDataTypeWithCustom(&PointType.typeId, &customTypes) == &PointType);
+
+    /* Decode an ExtensionObject with the indexed type */
+    UA_ExtensionObject eo;
+    UA_ExtensionObject_init(&eo);
+    Point p = {1.0, 2.0, 3.0};
+    eo.encoding = UA_EXTENSIONOBJECT_DECODED_NODELETE;
+    eo.content.decoded.data = &p;
+    eo.content.decoded.type = &types[INDEXED_TYPES - 2];
+    UA_ByteString buf = UA_BYTESTRING_NULL;
+    res = UA_encodeBinary(&eo, &UA_TYPES[UA_TYPES_EXTENSIONOBJECT], &buf);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_ExtensionObject eo2;
+    size_t offset = 0;
+    res = UA_decodeBinaryInternal(&buf, &offset, &eo2,
+                                  &UA_TYPES[UA_TYPES_EXTENSIONOBJECT], &customTypes);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(eo2.encoding, UA_EXTENSIONOBJECT_DECODED);
+    ck_assert(eo2.content.decoded.type == &types[INDEXED_TYPES - 2]);
+    UA_ExtensionObject_clear(&eo2);
+    UA_ByteString_clear(&buf);
+
+    UA_DataTypeArray_clearIndex(&customTypes);
+    ck_assert(customTypes.index == NULL);
+    for(size_t i = 0; i < INDEXED_TYPES; i++) {
+        UA_NodeId_clear(&types[i].typeId);
+        UA_NodeId_clear(&types[i].binaryEncodingId);
+    }
+    UA_free(types);
+} END_TEST
+
+/* The index of the generated (static) arrays uses static storage */
+static UA_DATATYPEINDEX_STORAGE(staticIndexStorage, 1);
+
+START_TEST(findCustomTypesWithStaticIndex) {
+    UA_DataTypeArray customTypes = {NULL, 1, &PointType, false, NULL};
+
+    /* The storage is too small */
+    void *small[4];
+    UA_StatusCode res = UA_DataTypeArray_buildIndexStatic(&customTypes, small,
+                                                          sizeof(small));
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADINVALIDARGUMENT);
+    ck_assert(customTypes.index == NULL);
+
+    res = UA_DataTypeArray_buildIndexStatic(&customTypes, staticIndexStorage,
+                                            sizeof(staticIndexStorage));
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(customTypes.index != NULL);
+    ck_assert(UA_findDataTypeWithCustom(&PointType.typeId, &customTypes) == &PointType);
+    ck_assert(UA_findDataTypeByBinaryWithCustom(&PointType.binaryEncodingId,
+                                                &customTypes) == &PointType);
+
+    /* The static storage is not freed */
+    UA_DataTypeArray_clearIndex(&customTypes);
+    ck_assert(customTypes.index == NULL);
+} END_TEST
+
 int main(void) {
     Suite *s  = suite_create("Test Custom DataType Encoding");
     TCase *tc = tcase_create("test cases");
@@ -709,6 +823,9 @@ int main(void) {
     tcase_add_test(tc, parseSelfContainingUnionSelfMember);
     tcase_add_test(tc, parseCustomStructureWithOptionalFieldsWithArrayNotContained);
     tcase_add_test(tc, parseCustomStructureWithOptionalFieldsWithArrayContained);
+    tcase_add_test(tc, findBuiltinTypes);
+    tcase_add_test(tc, findCustomTypesWithIndex);
+    tcase_add_test(tc, findCustomTypesWithStaticIndex);
     suite_add_tcase(s, tc);
 
     SRunner *sr = srunner_create(s);
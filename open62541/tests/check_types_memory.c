@@ -12,6 +12,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include "check.h"
 
@@ -226,6 +227,246 @@ START_TEST(calcSizeBinaryShallBeCorrect) {
 }
 END_TEST
 
+START_TEST(arenaDecodeShallYieldDecode) {
+    /* Encode the default value */
+    UA_ByteString msg = UA_BYTESTRING_NULL;
+    void *obj1 = UA_new(&UA_TYPES[_i]);
+    UA_StatusCode retval = UA_encodeBinary(obj1, &UA_TYPES[_i], &msg);
+    if(retval != UA_STATUSCODE_GOOD) {
+        UA_delete(obj1, &UA_TYPES[_i]);
+        return;
+    }
+
+    /* Decode into the arena */
+    UA_Arena arena;
+    UA_Arena_init(&arena, 128);
+    void *obj2 = UA_new(&UA_TYPES[_i]);
+    size_t offset = 0;
+    retval = UA_decodeBinaryInternalArena(&msg, &offset, obj2, &UA_TYPES[_i],
+                                          NULL, &arena, true);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(offset, msg.length);
+    ck_assert(UA_order(obj1, obj2, &UA_TYPES[_i]) == UA_ORDER_EQ);
+
+    /* Release the decoded value with the arena. Not with UA_delete. */
+    UA_Arena_clear(&arena);
+    UA_free(obj2);
+    UA_delete(obj1, &UA_TYPES[_i]);
+    UA_ByteString_clear(&msg);
+}
+END_TEST
+
+START_TEST(arenaDecodeTruncatedBufferShallSurvive) {
+    UA_ByteString msg1;
+    void *obj1 = UA_new(&UA_TYPES[_i]);
+    UA_StatusCode retval = UA_ByteString_allocBuffer(&msg1, 65000);
+    UA_Byte *pos = msg1.data;
+    const UA_Byte *end = &msg1.data[msg1.length];
+    retval |= UA_encodeBinaryInternal(obj1, &UA_TYPES[_i], &pos, &end, NULL, NULL);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    UA_delete(obj1, &UA_TYPES[_i]);
+    msg1.length = (uintptr_t)(pos - msg1.data) / 2;
+
+    UA_Arena arena;
+    UA_Arena_init(&arena, 0);
+    void *obj2 = UA_new(&UA_TYPES[_i]);
+    size_t offset = 0;
+    retval = UA_decodeBinaryInternalArena(&msg1, &offset, obj2, &UA_TYPES[_i],
+                                          NULL, &arena, true);
+    ck_assert_int_ne(retval, UA_STATUSCODE_GOOD);
+    UA_Arena_clear(&arena);
+    UA_free(obj2);
+    msg1.length = 65000;
+    UA_ByteString_clear(&msg1);
+}
+END_TEST
+
+START_TEST(arenaResetShallReuseBlock) {
+    UA_Arena arena;
+    UA_Arena_init(&arena, 256);
+
+    /* Allocations are aligned and zeroed */
+    UA_Byte *p1 = (UA_Byte*)UA_Arena_alloc(&arena, 3);
+    UA_Byte *p2 = (UA_Byte*)UA_Arena_alloc(&arena, 8);
+    ck_assert_ptr_ne(p1, NULL);
+    ck_assert_ptr_ne(p2, NULL);
+    ck_assert_uint_eq((uintptr_t)p1 % 8, 0);
+    ck_assert_uint_eq((uintptr_t)p2 % 8, 0);
+    ck_assert_uint_eq(p1[0] | p1[1] | p1[2], 0);
+    memset(p2, 0xff, 8);
+
+    /* A large allocation gets its own block */
+    void *big = UA_Arena_alloc(&arena, 10000);
+    ck_assert_ptr_ne(big, NULL);
+    ck_assert_uint_eq(arena.allocations, 3);
+    ck_assert_uint_eq(arena.blockAllocations, 2);
+
+    /* The block size grows after more than one block was used */
+    UA_Arena_reset(&arena);
+    ck_assert_uint_ge(arena.blockSize, 10000);
+    ck_assert_uint_eq(arena.allocations, 0);
+
+    /* The next round of allocations fits into a single block */
+    for(size_t i = 0; i < 2; i++) {
+        big = UA_Arena_alloc(&arena, 10000);
+        ck_assert_ptr_ne(big, NULL);
+        UA_Arena_reset(&arena);
+    }
+    big = UA_Arena_alloc(&arena, 10000);
+    ck_assert_uint_eq(arena.blockAllocations, 0);
+
+    /* Memory from a kept block is zeroed again */
+    UA_Arena_reset(&arena);
+    UA_Byte *p3 = (UA_Byte*)UA_Arena_alloc(&arena, 8);
+    for(size_t i = 0; i < 8; i++)
+        ck_assert_uint_eq(p3[i], 0);
+
+    UA_Arena_clear(&arena);
+}
+END_TEST
+
+START_TEST(zeroCopyDecodeShallReferenceBuffer) {
+    UA_Double doubles[3] = {1.0, 2.0, 3.0};
+    UA_WriteValue wv[2];
+    UA_WriteValue_init(&wv[0]);
+    UA_WriteValue_init(&wv[1]);
+    wv[0].nodeId = UA_NODEID_STRING(1, "bytes");
+    wv[0].value.hasValue = true;
+    UA_ByteString payload = UA_BYTESTRING("large payload");
+    UA_Variant_setScalar(&wv[0].value.value, &payload, &UA_TYPES[UA_TYPES_BYTESTRING]);
+    wv[1].nodeId = UA_NODEID_NUMERIC(1, 42);
+    wv[1].value.hasValue = true;
+    UA_Variant_setArray(&wv[1].value.value, doubles, 3, &UA_TYPES[UA_TYPES_DOUBLE]);
+    UA_WriteRequest request;
+    UA_WriteRequest_init(&request);
+    request.nodesToWrite = wv;
+    request.nodesToWriteSize = 2;
+
+    UA_ByteString msg = UA_BYTESTRING_NULL;
+    UA_StatusCode retval = UA_encodeBinary(&request, &UA_TYPES[UA_TYPES_WRITEREQUEST], &msg);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_Arena arena;
+    UA_Arena_init(&arena, 0);
+    UA_DecodeBinaryOptions opts;
+    memset(&opts, 0, sizeof(UA_DecodeBinaryOptions));
+    opts.arena = &arena;
+    opts.zeroCopy = true;
+    UA_WriteRequest decoded;
+    retval = UA_decodeBinary(&msg, &decoded, &UA_TYPES[UA_TYPES_WRITEREQUEST], &opts);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(UA_order(&decoded, &request, &UA_TYPES[UA_TYPES_WRITEREQUEST]) == UA_ORDER_EQ);
+
+    /* The strings point into the message buffer */
+    const UA_Byte *begin = msg.data;
+    const UA_Byte *end = &msg.data[msg.length];
+    UA_String *s = &decoded.nodesToWrite[0].nodeId.identifier.string;
+    ck_assert(s->data >= begin && s->data + s->length <= end);
+    UA_ByteString *b = (UA_ByteString*)decoded.nodesToWrite[0].value.value.data;
+    ck_assert(b->data >= begin && b->data + b->length <= end);
+
+    /* The double array is only referenced if it is aligned in the buffer */
+    const UA_Byte *d = (const UA_Byte*)decoded.nodesToWrite[1].value.value.data;
+    if(d >= begin && d < end)
+        ck_assert_uint_eq((uintptr_t)d % sizeof(UA_Double), 0);
+
+    /* Without the arena, zeroCopy has no effect */
+    opts.arena = NULL;
+    retval = UA_decodeBinary(&msg, &decoded, &UA_TYPES[UA_TYPES_WRITEREQUEST], &opts);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    s = &decoded.nodesToWrite[0].nodeId.identifier.string;
+    ck_assert(s->data < begin || s->data >= end);
+    UA_WriteRequest_clear(&decoded);
+
+    UA_Arena_clear(&arena);
+    UA_ByteString_clear(&msg);
+}
+END_TEST
+
+#define ARENA_BENCH_NODES 100
+#define ARENA_BENCH_ROUNDS 2000
+
+/* Decode a WriteRequest with string NodeIds and string array values. Compare
+ * the individual heap allocations with the decoding into an arena. */
+START_TEST(arenaDecodeSpeed) {
+    UA_WriteValue wv[ARENA_BENCH_NODES];
+    UA_String strings[4] = {UA_STRING_STATIC("alpha"), UA_STRING_STATIC("beta"),
+                            UA_STRING_STATIC("gamma"), UA_STRING_STATIC("delta")};
+    for(size_t i = 0; i < ARENA_BENCH_NODES; i++) {
+        UA_WriteValue_init(&wv[i]);
+        wv[i].nodeId = UA_NODEID_STRING(1, "Demo.Static.Arrays.String");
+        wv[i].attributeId = UA_ATTRIBUTEID_VALUE;
+        wv[i].value.hasValue = true;
+        UA_Variant_setArray(&wv[i].value.value, strings, 4, &UA_TYPES[UA_TYPES_STRING]);
+    }
+    UA_WriteRequest request;
+    UA_WriteRequest_init(&request);
+    request.nodesToWrite = wv;
+    request.nodesToWriteSize = ARENA_BENCH_NODES;
+
+    UA_ByteString msg = UA_BYTESTRING_NULL;
+    UA_StatusCode retval = UA_encodeBinary(&request, &UA_TYPES[UA_TYPES_WRITEREQUEST], &msg);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Decode with individual heap allocations */
+    UA_WriteRequest decoded;
+    clock_t begin = clock();
+    for(size_t i = 0; i < ARENA_BENCH_ROUNDS; i++) {
+        retval |= UA_decodeBinary(&msg, &decoded, &UA_TYPES[UA_TYPES_WRITEREQUEST], NULL);
+        UA_WriteRequest_clear(&decoded);
+    }
+    clock_t heapTime = clock() - begin;
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Decode into the arena */
+    UA_Arena arena;
+    UA_Arena_init(&arena, 0);
+    UA_DecodeBinaryOptions opts;
+    memset(&opts, 0, sizeof(UA_DecodeBinaryOptions));
+    opts.arena = &arena;
+    size_t allocations = 0;
+    size_t blockAllocations = 0;
+    begin = clock();
+    for(size_t i = 0; i < ARENA_BENCH_ROUNDS; i++) {
+        retval |= UA_decodeBinary(&msg, &decoded, &UA_TYPES[UA_TYPES_WRITEREQUEST], &opts);
+        allocations += arena.allocations;
+        blockAllocations += arena.blockAllocations;
+        UA_Arena_reset(&arena);
+    }
+    clock_t arenaTime = clock() - begin;
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Decode into the arena with the strings pointing into the buffer */
+    opts.zeroCopy = true;
+    begin = clock();
+    for(size_t i = 0; i < ARENA_BENCH_ROUNDS; i++) {
+        retval |= UA_decodeBinary(&msg, &decoded, &UA_TYPES[UA_TYPES_WRITEREQUEST], &opts);
+        UA_Arena_reset(&arena);
+    }
+    clock_t zeroCopyTime = clock() - begin;
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    opts.zeroCopy = false;
+
+    /* The arena has adapted its block size. Steady state needs no heap
+     * allocation. */
+    retval = UA_decodeBinary(&msg, &decoded, &UA_TYPES[UA_TYPES_WRITEREQUEST], &opts);
+    ck_assert_int_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(arena.blockAllocations, 0);
+    ck_assert(UA_order(&decoded, &request, &UA_TYPES[UA_TYPES_WRITEREQUEST]) == UA_ORDER_EQ);
+    UA_Arena_clear(&arena);
+
+    printf("heap decoding:  %.0f ns/op, %.1f allocations/op\n",
+           (double)heapTime * 1e9 / CLOCKS_PER_SEC / ARENA_BENCH_ROUNDS,
+           (double)allocations / ARENA_BENCH_ROUNDS);
+    printf("arena decoding: %.0f ns/op, %.3f allocations/op\n",
+           (double)arenaTime * 1e9 / CLOCKS_PER_SEC / ARENA_BENCH_ROUNDS,
+           (double)blockAllocations / ARENA_BENCH_ROUNDS);
+    printf("zero-copy decoding: %.0f ns/op\n",
+           (double)zeroCopyTime * 1e9 / CLOCKS_PER_SEC / ARENA_BENCH_ROUNDS);
+    UA_ByteString_clear(&msg);
+}
+END_TEST
+
 int main(void) {
     int number_failed = 0;
     SRunner *sr;
@@ -248,6 +489,15 @@ int main(void) {
                         UA_TYPES_NODEID, UA_TYPES_COUNT - 1);
     suite_add_tcase(s, tc);
 
+    tc = tcase_create("Arena Decoding");
+    tcase_add_test(tc, arenaResetShallReuseBlock);
+    tcase_add_loop_test(tc, arenaDecodeShallYieldDecode, UA_TYPES_BOOLEAN, UA_TYPES_COUNT - 1);
+    tcase_add_loop_test(tc, arenaDecodeTruncatedBufferShallSurvive,
+                        UA_TYPES_BOOLEAN, UA_TYPES_COUNT - 1);
+    tcase_add_test(tc, zeroCopyDecodeShallReferenceBuffer);
+    tcase_add_test(tc, arenaDecodeSpeed);
+    suite_add_tcase(s, tc);
+
     tc = tcase_create("Test calcSizeBinary");
     tcase_add_loop_test(tc, calcSizeBinaryShallBeCorrect, UA_TYPES_BOOLEAN, UA_TYPES_COUNT - 1);
     suite_add_tcase(s, tc);
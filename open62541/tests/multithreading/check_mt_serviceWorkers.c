@@ -0,0 +1,174 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/plugin/log_stdout.h>
+#include <open62541/client_config_default.h>
+#include <open62541/client_highlevel.h>
+#include <open62541/client_highlevel_async.h>
+#include <check.h>
+#include <stdlib.h>
+#include "thread_wrapper.h"
+#include "mt_testing.h"
+#include "testing_clock.h"
+
+#define NUMBER_OF_WORKERS 0
+#define NUMBER_OF_CLIENTS 6
+#define ITERATIONS_PER_CLIENT 5
+#define REQUESTS_PER_ITERATION 6
+
+UA_NodeId slowNodeId = {1, UA_NODEIDTYPE_NUMERIC, {1001}};
+UA_NodeId fastNodeId = {1, UA_NODEIDTYPE_NUMERIC, {1002}};
+
+/* Track how many read callbacks execute in parallel */
+static volatile int activeReaders;
+static volatile int maxActiveReaders;
+
+static UA_StatusCode
+readSlow(UA_Server *server, const UA_NodeId *sessionId,
+         void *sessionContext, const UA_NodeId *nodeId, void *nodeContext,
+         UA_Boolean includeSourceTimeStamp, const UA_NumericRange *range,
+         UA_DataValue *value) {
+    int active = UA_atomic_addInt(&activeReaders, 1);
+    int max = maxActiveReaders;
+    while(active > max) {
+        int old = UA_atomic_cmpxchgInt(&maxActiveReaders, max, active);
+        if(old == max)
+            break;
+        max = old;
+    }
+    UA_realSleep(10);
+    UA_atomic_addInt(&activeReaders, -1);
+
+    UA_Int32 v = 42;
+    value->hasValue = true;
+    return UA_Variant_setScalarCopy(&value->value, &v, &UA_TYPES[UA_TYPES_INT32]);
+}
+
+static void
+addNodes(void) {
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    attr.displayName = UA_LOCALIZEDTEXT("en-US","Slow");
+    attr.accessLevel = UA_ACCESSLEVELMASK_READ;
+    UA_DataSource ds;
+    ds.read = readSlow;
+    ds.write = NULL;
+    UA_StatusCode res =
+        UA_Server_addDataSourceVariableNode(tc.server, slowNodeId,
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                            UA_QUALIFIEDNAME(1, "Slow"),
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                            attr, ds, NULL, NULL);
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, res);
+
+    attr = UA_VariableAttributes_default;
+    UA_Int32 myInteger = 42;
+    UA_Variant_setScalar(&attr.value, &myInteger, &UA_TYPES[UA_TYPES_INT32]);
+    attr.displayName = UA_LOCALIZEDTEXT("en-US","Fast");
+    res = UA_Server_addVariableNode(tc.server, fastNodeId,
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                    UA_QUALIFIEDNAME(1, "Fast"),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                    attr, NULL, NULL);
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, res);
+}
+
+static void setup(void) {
+    activeReaders = 0;
+    maxActiveReaders = 0;
+    tc.running = true;
+    tc.server = UA_Server_new();
+    ck_assert(tc.server != NULL);
+    UA_ServerConfig *config = UA_Server_getConfig(tc.server);
+    UA_ServerConfig_setDefault(config);
+    config->sharedServiceLock = true;
+    config->serviceWorkers = 4;
+    addNodes();
+    UA_Server_run_startup(tc.server);
+    THREAD_CREATE(server_thread, serverloop);
+}
+
+typedef struct {
+    UA_UInt32 sent[REQUESTS_PER_ITERATION];
+    UA_UInt32 received[REQUESTS_PER_ITERATION];
+    size_t receivedSize;
+} RequestOrder;
+
+static void
+readCallback(UA_Client *client, void *userdata, UA_UInt32 requestId,
+             UA_StatusCode status, UA_DataValue *value) {
+    RequestOrder *ro = (RequestOrder*)userdata;
+    ck_assert_uint_eq(status, UA_STATUSCODE_GOOD);
+    ck_assert(value && value->hasValue);
+    ck_assert_int_eq(42, *(UA_Int32 *)value->value.data);
+    ck_assert_uint_lt(ro->receivedSize, REQUESTS_PER_ITERATION);
+    ro->received[ro->receivedSize++] = requestId;
+}
+
+static void
+client_readAsync(void *value) {
+    ThreadContext tmp = (*(ThreadContext *) value);
+    UA_Client *client = tc.clients[tmp.index];
+
+    /* Alternate slow and fast reads in the same SecureChannel */
+    RequestOrder ro;
+    memset(&ro, 0, sizeof(RequestOrder));
+    for(size_t i = 0; i < REQUESTS_PER_ITERATION; i++) {
+        UA_StatusCode res =
+            UA_Client_readValueAttribute_async(client, (i % 2 == 0) ? slowNodeId : fastNodeId,
+                                               readCallback, &ro, &ro.sent[i]);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+
+    for(size_t i = 0; i < 1000 && ro.receivedSize < REQUESTS_PER_ITERATION; i++)
+        UA_Client_run_iterate(client, 10);
+
+    /* The responses arrive in the order of the requests */
+    ck_assert_uint_eq(ro.receivedSize, REQUESTS_PER_ITERATION);
+    for(size_t i = 0; i < REQUESTS_PER_ITERATION; i++)
+        ck_assert_uint_eq(ro.sent[i], ro.received[i]);
+}
+
+static void
+checkServer(void) {
+    /* Requests of different SecureChannels were processed in parallel */
+    ck_assert_int_gt(maxActiveReaders, 1);
+    ck_assert_int_eq(activeReaders, 0);
+}
+
+static void
+initTest(void) {
+    for(size_t i = 0; i < tc.numberofClients; i++)
+        setThreadContext(&tc.clientContext[i], i, ITERATIONS_PER_CLIENT, client_readAsync);
+}
+
+START_TEST(serviceWorkers) {
+        startMultithreading();
+    }
+END_TEST
+
+static Suite* testSuite_serviceWorkers(void) {
+    Suite *s = suite_create("Multithreading");
+    TCase *tcWorkers = tcase_create("Service Workers");
+    tcase_add_checked_fixture(tcWorkers, setup, teardown);
+    tcase_add_test(tcWorkers, serviceWorkers);
+    suite_add_tcase(s, tcWorkers);
+    return s;
+}
+
+int main(void) {
+    Suite *s = testSuite_serviceWorkers();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    createThreadContext(NUMBER_OF_WORKERS, NUMBER_OF_CLIENTS, checkServer);
+    initTest();
+    srunner_run_all(sr, CK_NORMAL);
+    deleteThreadContext();
+
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
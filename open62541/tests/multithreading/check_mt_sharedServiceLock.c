@@ -0,0 +1,277 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/plugin/log_stdout.h>
+#include <open62541/client_config_default.h>
+#include <open62541/client_highlevel.h>
+#include <check.h>
+#include <stdlib.h>
+#include "thread_wrapper.h"
+#include "mt_testing.h"
+#include "testing_clock.h"
+
+#define NUMBER_OF_WORKERS 10
+#define ITERATIONS_PER_WORKER 10
+#define NUMBER_OF_CLIENTS 5
+#define ITERATIONS_PER_CLIENT 10
+
+UA_NodeId dataSourceId = {1, UA_NODEIDTYPE_NUMERIC, {1001}};
+UA_NodeId variableId = {1, UA_NODEIDTYPE_NUMERIC, {1002}};
+UA_NodeId writingDataSourceId = {1, UA_NODEIDTYPE_NUMERIC, {1003}};
+
+/* Track how many read callbacks execute in parallel */
+static volatile int activeReaders;
+static volatile int maxActiveReaders;
+
+/* Writes from within a read callback */
+static volatile int acceptedNestedWrites;
+static volatile int rejectedNestedWrites;
+
+static UA_StatusCode
+readDataSource(UA_Server *server, const UA_NodeId *sessionId,
+               void *sessionContext, const UA_NodeId *nodeId, void *nodeContext,
+               UA_Boolean includeSourceTimeStamp, const UA_NumericRange *range,
+               UA_DataValue *value) {
+    int active = UA_atomic_addInt(&activeReaders, 1);
+    int max = maxActiveReaders;
+    while(active > max) {
+        int old = UA_atomic_cmpxchgInt(&maxActiveReaders, max, active);
+        if(old == max)
+            break;
+        max = old;
+    }
+    UA_realSleep(5);
+    UA_atomic_addInt(&activeReaders, -1);
+
+    UA_Int32 v = 42;
+    value->hasValue = true;
+    return UA_Variant_setScalarCopy(&value->value, &v, &UA_TYPES[UA_TYPES_INT32]);
+}
+
+/* Tries to modify the server from within the read-only service */
+static UA_StatusCode
+readWritingDataSource(UA_Server *server, const UA_NodeId *sessionId,
+                      void *sessionContext, const UA_NodeId *nodeId,
+                      void *nodeContext, UA_Boolean includeSourceTimeStamp,
+                      const UA_NumericRange *range, UA_DataValue *value) {
+    UA_Int32 v = 43;
+    UA_Variant var;
+    UA_Variant_setScalar(&var, &v, &UA_TYPES[UA_TYPES_INT32]);
+    UA_StatusCode res = UA_Server_writeValue(server, variableId, var);
+    if(res == UA_STATUSCODE_BADINVALIDSTATE)
+        UA_atomic_addInt(&rejectedNestedWrites, 1);
+    else
+        UA_atomic_addInt(&acceptedNestedWrites, 1);
+
+    value->hasValue = true;
+    return UA_Variant_setScalarCopy(&value->value, &v, &UA_TYPES[UA_TYPES_INT32]);
+}
+
+static void
+addNodes(void) {
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    attr.displayName = UA_LOCALIZEDTEXT("en-US","DataSource");
+    attr.accessLevel = UA_ACCESSLEVELMASK_READ;
+    UA_DataSource ds;
+    ds.read = readDataSource;
+    ds.write = NULL;
+    UA_StatusCode res =
+        UA_Server_addDataSourceVariableNode(tc.server, dataSourceId,
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                            UA_QUALIFIEDNAME(1, "DataSource"),
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                            attr, ds, NULL, NULL);
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, res);
+
+    attr.displayName = UA_LOCALIZEDTEXT("en-US","WritingDataSource");
+    ds.read = readWritingDataSource;
+    res = UA_Server_addDataSourceVariableNode(tc.server, writingDataSourceId,
+                                              UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                              UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                              UA_QUALIFIEDNAME(1, "WritingDataSource"),
+                                              UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                              attr, ds, NULL, NULL);
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, res);
+
+    attr = UA_VariableAttributes_default;
+    UA_Int32 myInteger = 0;
+    UA_Variant_setScalar(&attr.value, &myInteger, &UA_TYPES[UA_TYPES_INT32]);
+    attr.displayName = UA_LOCALIZEDTEXT("en-US","Variable");
+    attr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    res = UA_Server_addVariableNode(tc.server, variableId,
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                    UA_QUALIFIEDNAME(1, "Variable"),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                    attr, NULL, NULL);
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, res);
+}
+
+static void
+setupServer(size_t serviceWorkers) {
+    activeReaders = 0;
+    maxActiveReaders = 0;
+    tc.running = true;
+    tc.server = UA_Server_new();
+    ck_assert(tc.server != NULL);
+    UA_ServerConfig *config = UA_Server_getConfig(tc.server);
+    UA_ServerConfig_setDefault(config);
+    config->sharedServiceLock = true;
+    config->serviceWorkers = serviceWorkers;
+    addNodes();
+    /* Adding the DataSource reads (and tries to write) once */
+    acceptedNestedWrites = 0;
+    rejectedNestedWrites = 0;
+    UA_Server_run_startup(tc.server);
+    THREAD_CREATE(server_thread, serverloop);
+}
+
+static void setup(void) {
+    setupServer(0);
+}
+
+/* The network requests are processed in the worker pool */
+static void setupWorkers(void) {
+    setupServer(4);
+}
+
+static void
+server_readWrite(void *value) {
+    ThreadContext tmp = (*(ThreadContext *) value);
+
+    /* Read the DataSource in parallel */
+    UA_Variant var;
+    UA_Variant_init(&var);
+    UA_StatusCode ret = UA_Server_readValue(tc.server, dataSourceId, &var);
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, ret);
+    ck_assert_int_eq(42, *(UA_Int32 *)var.data);
+    UA_Variant_clear(&var);
+
+    /* The nested write is rejected */
+    ret = UA_Server_readValue(tc.server, writingDataSourceId, &var);
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, ret);
+    UA_Variant_clear(&var);
+
+    /* Interleave with exclusive write access */
+    if(tmp.index % 2 == 0) {
+        UA_Int32 v = (UA_Int32)tmp.counter;
+        UA_Variant_setScalar(&var, &v, &UA_TYPES[UA_TYPES_INT32]);
+        ret = UA_Server_writeValue(tc.server, variableId, var);
+        ck_assert_int_eq(UA_STATUSCODE_GOOD, ret);
+    }
+
+    /* Browse (shared) */
+    UA_QualifiedName browseName = UA_QUALIFIEDNAME(1, "Variable");
+    UA_BrowsePathResult bpr =
+        UA_Server_browseSimplifiedBrowsePath(tc.server,
+                                             UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                             1, &browseName);
+    ck_assert_int_eq(UA_STATUSCODE_GOOD, bpr.statusCode);
+    ck_assert_uint_eq(1, bpr.targetsSize);
+    UA_BrowsePathResult_clear(&bpr);
+}
+
+static void
+client_readBrowse(void *value) {
+    ThreadContext tmp = (*(ThreadContext *) value);
+    UA_Client *client = tc.clients[tmp.index];
+    UA_Variant val;
+    UA_StatusCode retval =
+        UA_Client_readValueAttribute(client, dataSourceId, &val);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(42, *(UA_Int32 *)val.data);
+    UA_Variant_clear(&val);
+
+    /* The nested write is rejected also for requests from the network */
+    retval = UA_Client_readValueAttribute(client, writingDataSourceId, &val);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    UA_Variant_clear(&val);
+
+    /* Browse the ObjectsFolder */
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.resultMask = UA_BROWSERESULTMASK_BROWSENAME;
+    UA_BrowseRequest bReq;
+    UA_BrowseRequest_init(&bReq);
+    bReq.nodesToBrowse = &bd;
+    bReq.nodesToBrowseSize = 1;
+    UA_BrowseResponse bResp = UA_Client_Service_browse(client, bReq);
+    ck_assert_uint_eq(bResp.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(bResp.resultsSize, 1);
+    ck_assert_uint_eq(bResp.results[0].statusCode, UA_STATUSCODE_GOOD);
+    size_t found = 0;
+    for(size_t i = 0; i < bResp.results[0].referencesSize; i++) {
+        const UA_NodeId *id = &bResp.results[0].references[i].nodeId.nodeId;
+        if(UA_NodeId_equal(id, &dataSourceId) || UA_NodeId_equal(id, &variableId) ||
+           UA_NodeId_equal(id, &writingDataSourceId))
+            found++;
+    }
+    ck_assert_uint_eq(found, 3);
+    UA_BrowseResponse_clear(&bResp);
+}
+
+static void
+checkServer(void) {
+    /* The read callbacks did overlap */
+    ck_assert_int_gt(maxActiveReaders, 1);
+    ck_assert_int_eq(activeReaders, 0);
+
+    /* The writes from the read callbacks were rejected under the shared lock.
+     * Without service workers, the network requests are processed in the
+     * EventLoop thread with exclusive access. There the writes succeed. */
+    ck_assert_int_gt(rejectedNestedWrites, 0);
+    if(UA_Server_getConfig(tc.server)->serviceWorkers > 0)
+        ck_assert_int_eq(acceptedNestedWrites, 0);
+}
+
+static void
+initTest(void) {
+    for(size_t i = 0; i < tc.numberOfWorkers; i++)
+        setThreadContext(&tc.workerContext[i], i, ITERATIONS_PER_WORKER, server_readWrite);
+
+    for(size_t i = 0; i < tc.numberofClients; i++)
+        setThreadContext(&tc.clientContext[i], i, ITERATIONS_PER_CLIENT, client_readBrowse);
+}
+
+START_TEST(sharedServiceLock) {
+        startMultithreading();
+    }
+END_TEST
+
+START_TEST(sharedServiceLockWorkers) {
+        startMultithreading();
+    }
+END_TEST
+
+static Suite* testSuite_sharedServiceLock(void) {
+    Suite *s = suite_create("Multithreading");
+    TCase *tcShared = tcase_create("Shared Service Lock");
+    tcase_add_checked_fixture(tcShared, setup, teardown);
+    tcase_add_test(tcShared, sharedServiceLock);
+    suite_add_tcase(s, tcShared);
+
+    TCase *tcWorkers = tcase_create("Shared Service Lock with Service Workers");
+    tcase_add_checked_fixture(tcWorkers, setupWorkers, teardown);
+    tcase_add_test(tcWorkers, sharedServiceLockWorkers);
+    suite_add_tcase(s, tcWorkers);
+    return s;
+}
+
+int main(void) {
+    Suite *s = testSuite_sharedServiceLock();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+
+    createThreadContext(NUMBER_OF_WORKERS, NUMBER_OF_CLIENTS, checkServer);
+    initTest();
+    srunner_run_all(sr, CK_NORMAL);
+    deleteThreadContext();
+
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -13,6 +13,8 @@
 
 #include <check.h>
 #include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
 
 START_TEST(UA_PubSub_EncodeAllOptionalFields) {
     UA_NetworkMessage m;
@@ -376,6 +378,144 @@ START_TEST(UA_NetworkMessage_fieldNames_json_decode) {
 }
 END_TEST
 
+#define SPEED_FIELDS 5000
+#define SPEED_ROUNDS 50
+
+/* Compare the two-pass encoding (calcSize, then encode) with the single-pass
+ * encoding into a growable buffer for a DataSetMessage with many fields */
+START_TEST(UA_PubSub_EncodeSinglePassSpeed) {
+    UA_NetworkMessage m;
+    memset(&m, 0, sizeof(UA_NetworkMessage));
+    m.version = 1;
+    m.networkMessageType = UA_NETWORKMESSAGE_DATASET;
+    m.payloadHeaderEnabled = true;
+    m.payloadHeader.dataSetPayloadHeader.count = 1;
+    m.payloadHeader.dataSetPayloadHeader.dataSetWriterIds = (UA_UInt16 *)
+        UA_Array_new(1, &UA_TYPES[UA_TYPES_UINT16]);
+    m.payloadHeader.dataSetPayloadHeader.dataSetWriterIds[0] = 12345;
+    m.payload.dataSetPayload.dataSetMessages = (UA_DataSetMessage*)
+        UA_calloc(1, sizeof(UA_DataSetMessage));
+
+    UA_DataSetMessage *dsm = &m.payload.dataSetPayload.dataSetMessages[0];
+    dsm->header.dataSetMessageValid = true;
+    dsm->header.fieldEncoding = UA_FIELDENCODING_VARIANT;
+    dsm->header.dataSetMessageType = UA_DATASETMESSAGE_DATAKEYFRAME;
+    dsm->data.keyFrameData.fieldCount = SPEED_FIELDS;
+    dsm->data.keyFrameData.dataSetFields = (UA_DataValue*)
+        UA_Array_new(SPEED_FIELDS, &UA_TYPES[UA_TYPES_DATAVALUE]);
+    dsm->data.keyFrameData.fieldNames = (UA_String*)
+        UA_Array_new(SPEED_FIELDS, &UA_TYPES[UA_TYPES_STRING]);
+    for(size_t i = 0; i < SPEED_FIELDS; i++) {
+        char name[32];
+        snprintf(name, 32, "Field%u", (unsigned)i);
+        dsm->data.keyFrameData.fieldNames[i] = UA_STRING_ALLOC(name);
+        UA_Double d = (UA_Double)i * 1.5;
+        UA_Variant_setScalarCopy(&dsm->data.keyFrameData.dataSetFields[i].value,
+                                 &d, &UA_TYPES[UA_TYPES_DOUBLE]);
+        dsm->data.keyFrameData.dataSetFields[i].hasValue = true;
+    }
+
+    /* Two passes */
+    UA_ByteString twoPass = UA_BYTESTRING_NULL;
+    UA_StatusCode rv = UA_STATUSCODE_GOOD;
+    clock_t begin = clock();
+    for(size_t i = 0; i < SPEED_ROUNDS; i++) {
+        UA_ByteString_clear(&twoPass);
+        size_t size = UA_NetworkMessage_calcSizeJson(&m, NULL, 0, NULL, 0, true);
+        rv |= UA_ByteString_allocBuffer(&twoPass, size);
+        UA_Byte *bufPos = twoPass.data;
+        const UA_Byte *bufEnd = &twoPass.data[twoPass.length];
+        rv |= UA_NetworkMessage_encodeJson(&m, &bufPos, &bufEnd, NULL, 0, NULL, 0, true);
+    }
+    clock_t twoPassTime = clock() - begin;
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+
+    /* Single pass */
+    UA_ByteString singlePass = UA_BYTESTRING_NULL;
+    begin = clock();
+    for(size_t i = 0; i < SPEED_ROUNDS; i++) {
+        UA_ByteString_clear(&singlePass);
+        rv |= UA_NetworkMessage_encodeJsonAlloc(&m, &singlePass, NULL, 0, NULL, 0, true);
+    }
+    clock_t singlePassTime = clock() - begin;
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+
+    /* Identical result */
+    ck_assert_uint_eq(singlePass.length, twoPass.length);
+    ck_assert(memcmp(singlePass.data, twoPass.data, twoPass.length) == 0);
+
+    printf("%u fields, %lu bytes: two-pass %.3f ms, single-pass %.3f ms\n",
+           (unsigned)SPEED_FIELDS, (unsigned long)singlePass.length,
+           (double)twoPassTime * 1000.0 / CLOCKS_PER_SEC / SPEED_ROUNDS,
+           (double)singlePassTime * 1000.0 / CLOCKS_PER_SEC / SPEED_ROUNDS);
+
+    UA_ByteString_clear(&twoPass);
+    UA_ByteString_clear(&singlePass);
+    UA_NetworkMessage_clear(&m);
+}
+END_TEST
+
+/* Decoding the wide DataSet. The lookahead for the NetworkMessage keys jumps
+ * over the nested DataSetMessages without scanning them. */
+START_TEST(UA_PubSub_DecodeWideDataSetSpeed) {
+    UA_NetworkMessage m;
+    memset(&m, 0, sizeof(UA_NetworkMessage));
+    m.version = 1;
+    m.networkMessageType = UA_NETWORKMESSAGE_DATASET;
+    m.payloadHeaderEnabled = true;
+    m.payloadHeader.dataSetPayloadHeader.count = 1;
+    m.payloadHeader.dataSetPayloadHeader.dataSetWriterIds = (UA_UInt16 *)
+        UA_Array_new(1, &UA_TYPES[UA_TYPES_UINT16]);
+    m.payloadHeader.dataSetPayloadHeader.dataSetWriterIds[0] = 12345;
+    m.payload.dataSetPayload.dataSetMessages = (UA_DataSetMessage*)
+        UA_calloc(1, sizeof(UA_DataSetMessage));
+
+    UA_DataSetMessage *dsm = &m.payload.dataSetPayload.dataSetMessages[0];
+    dsm->header.dataSetMessageValid = true;
+    dsm->header.fieldEncoding = UA_FIELDENCODING_VARIANT;
+    dsm->header.dataSetMessageType = UA_DATASETMESSAGE_DATAKEYFRAME;
+    dsm->data.keyFrameData.fieldCount = SPEED_FIELDS;
+    dsm->data.keyFrameData.dataSetFields = (UA_DataValue*)
+        UA_Array_new(SPEED_FIELDS, &UA_TYPES[UA_TYPES_DATAVALUE]);
+    dsm->data.keyFrameData.fieldNames = (UA_String*)
+        UA_Array_new(SPEED_FIELDS, &UA_TYPES[UA_TYPES_STRING]);
+    for(size_t i = 0; i < SPEED_FIELDS; i++) {
+        char name[32];
+        snprintf(name, 32, "Field%u", (unsigned)i);
+        dsm->data.keyFrameData.fieldNames[i] = UA_STRING_ALLOC(name);
+        UA_Double d = (UA_Double)i * 1.5;
+        UA_Variant_setScalarCopy(&dsm->data.keyFrameData.dataSetFields[i].value,
+                                 &d, &UA_TYPES[UA_TYPES_DOUBLE]);
+        dsm->data.keyFrameData.dataSetFields[i].hasValue = true;
+    }
+
+    UA_ByteString buf = UA_BYTESTRING_NULL;
+    UA_StatusCode rv =
+        UA_NetworkMessage_encodeJsonAlloc(&m, &buf, NULL, 0, NULL, 0, true);
+    ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+    UA_NetworkMessage_clear(&m);
+
+    clock_t begin = clock();
+    for(size_t i = 0; i < SPEED_ROUNDS; i++) {
+        rv = UA_NetworkMessage_decodeJson(&m, &buf);
+        ck_assert_int_eq(rv, UA_STATUSCODE_GOOD);
+        dsm = &m.payload.dataSetPayload.dataSetMessages[0];
+        ck_assert_uint_eq(dsm->data.keyFrameData.fieldCount, SPEED_FIELDS);
+        ck_assert_double_eq(*(UA_Double*)dsm->data.keyFrameData.
+                            dataSetFields[SPEED_FIELDS-1].value.data,
+                            (UA_Double)(SPEED_FIELDS-1) * 1.5);
+        UA_NetworkMessage_clear(&m);
+    }
+    clock_t decodeTime = clock() - begin;
+
+    printf("%u fields, %lu bytes: decode %.3f ms\n",
+           (unsigned)SPEED_FIELDS, (unsigned long)buf.length,
+           (double)decodeTime * 1000.0 / CLOCKS_PER_SEC / SPEED_ROUNDS);
+
+    UA_ByteString_clear(&buf);
+}
+END_TEST
+
 static Suite *testSuite_networkmessage(void) {
     Suite *s = suite_create("Built-in Data Types 62541-6 Json");
     TCase *tc_json_networkmessage = tcase_create("networkmessage_json");
@@ -387,6 +527,8 @@ static Suite *testSuite_networkmessage(void) {
     tcase_add_test(tc_json_networkmessage, UA_NetworkMessage_json_decode);
     tcase_add_test(tc_json_networkmessage, UA_Networkmessage_DataSetFieldsNull_json_decode);
     tcase_add_test(tc_json_networkmessage, UA_NetworkMessage_fieldNames_json_decode);
+    tcase_add_test(tc_json_networkmessage, UA_PubSub_EncodeSinglePassSpeed);
+    tcase_add_test(tc_json_networkmessage, UA_PubSub_DecodeWideDataSetSpeed);
 
     suite_add_tcase(s, tc_json_networkmessage);
     return s;
@@ -13,6 +13,9 @@
 #include <server/ua_server_internal.h>
 
 #include <check.h>
+#if UA_MULTITHREADING >= 100
+#include <pthread.h>
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -23,17 +26,17 @@ UA_NodeId connectionIdentifier, publishedDataSetIdent, writerGroupIdent, dataSet
 UA_DataValue *staticSource1, *staticSource2;
 
 static UA_StatusCode
-addMinimalPubSubConfiguration(void){
+addPubSubConfiguration(const char *name, const char *profileUri,
+                       UA_NetworkAddressUrlDataType *networkAddressUrl) {
     UA_StatusCode retVal = UA_STATUSCODE_GOOD;
     /* Add one PubSubConnection */
     UA_PubSubConnectionConfig connectionConfig;
     memset(&connectionConfig, 0, sizeof(connectionConfig));
-    connectionConfig.name = UA_STRING("UDP-UADP Connection 1");
-    connectionConfig.transportProfileUri = UA_STRING("http://opcfoundation.org/UA-Profile/Transport/pubsub-udp-uadp");
+    connectionConfig.name = UA_STRING((char*)(uintptr_t)name);
+    connectionConfig.transportProfileUri = UA_STRING((char*)(uintptr_t)profileUri);
     connectionConfig.enabled = UA_TRUE;
     connectionConfig.eventLoop = rtEventLoop;
-    UA_NetworkAddressUrlDataType networkAddressUrl = {UA_STRING_NULL , UA_STRING("opc.udp://224.0.0.22:4840/")};
-    UA_Variant_setScalar(&connectionConfig.address, &networkAddressUrl, &UA_TYPES[UA_TYPES_NETWORKADDRESSURLDATATYPE]);
+    UA_Variant_setScalar(&connectionConfig.address, networkAddressUrl, &UA_TYPES[UA_TYPES_NETWORKADDRESSURLDATATYPE]);
     connectionConfig.publisherIdType = UA_PUBLISHERIDTYPE_UINT32;
     connectionConfig.publisherId.uint32 = UA_UInt32_random();
     retVal = UA_Server_addPubSubConnection(server, &connectionConfig, &connectionIdentifier);
@@ -49,6 +52,14 @@ addMinimalPubSubConfiguration(void){
     return addResult.addResult;
 }
 
+static UA_StatusCode
+addMinimalPubSubConfiguration(void){
+    UA_NetworkAddressUrlDataType networkAddressUrl = {UA_STRING_NULL , UA_STRING("opc.udp://224.0.0.22:4840/")};
+    return addPubSubConfiguration("UDP-UADP Connection 1",
+                                  "http://opcfoundation.org/UA-Profile/Transport/pubsub-udp-uadp",
+                                  &networkAddressUrl);
+}
+
 static void setup(void) {
     server = UA_Server_new();
     ck_assert(server != NULL);
@@ -68,6 +79,13 @@ static void setup(void) {
         UA_ConnectionManager_new_POSIX_UDP(UA_STRING("udp connection manager"));
     rtEventLoop->registerEventSource(rtEventLoop, (UA_EventSource *)udpCM);
 
+#if defined(UA_ARCHITECTURE_POSIX) && defined(__linux__)
+    /* Add the Ethernet connection manager */
+    UA_ConnectionManager *ethCM =
+        UA_ConnectionManager_new_POSIX_Ethernet(UA_STRING("eth connection manager"));
+    rtEventLoop->registerEventSource(rtEventLoop, (UA_EventSource *)ethCM);
+#endif
+
     rtEventLoop->start(rtEventLoop);
 }
 
@@ -356,6 +374,131 @@ START_TEST(PublishSingleFieldInCustomCallback) {
         UA_Server_run_iterate(server, false);
 } END_TEST
 
+#if UA_MULTITHREADING >= 100
+static void *
+publishInThread(void *wg) {
+    UA_WriterGroup_publishCallback(server, (UA_WriterGroup*)wg);
+    return NULL;
+}
+#endif
+
+/* Search for the binary encoding of the value */
+static UA_Boolean
+containsUInt32(const UA_ByteString *buf, UA_UInt32 value) {
+    UA_Byte encoded[4] = {(UA_Byte)value, (UA_Byte)(value >> 8),
+                          (UA_Byte)(value >> 16), (UA_Byte)(value >> 24)};
+    for(size_t i = 0; i + 4 <= buf->length; i++) {
+        if(memcmp(&buf->data[i], encoded, 4) == 0)
+            return true;
+    }
+    return false;
+}
+
+static void
+publishFromRetainedSendBuffer(void) {
+        UA_WriterGroupConfig writerGroupConfig;
+        memset(&writerGroupConfig, 0, sizeof(UA_WriterGroupConfig));
+        writerGroupConfig.name = UA_STRING("Demo WriterGroup");
+        writerGroupConfig.publishingInterval = 10;
+        writerGroupConfig.enabled = UA_FALSE;
+        writerGroupConfig.writerGroupId = 100;
+        writerGroupConfig.encodingMimeType = UA_PUBSUB_ENCODING_UADP;
+        writerGroupConfig.rtLevel = UA_PUBSUB_RT_DETERMINISTIC;
+        UA_UadpWriterGroupMessageDataType *wgm = UA_UadpWriterGroupMessageDataType_new();
+        wgm->networkMessageContentMask = UA_UADPNETWORKMESSAGECONTENTMASK_PAYLOADHEADER;
+        writerGroupConfig.messageSettings.content.decoded.data = wgm;
+        writerGroupConfig.messageSettings.content.decoded.type =
+            &UA_TYPES[UA_TYPES_UADPWRITERGROUPMESSAGEDATATYPE];
+        writerGroupConfig.messageSettings.encoding = UA_EXTENSIONOBJECT_DECODED;
+        ck_assert(UA_Server_addWriterGroup(server, connectionIdentifier, &writerGroupConfig, &writerGroupIdent) == UA_STATUSCODE_GOOD);
+        UA_UadpWriterGroupMessageDataType_delete(wgm);
+        UA_DataSetWriterConfig dataSetWriterConfig;
+        memset(&dataSetWriterConfig, 0, sizeof(UA_DataSetWriterConfig));
+        dataSetWriterConfig.name = UA_STRING("Test DataSetWriter");
+        dataSetWriterConfig.dataSetWriterId = 62541;
+        UA_DataSetFieldConfig dsfConfig;
+        memset(&dsfConfig, 0, sizeof(UA_DataSetFieldConfig));
+        UA_UInt32 *intValue = UA_UInt32_new();
+        *intValue = (UA_UInt32) 1000;
+        staticSource1 = UA_DataValue_new();
+        UA_Variant_setScalar(&staticSource1->value, intValue, &UA_TYPES[UA_TYPES_UINT32]);
+        dsfConfig.field.variable.rtValueSource.rtFieldSourceEnabled = UA_TRUE;
+        dsfConfig.field.variable.rtValueSource.staticValueSource = &staticSource1;
+        dsfConfig.field.variable.publishParameters.attributeId = UA_ATTRIBUTEID_VALUE;
+        ck_assert(UA_Server_addDataSetField(server, publishedDataSetIdent, &dsfConfig, &dataSetFieldIdent).result == UA_STATUSCODE_GOOD);
+        ck_assert(UA_Server_addDataSetWriter(server, writerGroupIdent, publishedDataSetIdent, &dataSetWriterConfig, &dataSetWriterIdent) == UA_STATUSCODE_GOOD);
+
+        ck_assert(UA_Server_freezeWriterGroupConfiguration(server, writerGroupIdent) == UA_STATUSCODE_GOOD);
+        ck_assert(UA_Server_setWriterGroupOperational(server, writerGroupIdent) == UA_STATUSCODE_GOOD);
+        UA_Server_run_iterate(server, false);
+
+        lockServer(server);
+        UA_WriterGroup *wg = UA_WriterGroup_findWGbyId(server, writerGroupIdent);
+        unlockServer(server);
+        ck_assert(wg != NULL);
+
+        /* Every cycle patches the new value into the same retained buffer */
+        const UA_ByteString *msg = &wg->bufferedMessage.buffer;
+        UA_Byte *sendBufferData = NULL;
+        for(size_t i = 0; i < 10; i++) {
+            *intValue = (UA_UInt32)(2000 + i);
+            UA_UInt16 seq = wg->sequenceNumber;
+            UA_WriterGroup_publishCallback(server, wg);
+            ck_assert_uint_eq(wg->sequenceNumber, (UA_UInt16)(seq + 1));
+            ck_assert_uint_eq(wg->sendBuffer.length, msg->length);
+            if(i == 0)
+                sendBufferData = wg->sendBuffer.data;
+            ck_assert_ptr_eq(wg->sendBuffer.data, sendBufferData);
+            ck_assert(containsUInt32(&wg->sendBuffer, *intValue));
+        }
+
+        /* The frozen deterministic WriterGroup publishes without the server
+         * lock. Otherwise the publisher thread would block forever. */
+        ck_assert(wg->rtPublishLockFree);
+#if UA_MULTITHREADING >= 100
+        UA_UInt16 seq = wg->sequenceNumber;
+        lockServer(server);
+        pthread_t publisher;
+        pthread_create(&publisher, NULL, publishInThread, wg);
+        pthread_join(publisher, NULL);
+        unlockServer(server);
+        ck_assert_uint_eq(wg->sequenceNumber, (UA_UInt16)(seq + 1));
+#endif
+
+        /* Unfreezing returns the buffer to the ConnectionManager */
+        ck_assert(UA_Server_setWriterGroupDisabled(server, writerGroupIdent) == UA_STATUSCODE_GOOD);
+        ck_assert(UA_Server_unfreezeWriterGroupConfiguration(server, writerGroupIdent) == UA_STATUSCODE_GOOD);
+        ck_assert(!wg->rtPublishLockFree);
+        ck_assert_uint_eq(wg->sendBuffer.length, 0);
+}
+
+START_TEST(PublishFromRetainedSendBuffer) {
+        ck_assert(addMinimalPubSubConfiguration() == UA_STATUSCODE_GOOD);
+        publishFromRetainedSendBuffer();
+} END_TEST
+
+#if defined(UA_ARCHITECTURE_POSIX) && defined(__linux__)
+/* Sending over the loopback interface requires the permission to open raw
+ * sockets. The test is skipped if the Ethernet connection cannot be opened. */
+START_TEST(PublishFromRetainedSendBufferEthernet) {
+        UA_NetworkAddressUrlDataType networkAddressUrl =
+            {UA_STRING("lo"), UA_STRING("opc.eth://01-00-5E-7F-00-01")};
+        UA_StatusCode res =
+            addPubSubConfiguration("ETH-UADP Connection 1",
+                                   "http://opcfoundation.org/UA-Profile/Transport/pubsub-eth-uadp",
+                                   &networkAddressUrl);
+        if(res != UA_STATUSCODE_GOOD)
+            return;
+        UA_PubSubConnection *connection =
+            UA_PubSubConnection_findConnectionbyId(server, connectionIdentifier);
+        ck_assert(connection != NULL);
+        if(connection->sendChannel == 0)
+            return;
+        ck_assert(connection->cm->sendRetainedWithConnection != NULL);
+        publishFromRetainedSendBuffer();
+} END_TEST
+#endif
+
 static UA_StatusCode
 simpleNotificationRead(UA_Server *srv, const UA_NodeId *sessionId,
                        void *sessionContext, const UA_NodeId *nodeid,
@@ -537,6 +680,10 @@ int main(void) {
     tcase_add_test(tc_pubsub_rt_fixed_offsets, PublishSingleFieldWithFixedOffsets);
     tcase_add_test(tc_pubsub_rt_fixed_offsets, PublishPDSWithMultipleFieldsAndFixedOffset);
     tcase_add_test(tc_pubsub_rt_fixed_offsets, PublishSingleFieldInCustomCallback);
+    tcase_add_test(tc_pubsub_rt_fixed_offsets, PublishFromRetainedSendBuffer);
+#if defined(UA_ARCHITECTURE_POSIX) && defined(__linux__)
+    tcase_add_test(tc_pubsub_rt_fixed_offsets, PublishFromRetainedSendBufferEthernet);
+#endif
 
     Suite *s = suite_create("PubSub RT configuration levels");
     suite_add_tcase(s, tc_pubsub_rt_static_value_source);
@@ -1620,6 +1620,111 @@ START_TEST(SinglePublishSubscribeHeartbeat) {
 
 } END_TEST
 
+/* Heartbeat NetworkMessages are dispatched to the matching DataSetReader out of
+ * many DataSetReaders of the connection */
+START_TEST(DispatchToManyDataSetReaders) {
+#define DISPATCH_READERS 2000
+    UA_ReaderGroupConfig readerGroupConfig;
+    memset(&readerGroupConfig, 0, sizeof(UA_ReaderGroupConfig));
+    readerGroupConfig.name = UA_STRING("ReaderGroup Test");
+    UA_StatusCode retVal =
+        UA_Server_addReaderGroup(server, connectionId, &readerGroupConfig, &readerGroupId);
+    ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+
+    UA_DataSetReaderConfig readerConfig;
+    memset(&readerConfig, 0, sizeof(UA_DataSetReaderConfig));
+    readerConfig.name = UA_STRING("DataSetReader Test");
+    UA_UInt16 publisherIdentifier = PUBLISHER_ID;
+    UA_Variant_setScalar(&readerConfig.publisherId, &publisherIdentifier,
+                         &UA_TYPES[UA_TYPES_UINT16]);
+    readerConfig.writerGroupId = WRITER_GROUP_ID;
+    UA_NodeId readerIds[DISPATCH_READERS];
+    for(UA_UInt16 i = 0; i < DISPATCH_READERS; i++) {
+        readerConfig.dataSetWriterId = (UA_UInt16)(i + 1);
+        retVal = UA_Server_addDataSetReader(server, readerGroupId, &readerConfig,
+                                            &readerIds[i]);
+        ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+    }
+    retVal = UA_Server_setReaderGroupOperational(server, readerGroupId);
+    ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+    UA_ReaderGroup *rg = UA_ReaderGroup_findRGbyId(server, readerGroupId);
+    ck_assert_ptr_ne(rg, NULL);
+
+    /* Heartbeat with a single DataSetMessage */
+    UA_UInt16 dataSetWriterId = 0;
+    UA_DataSetMessage dsm;
+    memset(&dsm, 0, sizeof(UA_DataSetMessage));
+    dsm.header.dataSetMessageValid = true;
+    dsm.header.dataSetMessageType = UA_DATASETMESSAGE_DATAKEYFRAME;
+    dsm.header.fieldEncoding = UA_FIELDENCODING_VARIANT;
+    UA_NetworkMessage nm;
+    memset(&nm, 0, sizeof(UA_NetworkMessage));
+    nm.publisherIdEnabled = true;
+    nm.publisherIdType = UA_PUBLISHERIDTYPE_UINT16;
+    nm.publisherId.uint16 = PUBLISHER_ID;
+    nm.groupHeaderEnabled = true;
+    nm.groupHeader.writerGroupIdEnabled = true;
+    nm.groupHeader.writerGroupId = WRITER_GROUP_ID;
+    nm.payloadHeaderEnabled = true;
+    nm.payloadHeader.dataSetPayloadHeader.count = 1;
+    nm.payloadHeader.dataSetPayloadHeader.dataSetWriterIds = &dataSetWriterId;
+    nm.payload.dataSetPayload.dataSetMessages = &dsm;
+
+    /* Only the reader of the DataSetWriter receives the message */
+    dataSetWriterId = DISPATCH_READERS / 2;
+    lockServer(server);
+    ck_assert(UA_ReaderGroup_process(server, rg, &nm));
+    unlockServer(server);
+    for(size_t i = 0; i < DISPATCH_READERS; i++) {
+        UA_DataSetReader *dsr = UA_ReaderGroup_findDSRbyId(server, readerIds[i]);
+        ck_assert_ptr_ne(dsr, NULL);
+        if(dsr->config.dataSetWriterId == dataSetWriterId)
+            ck_assert(dsr->lastHeartbeatReceived == UA_DateTime_nowMonotonic());
+        else
+            ck_assert(dsr->lastHeartbeatReceived == 0);
+    }
+
+    /* No reader for a different WriterGroup or PublisherId */
+    nm.groupHeader.writerGroupId = WRITER_GROUP_ID + 1;
+    lockServer(server);
+    ck_assert(!UA_ReaderGroup_process(server, rg, &nm));
+    unlockServer(server);
+    nm.groupHeader.writerGroupId = WRITER_GROUP_ID;
+    nm.publisherId.uint16 = PUBLISHER_ID + 1;
+    lockServer(server);
+    ck_assert(!UA_ReaderGroup_process(server, rg, &nm));
+    unlockServer(server);
+    nm.publisherId.uint16 = PUBLISHER_ID;
+
+    /* A removed reader no longer receives messages */
+    retVal = UA_Server_setReaderGroupDisabled(server, readerGroupId);
+    ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+    retVal = UA_Server_removeDataSetReader(server, readerIds[0]);
+    ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+    retVal = UA_Server_setReaderGroupOperational(server, readerGroupId);
+    ck_assert_int_eq(retVal, UA_STATUSCODE_GOOD);
+    dataSetWriterId = 1;
+    lockServer(server);
+    ck_assert(!UA_ReaderGroup_process(server, rg, &nm));
+    unlockServer(server);
+
+    /* Measure the dispatch */
+    const size_t messages = 100000;
+    lockServer(server);
+    clock_t begin = clock();
+    for(size_t i = 0; i < messages; i++) {
+        dataSetWriterId = (UA_UInt16)(2 + (i % (DISPATCH_READERS - 1)));
+        UA_ReaderGroup_process(server, rg, &nm);
+    }
+    clock_t duration = clock() - begin;
+    unlockServer(server);
+    double seconds = (double)duration / CLOCKS_PER_SEC;
+    printf("%lu messages dispatched to %u DataSetReaders: %f s (%.0f messages/s)\n",
+           (unsigned long)messages, DISPATCH_READERS, seconds,
+           (seconds > 0.0) ? (double)messages / seconds : 0.0);
+#undef DISPATCH_READERS
+} END_TEST
+
 START_TEST(SinglePublishSubscribeWithoutPayloadHeader) {
         /* To check status after running both publisher and subscriber */
         UA_StatusCode retVal = UA_STATUSCODE_GOOD;
@@ -2570,6 +2675,7 @@ int main(void) {
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribeBool);
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribewithValidIdentifiers);
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribeHeartbeat);
+    tcase_add_test(tc_pubsub_publish_subscribe, DispatchToManyDataSetReaders);
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishSubscribeWithoutPayloadHeader);
     tcase_add_test(tc_pubsub_publish_subscribe, MultiPublishSubscribeInt32);
     tcase_add_test(tc_pubsub_publish_subscribe, SinglePublishOnDemand);
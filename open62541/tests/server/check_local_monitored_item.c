@@ -162,6 +162,71 @@ START_TEST(Server_LocalMonitoredItem_dataSource) {
 }
 END_TEST
 
+static size_t groupCounts[4];
+static UA_UInt32 groupMonIds[4];
+
+/* Count per MonitoredItem. The third MonitoredItem deletes the second during
+ * the sampling. The MonitoredItems are sampled in the reverse order of their
+ * creation. So the deleted MonitoredItem is the next to be sampled. */
+static void
+groupNotificationCallback(UA_Server *thisServer, UA_UInt32 monitoredItemId,
+                          void *monitoredItemContext, const UA_NodeId *nodeId,
+                          void *nodeContext, UA_UInt32 attributeId,
+                          const UA_DataValue *value) {
+    size_t index = (size_t)(uintptr_t)monitoredItemContext;
+    groupCounts[index]++;
+    if(index == 2 && groupCounts[index] == 3)
+        UA_Server_deleteMonitoredItem(thisServer, groupMonIds[1]);
+}
+
+/* MonitoredItems with the same sampling interval are sampled together */
+START_TEST(Server_LocalMonitoredItem_samplingGroup) {
+    UA_DataSource ds = {readDataSource, NULL};
+    UA_Server_setVariableNode_dataSource(server, outNodeId, ds);
+
+    const UA_Double intervals[4] = {100.0, 100.0, 100.0, 200.0};
+    for(size_t i = 0; i < 4; i++) {
+        groupCounts[i] = 0;
+        UA_MonitoredItemCreateRequest monitorRequest =
+            UA_MonitoredItemCreateRequest_default(outNodeId);
+        monitorRequest.requestedParameters.samplingInterval = intervals[i];
+        monitorRequest.monitoringMode = UA_MONITORINGMODE_REPORTING;
+        UA_MonitoredItemCreateResult result =
+            UA_Server_createDataChangeMonitoredItem(server, UA_TIMESTAMPSTORETURN_BOTH,
+                                                    monitorRequest, (void*)(uintptr_t)i,
+                                                    &groupNotificationCallback);
+        ASSERT_STATUSCODE(result.statusCode, UA_STATUSCODE_GOOD);
+        groupMonIds[i] = result.monitoredItemId;
+        ck_assert_uint_eq(groupCounts[i], 1);
+    }
+
+    for(size_t i = 0; i < 10; i++) {
+        staticUInt32++;
+        UA_fakeSleep(100);
+        UA_Server_run_iterate(server, 1);
+    }
+
+    /* The second MonitoredItem was deleted in the second sampling round
+     * before it was sampled. The first MonitoredItem is sampled after it and
+     * continues. */
+    ck_assert_uint_eq(groupCounts[0], 11);
+    ck_assert_uint_eq(groupCounts[1], 2);
+    ck_assert_uint_eq(groupCounts[2], 11);
+    ck_assert_uint_eq(groupCounts[3], 6);
+
+    /* Delete the remaining MonitoredItems. The sampling stops. */
+    for(size_t i = 0; i < 4; i++) {
+        if(i != 1)
+            UA_Server_deleteMonitoredItem(server, groupMonIds[i]);
+    }
+    staticUInt32++;
+    UA_fakeSleep(200);
+    UA_Server_run_iterate(server, 1);
+    ck_assert_uint_eq(groupCounts[0], 11);
+    ck_assert_uint_eq(groupCounts[3], 6);
+}
+END_TEST
+
 /* Custom datatype with a String NodeId */
 typedef struct {
     UA_Float p;
@@ -192,7 +257,7 @@ static UA_DataType PointType = {
     members
 };
 
-UA_DataTypeArray customDataTypes = {NULL, 1, &PointType, UA_FALSE};
+UA_DataTypeArray customDataTypes = {NULL, 1, &PointType, UA_FALSE, NULL};
 
 START_TEST(Server_LocalMonitoredItem_CustomType) {
     callbackCount = 0;
@@ -325,6 +390,7 @@ static Suite * testSuite_Client(void) {
     tcase_add_test(tc_server, Server_LocalMonitoredItem);
     tcase_add_test(tc_server, Server_LocalMonitoredItem_dataSource);
     tcase_add_test(tc_server, Server_LocalMonitoredItem_CustomType);
+    tcase_add_test(tc_server, Server_LocalMonitoredItem_samplingGroup);
     suite_add_tcase(s, tc_server);
 
     TCase *tc_server_indexrange = tcase_create("Local Monitored Item Index Range");
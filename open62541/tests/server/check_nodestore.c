@@ -27,6 +27,10 @@ static void setupHashMap(void) {
     UA_Nodestore_HashMap(&ns);
 }
 
+static void setupHashMapConcurrent(void) {
+    UA_Nodestore_HashMapConcurrent(&ns);
+}
+
 static void teardown(void) {
     ns.clear(ns.context);
 }
@@ -257,6 +261,82 @@ START_TEST(profileGetDelete) {
 }
 END_TEST
 
+#if UA_MULTITHREADING >= 100
+#include "thread_wrapper.h"
+
+#define READERS 4
+#define CONCURRENT_NODES 1000
+#define CONCURRENT_ROUNDS 200
+
+static volatile int readersRunning;
+static volatile int readsDone;
+
+/* Get the nodes without a lock. Every node has its numeric identifier as the
+ * ValueRank. The nodes can be replaced or removed meanwhile. */
+THREAD_CALLBACK(concurrentReadThread) {
+    UA_NodeId id = UA_NODEID_NUMERIC(0, 0);
+    int reads = 0;
+    while(readersRunning) {
+        for(UA_UInt32 i = 1; i <= CONCURRENT_NODES; i++) {
+            id.identifier.numeric = i;
+            const UA_Node *n = ns.getNode(ns.context, &id, ~(UA_UInt32)0,
+                                          UA_REFERENCETYPESET_ALL,
+                                          UA_BROWSEDIRECTION_BOTH);
+            if(!n)
+                continue;
+            ck_assert_uint_eq(n->head.nodeId.identifier.numeric, i);
+            ck_assert_int_eq(n->variableNode.valueRank, (UA_Int32)i);
+            ns.releaseNode(ns.context, n);
+            reads++;
+        }
+    }
+    UA_atomic_addInt(&readsDone, reads);
+    return 0;
+}
+
+START_TEST(concurrentGetReplaceRemove) {
+    for(UA_UInt32 i = 1; i <= CONCURRENT_NODES; i++) {
+        UA_Node *n = createNode(0, i);
+        n->variableNode.valueRank = (UA_Int32)i;
+        ck_assert_uint_eq(ns.insertNode(ns.context, n, NULL), UA_STATUSCODE_GOOD);
+    }
+
+    readersRunning = 1;
+    readsDone = 0;
+    THREAD_HANDLE threads[READERS];
+    for(size_t i = 0; i < READERS; i++)
+        THREAD_CREATE(threads[i], concurrentReadThread);
+
+    /* Replace all nodes. Remove and re-insert half of the nodes. Removing
+     * that many nodes shrinks the table and inserting them grows it again. */
+    UA_NodeId id = UA_NODEID_NUMERIC(0, 0);
+    for(size_t r = 0; r < CONCURRENT_ROUNDS; r++) {
+        for(UA_UInt32 i = 1; i <= CONCURRENT_NODES; i++) {
+            id.identifier.numeric = i;
+            UA_Node *copy = NULL;
+            ck_assert_uint_eq(ns.getNodeCopy(ns.context, &id, &copy),
+                              UA_STATUSCODE_GOOD);
+            ck_assert_uint_eq(ns.replaceNode(ns.context, copy), UA_STATUSCODE_GOOD);
+        }
+        for(UA_UInt32 i = 1; i <= CONCURRENT_NODES; i += 2) {
+            id.identifier.numeric = i;
+            ck_assert_uint_eq(ns.removeNode(ns.context, &id), UA_STATUSCODE_GOOD);
+        }
+        for(UA_UInt32 i = 1; i <= CONCURRENT_NODES; i += 2) {
+            UA_Node *n = createNode(0, i);
+            n->variableNode.valueRank = (UA_Int32)i;
+            ck_assert_uint_eq(ns.insertNode(ns.context, n, NULL), UA_STATUSCODE_GOOD);
+        }
+    }
+
+    readersRunning = 0;
+    for(size_t i = 0; i < READERS; i++)
+        THREAD_JOIN(threads[i]);
+    ck_assert_int_gt(readsDone, 0);
+}
+END_TEST
+#endif
+
 static Suite * namespace_suite (void) {
     Suite *s = suite_create ("UA_NodeStore");
 
@@ -312,6 +392,35 @@ static Suite * namespace_suite (void) {
     tcase_add_test (tc_profile_hm, profileGetDelete);
     suite_add_tcase (s, tc_profile_hm);
 
+    TCase* tc_find_hmc = tcase_create ("Find-HashMapConcurrent");
+    tcase_add_checked_fixture(tc_find_hmc, setupHashMapConcurrent, teardown);
+    tcase_add_test (tc_find_hmc, findNodeInUA_NodeStoreWithSingleEntry);
+    tcase_add_test (tc_find_hmc, findNodeInUA_NodeStoreWithSeveralEntries);
+    tcase_add_test (tc_find_hmc, findNodeInExpandedNamespace);
+    tcase_add_test (tc_find_hmc, failToFindNonExistentNodeInUA_NodeStoreWithSeveralEntries);
+    tcase_add_test (tc_find_hmc, failToFindNodeInOtherUA_NodeStore);
+    suite_add_tcase (s, tc_find_hmc);
+
+    TCase *tc_replace_hmc = tcase_create("Replace-HashMapConcurrent");
+    tcase_add_checked_fixture(tc_replace_hmc, setupHashMapConcurrent, teardown);
+    tcase_add_test (tc_replace_hmc, replaceExistingNode);
+    tcase_add_test (tc_replace_hmc, replaceOldNode);
+    suite_add_tcase (s, tc_replace_hmc);
+
+    TCase* tc_iterate_hmc = tcase_create ("Iterate-HashMapConcurrent");
+    tcase_add_checked_fixture(tc_iterate_hmc, setupHashMapConcurrent, teardown);
+    tcase_add_test (tc_iterate_hmc, iterateOverUA_NodeStoreShallNotVisitEmptyNodes);
+    tcase_add_test (tc_iterate_hmc, iterateOverExpandedNamespaceShallNotVisitEmptyNodes);
+    suite_add_tcase (s, tc_iterate_hmc);
+
+#if UA_MULTITHREADING >= 100
+    TCase* tc_concurrent_hmc = tcase_create ("Concurrent-HashMapConcurrent");
+    tcase_add_checked_fixture(tc_concurrent_hmc, setupHashMapConcurrent, teardown);
+    tcase_add_test (tc_concurrent_hmc, concurrentGetReplaceRemove);
+    tcase_set_timeout(tc_concurrent_hmc, 60);
+    suite_add_tcase (s, tc_concurrent_hmc);
+#endif
+
     return s;
 }
 
@@ -0,0 +1,122 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information. */
+
+/* Measure the cost of resolving the Session of a request. It should not depend
+ * on the number of Sessions in the server. */
+
+#include <open62541/server_config_default.h>
+
+#include "ua_server_internal.h"
+
+#include <check.h>
+#include <stdlib.h>
+#include <time.h>
+#include <stdio.h>
+
+#define MAXSESSIONS 10000
+#define LOOKUPS 1000000
+
+static UA_Server *server;
+static UA_NodeId tokens[MAXSESSIONS];
+static UA_NodeId sessionIds[MAXSESSIONS];
+static size_t sessionsSize;
+
+static void setup(void) {
+    server = UA_Server_new();
+    ck_assert(server != NULL);
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    config->maxSessions = MAXSESSIONS;
+    config->maxSessionTimeout = 3600.0 * 1000.0; /* One hour */
+    sessionsSize = 0;
+}
+
+static void teardown(void) {
+    UA_Server_delete(server);
+}
+
+static void
+addSessions(size_t count) {
+    UA_CreateSessionRequest request;
+    UA_CreateSessionRequest_init(&request);
+    lockServer(server);
+    for(; sessionsSize < count; sessionsSize++) {
+        UA_Session *session = NULL;
+        UA_StatusCode res = UA_Server_createSession(server, NULL, &request, &session);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        tokens[sessionsSize] = session->header.authenticationToken;
+        sessionIds[sessionsSize] = session->sessionId;
+    }
+    unlockServer(server);
+}
+
+START_TEST(sessionLookupSpeed) {
+    size_t counts[4] = {10, 100, 1000, 10000};
+    for(size_t c = 0; c < 4; c++) {
+        addSessions(counts[c]);
+        ck_assert_uint_eq(server->sessionCount, counts[c]);
+
+        clock_t begin, finish;
+        begin = clock();
+
+        lockServer(server);
+        for(size_t i = 0; i < LOOKUPS; i++) {
+            size_t j = (i * 7919) % sessionsSize;
+            UA_Session *byToken = getSessionByToken(server, &tokens[j]);
+            UA_Session *byId = getSessionById(server, &sessionIds[j]);
+            ck_assert(byToken != NULL);
+            ck_assert(byToken == byId);
+        }
+        unlockServer(server);
+
+        finish = clock();
+        double time_spent = (double)(finish - begin) / CLOCKS_PER_SEC;
+        printf("%u lookups with %u sessions took %f s\n",
+               (unsigned)LOOKUPS, (unsigned)sessionsSize, time_spent);
+    }
+}
+END_TEST
+
+START_TEST(sessionLookupRemove) {
+    addSessions(1000);
+
+    /* Remove every second session */
+    lockServer(server);
+    for(size_t i = 0; i < sessionsSize; i += 2) {
+        UA_StatusCode res =
+            UA_Server_removeSessionByToken(server, &tokens[i], UA_SHUTDOWNREASON_CLOSE);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+    ck_assert_uint_eq(server->sessionCount, 500);
+
+    for(size_t i = 0; i < sessionsSize; i++) {
+        UA_Session *byToken = getSessionByToken(server, &tokens[i]);
+        UA_Session *byId = getSessionById(server, &sessionIds[i]);
+        ck_assert(byToken == byId);
+        ck_assert((byToken == NULL) == (i % 2 == 0));
+    }
+    unlockServer(server);
+}
+END_TEST
+
+static Suite * session_speed_suite (void) {
+    Suite *s = suite_create ("Session Speed");
+
+    TCase* tc_lookup = tcase_create ("Lookup");
+    tcase_add_checked_fixture(tc_lookup, setup, teardown);
+    tcase_add_test (tc_lookup, sessionLookupSpeed);
+    tcase_add_test (tc_lookup, sessionLookupRemove);
+    suite_add_tcase (s, tc_lookup);
+
+    return s;
+}
+
+int main (void) {
+    int number_failed = 0;
+    Suite *s = session_speed_suite();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr,CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed += srunner_ntests_failed (sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
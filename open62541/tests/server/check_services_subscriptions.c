@@ -625,6 +625,62 @@ START_TEST(Server_deleteMonitoredItems) {
 }
 END_TEST
 
+#define MANY_ITEMS 1000
+
+/* Exercise the growing of the id index and the removal from it */
+START_TEST(Server_deleteManyMonitoredItems) {
+    createSubscription();
+    UA_UInt32 ids[MANY_ITEMS];
+    for(size_t i = 0; i < MANY_ITEMS; i++) {
+        createMonitoredItem();
+        ids[i] = monitoredItemId;
+    }
+
+    UA_Subscription *sub = UA_Session_getSubscriptionById(session, subscriptionId);
+    ck_assert_ptr_ne(sub, NULL);
+    ck_assert_uint_eq(sub->monitoredItemsSize, MANY_ITEMS);
+    for(size_t i = 0; i < MANY_ITEMS; i++) {
+        UA_MonitoredItem *mon = UA_Subscription_getMonitoredItem(sub, ids[i]);
+        ck_assert_ptr_ne(mon, NULL);
+        ck_assert_uint_eq(mon->monitoredItemId, ids[i]);
+    }
+
+    /* Delete every second MonitoredItem */
+    UA_UInt32 evenIds[MANY_ITEMS / 2];
+    for(size_t i = 0; i < MANY_ITEMS / 2; i++)
+        evenIds[i] = ids[2 * i];
+    UA_DeleteMonitoredItemsRequest request;
+    UA_DeleteMonitoredItemsRequest_init(&request);
+    request.subscriptionId = subscriptionId;
+    request.monitoredItemIdsSize = MANY_ITEMS / 2;
+    request.monitoredItemIds = evenIds;
+    UA_DeleteMonitoredItemsResponse response;
+    UA_DeleteMonitoredItemsResponse_init(&response);
+    lockServer(server);
+    Service_DeleteMonitoredItems(server, session, &request, &response);
+    unlockServer(server);
+    ck_assert_uint_eq(response.resultsSize, MANY_ITEMS / 2);
+    for(size_t i = 0; i < MANY_ITEMS / 2; i++)
+        ck_assert_uint_eq(response.results[i], UA_STATUSCODE_GOOD);
+    UA_DeleteMonitoredItemsResponse_clear(&response);
+
+    /* Delete all. The already deleted MonitoredItems are not found. */
+    request.monitoredItemIdsSize = MANY_ITEMS;
+    request.monitoredItemIds = ids;
+    lockServer(server);
+    Service_DeleteMonitoredItems(server, session, &request, &response);
+    unlockServer(server);
+    ck_assert_uint_eq(response.resultsSize, MANY_ITEMS);
+    for(size_t i = 0; i < MANY_ITEMS; i++) {
+        UA_StatusCode expected = (i % 2 == 0) ?
+            UA_STATUSCODE_BADMONITOREDITEMIDINVALID : UA_STATUSCODE_GOOD;
+        ck_assert_uint_eq(response.results[i], expected);
+    }
+    UA_DeleteMonitoredItemsResponse_clear(&response);
+    ck_assert_uint_eq(sub->monitoredItemsSize, 0);
+}
+END_TEST
+
 START_TEST(Server_lifeTimeCount) {
     /* Create a subscription */
     UA_CreateSubscriptionRequest request;
@@ -871,6 +927,7 @@ static Suite* testSuite_Client(void) {
     tcase_add_test(tc_server, Server_overflow);
     tcase_add_test(tc_server, Server_setMonitoringMode);
     tcase_add_test(tc_server, Server_deleteMonitoredItems);
+    tcase_add_test(tc_server, Server_deleteManyMonitoredItems);
     tcase_add_test(tc_server, Server_republish);
     tcase_add_test(tc_server, Server_republish_invalid);
     tcase_add_test(tc_server, Server_deleteSubscription);
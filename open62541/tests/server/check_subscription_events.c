@@ -18,6 +18,7 @@
 #include <check.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <time.h>
 
 #include "testing_clock.h"
 #include "thread_wrapper.h"
@@ -736,7 +737,7 @@ START_TEST(evaluateFilterWhereClause) {
     }
     lockServer(server);
     retval = evaluateWhereClause(server, &server->adminSession,
-                                 &eventNodeId, &contentFilter, &contentFilterResult);
+                                 &eventNodeId, NULL, &contentFilter, &contentFilterResult);
     unlockServer(server);
     ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
     UA_ContentFilterResult_clear(&contentFilterResult);
@@ -770,7 +771,7 @@ START_TEST(evaluateFilterWhereClause) {
     }
     lockServer(server);
     retval = evaluateWhereClause(server, &server->adminSession,
-                                 &eventNodeId, &contentFilter, &contentFilterResult);
+                                 &eventNodeId, NULL, &contentFilter, &contentFilterResult);
     unlockServer(server);
     ck_assert_uint_eq(retval, UA_STATUSCODE_BADFILTEROPERATORUNSUPPORTED);
     UA_ContentFilterResult_clear(&contentFilterResult);
@@ -797,7 +798,7 @@ START_TEST(evaluateFilterWhereClause) {
     }
     lockServer(server);
     retval = evaluateWhereClause(server, &server->adminSession,
-                                 &eventNodeId, &contentFilter,
+                                 &eventNodeId, NULL, &contentFilter,
                                  &contentFilterResult);
     unlockServer(server);
     ck_assert_uint_eq(retval, UA_STATUSCODE_BADFILTEROPERATORUNSUPPORTED);
@@ -845,7 +846,7 @@ START_TEST(evaluateFilterWhereClause) {
     }
     lockServer(server);
     retval = evaluateWhereClause(server, &server->adminSession,
-                                 &eventNodeId, &contentFilter, &contentFilterResult);
+                                 &eventNodeId, NULL, &contentFilter, &contentFilterResult);
     unlockServer(server);
     ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
     UA_ContentFilterResult_clear(&contentFilterResult);
@@ -875,7 +876,7 @@ START_TEST(evaluateFilterWhereClause) {
     }
     lockServer(server);
     retval = evaluateWhereClause(server, &server->adminSession,
-                                 &eventNodeId, &contentFilter, &contentFilterResult);
+                                 &eventNodeId, NULL, &contentFilter, &contentFilterResult);
     unlockServer(server);
     ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
     UA_ContentFilterResult_clear(&contentFilterResult);
@@ -904,13 +905,705 @@ START_TEST(evaluateFilterWhereClause) {
     }
     lockServer(server);
     retval = evaluateWhereClause(server, &server->adminSession,
-                                 &eventNodeId, &contentFilter, &contentFilterResult);
+                                 &eventNodeId, NULL, &contentFilter, &contentFilterResult);
     unlockServer(server);
     ck_assert_uint_eq(retval, UA_STATUSCODE_BADNOMATCH);
     UA_ContentFilterResult_clear(&contentFilterResult);
 }
 END_TEST
 
+/* Event fields for events that are triggered without a node */
+static void
+setupEventFields(UA_KeyValueMap *fields, UA_UInt16 *severity,
+                 UA_LocalizedText *message) {
+    *severity = 1000;
+    *message = UA_LOCALIZEDTEXT("en-US", "Generated Event");
+    *fields = UA_KEYVALUEMAP_NULL;
+    UA_StatusCode retval =
+        UA_KeyValueMap_setScalar(fields, UA_QUALIFIEDNAME(0, "Severity"),
+                                 severity, &UA_TYPES[UA_TYPES_UINT16]);
+    retval |= UA_KeyValueMap_setScalar(fields, UA_QUALIFIEDNAME(0, "Message"),
+                                       message, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+}
+
+/* Events from a map of fields are received with the same values */
+START_TEST(generateEventsFromFields) {
+    UA_MonitoredItemCreateResult createResult =
+        addMonitoredItem(handler_events_simple, true, true);
+    ck_assert_uint_eq(createResult.statusCode, UA_STATUSCODE_GOOD);
+    monitoredItemId = createResult.monitoredItemId;
+
+    UA_KeyValueMap fields;
+    UA_UInt16 severity;
+    UA_LocalizedText message;
+    setupEventFields(&fields, &severity, &message);
+
+    UA_ByteString eventId = UA_BYTESTRING_NULL;
+    serverMutexLock();
+    UA_StatusCode retval =
+        UA_Server_triggerEventFields(server, eventType,
+                                     UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER),
+                                     &fields, &eventId);
+    serverMutexUnlock();
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(eventId.length, 16);
+    UA_ByteString_clear(&eventId);
+
+    /* The origin must exist */
+    serverMutexLock();
+    retval = UA_Server_triggerEventFields(server, eventType,
+                                          UA_NODEID_NUMERIC(1, 12345678),
+                                          &fields, NULL);
+    serverMutexUnlock();
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADNOTFOUND);
+
+    /* The event type must be a subtype of BaseEventType */
+    serverMutexLock();
+    retval = UA_Server_triggerEventFields(server,
+                                          UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                          UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER),
+                                          &fields, NULL);
+    serverMutexUnlock();
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADINVALIDARGUMENT);
+
+    UA_KeyValueMap_clear(&fields);
+
+    notificationReceived = false;
+    sleepUntilAnswer(publishingInterval + 100);
+    retval = UA_Client_run_iterate(client, 0);
+    sleepUntilAnswer(publishingInterval + 100);
+    retval |= UA_Client_run_iterate(client, 0);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(notificationReceived, true);
+
+    UA_DeleteMonitoredItemsRequest deleteRequest;
+    UA_DeleteMonitoredItemsRequest_init(&deleteRequest);
+    deleteRequest.subscriptionId = subscriptionId;
+    deleteRequest.monitoredItemIds = &monitoredItemId;
+    deleteRequest.monitoredItemIdsSize = 1;
+    UA_DeleteMonitoredItemsResponse deleteResponse =
+        UA_Client_MonitoredItems_delete(client, deleteRequest);
+    sleepUntilAnswer(publishingInterval + 100);
+    ck_assert_uint_eq(deleteResponse.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    UA_DeleteMonitoredItemsResponse_clear(&deleteResponse);
+} END_TEST
+
+static UA_StatusCode
+evaluateFieldsOperator(const UA_KeyValueMap *fields, UA_FilterOperator op,
+                       UA_ExtensionObject *operands, size_t operandsSize) {
+    UA_ContentFilterElement element;
+    UA_ContentFilterElement_init(&element);
+    element.filterOperator = op;
+    element.filterOperands = operands;
+    element.filterOperandsSize = operandsSize;
+    UA_ContentFilter contentFilter;
+    contentFilter.elements = &element;
+    contentFilter.elementsSize = 1;
+
+    UA_StatusCode operandResults[2];
+    UA_ContentFilterElementResult elementResult;
+    UA_ContentFilterElementResult_init(&elementResult);
+    elementResult.operandStatusCodes = operandResults;
+    elementResult.operandStatusCodesSize = operandsSize;
+    UA_ContentFilterResult contentFilterResult;
+    UA_ContentFilterResult_init(&contentFilterResult);
+    contentFilterResult.elementResults = &elementResult;
+    contentFilterResult.elementResultsSize = 1;
+
+    lockServer(server);
+    UA_StatusCode retval =
+        evaluateWhereClause(server, &server->adminSession, NULL, fields,
+                            &contentFilter, &contentFilterResult);
+    unlockServer(server);
+    return retval;
+}
+
+START_TEST(evaluateFilterWhereClauseFields) {
+    UA_KeyValueMap fields;
+    UA_UInt16 severity;
+    UA_LocalizedText message;
+    setupEventFields(&fields, &severity, &message);
+    UA_StatusCode retval =
+        UA_KeyValueMap_setScalar(&fields, UA_QUALIFIEDNAME(0, "EventType"),
+                                 &eventType, &UA_TYPES[UA_TYPES_NODEID]);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* OfType compares with the EventType field */
+    UA_LiteralOperand literal;
+    UA_LiteralOperand_init(&literal);
+    UA_NodeId baseEventTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEEVENTTYPE);
+    UA_Variant_setScalar(&literal.value, &baseEventTypeId, &UA_TYPES[UA_TYPES_NODEID]);
+    UA_ExtensionObject operands[2];
+    UA_ExtensionObject_setValue(&operands[0], &literal,
+                                &UA_TYPES[UA_TYPES_LITERALOPERAND]);
+    retval = evaluateFieldsOperator(&fields, UA_FILTEROPERATOR_OFTYPE, operands, 1);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_NodeId auditEventTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_AUDITEVENTTYPE);
+    UA_Variant_setScalar(&literal.value, &auditEventTypeId, &UA_TYPES[UA_TYPES_NODEID]);
+    retval = evaluateFieldsOperator(&fields, UA_FILTEROPERATOR_OFTYPE, operands, 1);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADNOMATCH);
+
+    /* Compare a field value with a literal */
+    UA_SimpleAttributeOperand sao;
+    UA_SimpleAttributeOperand_init(&sao);
+    sao.typeDefinitionId = baseEventTypeId;
+    sao.attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_QualifiedName severityName = UA_QUALIFIEDNAME(0, "Severity");
+    sao.browsePath = &severityName;
+    sao.browsePathSize = 1;
+    UA_ExtensionObject_setValue(&operands[0], &sao,
+                                &UA_TYPES[UA_TYPES_SIMPLEATTRIBUTEOPERAND]);
+    UA_UInt16 compare = 1000;
+    UA_Variant_setScalar(&literal.value, &compare, &UA_TYPES[UA_TYPES_UINT16]);
+    UA_ExtensionObject_setValue(&operands[1], &literal,
+                                &UA_TYPES[UA_TYPES_LITERALOPERAND]);
+    retval = evaluateFieldsOperator(&fields, UA_FILTEROPERATOR_EQUALS, operands, 2);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    compare = 500;
+    retval = evaluateFieldsOperator(&fields, UA_FILTEROPERATOR_EQUALS, operands, 2);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADNOMATCH);
+    retval = evaluateFieldsOperator(&fields, UA_FILTEROPERATOR_GREATERTHAN, operands, 2);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_KeyValueMap_clear(&fields);
+} END_TEST
+
+/* A select-clause with the ConditionType falls back to the BaseEventType for
+ * events that are not Conditions. Same as for events with a node. */
+START_TEST(selectClauseConditionTypeFields) {
+    UA_KeyValueMap fields;
+    UA_UInt16 severity;
+    UA_LocalizedText message;
+    setupEventFields(&fields, &severity, &message);
+    UA_StatusCode retval =
+        UA_KeyValueMap_setScalar(&fields, UA_QUALIFIEDNAME(0, "EventType"),
+                                 &eventType, &UA_TYPES[UA_TYPES_NODEID]);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_SimpleAttributeOperand sao;
+    UA_SimpleAttributeOperand_init(&sao);
+    sao.typeDefinitionId = UA_NODEID_NUMERIC(0, UA_NS0ID_CONDITIONTYPE);
+    sao.attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_QualifiedName severityName = UA_QUALIFIEDNAME(0, "Severity");
+    sao.browsePath = &severityName;
+    sao.browsePathSize = 1;
+    UA_EventFilter filter;
+    UA_EventFilter_init(&filter);
+    filter.selectClauses = &sao;
+    filter.selectClausesSize = 1;
+
+    UA_EventFieldList efl;
+    UA_EventFilterResult result;
+    UA_NodeId eventNode = UA_NODEID_NULL;
+    lockServer(server);
+    retval = filterEvent(server, &server->adminSession, &eventNode, &fields,
+                         &filter, NULL, &efl, &result);
+    unlockServer(server);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(efl.eventFieldsSize, 1);
+    ck_assert(UA_Variant_hasScalarType(&efl.eventFields[0], &UA_TYPES[UA_TYPES_UINT16]));
+    ck_assert_uint_eq(*(UA_UInt16*)efl.eventFields[0].data, 1000);
+
+    UA_EventFieldList_clear(&efl);
+    UA_EventFilterResult_clear(&result);
+    UA_KeyValueMap_clear(&fields);
+} END_TEST
+
+/* Compare triggering events with a temporary node and from a map of fields */
+START_TEST(triggerEventFieldsSpeed) {
+    UA_MonitoredItemCreateResult createResult =
+        addMonitoredItem(handler_events_overflow, true, true);
+    ck_assert_uint_eq(createResult.statusCode, UA_STATUSCODE_GOOD);
+    monitoredItemId = createResult.monitoredItemId;
+
+    const size_t events = 2000;
+    UA_UInt16 severity = 1000;
+    UA_LocalizedText message = UA_LOCALIZEDTEXT("en-US", "Generated Event");
+    UA_NodeId serverId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER);
+
+    serverMutexLock();
+    clock_t begin = clock();
+    for(size_t i = 0; i < events; i++) {
+        UA_NodeId eventNodeId;
+        UA_StatusCode retval = UA_Server_createEvent(server, eventType, &eventNodeId);
+        retval |= UA_Server_writeObjectProperty_scalar(server, eventNodeId,
+                                                       UA_QUALIFIEDNAME(0, "Severity"),
+                                                       &severity, &UA_TYPES[UA_TYPES_UINT16]);
+        retval |= UA_Server_writeObjectProperty_scalar(server, eventNodeId,
+                                                       UA_QUALIFIEDNAME(0, "Message"),
+                                                       &message, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+        retval |= UA_Server_triggerEvent(server, eventNodeId, serverId, NULL, true);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+    clock_t nodeTime = clock() - begin;
+
+    UA_KeyValuePair pairs[2];
+    pairs[0].key = UA_QUALIFIEDNAME(0, "Severity");
+    UA_Variant_setScalar(&pairs[0].value, &severity, &UA_TYPES[UA_TYPES_UINT16]);
+    pairs[1].key = UA_QUALIFIEDNAME(0, "Message");
+    UA_Variant_setScalar(&pairs[1].value, &message, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+    UA_KeyValueMap fields = {2, pairs};
+
+    begin = clock();
+    for(size_t i = 0; i < events; i++) {
+        UA_StatusCode retval =
+            UA_Server_triggerEventFields(server, eventType, serverId, &fields, NULL);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+    clock_t fieldsTime = clock() - begin;
+    serverMutexUnlock();
+
+    printf("%lu events triggered from an event node: %f s\n", (unsigned long)events,
+           (double)nodeTime / CLOCKS_PER_SEC);
+    printf("%lu events triggered from a map of fields: %f s\n", (unsigned long)events,
+           (double)fieldsTime / CLOCKS_PER_SEC);
+
+    UA_DeleteMonitoredItemsRequest deleteRequest;
+    UA_DeleteMonitoredItemsRequest_init(&deleteRequest);
+    deleteRequest.subscriptionId = subscriptionId;
+    deleteRequest.monitoredItemIds = &monitoredItemId;
+    deleteRequest.monitoredItemIdsSize = 1;
+    UA_DeleteMonitoredItemsResponse deleteResponse =
+        UA_Client_MonitoredItems_delete(client, deleteRequest);
+    ck_assert_uint_eq(deleteResponse.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    UA_DeleteMonitoredItemsResponse_clear(&deleteResponse);
+} END_TEST
+
+static size_t eventsReceived;
+
+static void
+handler_events_count(UA_Client *lclient, UA_UInt32 subId, void *subContext,
+                     UA_UInt32 monId, void *monContext,
+                     size_t nEventFields, UA_Variant *eventFields) {
+    eventsReceived++;
+}
+
+static size_t
+triggerAndCount(const UA_NodeId origin) {
+    serverMutexLock();
+    UA_StatusCode retval =
+        UA_Server_triggerEventFields(server, eventType, origin, NULL, NULL);
+    serverMutexUnlock();
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    eventsReceived = 0;
+    sleepUntilAnswer(publishingInterval + 100);
+    retval = UA_Client_run_iterate(client, 0);
+    sleepUntilAnswer(publishingInterval + 100);
+    retval |= UA_Client_run_iterate(client, 0);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    return eventsReceived;
+}
+
+/* The cached emitting nodes of an origin follow reference changes */
+START_TEST(emitCacheInvalidation) {
+    UA_NodeId sourceId, notifierId;
+    UA_ObjectAttributes attr = UA_ObjectAttributes_default;
+    attr.eventNotifier = UA_EVENTNOTIFIER_SUBSCRIBE_TO_EVENT;
+    serverMutexLock();
+    UA_StatusCode retval =
+        UA_Server_addObjectNode(server, UA_NODEID_NULL,
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                UA_QUALIFIEDNAME(1, "EventSource"),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                attr, NULL, &sourceId);
+    retval |= UA_Server_addObjectNode(server, UA_NODEID_NULL,
+                                      UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                      UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                      UA_QUALIFIEDNAME(1, "EventNotifier"),
+                                      UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                      attr, NULL, &notifierId);
+    serverMutexUnlock();
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_MonitoredItemCreateRequest item;
+    UA_MonitoredItemCreateRequest_init(&item);
+    item.itemToMonitor.nodeId = notifierId;
+    item.itemToMonitor.attributeId = UA_ATTRIBUTEID_EVENTNOTIFIER;
+    item.monitoringMode = UA_MONITORINGMODE_REPORTING;
+    UA_EventFilter filter;
+    UA_EventFilter_init(&filter);
+    filter.selectClauses = selectClauses;
+    filter.selectClausesSize = nSelectClauses;
+    item.requestedParameters.filter.encoding = UA_EXTENSIONOBJECT_DECODED;
+    item.requestedParameters.filter.content.decoded.data = &filter;
+    item.requestedParameters.filter.content.decoded.type = &UA_TYPES[UA_TYPES_EVENTFILTER];
+    item.requestedParameters.queueSize = 10;
+    UA_MonitoredItemCreateResult createResult =
+        UA_Client_MonitoredItems_createEvent(client, subscriptionId,
+                                             UA_TIMESTAMPSTORETURN_BOTH, item,
+                                             NULL, handler_events_count, NULL);
+    ck_assert_uint_eq(createResult.statusCode, UA_STATUSCODE_GOOD);
+
+    /* The notifier is not a parent of the source. The second event uses the
+     * cached emitting nodes. */
+    ck_assert_uint_eq(triggerAndCount(sourceId), 0);
+    ck_assert_uint_eq(triggerAndCount(sourceId), 0);
+
+    /* Events propagate over the new reference */
+    serverMutexLock();
+    retval = UA_Server_addReference(server, notifierId,
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_HASNOTIFIER),
+                                    UA_EXPANDEDNODEID_NUMERIC(sourceId.namespaceIndex,
+                                                              sourceId.identifier.numeric),
+                                    true);
+    serverMutexUnlock();
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(triggerAndCount(sourceId), 1);
+    ck_assert_uint_eq(triggerAndCount(sourceId), 1);
+
+    /* And no longer after it is deleted */
+    serverMutexLock();
+    retval = UA_Server_deleteReference(server, notifierId,
+                                       UA_NODEID_NUMERIC(0, UA_NS0ID_HASNOTIFIER), true,
+                                       UA_EXPANDEDNODEID_NUMERIC(sourceId.namespaceIndex,
+                                                                 sourceId.identifier.numeric),
+                                       true);
+    serverMutexUnlock();
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(triggerAndCount(sourceId), 0);
+
+    /* A removed origin is not found in the cache */
+    serverMutexLock();
+    retval = UA_Server_deleteNode(server, sourceId, true);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    retval = UA_Server_triggerEventFields(server, eventType, sourceId, NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADNOTFOUND);
+    retval = UA_Server_deleteNode(server, notifierId, true);
+    serverMutexUnlock();
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+} END_TEST
+
+/* Per-MonitoredItem event counters passed as monContext */
+static void
+handler_events_countPerItem(UA_Client *lclient, UA_UInt32 subId, void *subContext,
+                            UA_UInt32 monId, void *monContext,
+                            size_t nEventFields, UA_Variant *eventFields) {
+    (*(size_t*)monContext)++;
+}
+
+static void
+setOfTypeWhereClause(UA_ContentFilterElement *element, UA_ExtensionObject *operand,
+                     UA_LiteralOperand *literal, UA_NodeId *type) {
+    UA_Variant_setScalar(&literal->value, type, &UA_TYPES[UA_TYPES_NODEID]);
+    UA_ExtensionObject_setValue(operand, literal, &UA_TYPES[UA_TYPES_LITERALOPERAND]);
+    element->filterOperator = UA_FILTEROPERATOR_OFTYPE;
+    element->filterOperands = operand;
+    element->filterOperandsSize = 1;
+}
+
+/* Events are dispatched only to the MonitoredItems whose where-clause accepts
+ * the event type or one of its supertypes */
+START_TEST(eventTypeIndexDispatch) {
+#define TYPED_MONITOREDITEMS 4
+    UA_NodeId auditEventTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_AUDITEVENTTYPE);
+    UA_NodeId baseEventTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEEVENTTYPE);
+
+    /* 0: OfType(AuditEventType), 1: OfType(BaseEventType), 2: no where-clause,
+     * 3: OfType(AuditEventType) OR OfType(eventType) */
+    UA_LiteralOperand literals[4];
+    UA_ExtensionObject operands[6];
+    UA_ContentFilterElement elements[6];
+    setOfTypeWhereClause(&elements[0], &operands[0], &literals[0], &auditEventTypeId);
+    setOfTypeWhereClause(&elements[1], &operands[1], &literals[1], &baseEventTypeId);
+    UA_ElementOperand elementOperands[2] = {{1}, {2}};
+    UA_ExtensionObject_setValue(&operands[2], &elementOperands[0],
+                                &UA_TYPES[UA_TYPES_ELEMENTOPERAND]);
+    UA_ExtensionObject_setValue(&operands[3], &elementOperands[1],
+                                &UA_TYPES[UA_TYPES_ELEMENTOPERAND]);
+    elements[2].filterOperator = UA_FILTEROPERATOR_OR;
+    elements[2].filterOperands = &operands[2];
+    elements[2].filterOperandsSize = 2;
+    setOfTypeWhereClause(&elements[3], &operands[4], &literals[2], &auditEventTypeId);
+    setOfTypeWhereClause(&elements[4], &operands[5], &literals[3], &eventType);
+
+    UA_EventFilter filters[TYPED_MONITOREDITEMS];
+    UA_MonitoredItemCreateRequest items[TYPED_MONITOREDITEMS];
+    UA_Client_EventNotificationCallback callbacks[TYPED_MONITOREDITEMS];
+    size_t counters[TYPED_MONITOREDITEMS] = {0};
+    void *contexts[TYPED_MONITOREDITEMS];
+    for(size_t i = 0; i < TYPED_MONITOREDITEMS; i++) {
+        UA_EventFilter_init(&filters[i]);
+        filters[i].selectClauses = selectClauses;
+        filters[i].selectClausesSize = nSelectClauses;
+        UA_MonitoredItemCreateRequest_init(&items[i]);
+        items[i].itemToMonitor.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER);
+        items[i].itemToMonitor.attributeId = UA_ATTRIBUTEID_EVENTNOTIFIER;
+        items[i].monitoringMode = UA_MONITORINGMODE_REPORTING;
+        UA_ExtensionObject_setValue(&items[i].requestedParameters.filter, &filters[i],
+                                    &UA_TYPES[UA_TYPES_EVENTFILTER]);
+        items[i].requestedParameters.queueSize = 10;
+        callbacks[i] = handler_events_countPerItem;
+        contexts[i] = &counters[i];
+    }
+    filters[0].whereClause.elements = &elements[0];
+    filters[0].whereClause.elementsSize = 1;
+    filters[1].whereClause.elements = &elements[1];
+    filters[1].whereClause.elementsSize = 1;
+    filters[3].whereClause.elements = &elements[2];
+    filters[3].whereClause.elementsSize = 3;
+
+    UA_CreateMonitoredItemsRequest createRequest;
+    UA_CreateMonitoredItemsRequest_init(&createRequest);
+    createRequest.subscriptionId = subscriptionId;
+    createRequest.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+    createRequest.itemsToCreate = items;
+    createRequest.itemsToCreateSize = TYPED_MONITOREDITEMS;
+    UA_CreateMonitoredItemsResponse createResponse =
+        UA_Client_MonitoredItems_createEvents(client, createRequest, contexts,
+                                              callbacks, NULL);
+    ck_assert_uint_eq(createResponse.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(createResponse.resultsSize, TYPED_MONITOREDITEMS);
+    UA_UInt32 monIds[TYPED_MONITOREDITEMS];
+    for(size_t i = 0; i < TYPED_MONITOREDITEMS; i++) {
+        ck_assert_uint_eq(createResponse.results[i].statusCode, UA_STATUSCODE_GOOD);
+        monIds[i] = createResponse.results[i].monitoredItemId;
+    }
+    UA_CreateMonitoredItemsResponse_clear(&createResponse);
+
+    triggerAndCount(UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER));
+    ck_assert_uint_eq(counters[0], 0);
+    ck_assert_uint_eq(counters[1], 1);
+    ck_assert_uint_eq(counters[2], 1);
+    ck_assert_uint_eq(counters[3], 1);
+
+    /* Modify the first MonitoredItem to accept the event type */
+    setOfTypeWhereClause(&elements[0], &operands[0], &literals[0], &eventType);
+    UA_MonitoredItemModifyRequest modifyItem;
+    UA_MonitoredItemModifyRequest_init(&modifyItem);
+    modifyItem.monitoredItemId = monIds[0];
+    modifyItem.requestedParameters = items[0].requestedParameters;
+    UA_ModifyMonitoredItemsRequest modifyRequest;
+    UA_ModifyMonitoredItemsRequest_init(&modifyRequest);
+    modifyRequest.subscriptionId = subscriptionId;
+    modifyRequest.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+    modifyRequest.itemsToModify = &modifyItem;
+    modifyRequest.itemsToModifySize = 1;
+    UA_ModifyMonitoredItemsResponse modifyResponse =
+        UA_Client_MonitoredItems_modify(client, modifyRequest);
+    ck_assert_uint_eq(modifyResponse.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(modifyResponse.resultsSize, 1);
+    ck_assert_uint_eq(modifyResponse.results[0].statusCode, UA_STATUSCODE_GOOD);
+    UA_ModifyMonitoredItemsResponse_clear(&modifyResponse);
+
+    triggerAndCount(UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER));
+    ck_assert_uint_eq(counters[0], 1);
+    ck_assert_uint_eq(counters[1], 2);
+    ck_assert_uint_eq(counters[2], 2);
+    ck_assert_uint_eq(counters[3], 2);
+
+    UA_DeleteMonitoredItemsRequest deleteRequest;
+    UA_DeleteMonitoredItemsRequest_init(&deleteRequest);
+    deleteRequest.subscriptionId = subscriptionId;
+    deleteRequest.monitoredItemIds = monIds;
+    deleteRequest.monitoredItemIdsSize = TYPED_MONITOREDITEMS;
+    UA_DeleteMonitoredItemsResponse deleteResponse =
+        UA_Client_MonitoredItems_delete(client, deleteRequest);
+    ck_assert_uint_eq(deleteResponse.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    UA_DeleteMonitoredItemsResponse_clear(&deleteResponse);
+#undef TYPED_MONITOREDITEMS
+} END_TEST
+
+/* A where-clause whose elements all point twice to the next element is
+ * compiled in linear time. The event type of the OfType leaf still restricts
+ * the dispatch. */
+START_TEST(sharedElementOperandsWhereClause) {
+#define CHAINED_ELEMENTS 64
+    UA_ContentFilterElement elements[CHAINED_ELEMENTS];
+    UA_ExtensionObject operands[2 * CHAINED_ELEMENTS];
+    UA_ElementOperand elementOperands[CHAINED_ELEMENTS];
+    for(size_t i = 0; i < CHAINED_ELEMENTS - 1; i++) {
+        elementOperands[i].index = (UA_UInt32)(i + 1);
+        UA_ExtensionObject_setValue(&operands[2 * i], &elementOperands[i],
+                                    &UA_TYPES[UA_TYPES_ELEMENTOPERAND]);
+        UA_ExtensionObject_setValue(&operands[(2 * i) + 1], &elementOperands[i],
+                                    &UA_TYPES[UA_TYPES_ELEMENTOPERAND]);
+        elements[i].filterOperator = UA_FILTEROPERATOR_OR;
+        elements[i].filterOperands = &operands[2 * i];
+        elements[i].filterOperandsSize = 2;
+    }
+    UA_LiteralOperand literal;
+    setOfTypeWhereClause(&elements[CHAINED_ELEMENTS - 1],
+                         &operands[2 * (CHAINED_ELEMENTS - 1)], &literal, &eventType);
+
+    UA_EventFilter filter;
+    UA_EventFilter_init(&filter);
+    filter.selectClauses = selectClauses;
+    filter.selectClausesSize = nSelectClauses;
+    filter.whereClause.elements = elements;
+    filter.whereClause.elementsSize = CHAINED_ELEMENTS;
+
+    UA_MonitoredItemCreateRequest item;
+    UA_MonitoredItemCreateRequest_init(&item);
+    item.itemToMonitor.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER);
+    item.itemToMonitor.attributeId = UA_ATTRIBUTEID_EVENTNOTIFIER;
+    item.monitoringMode = UA_MONITORINGMODE_REPORTING;
+    UA_ExtensionObject_setValue(&item.requestedParameters.filter, &filter,
+                                &UA_TYPES[UA_TYPES_EVENTFILTER]);
+    item.requestedParameters.queueSize = 10;
+    UA_MonitoredItemCreateResult result =
+        UA_Client_MonitoredItems_createEvent(client, subscriptionId,
+                                             UA_TIMESTAMPSTORETURN_BOTH, item,
+                                             NULL, handler_events_count, NULL);
+    ck_assert_uint_eq(result.statusCode, UA_STATUSCODE_GOOD);
+    UA_UInt32 monId = result.monitoredItemId;
+    UA_MonitoredItemCreateResult_clear(&result);
+
+    ck_assert_uint_eq(triggerAndCount(UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER)), 1);
+
+    UA_DeleteMonitoredItemsRequest deleteRequest;
+    UA_DeleteMonitoredItemsRequest_init(&deleteRequest);
+    deleteRequest.subscriptionId = subscriptionId;
+    deleteRequest.monitoredItemIds = &monId;
+    deleteRequest.monitoredItemIdsSize = 1;
+    UA_DeleteMonitoredItemsResponse deleteResponse =
+        UA_Client_MonitoredItems_delete(client, deleteRequest);
+    ck_assert_uint_eq(deleteResponse.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    UA_DeleteMonitoredItemsResponse_clear(&deleteResponse);
+#undef CHAINED_ELEMENTS
+} END_TEST
+
+/* Many event MonitoredItems with a where-clause. Every event matches only one
+ * of them. Measures the evaluation of the compiled where-clauses. Then events
+ * of an unrelated type are triggered that match none of them. */
+START_TEST(filteredEventSubscriptionsSpeed) {
+#define FILTERED_MONITOREDITEMS 1000
+    /* Where-clause: OfType(eventType) AND (Severity == i) */
+    UA_NodeId baseEventTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEEVENTTYPE);
+    UA_QualifiedName severityName = UA_QUALIFIEDNAME(0, "Severity");
+    UA_SimpleAttributeOperand sao;
+    UA_SimpleAttributeOperand_init(&sao);
+    sao.typeDefinitionId = baseEventTypeId;
+    sao.attributeId = UA_ATTRIBUTEID_VALUE;
+    sao.browsePath = &severityName;
+    sao.browsePathSize = 1;
+    UA_ElementOperand elementOperands[2] = {{1}, {2}};
+    UA_LiteralOperand typeLiteral;
+    UA_Variant_setScalar(&typeLiteral.value, &eventType, &UA_TYPES[UA_TYPES_NODEID]);
+
+    UA_UInt32 severities[FILTERED_MONITOREDITEMS];
+    UA_LiteralOperand severityLiterals[FILTERED_MONITOREDITEMS];
+    UA_ExtensionObject operands[FILTERED_MONITOREDITEMS][5];
+    UA_ContentFilterElement elements[FILTERED_MONITOREDITEMS][3];
+    UA_EventFilter filters[FILTERED_MONITOREDITEMS];
+    UA_MonitoredItemCreateRequest items[FILTERED_MONITOREDITEMS];
+    UA_Client_EventNotificationCallback callbacks[FILTERED_MONITOREDITEMS];
+    for(size_t i = 0; i < FILTERED_MONITOREDITEMS; i++) {
+        /* The literal is an UInt32. The UInt16 Severity is cast implicitly. */
+        severities[i] = (UA_UInt32)i;
+        UA_Variant_setScalar(&severityLiterals[i].value, &severities[i],
+                             &UA_TYPES[UA_TYPES_UINT32]);
+        UA_ExtensionObject_setValue(&operands[i][0], &elementOperands[0],
+                                    &UA_TYPES[UA_TYPES_ELEMENTOPERAND]);
+        UA_ExtensionObject_setValue(&operands[i][1], &elementOperands[1],
+                                    &UA_TYPES[UA_TYPES_ELEMENTOPERAND]);
+        UA_ExtensionObject_setValue(&operands[i][2], &typeLiteral,
+                                    &UA_TYPES[UA_TYPES_LITERALOPERAND]);
+        UA_ExtensionObject_setValue(&operands[i][3], &sao,
+                                    &UA_TYPES[UA_TYPES_SIMPLEATTRIBUTEOPERAND]);
+        UA_ExtensionObject_setValue(&operands[i][4], &severityLiterals[i],
+                                    &UA_TYPES[UA_TYPES_LITERALOPERAND]);
+        elements[i][0].filterOperator = UA_FILTEROPERATOR_AND;
+        elements[i][0].filterOperands = &operands[i][0];
+        elements[i][0].filterOperandsSize = 2;
+        elements[i][1].filterOperator = UA_FILTEROPERATOR_OFTYPE;
+        elements[i][1].filterOperands = &operands[i][2];
+        elements[i][1].filterOperandsSize = 1;
+        elements[i][2].filterOperator = UA_FILTEROPERATOR_EQUALS;
+        elements[i][2].filterOperands = &operands[i][3];
+        elements[i][2].filterOperandsSize = 2;
+
+        UA_EventFilter_init(&filters[i]);
+        filters[i].selectClauses = selectClauses;
+        filters[i].selectClausesSize = nSelectClauses;
+        filters[i].whereClause.elements = elements[i];
+        filters[i].whereClause.elementsSize = 3;
+
+        UA_MonitoredItemCreateRequest_init(&items[i]);
+        items[i].itemToMonitor.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER);
+        items[i].itemToMonitor.attributeId = UA_ATTRIBUTEID_EVENTNOTIFIER;
+        items[i].monitoringMode = UA_MONITORINGMODE_REPORTING;
+        UA_ExtensionObject_setValue(&items[i].requestedParameters.filter, &filters[i],
+                                    &UA_TYPES[UA_TYPES_EVENTFILTER]);
+        items[i].requestedParameters.queueSize = 1;
+        items[i].requestedParameters.discardOldest = true;
+        callbacks[i] = handler_events_count;
+    }
+
+    UA_CreateMonitoredItemsRequest createRequest;
+    UA_CreateMonitoredItemsRequest_init(&createRequest);
+    createRequest.subscriptionId = subscriptionId;
+    createRequest.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+    createRequest.itemsToCreate = items;
+    createRequest.itemsToCreateSize = FILTERED_MONITOREDITEMS;
+    UA_CreateMonitoredItemsResponse createResponse =
+        UA_Client_MonitoredItems_createEvents(client, createRequest, NULL,
+                                              callbacks, NULL);
+    ck_assert_uint_eq(createResponse.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(createResponse.resultsSize, FILTERED_MONITOREDITEMS);
+    UA_UInt32 monIds[FILTERED_MONITOREDITEMS];
+    for(size_t i = 0; i < FILTERED_MONITOREDITEMS; i++) {
+        ck_assert_uint_eq(createResponse.results[i].statusCode, UA_STATUSCODE_GOOD);
+        monIds[i] = createResponse.results[i].monitoredItemId;
+    }
+    UA_CreateMonitoredItemsResponse_clear(&createResponse);
+
+    /* Trigger the events. Each matches exactly one MonitoredItem. */
+    const size_t events = 10000;
+    UA_UInt16 severity = 0;
+    UA_KeyValuePair pair;
+    pair.key = severityName;
+    UA_Variant_setScalar(&pair.value, &severity, &UA_TYPES[UA_TYPES_UINT16]);
+    UA_KeyValueMap fields = {1, &pair};
+    serverMutexLock();
+    clock_t begin = clock();
+    for(size_t i = 0; i < events; i++) {
+        severity = (UA_UInt16)(i % FILTERED_MONITOREDITEMS);
+        UA_StatusCode retval =
+            UA_Server_triggerEventFields(server, eventType,
+                                         UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER),
+                                         &fields, NULL);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+    clock_t duration = clock() - begin;
+    serverMutexUnlock();
+    double seconds = (double)duration / CLOCKS_PER_SEC;
+    printf("%lu events filtered by %u MonitoredItems: %f s (%.0f events/s)\n",
+           (unsigned long)events, FILTERED_MONITOREDITEMS, seconds,
+           (seconds > 0.0) ? (double)events / seconds : 0.0);
+
+    UA_NodeId auditEventTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_AUDITEVENTTYPE);
+    serverMutexLock();
+    begin = clock();
+    for(size_t i = 0; i < events; i++) {
+        UA_StatusCode retval =
+            UA_Server_triggerEventFields(server, auditEventTypeId,
+                                         UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER),
+                                         &fields, NULL);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+    duration = clock() - begin;
+    serverMutexUnlock();
+    seconds = (double)duration / CLOCKS_PER_SEC;
+    printf("%lu events of an unrelated type for %u MonitoredItems: %f s (%.0f events/s)\n",
+           (unsigned long)events, FILTERED_MONITOREDITEMS, seconds,
+           (seconds > 0.0) ? (double)events / seconds : 0.0);
+
+    UA_DeleteMonitoredItemsRequest deleteRequest;
+    UA_DeleteMonitoredItemsRequest_init(&deleteRequest);
+    deleteRequest.subscriptionId = subscriptionId;
+    deleteRequest.monitoredItemIds = monIds;
+    deleteRequest.monitoredItemIdsSize = FILTERED_MONITOREDITEMS;
+    UA_DeleteMonitoredItemsResponse deleteResponse =
+        UA_Client_MonitoredItems_delete(client, deleteRequest);
+    ck_assert_uint_eq(deleteResponse.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    UA_DeleteMonitoredItemsResponse_clear(&deleteResponse);
+#undef FILTERED_MONITOREDITEMS
+} END_TEST
+
 #endif /* UA_ENABLE_SUBSCRIPTIONS_EVENTS */
 
 /* Assumes subscriptions work fine with data change because of other unit test */
@@ -930,6 +1623,14 @@ static Suite *testSuite_Client(void) {
     tcase_add_test(tc_server, discardNewestOverflow);
     tcase_add_test(tc_server, eventStressing);
     tcase_add_test(tc_server, evaluateFilterWhereClause);
+    tcase_add_test(tc_server, generateEventsFromFields);
+    tcase_add_test(tc_server, evaluateFilterWhereClauseFields);
+    tcase_add_test(tc_server, selectClauseConditionTypeFields);
+    tcase_add_test(tc_server, triggerEventFieldsSpeed);
+    tcase_add_test(tc_server, emitCacheInvalidation);
+    tcase_add_test(tc_server, eventTypeIndexDispatch);
+    tcase_add_test(tc_server, sharedElementOperandsWhereClause);
+    tcase_add_test(tc_server, filteredEventSubscriptionsSpeed);
 #endif /* UA_ENABLE_SUBSCRIPTIONS_EVENTS */
     suite_add_tcase(s, tc_server);
 
@@ -52,5 +52,7 @@ UA_ConnectionManager testConnectionManagerTCP = {
     testSendWithConnection,
     testCloseConnection,
     testAllocNetworkBuffer,
-    testFreeNetworkBuffer
+    testFreeNetworkBuffer,
+    NULL, /* sendBatchWithConnection */
+    NULL /* sendRetainedWithConnection */
 };
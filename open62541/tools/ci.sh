@@ -240,6 +240,20 @@ function unit_tests_mt {
     make test ARGS="-V"
 }
 
+function unit_tests_timer_wheel {
+    mkdir -p build; cd build; rm -rf *
+    cmake -DCMAKE_BUILD_TYPE=Debug \
+          -DUA_BUILD_EXAMPLES=ON \
+          -DUA_BUILD_UNIT_TESTS=ON \
+          -DUA_ENABLE_ALLOW_REUSEADDR=ON \
+          -DUA_ENABLE_TIMER_WHEEL=ON \
+          -DUA_FORCE_WERROR=ON \
+          ..
+    make ${MAKEOPTS}
+    set_capabilities
+    make test ARGS="-V"
+}
+
 function unit_tests_alarms {
     mkdir -p build; cd build; rm -rf *
     cmake -DCMAKE_BUILD_TYPE=Debug \
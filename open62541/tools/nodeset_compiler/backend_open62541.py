@@ -293,7 +293,9 @@ _UA_END_DECLS
         writec("    NULL,")
         writec("    " + arr + "_COUNT,")
         writec("    " + arr + ",")
-        writec("    UA_FALSE\n};")
+        writec("    UA_FALSE,")
+        writec("    NULL\n};")
+        writec("static UA_DATATYPEINDEX_STORAGE(custom" + arr + "_index, " + arr + "_COUNT);")
 
     writec("""
 UA_StatusCode %s(UA_Server *server) {
@@ -327,6 +329,9 @@ UA_StatusCode retVal = UA_STATUSCODE_GOOD;""" % (outfilebase))
         if arr == "UA_TYPES":
             continue
         writec("if(" + arr + "_COUNT > 0) {")
+        writec("retVal = UA_DataTypeArray_buildIndexStatic(&custom" + arr + ", custom" + arr +
+               "_index, sizeof(custom" + arr + "_index));")
+        writec("if(retVal != UA_STATUSCODE_GOOD) return retVal;")
         writec("custom" + arr + ".next = UA_Server_getConfig(server)->customDataTypes;")
         writec("UA_Server_getConfig(server)->customDataTypes = &custom" + arr + ";\n")
         writec("}")
@@ -75,24 +75,9 @@ encodeNetworkMessage(const UA_ByteString *buf, UA_ByteString *out) {
         return UA_STATUSCODE_BADINTERNALERROR;
     }
 
-    size_t jsonLength = UA_NetworkMessage_calcSizeJson(&msg, NULL, 0, NULL, 0, true);
-    retval = UA_ByteString_allocBuffer(out, jsonLength);
-    if(retval != UA_STATUSCODE_GOOD) {
-        UA_NetworkMessage_clear(&msg);
-        return retval;
-    }
-
-    uint8_t *bufPos = &out->data[0];
-    const uint8_t *bufEnd = &out->data[out->length];
-    retval = UA_NetworkMessage_encodeJson(&msg, &bufPos, &bufEnd, NULL, 0, NULL, 0, true);
+    retval = UA_NetworkMessage_encodeJsonAlloc(&msg, out, NULL, 0, NULL, 0, true);
     UA_NetworkMessage_clear(&msg);
-    if(retval != UA_STATUSCODE_GOOD) {
-        UA_ByteString_clear(out);
-        return retval;
-    }
-
-    out->length = (size_t)((uintptr_t)bufPos - (uintptr_t)out->data);
-    return UA_STATUSCODE_GOOD;
+    return retval;
 }
 
 static UA_StatusCode